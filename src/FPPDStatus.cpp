@@ -0,0 +1,91 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+#include "fpp-pch.h"
+
+#include "fpp-json.h"
+
+#include "FPPDStatus.h"
+#include "Player.h"
+#include "Warnings.h"
+#include "log.h"
+#include "channeltester/ChannelTester.h"
+
+// httpAPI.cpp
+extern void BuildFPPDStatus(Json::Value& result);
+
+FPPDStatus FPPDStatus::INSTANCE;
+
+class StatusWarningListener : public WarningListener {
+public:
+    virtual void handleWarnings(const std::list<FPPWarning>& warnings) override {
+        FPPDStatus::INSTANCE.Invalidate();
+    }
+};
+static StatusWarningListener warningListener;
+
+std::shared_ptr<const Json::Value> FPPDStatus::GetSnapshot(uint64_t* generation) {
+    std::unique_lock<std::mutex> lock(m_lock);
+    if (!m_listening) {
+        WarningHolder::AddWarningListener(&warningListener);
+        m_listening = true;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    int playerStatus = Player::INSTANCE.GetStatus();
+    bool testing = ChannelTester::INSTANCE.Testing();
+    if (m_dirty || !m_snapshot || (playerStatus != m_playerStatus) || (testing != m_testing) ||
+        (now - m_built) >= std::chrono::milliseconds(SNAPSHOT_INTERVAL_MS)) {
+        m_dirty = false;
+
+        auto status = std::make_shared<Json::Value>();
+        BuildFPPDStatus(*status);
+        m_snapshot = status;
+        m_built = now;
+        m_playerStatus = playerStatus;
+        m_testing = testing;
+        m_generation++;
+    }
+    if (generation) {
+        *generation = m_generation;
+    }
+    return m_snapshot;
+}
+
+Json::Value FPPDStatus::Diff(const Json::Value& from, const Json::Value& to) {
+    if (!from.isObject() || !to.isObject()) {
+        return to;
+    }
+    Json::Value patch(Json::objectValue);
+    for (auto& name : from.getMemberNames()) {
+        if (!to.isMember(name)) {
+            patch[name] = Json::Value::null;
+        }
+    }
+    for (auto& name : to.getMemberNames()) {
+        const Json::Value& t = to[name];
+        if (!from.isMember(name)) {
+            patch[name] = t;
+            continue;
+        }
+        const Json::Value& f = from[name];
+        if (f.isObject() && t.isObject()) {
+            Json::Value sub = Diff(f, t);
+            if (!sub.empty()) {
+                patch[name] = sub;
+            }
+        } else if (f != t) {
+            patch[name] = t;
+        }
+    }
+    return patch;
+}
@@ -0,0 +1,58 @@
+#pragma once
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "fpp-json-fwd.h"
+
+/*
+ * Shared snapshot of the fppd status JSON.  The web UI, remote dashboards,
+ * MQTT/Events publishing and the status WebSocket all read the same
+ * snapshot so building the status costs the same no matter how many
+ * clients are polling it.
+ *
+ * A snapshot is rebuilt when it is older than SNAPSHOT_INTERVAL_MS or
+ * sooner if the player state changes or Invalidate() is called.
+ */
+class FPPDStatus {
+public:
+    static FPPDStatus INSTANCE;
+
+    static constexpr int SNAPSHOT_INTERVAL_MS = 1000;
+
+    // generation is incremented every time a new snapshot is built
+    std::shared_ptr<const Json::Value> GetSnapshot(uint64_t* generation = nullptr);
+
+    // Force the next GetSnapshot() to rebuild
+    void Invalidate() { m_dirty = true; }
+
+    // Returns a JSON merge patch (RFC 7386) that turns from into to.
+    // Removed members are set to null, arrays are replaced whole.
+    static Json::Value Diff(const Json::Value& from, const Json::Value& to);
+
+private:
+    FPPDStatus() {}
+
+    std::mutex m_lock;
+    std::atomic<bool> m_dirty = true;
+    bool m_listening = false;
+    std::shared_ptr<const Json::Value> m_snapshot;
+    std::chrono::steady_clock::time_point m_built;
+    uint64_t m_generation = 0;
+    int m_playerStatus = -1;
+    bool m_testing = false;
+};
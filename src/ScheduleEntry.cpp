@@ -451,8 +451,23 @@ static void mapTimeString(const std::string& tm, int& h, int& m, int& s) {
 }
 
 void ScheduleEntry::pushStartEndTimes(int dow, int& delta, int deltaThreshold) {
-    time_t startTime = GetTimeOnDOW(dow, startHour, startMinute, startSecond);
-    time_t endTime = GetTimeOnDOW(dow, endHour, endMinute, endSecond);
+    time_t startTime;
+    time_t endTime;
+    GetStartEndTimes(dow, startTime, endTime);
+    pushStartEndTimes(startTime, endTime, delta, deltaThreshold);
+}
+
+std::string ScheduleEntry::GetOccurrenceKey() const {
+    // Fixed times are in the strings, SunRise/SunSet/etc. only use the day
+    return startTimeStr + "|" + std::to_string(startTimeOffset) + "|" +
+           endTimeStr + "|" + std::to_string(endTimeOffset) + "|" +
+           std::to_string(startDate) + "|" + std::to_string(endDate) + "|" +
+           std::to_string(repeatInterval);
+}
+
+void ScheduleEntry::GetStartEndTimes(int dow, time_t& startTime, time_t& endTime) {
+    startTime = GetTimeOnDOW(dow, startHour, startMinute, startSecond);
+    endTime = GetTimeOnDOW(dow, endHour, endMinute, endSecond);
 
     if (startTimeStr.find(":") == std::string::npos) {
         GetTimeFromSun(startTime, startTimeStr, startTimeOffset, startHour, startMinute, startSecond);
@@ -466,7 +481,25 @@ void ScheduleEntry::pushStartEndTimes(int dow, int& delta, int deltaThreshold) {
             GetTimeFromSun(endTime, endTimeStr, endTimeOffset, endHour, endMinute, endSecond);
         }
     }
+}
 
+void ScheduleEntry::SetSunTimes(time_t startTime, time_t endTime) {
+    struct tm tm;
+    if (startTimeStr.find(":") == std::string::npos) {
+        localtime_r(&startTime, &tm);
+        startHour = tm.tm_hour;
+        startMinute = tm.tm_min;
+        startSecond = tm.tm_sec;
+    }
+    if (endTimeStr.find(":") == std::string::npos) {
+        localtime_r(&endTime, &tm);
+        endHour = tm.tm_hour;
+        endMinute = tm.tm_min;
+        endSecond = tm.tm_sec;
+    }
+}
+
+void ScheduleEntry::pushStartEndTimes(time_t startTime, time_t endTime, int& delta, int deltaThreshold) {
     if (endTime < time(NULL))
         return;
 
@@ -490,10 +523,14 @@ void ScheduleEntry::pushStartEndTimes(int dow, int& delta, int deltaThreshold) {
         }
     }
 
+    GetRepeatTimes(startTime, endTime, startEndTimes);
+}
+
+void ScheduleEntry::GetRepeatTimes(time_t startTime, time_t endTime, std::vector<std::pair<time_t, time_t>>& times) {
     if ((repeatInterval) && (startTime != endTime)) {
         time_t newEnd = startTime + repeatInterval - 1;
         while (startTime < endTime) {
-            startEndTimes.push_back(std::pair<int, int>(startTime, newEnd));
+            times.push_back(std::pair<int, int>(startTime, newEnd));
             newEnd += repeatInterval;
             if (newEnd > endTime) {
                 newEnd = endTime;
@@ -501,7 +538,7 @@ void ScheduleEntry::pushStartEndTimes(int dow, int& delta, int deltaThreshold) {
             startTime += repeatInterval;
         }
     } else {
-        startEndTimes.push_back(std::pair<int, int>(startTime, endTime));
+        times.push_back(std::pair<int, int>(startTime, endTime));
     }
 }
 
@@ -39,6 +39,20 @@ public:
     int LoadFromJson(Json::Value& entry);
 
     void pushStartEndTimes(int day, int &delta, int deltaThreshold);
+    void pushStartEndTimes(time_t startTime, time_t endTime, int& delta, int deltaThreshold);
+
+    // Start and end time of the occurrence on 'day' (relative to Sunday of
+    // the current week) before any date range or time delta is applied.
+    // Entries with the same GetOccurrenceKey() get the same times, date
+    // range checks and repeats so the Scheduler can index them by date
+    // across reloads.
+    void GetStartEndTimes(int day, time_t& startTime, time_t& endTime);
+    std::string GetOccurrenceKey() const;
+    // Split an occurrence into repeatInterval sized pieces, if repeating
+    void GetRepeatTimes(time_t startTime, time_t endTime, std::vector<std::pair<time_t, time_t>>& times);
+    // Update the displayed times of SunRise/SunSet/etc. entries from a
+    // cached occurrence, GetStartEndTimes() does this itself
+    void SetSunTimes(time_t startTime, time_t endTime);
 
     void GetTimeFromSun(time_t& when, const std::string info,
                         const int infoOffset, int& h, int& m, int& s);
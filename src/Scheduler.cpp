@@ -84,8 +84,8 @@ void Scheduler::ScheduleProc(void) {
 
     // reload the schedule file once per day or if 5 seconds has elapsed
     // since the last process time in case the time jumps
-    if ((m_lastLoadDate != GetCurrentDateInt()) ||
-        (abs(timeDelta) > 5)) {
+    bool timeJumped = abs(timeDelta) > 5;
+    if ((m_lastLoadDate != GetCurrentDateInt()) || timeJumped) {
         m_loadSchedule = true;
 
         // Cleanup any ran items older than 2 days
@@ -99,6 +99,11 @@ void Scheduler::ScheduleProc(void) {
 
     std::unique_lock<std::recursive_mutex> lock(m_scheduleLock);
 
+    if (timeJumped) {
+        // the clock or time zone changed, don't trust any indexed times
+        m_occurrenceIndex.clear();
+    }
+
     if (m_loadSchedule)
         LoadScheduleFromFile();
 
@@ -142,6 +147,8 @@ void Scheduler::CheckIfShouldBePlayingNow(int ignoreRepeat, int forceStopped) {
                     (forceStopped != item.entryIndex) &&
                     (item.entry->repeat || ir)) {
                     LogExcess(VB_SCHEDULE, "Item run status reset\n");
+                    if (item.ran)
+                        m_snapshotDirty = true;
                     item.ran = false;
                 }
             }
@@ -185,7 +192,7 @@ void Scheduler::ReloadScheduleFile(void) {
     m_loadSchedule = true;
 }
 
-void Scheduler::AddScheduledItems(ScheduleEntry* entry, int index) {
+void Scheduler::AddScheduledItems(ScheduleEntry* entry, int index, OccurrenceIndex& previousIndex) {
     if (!entry->enabled)
         return;
 
@@ -214,8 +221,60 @@ void Scheduler::AddScheduledItems(ScheduleEntry* entry, int index) {
         }
     }
 
+    // Reuse the occurrences indexed for this entry's settings on previous
+    // loads, only days new to the schedule window need calculating
+    std::string key = entry->GetOccurrenceKey();
+    auto& dayTimes = m_occurrenceIndex[key];
+    if (dayTimes.empty()) {
+        auto node = previousIndex.extract(key);
+        if (!node.empty())
+            dayTimes = std::move(node.mapped());
+    }
+
+    time_t currTime = std::time(nullptr);
+    entry->startEndTimes.clear();
+    auto pushStartEndTimes = [&](int day) {
+        int date = ((day + 1) >= 0 && (day + 1) < m_dayDates.size()) ? m_dayDates[day + 1] : 0;
+        if (m_timeDelta || !date) {
+            // The Extend Schedule delta depends on the current time, calculate
+            // these the old way and check the date range of each occurrence
+            std::vector<std::pair<time_t, time_t>> times;
+            std::swap(times, entry->startEndTimes);
+            entry->pushStartEndTimes(day, m_timeDelta, m_timeDeltaThreshold);
+            std::swap(times, entry->startEndTimes);
+            for (auto& startEnd : times) {
+                if (DateInRange(startEnd.first, entry->startDate, entry->endDate))
+                    entry->startEndTimes.push_back(startEnd);
+            }
+            m_occurrenceIndexMisses++;
+            return;
+        }
+
+        auto it = dayTimes.find(date);
+        if (it != dayTimes.end()) {
+            entry->SetSunTimes(it->second.startTime, it->second.endTime);
+            m_occurrenceIndexHits++;
+        } else {
+            DayOccurrences occurrences;
+            entry->GetStartEndTimes(day, occurrences.startTime, occurrences.endTime);
+            if (DateInRange(occurrences.startTime, entry->startDate, entry->endDate)) {
+                std::vector<std::pair<time_t, time_t>> times;
+                entry->GetRepeatTimes(occurrences.startTime, occurrences.endTime, times);
+                for (auto& startEnd : times) {
+                    if (DateInRange(startEnd.first, entry->startDate, entry->endDate))
+                        occurrences.times.push_back(startEnd);
+                }
+            }
+            it = dayTimes.emplace(date, std::move(occurrences)).first;
+            m_occurrenceIndexMisses++;
+        }
+
+        // same as pushStartEndTimes(), skip occurrences which already ended
+        if (it->second.endTime >= currTime)
+            entry->startEndTimes.insert(entry->startEndTimes.end(), it->second.times.begin(), it->second.times.end());
+    };
+
     int dayIndex = entry->dayIndex;
-    std::time_t currTime = std::time(nullptr);
     struct tm now;
     localtime_r(&currTime, &now);
     int scheduleDistance = getSettingInt("ScheduleDistance");
@@ -319,10 +378,10 @@ void Scheduler::AddScheduledItems(ScheduleEntry* entry, int index) {
 
         // Schedule yesterday if needed to handle midnight crossovers
         if (dayOffset)
-            entry->pushStartEndTimes(now.tm_wday - 1, m_timeDelta, m_timeDeltaThreshold);
+            pushStartEndTimes(now.tm_wday - 1);
 
         for (int i = now.tm_wday + dayOffset; i <= scheduleDistance; i += 2) {
-            entry->pushStartEndTimes(i, m_timeDelta, m_timeDeltaThreshold);
+            pushStartEndTimes(i);
         }
 
         break;
@@ -330,53 +389,53 @@ void Scheduler::AddScheduledItems(ScheduleEntry* entry, int index) {
 
     // Special case if today is Sunday, handle any Saturday night crossovers
     if (now.tm_wday == 0)
-        entry->pushStartEndTimes(-1, m_timeDelta, m_timeDeltaThreshold);
+        pushStartEndTimes(-1);
 
     if ((entry->dayIndex != INX_ODD_DAY) && (entry->dayIndex != INX_EVEN_DAY)) {
         for (int weekOffset = 0; weekOffset <= scheduleDistance; weekOffset += 7) {
             if (dayIndex & INX_DAY_MASK_SUNDAY)
-                entry->pushStartEndTimes(INX_SUN + weekOffset, m_timeDelta, m_timeDeltaThreshold);
+                pushStartEndTimes(INX_SUN + weekOffset);
 
             if (dayIndex & INX_DAY_MASK_MONDAY)
-                entry->pushStartEndTimes(INX_MON + weekOffset, m_timeDelta, m_timeDeltaThreshold);
+                pushStartEndTimes(INX_MON + weekOffset);
 
             if (dayIndex & INX_DAY_MASK_TUESDAY)
-                entry->pushStartEndTimes(INX_TUE + weekOffset, m_timeDelta, m_timeDeltaThreshold);
+                pushStartEndTimes(INX_TUE + weekOffset);
 
             if (dayIndex & INX_DAY_MASK_WEDNESDAY)
-                entry->pushStartEndTimes(INX_WED + weekOffset, m_timeDelta, m_timeDeltaThreshold);
+                pushStartEndTimes(INX_WED + weekOffset);
 
             if (dayIndex & INX_DAY_MASK_THURSDAY)
-                entry->pushStartEndTimes(INX_THU + weekOffset, m_timeDelta, m_timeDeltaThreshold);
+                pushStartEndTimes(INX_THU + weekOffset);
 
             if (dayIndex & INX_DAY_MASK_FRIDAY)
-                entry->pushStartEndTimes(INX_FRI + weekOffset, m_timeDelta, m_timeDeltaThreshold);
+                pushStartEndTimes(INX_FRI + weekOffset);
 
             if (dayIndex & INX_DAY_MASK_SATURDAY)
-                entry->pushStartEndTimes(INX_SAT + weekOffset, m_timeDelta, m_timeDeltaThreshold);
+                pushStartEndTimes(INX_SAT + weekOffset);
         }
     }
 
-    // loop through entry->startEndTimes and add to m_scheduledItems
+    std::shared_ptr<const Json::Value> args;
+    if (!entry->playlist.empty()) {
+        // Old style schedule entry without a FPP Command
+        Json::Value playlistArgs(Json::arrayValue);
+        playlistArgs.append(entry->playlist);
+        playlistArgs.append(entry->repeat ? "true" : "false");
+        playlistArgs.append("false");
+        args = std::make_shared<const Json::Value>(std::move(playlistArgs));
+    } else {
+        args = std::make_shared<const Json::Value>(entry->args);
+    }
+
+    // loop through entry->startEndTimes, which are all within the entry's
+    // date range, and add to m_scheduledItems
     time_t startTime = 0;
     time_t endTime = 0;
     for (auto& startEnd : entry->startEndTimes) {
         startTime = startEnd.first;
         endTime = startEnd.second;
 
-        // Check to see if this occurrence is within the date range
-        struct tm later;
-        localtime_r(&startTime, &later);
-        int dateInt = 0;
-        dateInt += (later.tm_year + 1900) * 10000;
-        dateInt += (later.tm_mon + 1) * 100;
-        dateInt += (later.tm_mday);
-
-        // Skip if occurrence is outside the date range
-        if (!DateInRange(dateInt, entry->startDate, entry->endDate)) {
-            continue;
-        }
-
         auto& vec = m_scheduledItems[startTime];
         vec.push_back({ .entry = entry,
                         .priority = index, // change this if we add a priority field
@@ -386,15 +445,9 @@ void Scheduler::AddScheduledItems(ScheduleEntry* entry, int index) {
                         .endTime = startTime });
         ScheduledItem& newItem = vec.back();
 
+        newItem.args = args;
         if (!entry->playlist.empty()) {
-            // Old style schedule entry without a FPP Command
-            Json::Value args(Json::arrayValue);
-            args.append(entry->playlist);
-            args.append(entry->repeat ? "true" : "false");
-            args.append("false");
-
             newItem.command = "Start Playlist";
-            newItem.args = std::move(args);
             newItem.endTime = endTime;
 
             // Check to see if this item already ran
@@ -403,9 +456,9 @@ void Scheduler::AddScheduledItems(ScheduleEntry* entry, int index) {
                     if ((newItem.command == item.command) &&
                         (newItem.startTime == item.startTime) &&
                         (newItem.endTime == item.endTime) &&
-                        (newItem.args.size() == item.args.size()) &&
-                        ((!newItem.args.size() && !item.args.size()) ||
-                         (newItem.args[0].asString() == item.args[0].asString()))) {
+                        (newItem.args->size() == item.args->size()) &&
+                        ((!newItem.args->size() && !item.args->size()) ||
+                         ((*newItem.args)[0].asString() == (*item.args)[0].asString()))) {
                         LogDebug(VB_SCHEDULE, "Marking playlist item as already ran:\n");
                         DumpScheduledItem(newItem.startTime, newItem);
                         newItem.ran = true;
@@ -415,7 +468,6 @@ void Scheduler::AddScheduledItems(ScheduleEntry* entry, int index) {
         } else {
             // New style schedule entry with a FPP Command
             newItem.command = entry->command;
-            newItem.args = entry->args;
         }
     }
 }
@@ -425,9 +477,9 @@ void Scheduler::DumpScheduledItem(const std::time_t itemTime, const ScheduledIte
     std::string timeStr = ctime_r(&itemTime, timeBuf);
 
     std::string argStr;
-    for (int i = 0; i < item.args.size(); i++) {
+    for (int i = 0; i < item.args->size(); i++) {
         argStr += "\"";
-        argStr += item.args[i].asString();
+        argStr += (*item.args)[i].asString();
         argStr += "\" ";
     }
 
@@ -486,7 +538,7 @@ void Scheduler::doScheduledCommand(const std::time_t itemTime, const ScheduledIt
     DumpScheduledItem(itemTime, item);
     Json::Value cmd;
     cmd["command"] = item.command;
-    cmd["args"] = item.args;
+    cmd["args"] = *item.args;
     cmd["multisyncCommand"] = item.entry->multisyncCommand;
     cmd["multisyncHosts"] = item.entry->multisyncHosts;
 
@@ -541,6 +593,7 @@ bool Scheduler::doScheduledPlaylist(const std::time_t now, const std::time_t ite
                 LogInfo(VB_SCHEDULE, "Manual playlist '%s' is protected from schedule override, not starting scheduled playlist '%s'\n",
                         Player::INSTANCE.GetPlaylistName().c_str(), item.entry->playlist.c_str());
                 // Track this blocked scheduled item
+                std::unique_lock<std::mutex> lock(m_snapshotLock);
                 m_lastBlockedPlaylist = item.entry->playlist;
                 m_lastBlockedTime = now;
                 return false;
@@ -573,6 +626,7 @@ bool Scheduler::doScheduledPlaylist(const std::time_t now, const std::time_t ite
                     if ((oldItem.command == "Start Playlist") &&
                         (oldItem.entry->playlist == playlistName)) {
                         oldItem.ran = false;
+                        m_snapshotDirty = true;
                         m_forcedNextPlaylist = oldItem.entryIndex;
                     }
                 }
@@ -656,6 +710,9 @@ void Scheduler::CheckScheduledItems(bool restarted) {
             SetItemRan(item, true);
         }
     }
+
+    if (m_snapshotDirty)
+        PublishSnapshot();
 }
 
 void Scheduler::ClearScheduledItems() {
@@ -663,6 +720,8 @@ void Scheduler::ClearScheduledItems() {
 }
 
 void Scheduler::SetItemRan(ScheduledItem& item, bool ran) {
+    if (item.ran != ran)
+        m_snapshotDirty = true;
     item.ran = ran;
 
     auto& vec = m_ranItems[item.startTime];
@@ -670,8 +729,8 @@ void Scheduler::SetItemRan(ScheduledItem& item, bool ran) {
         return item.command == ranItem.command &&
                item.startTime == ranItem.startTime &&
                item.endTime == ranItem.endTime &&
-               item.args.size() == ranItem.args.size() &&
-               (item.args.empty() || item.args[0].asString() == ranItem.args[0].asString());
+               item.args->size() == ranItem.args->size() &&
+               (item.args->empty() || (*item.args)[0].asString() == (*ranItem.args)[0].asString());
     });
     if (it != vec.end()) {
         it->ran = ran;
@@ -740,10 +799,23 @@ void Scheduler::LoadScheduleFromFile(void) {
         m_Schedule.push_back(scheduleEntry);
     }
 
+    UpdateOccurrenceIndex();
+    m_occurrenceIndexHits = 0;
+    m_occurrenceIndexMisses = 0;
+
+    // Entries take their days from the previous index, whatever is left
+    // over is no longer in the schedule
+    OccurrenceIndex previousIndex;
+    std::swap(previousIndex, m_occurrenceIndex);
     for (int i = 0; i < m_Schedule.size(); i++) {
-        AddScheduledItems(&m_Schedule[i], i);
+        AddScheduledItems(&m_Schedule[i], i, previousIndex);
     }
 
+    LogDebug(VB_SCHEDULE, "Expanded %d schedule entries, %d days indexed, %d calculated\n",
+             (int)m_Schedule.size(), m_occurrenceIndexHits, m_occurrenceIndexMisses);
+
+    PublishSnapshot(true);
+
     SchedulePrint();
 
     if (WillLog(LOG_EXCESSIVE, VB_SCHEDULE))
@@ -754,6 +826,102 @@ void Scheduler::LoadScheduleFromFile(void) {
     return;
 }
 
+void Scheduler::UpdateOccurrenceIndex() {
+    // Dates of the day offsets AddScheduledItems() uses, relative to
+    // Sunday of the current week
+    int days = getSettingInt("ScheduleDistance") + 8;
+    time_t currTime = time(NULL);
+    struct tm now;
+    localtime_r(&currTime, &now);
+
+    m_dayDates.resize(days);
+    for (int i = 0; i < days; i++) {
+        struct tm day = now;
+        day.tm_mday = now.tm_mday - now.tm_wday + i - 1;
+        day.tm_hour = 12;
+        day.tm_min = 0;
+        day.tm_sec = 0;
+        day.tm_isdst = -1;
+        mktime(&day);
+        m_dayDates[i] = (day.tm_year + 1900) * 10000 + (day.tm_mon + 1) * 100 + day.tm_mday;
+    }
+
+    std::string location = getSetting("Latitude") + "," + getSetting("Longitude");
+    if (location != m_occurrenceIndexLocation) {
+        m_occurrenceIndex.clear();
+        m_occurrenceIndexLocation = location;
+    }
+
+    // drop days which have rolled out of the window
+    for (auto it = m_occurrenceIndex.begin(); it != m_occurrenceIndex.end(); /* in loop */) {
+        auto& dayTimes = it->second;
+        dayTimes.erase(dayTimes.begin(), dayTimes.lower_bound(m_dayDates[0]));
+        if (dayTimes.empty())
+            it = m_occurrenceIndex.erase(it);
+        else
+            ++it;
+    }
+}
+
+void Scheduler::PublishSnapshot(bool entriesChanged) {
+    std::shared_ptr<ScheduleSnapshot> snapshot = std::make_shared<ScheduleSnapshot>();
+
+    std::shared_ptr<const ScheduleSnapshot> previous = GetSnapshot();
+    if (entriesChanged || !previous) {
+        std::shared_ptr<Json::Value> entries = std::make_shared<Json::Value>(Json::arrayValue);
+        entries->resize(m_Schedule.size());
+        for (int i = 0; i < m_Schedule.size(); i++) {
+            // assigning swaps the temporary in rather than copying it
+            Json::Value& entry = (*entries)[i];
+            entry = m_Schedule[i].GetJson();
+            entry["id"] = i;
+            entry["type"] = m_Schedule[i].playlist.empty() ? "command" : "playlist";
+            entry["dayStr"] = GetDayTextFromDayIndex(m_Schedule[i].dayIndex);
+        }
+        snapshot->entries = entries;
+    } else {
+        snapshot->entries = previous->entries;
+    }
+
+    snapshot->entryInfo.resize(m_Schedule.size());
+    std::vector<bool> haveInfo(m_Schedule.size(), false);
+    for (auto& itemTime : m_scheduledItems) {
+        for (auto& item : itemTime.second) {
+            if (item.ran)
+                continue;
+
+            if (!haveInfo[item.entryIndex]) {
+                ScheduleSnapshot::Entry& info = snapshot->entryInfo[item.entryIndex];
+                info.command = item.command;
+                info.args = *item.args;
+                info.playlist = item.entry->playlist;
+                info.dayIndex = item.entry->dayIndex;
+                info.multisyncCommand = item.entry->multisyncCommand;
+                info.multisyncHosts = item.entry->multisyncHosts;
+                haveInfo[item.entryIndex] = true;
+            }
+
+            snapshot->items.push_back({ .priority = item.priority,
+                                        .entryIndex = item.entryIndex,
+                                        .startTime = item.startTime,
+                                        .endTime = item.endTime });
+            if (snapshot->nextPlaylist < 0 && item.command == "Start Playlist") {
+                snapshot->nextPlaylist = snapshot->items.size() - 1;
+            }
+        }
+    }
+    snapshot->schedulesExtendBeyondDistance = m_schedulesExtendBeyondDistance;
+
+    std::unique_lock<std::mutex> lock(m_snapshotLock);
+    m_snapshot = snapshot;
+    m_snapshotDirty = false;
+}
+
+std::shared_ptr<const ScheduleSnapshot> Scheduler::GetSnapshot() {
+    std::unique_lock<std::mutex> lock(m_snapshotLock);
+    return m_snapshot;
+}
+
 void Scheduler::SchedulePrint(void) {
     int i = 0;
     char stopTypes[4] = "GHL";
@@ -809,13 +977,12 @@ std::string Scheduler::GetNextPlaylistName() {
     if (m_schedulerDisabled)
         return "Scheduler is disabled.";
 
-    std::unique_lock<std::recursive_mutex> lock(m_scheduleLock);
-    ScheduledItem* item = GetNextScheduledPlaylist();
-
+    std::shared_ptr<const ScheduleSnapshot> snapshot = GetSnapshot();
+    const ScheduleSnapshot::Item* item = snapshot ? snapshot->GetNextPlaylist() : nullptr;
     if (!item)
         return "No playlist scheduled.";
 
-    return item->entry->playlist;
+    return snapshot->entryInfo[item->entryIndex].playlist;
 }
 
 std::string Scheduler::GetNextPlaylistStartStr() {
@@ -824,16 +991,14 @@ std::string Scheduler::GetNextPlaylistStartStr() {
 
     std::string timeFmt = getSetting("DateFormat") + " @ " + getSetting("TimeFormat");
     std::string result;
-    std::unique_lock<std::recursive_mutex> lock(m_scheduleLock);
-    ScheduledItem* item = GetNextScheduledPlaylist();
+    std::shared_ptr<const ScheduleSnapshot> snapshot = GetSnapshot();
+    const ScheduleSnapshot::Item* item = snapshot ? snapshot->GetNextPlaylist() : nullptr;
 
     if (!item)
         return result;
 
     char timeStr[32];
-    std::time_t timeT = 0;
     struct tm timeStruct;
-    time_t currTime = time(NULL);
 
     localtime_r(&item->startTime, &timeStruct);
     strftime(timeStr, 32, timeFmt.c_str(), &timeStruct);
@@ -841,7 +1006,7 @@ std::string Scheduler::GetNextPlaylistStartStr() {
     // Thursday @ 11:00:00 - (Everyday)
     result = timeStr;
     result += " - (";
-    result += GetDayTextFromDayIndex(item->entry->dayIndex);
+    result += GetDayTextFromDayIndex(snapshot->entryInfo[item->entryIndex].dayIndex);
     result += ")";
 
     return result;
@@ -903,9 +1068,9 @@ Json::Value Scheduler::GetInfo(void) {
     Json::Value result;
 
     std::string timeFmt = getSetting("DateFormat") + " @ " + getSetting("TimeFormat");
-    std::unique_lock<std::recursive_mutex> lock(m_scheduleLock);
+    std::shared_ptr<const ScheduleSnapshot> snapshot = GetSnapshot();
     Json::Value np;
-    ScheduledItem* nextItem = GetNextScheduledPlaylist();
+    const ScheduleSnapshot::Item* nextItem = snapshot ? snapshot->GetNextPlaylist() : nullptr;
     np["playlistName"] = GetNextPlaylistName();
     np["scheduledStartTime"] = nextItem ? (Json::UInt64)(nextItem->startTime) : 0;
     np["scheduledStartTimeStr"] = GetNextPlaylistStartStr();
@@ -972,6 +1137,7 @@ Json::Value Scheduler::GetInfo(void) {
     }
 
     // Add blocked schedule information
+    std::unique_lock<std::mutex> lock(m_snapshotLock);
     if (m_lastBlockedTime > 0) {
         time_t now = time(NULL);
         // Only report if blocked within last 5 minutes
@@ -987,24 +1153,15 @@ Json::Value Scheduler::GetInfo(void) {
 Json::Value Scheduler::GetSchedule() {
     std::string timeFmt = getSetting("DateFormat") + " @ " + getSetting("TimeFormat");
     Json::Value result;
-    Json::Value entries(Json::arrayValue);
-    Json::Value entry;
     Json::Value items(Json::arrayValue);
     Json::Value scheduledItem;
     std::time_t now = time(nullptr);
-    std::unique_lock<std::recursive_mutex> lock(m_scheduleLock);
+    std::shared_ptr<const ScheduleSnapshot> snapshot = GetSnapshot();
+    if (!snapshot)
+        snapshot = std::make_shared<ScheduleSnapshot>();
 
     result["enabled"] = m_schedulerDisabled ? 0 : 1;
-
-    for (int i = 0; i < m_Schedule.size(); i++) {
-        entry = m_Schedule[i].GetJson();
-        entry["id"] = i;
-        entry["type"] = m_Schedule[i].playlist.empty() ? "command" : "playlist";
-        entry["dayStr"] = GetDayTextFromDayIndex(m_Schedule[i].dayIndex);
-
-        entries.append(entry);
-    }
-    result["entries"] = entries;
+    result["entries"] = snapshot->entries ? *snapshot->entries : Json::Value(Json::arrayValue);
 
     struct tm timeStruct;
     char timeStr[32];
@@ -1050,43 +1207,39 @@ Json::Value Scheduler::GetSchedule() {
         items.append(scheduledItem);
     }
 
-    for (auto& itemTime : m_scheduledItems) {
-        for (auto& item : itemTime.second) {
-            if (item.ran)
-                continue;
-
-            scheduledItem["priority"] = item.priority;
-            scheduledItem["id"] = item.entryIndex;
+    for (auto& item : snapshot->items) {
+        const ScheduleSnapshot::Entry& info = snapshot->entryInfo[item.entryIndex];
+        scheduledItem["priority"] = item.priority;
+        scheduledItem["id"] = item.entryIndex;
 
-            localtime_r(&item.startTime, &timeStruct);
-            strftime(timeStr, 32, timeFmt.c_str(), &timeStruct);
-            scheduledItem["startTimeStr"] = timeStr;
-            scheduledItem["startTime"] = (Json::UInt64)item.startTime;
+        localtime_r(&item.startTime, &timeStruct);
+        strftime(timeStr, 32, timeFmt.c_str(), &timeStruct);
+        scheduledItem["startTimeStr"] = timeStr;
+        scheduledItem["startTime"] = (Json::UInt64)item.startTime;
 
-            strftime(timeStr, 32, "%Y%m%d", &timeStruct);
-            scheduledItem["startDateStr"] = timeStr;
-            scheduledItem["startDateInt"] = atoi(timeStr);
+        strftime(timeStr, 32, "%Y%m%d", &timeStruct);
+        scheduledItem["startDateStr"] = timeStr;
+        scheduledItem["startDateInt"] = atoi(timeStr);
 
-            localtime_r(&item.endTime, &timeStruct);
-            strftime(timeStr, 32, timeFmt.c_str(), &timeStruct);
-            scheduledItem["endTimeStr"] = timeStr;
-            scheduledItem["endTime"] = (Json::UInt64)item.endTime;
+        localtime_r(&item.endTime, &timeStruct);
+        strftime(timeStr, 32, timeFmt.c_str(), &timeStruct);
+        scheduledItem["endTimeStr"] = timeStr;
+        scheduledItem["endTime"] = (Json::UInt64)item.endTime;
 
-            strftime(timeStr, 32, "%Y%m%d", &timeStruct);
-            scheduledItem["endDateStr"] = timeStr;
-            scheduledItem["endDateInt"] = atoi(timeStr);
+        strftime(timeStr, 32, "%Y%m%d", &timeStruct);
+        scheduledItem["endDateStr"] = timeStr;
+        scheduledItem["endDateInt"] = atoi(timeStr);
 
-            scheduledItem["command"] = item.command;
+        scheduledItem["command"] = info.command;
 
-            scheduledItem["args"] = item.args;
-            scheduledItem["multisyncCommand"] = item.entry->multisyncCommand;
-            scheduledItem["multisyncHosts"] = item.entry->multisyncHosts;
+        scheduledItem["args"] = info.args;
+        scheduledItem["multisyncCommand"] = info.multisyncCommand;
+        scheduledItem["multisyncHosts"] = info.multisyncHosts;
 
-            items.append(scheduledItem);
-        }
+        items.append(scheduledItem);
     }
     result["items"] = items;
-    result["schedulesExtendBeyondDistance"] = m_schedulesExtendBeyondDistance;
+    result["schedulesExtendBeyondDistance"] = snapshot->schedulesExtendBeyondDistance;
     result["scheduleDistance"] = getSettingInt("ScheduleDistance");
 
     return result;
@@ -13,6 +13,7 @@
 
 #include <map>
 #include "fpp-json.h"
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -67,7 +68,42 @@ public:
     time_t const startTime;
     time_t endTime;
     std::string command;
-    Json::Value args;
+    std::shared_ptr<const Json::Value> args; // shared by the items of an entry
+};
+
+// Read only copy of the schedule for the API, rebuilt whenever the
+// schedule is reloaded or an item runs so GetInfo()/GetSchedule() don't
+// have to wait on m_scheduleLock while a large schedule is expanded.
+class ScheduleSnapshot {
+public:
+    // command and args are the same for every item of an entry
+    class Entry {
+    public:
+        std::string command;
+        Json::Value args;
+        std::string playlist;
+        int dayIndex = 0;
+        bool multisyncCommand = false;
+        std::string multisyncHosts;
+    };
+    class Item {
+    public:
+        int priority;
+        int entryIndex;
+        time_t startTime;
+        time_t endTime;
+    };
+
+    // GetJson() of each ScheduleEntry, shared with the previous snapshot
+    // when only the run state of items changed
+    std::shared_ptr<const Json::Value> entries;
+    std::vector<Entry> entryInfo; // by entryIndex
+    std::vector<Item> items;      // items which haven't run yet, in start order
+    bool schedulesExtendBeyondDistance = false;
+
+    int nextPlaylist = -1; // index in items
+
+    const Item* GetNextPlaylist() const { return nextPlaylist < 0 ? nullptr : &items[nextPlaylist]; }
 };
 
 class Scheduler {
@@ -89,7 +125,13 @@ public:
     Json::Value GetSchedule(void);
 
 private:
-    void AddScheduledItems(ScheduleEntry* entry, int index);
+    class DayOccurrences;
+    typedef std::map<std::string, std::map<int, DayOccurrences>> OccurrenceIndex;
+
+    void AddScheduledItems(ScheduleEntry* entry, int index, OccurrenceIndex& previousIndex);
+    void UpdateOccurrenceIndex();
+    void PublishSnapshot(bool entriesChanged = false);
+    std::shared_ptr<const ScheduleSnapshot> GetSnapshot();
     void DumpScheduledItem(const std::time_t itemTime, const ScheduledItem& item);
     void DumpScheduledItems();
     void CheckScheduledItems(bool restarted = false);
@@ -121,6 +163,29 @@ private:
     std::map<std::time_t, std::vector<ScheduledItem>> m_oldItems;
     std::map<std::time_t, std::vector<ScheduledItem>> m_ranItems;
 
+    // Occurrences of each day in the ScheduleDistance window by
+    // ScheduleEntry::GetOccurrenceKey() and YYYYMMDD date, kept across
+    // reloads.  Only days rolling into the window and new or edited entries
+    // need their times (including any SunRise/SunSet math), date range and
+    // repeats calculated.  Days rolling out of the window are dropped, as
+    // are entries which are no longer in the schedule.
+    class DayOccurrences {
+    public:
+        time_t startTime; // before the date range and repeats are applied
+        time_t endTime;
+        std::vector<std::pair<time_t, time_t>> times;
+    };
+    OccurrenceIndex m_occurrenceIndex;
+    std::vector<int> m_dayDates; // date of each day offset for this load, from -1
+    std::string m_occurrenceIndexLocation;
+    int m_occurrenceIndexHits = 0;
+    int m_occurrenceIndexMisses = 0;
+
+    // also protects m_lastBlockedPlaylist/m_lastBlockedTime
+    std::mutex m_snapshotLock;
+    std::shared_ptr<const ScheduleSnapshot> m_snapshot;
+    bool m_snapshotDirty = false;
+
     int m_forcedNextPlaylist;
 
     std::string m_lastBlockedPlaylist;
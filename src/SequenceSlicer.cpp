@@ -0,0 +1,293 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+#include "fpp-pch.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "MultiSync.h"
+#include "SequenceSlicer.h"
+#include "common.h"
+#include "log.h"
+#include "settings.h"
+#include "fseq/FSEQFile.h"
+
+SequenceSlicer SequenceSlicer::INSTANCE;
+
+// a failed build is retried after 30s, doubling with each failure up to an
+// hour
+static constexpr int FAILED_RETRY_SECONDS = 30;
+static constexpr int FAILED_RETRY_MAX_SECONDS = 3600;
+
+static std::string SliceDir() {
+    return FPP_DIR_MEDIA("/cache/slices");
+}
+
+// FNV-1a so the cache file names are stable across builds
+static uint32_t HashString(const std::string& s) {
+    uint32_t h = 2166136261U;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 16777619U;
+    }
+    return h;
+}
+
+SequenceSlicer::RangeList SequenceSlicer::ParseRanges(const std::string& ranges) {
+    RangeList result;
+    for (auto& r : split(ranges, ',')) {
+        if (r.empty()) {
+            continue;
+        }
+        uint32_t first = 0;
+        uint32_t last = 0;
+        size_t dash = r.find('-');
+        first = std::strtoul(r.c_str(), nullptr, 10);
+        if (dash == std::string::npos) {
+            last = first;
+        } else {
+            last = std::strtoul(r.c_str() + dash + 1, nullptr, 10);
+        }
+        if (last < first) {
+            continue;
+        }
+        result.push_back(std::pair<uint32_t, uint32_t>(first, last - first + 1));
+    }
+    return NormalizeRanges(result);
+}
+
+SequenceSlicer::RangeList SequenceSlicer::NormalizeRanges(const RangeList& ranges) {
+    RangeList sorted;
+    for (auto& r : ranges) {
+        if (r.second) {
+            sorted.push_back(r);
+        }
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    RangeList result;
+    for (auto& r : sorted) {
+        if (!result.empty() && r.first <= (result.back().first + result.back().second)) {
+            uint32_t end = std::max(result.back().first + result.back().second, r.first + r.second);
+            result.back().second = end - result.back().first;
+        } else {
+            result.push_back(r);
+        }
+    }
+    return result;
+}
+
+bool SequenceSlicer::GetRemoteRanges(const std::string& remote, RangeList& ranges) {
+    for (auto& sys : MultiSync::INSTANCE.GetRemoteSystems()) {
+        if ((sys.address == remote) || (sys.hostname == remote)) {
+            ranges = ParseRanges(sys.ranges);
+            return !ranges.empty();
+        }
+    }
+    return false;
+}
+
+SequenceSlicer::~SequenceSlicer() {
+    m_running = false;
+    m_signal.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+SequenceSlicer::SliceState SequenceSlicer::GetSlice(const std::string& sequence, const RangeList& requested, std::string& path) {
+    if (sequence.empty() || (sequence.find('/') != std::string::npos)) {
+        LogErr(VB_SEQUENCE, "Invalid sequence name for slice: '%s'\n", sequence.c_str());
+        return SliceState::Failed;
+    }
+
+    std::string srcFile = FPP_DIR_SEQUENCE("/" + sequence);
+    FSEQFile* src = FSEQFile::openFSEQFile(srcFile);
+    if (!src) {
+        LogErr(VB_SEQUENCE, "Could not open %s to create slice\n", srcFile.c_str());
+        return SliceState::Failed;
+    }
+
+    // clamp to the channels actually in the sequence
+    uint32_t channelCount = src->getChannelCount();
+    RangeList ranges;
+    for (auto& r : NormalizeRanges(requested)) {
+        if (r.first >= channelCount) {
+            continue;
+        }
+        ranges.push_back(std::pair<uint32_t, uint32_t>(r.first, std::min(r.second, channelCount - r.first)));
+    }
+    if (ranges.empty()) {
+        LogWarn(VB_SEQUENCE, "No requested channel ranges are within %s\n", sequence.c_str());
+        delete src;
+        return SliceState::Failed;
+    }
+
+    std::string signature;
+    for (auto& r : ranges) {
+        if (!signature.empty()) {
+            signature += ",";
+        }
+        signature += std::to_string(r.first) + "+" + std::to_string(r.second);
+    }
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%016llX", (unsigned long long)src->getUniqueId());
+    std::string uid = buf;
+    snprintf(buf, sizeof(buf), "%08X", HashString(signature));
+    std::string base = sequence;
+    if (endsWith(base, ".fseq")) {
+        base = base.substr(0, base.length() - 5);
+    }
+    std::string dstFile = SliceDir() + "/" + base + "." + uid + "." + buf + ".fseq";
+    delete src;
+
+    // The slice only ever appears under its final name once it is complete
+    if (FileExists(dstFile)) {
+        LogDebug(VB_SEQUENCE, "Using cached slice %s (%s)\n", dstFile.c_str(), signature.c_str());
+        path = dstFile;
+        return SliceState::Ready;
+    }
+
+    std::unique_lock<std::mutex> lock(m_lock);
+    auto failed = m_failed.find(dstFile);
+    if ((failed != m_failed.end()) && (std::chrono::steady_clock::now() < failed->second.retryAt)) {
+        LogDebug(VB_SEQUENCE, "Slice %s failed to build %d times, not retrying yet\n", dstFile.c_str(), failed->second.failures);
+        return SliceState::Failed;
+    }
+    if (m_building.insert(dstFile).second) {
+        LogDebug(VB_SEQUENCE, "Queueing slice %s (%s)\n", dstFile.c_str(), signature.c_str());
+        m_queue.push_back({ base, uid, srcFile, dstFile, ranges });
+        if (!m_thread.joinable()) {
+            m_thread = std::thread(&SequenceSlicer::BuildThread, this);
+        }
+        m_signal.notify_one();
+    }
+    return SliceState::Building;
+}
+
+void SequenceSlicer::BuildThread() {
+    SetThreadName("FPP-SeqSlicer");
+    std::unique_lock<std::mutex> lock(m_lock);
+    while (m_running) {
+        if (m_queue.empty()) {
+            m_signal.wait(lock);
+            continue;
+        }
+        PendingSlice slice = m_queue.front();
+        m_queue.pop_front();
+        lock.unlock();
+
+        if (!DirectoryExists(SliceDir())) {
+            mkdir(SliceDir().c_str(), 0775);
+        }
+        RemoveStaleSlices(slice.base, slice.uid);
+        bool built = BuildSlice(slice.srcFile, slice.dstFile, slice.ranges);
+
+        lock.lock();
+        m_building.erase(slice.dstFile);
+        if (built) {
+            m_failed.erase(slice.dstFile);
+        } else if (m_running) {
+            FailedSlice& f = m_failed[slice.dstFile];
+            int delay = FAILED_RETRY_MAX_SECONDS;
+            if (f.failures < 7) {
+                delay = std::min(FAILED_RETRY_SECONDS << f.failures, FAILED_RETRY_MAX_SECONDS);
+            }
+            f.failures++;
+            f.retryAt = std::chrono::steady_clock::now() + std::chrono::seconds(delay);
+            LogWarn(VB_SEQUENCE, "Could not build slice %s, retrying in %ds\n", slice.dstFile.c_str(), delay);
+        }
+    }
+}
+
+bool SequenceSlicer::BuildSlice(const std::string& srcFile, const std::string& dstFile, const RangeList& ranges) {
+    FSEQFile* src = FSEQFile::openFSEQFile(srcFile);
+    if (!src) {
+        return false;
+    }
+
+    // write to a temporary name so a partial slice is never served
+    std::string tmpFile = dstFile + ".tmp";
+    V2FSEQFile* dest = (V2FSEQFile*)FSEQFile::createFSEQFile(tmpFile, 2, V2FSEQFile::CompressionType::zstd, -99);
+    if (!dest) {
+        LogErr(VB_SEQUENCE, "Could not create slice %s\n", tmpFile.c_str());
+        delete src;
+        return false;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    dest->m_sparseRanges = ranges;
+    src->prepareRead(ranges);
+    dest->initializeFromFSEQ(*src);
+    dest->writeHeader();
+
+    uint32_t maxChannel = 0;
+    for (auto& r : ranges) {
+        maxChannel = std::max(maxChannel, r.first + r.second);
+    }
+    std::vector<uint8_t> data(std::max(maxChannel, src->getChannelCount()));
+    for (uint32_t x = 0; x < src->getNumFrames() && m_running; x++) {
+        FSEQFile::FrameData* fdata = src->getFrame(x);
+        if (fdata) {
+            fdata->readFrame(&data[0], data.size());
+            delete fdata;
+        }
+        dest->addFrame(x, &data[0]);
+    }
+    dest->finalize();
+    uint32_t sliceChannels = dest->getChannelCount();
+    delete dest;
+    delete src;
+
+    if (!m_running) {
+        // shutting down part way through
+        unlink(tmpFile.c_str());
+        return false;
+    }
+    if (rename(tmpFile.c_str(), dstFile.c_str())) {
+        LogErr(VB_SEQUENCE, "Could not rename %s to %s: %s\n", tmpFile.c_str(), dstFile.c_str(), strerror(errno));
+        unlink(tmpFile.c_str());
+        return false;
+    }
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    LogInfo(VB_SEQUENCE, "Created slice %s with %u channels in %.2fs\n", dstFile.c_str(), sliceChannels, secs);
+    return true;
+}
+
+// Remove slices built from an older render of the same sequence
+void SequenceSlicer::RemoveStaleSlices(const std::string& sequence, const std::string& currentId) {
+    DIR* dir = opendir(SliceDir().c_str());
+    if (!dir) {
+        return;
+    }
+    std::string prefix = sequence + ".";
+    struct dirent* ep;
+    while ((ep = readdir(dir))) {
+        std::string name = ep->d_name;
+        if (!startsWith(name, prefix) || !endsWith(name, ".fseq")) {
+            continue;
+        }
+        // <sequence>.<uniqueId>.<rangeHash>.fseq
+        std::string rest = name.substr(prefix.length());
+        std::vector<std::string> parts = split(rest, '.');
+        if ((parts.size() != 3) || (parts[0] == currentId)) {
+            continue;
+        }
+        std::string path = SliceDir() + "/" + name;
+        LogDebug(VB_SEQUENCE, "Removing stale slice %s\n", path.c_str());
+        unlink(path.c_str());
+    }
+    closedir(dir);
+}
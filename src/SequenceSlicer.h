@@ -0,0 +1,103 @@
+#pragma once
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+ * Builds sparse V2 copies of a sequence that only contain the channel
+ * ranges a MultiSync remote actually outputs so remotes don't need to
+ * download and read the full master fseq.  Slices are cached in
+ * media/cache/slices keyed by the sequence's unique id and a signature of
+ * the ranges so a slice is rebuilt automatically when the sequence is
+ * re-rendered.
+ *
+ * Slices are built one at a time on a background thread so a request for a
+ * new slice never ties up an HTTP thread for the length of a full decode
+ * and re-encode of the sequence.
+ *
+ * Ranges are (startChannel, channelCount) pairs with 0 based start
+ * channels, the same as FSEQFile::prepareRead() and V2FSEQFile::m_sparseRanges.
+ */
+class SequenceSlicer {
+public:
+    typedef std::vector<std::pair<uint32_t, uint32_t>> RangeList;
+
+    enum class SliceState {
+        Ready,
+        Building,
+        Failed
+    };
+
+    static SequenceSlicer INSTANCE;
+    ~SequenceSlicer();
+
+    // Parse a "first-last,first-last" string (0 based, inclusive) as
+    // reported by remotes in MultiSync pings
+    static RangeList ParseRanges(const std::string& ranges);
+
+    // Sort and merge overlapping/adjacent ranges
+    static RangeList NormalizeRanges(const RangeList& ranges);
+
+    // Look up the channel ranges a remote reported via MultiSync.  remote
+    // can be the remote's address or hostname.
+    bool GetRemoteRanges(const std::string& remote, RangeList& ranges);
+
+    // Look up the slice of sequence (a file name in the sequences
+    // directory) containing only the given ranges.  If it is cached, path
+    // is set and Ready is returned.  Otherwise the slice is queued to be
+    // built and Building is returned so the caller can ask again later.
+    // Failed means the sequence can't be sliced with these ranges or the
+    // last build of this slice failed and is backing off before a retry.
+    SliceState GetSlice(const std::string& sequence, const RangeList& ranges, std::string& path);
+
+private:
+    struct PendingSlice {
+        std::string base;
+        std::string uid;
+        std::string srcFile;
+        std::string dstFile;
+        RangeList ranges;
+    };
+
+    void BuildThread();
+    bool BuildSlice(const std::string& srcFile, const std::string& dstFile, const RangeList& ranges);
+    void RemoveStaleSlices(const std::string& sequence, const std::string& currentId);
+
+    struct FailedSlice {
+        int failures = 0;
+        std::chrono::steady_clock::time_point retryAt;
+    };
+
+    // guards the queue, building set and failures only, never held during
+    // a build
+    std::mutex m_lock;
+    std::condition_variable m_signal;
+    std::list<PendingSlice> m_queue;
+    std::set<std::string> m_building;
+    // dstFile of slices whose last build failed.  The file name includes the
+    // sequence's unique id so a re-render starts over.
+    std::map<std::string, FailedSlice> m_failed;
+    std::thread m_thread;
+    std::atomic<bool> m_running = true;
+};
@@ -32,7 +32,7 @@
 #include "log.h"
 #include "settings.h"
 
-#include "overlays/wled/wled.h"   // AudioFrame, fetchAudioSamples, computeAudioFrame
+#include "overlays/wled/wled.h"   // AudioFrame, getAudioFrame
 
 WLEDAudioSync WLEDAudioSync::INSTANCE;
 
@@ -288,12 +288,12 @@ void WLEDAudioSync::SendLoop() {
         return;
     }
 
-    std::array<float, NUM_SAMPLES> samples;
     AudioFrame frame{};
 
     while (m_running) {
-        int sampleRate = 0;
-        if (!fetchAudioSamples(samples, sampleRate)) {
+        // The frame comes from the shared WLED audio analysis thread, the
+        // same one the local reactive effects read.
+        if (!getAudioFrame(frame)) {
             // No audio source producing right now (nothing playing,
             // mic unconfigured, etc.). Wait a bit and re-check rather
             // than spinning.
@@ -301,8 +301,6 @@ void WLEDAudioSync::SendLoop() {
             continue;
         }
 
-        computeAudioFrame(samples, sampleRate, frame);
-
         AudioSyncPacketV2 pkt{};
         std::memcpy(pkt.header, WLED_HEADER_V2, 5);  // header[6] keeps the trailing NUL
         pkt.sampleRaw     = static_cast<float>(frame.volumeRaw);
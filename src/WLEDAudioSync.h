@@ -23,13 +23,12 @@
 // other WLED nodes on the network using the standard WLED audiosync
 // UDP protocol (port 11988, "00002" V2 packet format, 44 bytes).
 //
-// FPP already computes its own FFT (via kiss_fftr) from currently-
-// playing media or a configured audio capture device — see
-// WS2812FXExt::processSamples in src/overlays/wled/wled.cpp. This
-// singleton:
+// FPP already computes its own FFT from currently-playing media or a
+// configured audio capture device on the WLED audio analysis thread —
+// see getAudioFrame in src/overlays/wled/wled.cpp. This singleton:
 //
 //   - Send mode:    rate-limits and broadcasts the FFT data computed
-//                   in processSamples so external WLED reactive
+//                   by that thread so external WLED reactive
 //                   devices can sync to whatever FPP is playing.
 //
 //   - Receive mode: listens for incoming audiosync packets, caches
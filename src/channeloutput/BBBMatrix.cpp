@@ -24,6 +24,7 @@
 #include "../common.h"
 #include "../log.h"
 
+#include "PanelBitPlanes.h"
 #include "PanelInterleaveHandler.h"
 #include "overlays/PixelOverlay.h"
 #include "util/BBBUtils.h"
@@ -754,6 +755,8 @@ int BBBMatrix::Init(Json::Value config) {
         m_numFrames++;
     }
     m_curFrame = 0;
+    BuildBitPlaneMap();
+
     if (PixelOverlayManager::INSTANCE.isAutoCreatePixelOverlayModels()) {
         std::string dd = "LED Panels";
         if (config.isMember("LEDPanelMatrixName") && !config["LEDPanelMatrixName"].asString().empty()) {
@@ -853,7 +856,7 @@ void BBBMatrix::OverlayTestData(unsigned char* channelData, int cycleNum, float
 }
 
 void BBBMatrix::PrepData(unsigned char* channelData) {
-    m_matrix->OverlaySubMatrices(channelData);
+    m_bitPlanes.UpdateSubMatrices(m_matrix, channelData);
 
     if (m_printStats) {
         fcount++;
@@ -864,103 +867,35 @@ void BBBMatrix::PrepData(unsigned char* channelData) {
         }
     }
 
-    channelData += m_startChannel;
-
-    // number of uint32_t per row for each bit
-    size_t rowLen = m_panelWidth * m_longestChain * m_panelHeight / (m_panelScan * 2) * 4; // 4 GPIO's
-    // number of uint32_t per full row (all bits)
-    size_t fullRowLen = rowLen * m_colorDepth;
-
-    uint32_t* gpioFrame = m_gpioFrame;
-    /*
-    if (m_numFrames >= 4) {
-       gpioFrame = (uint32_t*)m_frames[m_curFrame];
+    m_bitPlanes.Prep(channelData, m_gpioFrame);
+    if (m_numFrames >= 3) {
+        memcpy(m_frames[m_curFrame], m_gpioFrame, m_fullFrameLen);
     }
-    */
-
-    // long long startTime = GetTime();
-    memset(gpioFrame, 0, m_fullFrameLen);
-    // long long memsetTime = GetTime();
+}
 
+/*
+ * Hand the pin assignments to PanelBitPlanes so it can fold the interleave
+ * handler, chain position, pixelMap and pins into flat tables
+ */
+void BBBMatrix::BuildBitPlaneMap() {
+    std::vector<PanelBitPlanes::OutputPins> pins(m_outputs);
     for (int output = 0; output < m_outputs; output++) {
-        int panelsOnOutput = m_panelMatrix->m_outputPanels[output].size();
-        const GPIOPinInfo::Pins& pinInfo0 = m_pinInfo[output].row[0];
-        const GPIOPinInfo::Pins& pinInfo1 = m_pinInfo[output].row[1];
-
-        for (int i = 0; i < panelsOnOutput; i++) {
-            int panel = m_panelMatrix->m_outputPanels[output][i];
-            int chain = m_panelMatrix->m_panels[panel].chain;
-
-            for (int y = 0; y < (m_panelHeight / 2); y++) {
-                int yw1 = y * m_panelWidth * 3;
-                int yw2 = (y + (m_panelHeight / 2)) * m_panelWidth * 3;
-
-                int yOut = y;
-                int xo2 = 0;
-                m_handler->map(xo2, yOut);
-
-                int offset = yOut * fullRowLen + (m_longestChain - chain - 1) * 4 * m_panelWidth * m_panelHeight / m_panelScan / 2;
-                if (!m_outputByRow) {
-                    offset = yOut * rowLen + (m_longestChain - chain - 1) * 4 * m_panelWidth * m_panelHeight / m_panelScan / 2;
-                }
-
-                for (int x = 0; x < m_panelWidth; ++x) {
-                    uint16_t r1 = gammaCurve[channelData[m_panelMatrix->m_panels[panel].pixelMap[yw1 + x * 3]]];
-                    uint16_t g1 = gammaCurve[channelData[m_panelMatrix->m_panels[panel].pixelMap[yw1 + x * 3 + 1]]];
-                    uint16_t b1 = gammaCurve[channelData[m_panelMatrix->m_panels[panel].pixelMap[yw1 + x * 3 + 2]]];
-
-                    uint16_t r2 = gammaCurve[channelData[m_panelMatrix->m_panels[panel].pixelMap[yw2 + x * 3]]];
-                    uint16_t g2 = gammaCurve[channelData[m_panelMatrix->m_panels[panel].pixelMap[yw2 + x * 3 + 1]]];
-                    uint16_t b2 = gammaCurve[channelData[m_panelMatrix->m_panels[panel].pixelMap[yw2 + x * 3 + 2]]];
-
-                    int xOut = x;
-                    int yo2 = y;
-                    m_handler->map(xOut, yo2);
-
-                    int xOff = xOut * 4;
-
-                    for (auto bit : m_bitOrder) {
-                        uint16_t mask = 1 << bit;
-                        if (r1 & mask) {
-                            gpioFrame[offset + xOff + pinInfo0.r_gpio] |= pinInfo0.r_pin;
-                        }
-                        if (g1 & mask) {
-                            gpioFrame[offset + xOff + pinInfo0.g_gpio] |= pinInfo0.g_pin;
-                        }
-                        if (b1 & mask) {
-                            gpioFrame[offset + xOff + pinInfo0.b_gpio] |= pinInfo0.b_pin;
-                        }
-                        if (r2 & mask) {
-                            gpioFrame[offset + xOff + pinInfo1.r_gpio] |= pinInfo1.r_pin;
-                        }
-                        if (g2 & mask) {
-                            gpioFrame[offset + xOff + pinInfo1.g_gpio] |= pinInfo1.g_pin;
-                        }
-                        if (b2 & mask) {
-                            gpioFrame[offset + xOff + pinInfo1.b_gpio] |= pinInfo1.b_pin;
-                        }
-                        if (m_outputByRow) {
-                            xOff += rowLen;
-                        } else {
-                            xOff += rowLen * m_panelScan;
-                        }
-                    }
-                }
-            }
+        for (int row = 0; row < 2; row++) {
+            const GPIOPinInfo::Pins& p = m_pinInfo[output].row[row];
+            PanelBitPlanes::OutputPins& o = pins[output];
+            o.pin[row * 3] = p.r_pin;
+            o.pin[row * 3 + 1] = p.g_pin;
+            o.pin[row * 3 + 2] = p.b_pin;
+            o.bank[row * 3] = p.r_gpio;
+            o.bank[row * 3 + 1] = p.g_gpio;
+            o.bank[row * 3 + 2] = p.b_gpio;
         }
     }
-
-    // long long dataTime = GetTime();
-    if ((m_numFrames >= 3) && (m_frames[m_curFrame] != (uint8_t*)gpioFrame)) {
-        memcpy(m_frames[m_curFrame], m_gpioFrame, m_fullFrameLen);
-    }
-    /*
-    long long endTime = GetTime();
-    if ((endTime - startTime) > 5000) {
-        printf("%d:   Memset: %d     Data: %d    cpy: %d   Total: %d\n", m_curFrame, (int)(memsetTime- startTime), (int)(dataTime - memsetTime), (int)(endTime -dataTime), (int)(endTime -startTime));
-    }
-    */
+    m_bitPlanes.Build(m_panelMatrix, m_handler, m_startChannel, m_outputs, m_longestChain,
+                      m_panelWidth, m_panelHeight, m_panelScan, m_outputByRow, m_colorDepth,
+                      m_bitOrder, gammaCurve, pins, m_fullFrameLen / 4);
 }
+
 int BBBMatrix::SendData(unsigned char* channelData) {
     LogExcess(VB_CHANNELOUT, "BBBMatrix::SendData(%p)\n", channelData);
 
@@ -969,8 +904,8 @@ int BBBMatrix::SendData(unsigned char* channelData) {
     addr += (m_frames[m_curFrame] - m_frames[0]);
     uint8_t* ptr = m_frames[m_curFrame];
     if (m_numFrames < 3) {
-        // if we have less than 3 blocks, we cannot copy
-        // in prep  or we'd get potential tearing/flickering
+        // if we have less than 3 blocks, we cannot build the frame
+        // in prep or we'd get potential tearing/flickering
         memcpy(ptr, m_gpioFrame, m_fullFrameLen);
     }
     // long long cpyTime = GetTime();
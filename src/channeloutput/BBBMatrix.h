@@ -19,6 +19,7 @@
 #include "util/BBBPruUtils.h"
 
 #include "ChannelOutput.h"
+#include "PanelBitPlanes.h"
 
 // 16 rows (1/16 scan) * 8bits per row
 #define MAX_STATS 16 * 8
@@ -68,6 +69,7 @@ private:
     bool configureControlPin(const std::string& ctype, Json::Value& root, std::ofstream& outputFile, int pru, int& controlGPIO);
     void configurePanelPins(int x, Json::Value& root, std::ofstream& outputFile, int* minPort);
     void configurePanelPin(int x, const std::string& color, int row, Json::Value& root, std::ofstream& outputFile, int* minPort);
+    void BuildBitPlaneMap();
 
     BBBPru* m_pru;
     BBBPru* m_pruCopy;
@@ -128,4 +130,8 @@ private:
     int m_curFrame;
     int m_numFrames;
     int m_fullFrameLen;
+
+    // Precomputed by BuildBitPlaneMap() so PrepData doesn't need to do any
+    // interleave/chain/pixelMap lookups
+    PanelBitPlanes m_bitPlanes;
 };
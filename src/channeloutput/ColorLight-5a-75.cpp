@@ -163,6 +163,7 @@
 #ifndef PLATFORM_OSX
 #include <linux/if_packet.h>
 #include <netinet/ether.h>
+#include <sys/mman.h>
 #else
 #include <net/bpf.h>
 #endif
@@ -252,7 +253,15 @@ ColorLight5a75Output::ColorLight5a75Output(unsigned int startChannel, unsigned i
     m_invertedData(0),
     m_slowCount(0),
     m_flippedLayout(0),
-    m_highestFirmwareVersion(0) {
+    m_highestFirmwareVersion(0),
+    m_useTXRing(false),
+    m_txRing(nullptr),
+    m_txRingSize(0),
+    m_txRingFrameSize(0),
+    m_txRingFrameCount(0),
+    m_txRingHead(0),
+    m_packetsPerRow(0),
+    m_firstPixelPacket(0) {
     LogDebug(VB_CHANNELOUT, "ColorLight5a75Output::ColorLight5a75Output(%u, %u)\n",
              startChannel, channelCount);
 }
@@ -281,6 +290,8 @@ ColorLight5a75Output::~ColorLight5a75Output() {
             i++; // Every second iovec is either part of the header malloc() or external data
     }
 
+    CloseTXRing();
+
     if (m_fd >= 0)
         close(m_fd);
 }
@@ -436,6 +447,14 @@ int ColorLight5a75Output::Init(Json::Value config) {
     if (config.isMember("firmwareVersion")) {
         m_highestFirmwareVersion = config["firmwareVersion"].asInt();
     }
+    m_useTXRing = getSettingInt("ColorlightTXRing") == 1;
+    if (config.isMember("txRing")) {
+        m_useTXRing = config["txRing"].asBool();
+    }
+    bool qdiscBypass = getSettingInt("ColorlightQdiscBypass") == 1;
+    if (config.isMember("qdiscBypass")) {
+        qdiscBypass = config["qdiscBypass"].asBool();
+    }
 
     if (ifstate != "up") {
         LogErr(VB_CHANNELOUT, "Error ColorLight: Configured interface %s does not have link %s\n", m_ifName.c_str(), FPPstrerror(errno));
@@ -504,10 +523,24 @@ int ColorLight5a75Output::Init(Json::Value config) {
         }
     }
 
+    // Discovery above uses plain sendmmsg() so the ring is only set up
+    // once that is complete.  Once a TX ring is attached, all sends on
+    // this socket need to go through the ring.
+    if (m_useTXRing && !SetupTXRing(qdiscBypass)) {
+        LogWarn(VB_CHANNELOUT, "ColorLight: Unable to setup PACKET_TX_RING, falling back to sendmmsg()\n");
+        m_useTXRing = false;
+    }
 #else
     m_fd = bindBPFSocket(m_ifName);
+    m_useTXRing = false;
 #endif
 
+    // In TX ring mode the row data is gathered straight into the packets
+    // so the gather spans need to be split on packet boundaries
+    m_gather.Build(m_panelMatrix.get(), m_startChannel, m_outputs, m_longestChain,
+                   m_panelWidth, m_panelHeight, !m_flippedLayout,
+                   m_useTXRing ? CL_MAX_CHAN_PER_PACKET : 0);
+
     unsigned int byteCount = 0;
     unsigned int p = 0;
     unsigned char* header = nullptr;
@@ -524,10 +557,13 @@ int ColorLight5a75Output::Init(Json::Value config) {
 
     /////////////////////////////////////////////////
     // Prep the brightness and pixel data packets
-    int packetCount = 1 + (m_rows * (((int)(m_rowSize - 1) / CL_MAX_CHAN_PER_PACKET) + 1));
+    m_packetsPerRow = ((int)(m_rowSize - 1) / CL_MAX_CHAN_PER_PACKET) + 1;
+    m_firstPixelPacket = 1;
+    int packetCount = 1 + (m_rows * m_packetsPerRow);
 
     if (m_highestFirmwareVersion >= 13) {
         packetCount += 1; // 0x0A brightness sent twice
+        m_firstPixelPacket++;
     }
 
     m_msgs.resize(packetCount);
@@ -805,45 +841,245 @@ int ColorLight5a75Output::SendMessages(std::vector<struct mmsghdr>& msgsToSend)
  *
  */
 void ColorLight5a75Output::PrepData(unsigned char* channelData) {
-    m_matrix->OverlaySubMatrices(channelData);
+    // Submatrices are composited by the gather tables rather than
+    // overlaying them onto channelData
+    m_gather.UpdateSubMatrices(m_matrix.get(), channelData);
 
-    unsigned char* r = NULL;
-    unsigned char* g = NULL;
-    unsigned char* b = NULL;
-    unsigned char* s = NULL;
-    unsigned char* dst = NULL;
-    int pw3 = m_panelWidth * 3;
+    if (m_useTXRing) {
+        PrepDataTXRing(channelData);
+        return;
+    }
 
-    channelData += m_startChannel; // FIXME, this function gets offset 0
+    // Outputs are independent so they are gathered in parallel
+    int outputBytes = m_gather.OutputBytes();
+    m_gather.ForEachOutput([this, channelData, outputBytes](int output) {
+        m_gather.GatherOutput(output, channelData, (uint8_t*)m_outputFrame.get() + output * outputBytes, m_gammaCurve);
+    });
 
-    for (int output = 0; output < m_outputs; output++) {
-        int panelsOnOutput = m_panelMatrix->m_outputPanels[output].size();
+    SendMessages(m_msgs);
+}
 
-        for (int i = 0; i < panelsOnOutput; i++) {
-            int panel = m_panelMatrix->m_outputPanels[output][i];
-            int chain = (m_longestChain - 1) - m_panelMatrix->m_panels[panel].chain;
+#ifndef PLATFORM_OSX
+// Data in a TPACKET_V2 TX slot starts where the sockaddr_ll would be in
+// the header, see Documentation/networking/packet_mmap.rst
+#define CL_TX_RING_DATA_OFFSET (TPACKET2_HDRLEN - sizeof(struct sockaddr_ll))
+#endif
 
-            if (m_flippedLayout)
-                chain = m_panelMatrix->m_panels[panel].chain;
+/*
+ *
+ */
+bool ColorLight5a75Output::SetupTXRing(bool qdiscBypass) {
+#ifndef PLATFORM_OSX
+    int ver = TPACKET_V2;
+    if (setsockopt(m_fd, SOL_PACKET, PACKET_VERSION, &ver, sizeof(ver)) < 0) {
+        LogErr(VB_CHANNELOUT, "Error setting PACKET_VERSION: %s\n", FPPstrerror(errno));
+        return false;
+    }
 
-            for (int y = 0; y < m_panelHeight; y++) {
-                int px = chain * m_panelWidth;
-                int yw = y * m_panelWidth * 3;
+    if (qdiscBypass) {
+        int one = 1;
+        if (setsockopt(m_fd, SOL_PACKET, PACKET_QDISC_BYPASS, &one, sizeof(one)) < 0) {
+            LogWarn(VB_CHANNELOUT, "Error setting PACKET_QDISC_BYPASS: %s\n", FPPstrerror(errno));
+        }
+    }
 
-                dst = (unsigned char*)(m_outputFrame.get() + (((((output * m_panelHeight) + y) * m_panelWidth * m_longestChain) + px) * 3));
+    // Largest packet is a full row data packet
+    int maxPacket = CL_PACKET_DATA_OFFSET + CL_PIXL_HEADER_SIZE + CL_MAX_CHAN_PER_PACKET;
+    if (maxPacket < CL_SYNC_PACKET_SIZE) {
+        maxPacket = CL_SYNC_PACKET_SIZE;
+    }
+    int frameSize = 1;
+    while (frameSize < (int)(CL_TX_RING_DATA_OFFSET + maxPacket)) {
+        frameSize <<= 1;
+    }
 
-                for (int x = 0; x < pw3; x += 3) {
-                    *(dst++) = m_gammaCurve[channelData[m_panelMatrix->m_panels[panel].pixelMap[yw + x]]];
-                    *(dst++) = m_gammaCurve[channelData[m_panelMatrix->m_panels[panel].pixelMap[yw + x + 1]]];
-                    *(dst++) = m_gammaCurve[channelData[m_panelMatrix->m_panels[panel].pixelMap[yw + x + 2]]];
+    // Room for two complete display frames so the next frame can be
+    // prepared while the previous one is still draining out.  Each frame
+    // is up to two brightness packets, the row data and two sync packets.
+    int perFrame = 2 + (m_rows * (((int)(m_rowSize - 1) / CL_MAX_CHAN_PER_PACKET) + 1)) + 2;
+    int blockSize = getpagesize();
+    while (blockSize < frameSize * 16) {
+        blockSize <<= 1;
+    }
+    int framesPerBlock = blockSize / frameSize;
+    int blockCount = ((perFrame * 2) + framesPerBlock - 1) / framesPerBlock;
+
+    struct tpacket_req req;
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = blockSize;
+    req.tp_block_nr = blockCount;
+    req.tp_frame_size = frameSize;
+    req.tp_frame_nr = blockCount * framesPerBlock;
+    if (setsockopt(m_fd, SOL_PACKET, PACKET_TX_RING, &req, sizeof(req)) < 0) {
+        LogErr(VB_CHANNELOUT, "Error setting PACKET_TX_RING: %s\n", FPPstrerror(errno));
+        return false;
+    }
 
-                    px++;
-                }
+    m_txRingSize = (size_t)blockSize * blockCount;
+    void* ring = mmap(nullptr, m_txRingSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (ring == MAP_FAILED) {
+        LogErr(VB_CHANNELOUT, "Error mapping PACKET_TX_RING: %s\n", FPPstrerror(errno));
+        // release the ring so the socket can go back to plain sendmmsg()
+        req.tp_block_nr = 0;
+        req.tp_frame_nr = 0;
+        setsockopt(m_fd, SOL_PACKET, PACKET_TX_RING, &req, sizeof(req));
+        m_txRingSize = 0;
+        return false;
+    }
+    m_txRing = (unsigned char*)ring;
+    m_txRingFrameSize = frameSize;
+    m_txRingFrameCount = req.tp_frame_nr;
+    m_txRingHead = 0;
+
+    LogDebug(VB_CHANNELOUT, "ColorLight TX ring: %d slots of %d bytes (%d KB)\n",
+             m_txRingFrameCount, m_txRingFrameSize, (int)(m_txRingSize / 1024));
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ColorLight5a75Output::CloseTXRing() {
+#ifndef PLATFORM_OSX
+    if (m_txRing) {
+        munmap(m_txRing, m_txRingSize);
+        m_txRing = nullptr;
+        m_txRingSize = 0;
+    }
+#endif
+}
+
+unsigned char* ColorLight5a75Output::GetTXRingSlot(int idx) {
+    return m_txRing + (size_t)(idx % m_txRingFrameCount) * m_txRingFrameSize;
+}
+
+bool ColorLight5a75Output::WaitForTXRingSlot(unsigned char* slot) {
+#ifndef PLATFORM_OSX
+    volatile struct tpacket2_hdr* hdr = (struct tpacket2_hdr*)slot;
+    if (hdr->tp_status == TP_STATUS_AVAILABLE) {
+        return true;
+    }
+    if (hdr->tp_status & TP_STATUS_WRONG_FORMAT) {
+        LogWarn(VB_CHANNELOUT, "ColorLight TX ring slot rejected by kernel (wrong format)\n");
+        hdr->tp_status = TP_STATUS_AVAILABLE;
+        return true;
+    }
+    // Previous frame is still going out, give it the same ~22ms
+    // window the sendmmsg() path allows before giving up on this frame
+    long long startTime = GetTimeMS();
+    while (hdr->tp_status != TP_STATUS_AVAILABLE) {
+        if ((GetTimeMS() - startTime) > 22) {
+            return false;
+        }
+        KickTXRing();
+        std::this_thread::sleep_for(std::chrono::microseconds(250));
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*
+ * Copy prebuilt messages into consecutive ring slots starting at the
+ * current ring head.  Row data packets can skip the pixel payload as
+ * PrepDataTXRing() writes that directly into the slot.
+ */
+void ColorLight5a75Output::QueueRingMessages(std::vector<struct mmsghdr>& msgs, int first, int count, bool skipPixelData) {
+#ifndef PLATFORM_OSX
+    for (int m = first; m < first + count; m++) {
+        unsigned char* slot = GetTXRingSlot(m_txRingHead + m - first);
+        unsigned char* data = slot + CL_TX_RING_DATA_OFFSET;
+        struct tpacket2_hdr* hdr = (struct tpacket2_hdr*)slot;
+
+        unsigned int len = 0;
+        struct msghdr& mh = msgs[m].msg_hdr;
+        for (int io = 0; io < mh.msg_iovlen; io++) {
+            if (!skipPixelData || io == 0) {
+                memcpy(data + len, mh.msg_iov[io].iov_base, mh.msg_iov[io].iov_len);
             }
+            len += mh.msg_iov[io].iov_len;
         }
+        hdr->tp_len = len;
+    }
+    // make sure all the packet data is visible before the kernel is
+    // allowed to look at any of the slots
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int m = 0; m < count; m++) {
+        struct tpacket2_hdr* hdr = (struct tpacket2_hdr*)GetTXRingSlot(m_txRingHead + m);
+        hdr->tp_status = TP_STATUS_SEND_REQUEST;
+    }
+    m_txRingHead = (m_txRingHead + count) % m_txRingFrameCount;
+#endif
+}
+
+int ColorLight5a75Output::KickTXRing() {
+    int rc = send(m_fd, nullptr, 0, MSG_DONTWAIT);
+    if (rc < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS) {
+        LogWarn(VB_CHANNELOUT, "send() failed for ColorLight TX ring: %s\n", FPPstrerror(errno));
     }
+    return rc;
+}
 
-    SendMessages(m_msgs);
+/*
+ * Waits for the next count slots after m_txRingHead to be free.  If the
+ * kernel has not drained them in time the caller skips what it was about
+ * to queue, the same way a slow sendmmsg() frame is skipped.
+ */
+bool ColorLight5a75Output::WaitForTXRingSlots(int count) {
+    for (int m = 0; m < count; m++) {
+        if (!WaitForTXRingSlot(GetTXRingSlot(m_txRingHead + m))) {
+            LogWarn(VB_CHANNELOUT, "ColorLight TX ring is full, skipping frame\n");
+            m_slowCount++;
+            if (m_slowCount > 3) {
+                WarningHolder::AddWarningTimeout(30, 21, "Repeated frames taking more than 20ms to send to ColorLight");
+            }
+            return false;
+        }
+    }
+    m_slowCount = 0;
+    return true;
+}
+
+/*
+ * Same as PrepData(), but the gamma corrected row pixels are written
+ * straight into the TX ring slot of the packet that carries them instead
+ * of into m_outputFrame.
+ */
+void ColorLight5a75Output::PrepDataTXRing(unsigned char* channelData) {
+#ifndef PLATFORM_OSX
+    int packetCount = m_msgs.size();
+    if (!WaitForTXRingSlots(packetCount)) {
+        return;
+    }
+
+    int pixelDataOffset = CL_TX_RING_DATA_OFFSET + CL_PACKET_DATA_OFFSET + CL_PIXL_HEADER_SIZE;
+    int rowBase = m_txRingHead + m_firstPixelPacket;
+    int rowBytes = m_gather.RowBytes();
+    const uint32_t* offsets = m_gather.Offsets();
+
+    // The gather spans were split on packet boundaries in Init() so each
+    // span lands entirely inside one packet's slot
+    m_gather.ForEachOutput([&](int output) {
+        for (const PanelGather::Span& s : m_gather.Spans(output)) {
+            int row = (output * m_panelHeight) + (s.dst / rowBytes);
+            int rowOffset = s.dst % rowBytes;
+            int packet = rowBase + (row * m_packetsPerRow) + (rowOffset / CL_MAX_CHAN_PER_PACKET);
+            uint8_t* dst = GetTXRingSlot(packet) + pixelDataOffset + (rowOffset % CL_MAX_CHAN_PER_PACKET);
+            if (s.table == PanelGather::BLANK_SPAN) {
+                memset(dst, 0, s.count);
+            } else {
+                PanelGather::GatherGamma(dst, channelData, offsets + s.table, s.count, m_gammaCurve);
+            }
+        }
+    });
+
+    // Headers (and the brightness packets) are copied in from the
+    // prebuilt messages, then the whole batch is handed to the kernel
+    QueueRingMessages(m_msgs, 0, m_firstPixelPacket, false);
+    QueueRingMessages(m_msgs, m_firstPixelPacket, packetCount - m_firstPixelPacket, true);
+    KickTXRing();
+#endif
 }
 
 int ColorLight5a75Output::SendMessagesHelper(struct mmsghdr* msgs, int msgCount) {
@@ -872,6 +1108,15 @@ int ColorLight5a75Output::SendMessagesHelper(struct mmsghdr* msgs, int msgCount)
 int ColorLight5a75Output::SendData(unsigned char* channelData) {
     LogExcess(VB_CHANNELOUT, "ColorLight5a75Output::SendData(%p)\n", channelData);
 
+    if (m_useTXRing) {
+        if (!WaitForTXRingSlots(m_syncMsgs.size())) {
+            return m_channelCount;
+        }
+        QueueRingMessages(m_syncMsgs, 0, m_syncMsgs.size(), false);
+        KickTXRing();
+        return m_channelCount;
+    }
+
     SendMessages(m_syncMsgs);
 
     return m_channelCount;
@@ -892,6 +1137,7 @@ void ColorLight5a75Output::DumpConfig(void) {
     LogDebug(VB_CHANNELOUT, "    Longest Chain  : %d\n", m_longestChain);
     LogDebug(VB_CHANNELOUT, "    Inverted Data  : %d\n", m_invertedData);
     LogDebug(VB_CHANNELOUT, "    Interface      : %s\n", m_ifName.c_str());
+    LogDebug(VB_CHANNELOUT, "    TX Ring        : %d (%d slots)\n", m_useTXRing, m_txRingFrameCount);
 
     ChannelOutput::DumpConfig();
 }
@@ -22,6 +22,7 @@
 #include "ChannelOutput.h"
 #include "ColorOrder.h"
 #include "Matrix.h"
+#include "PanelGather.h"
 #include "PanelMatrix.h"
 
 #define CL_MAX_PIXL_PER_PACKET 497
@@ -84,6 +85,17 @@ private:
     int SendMessagesHelper(struct mmsghdr* msgs, int cnt);
     int SendMessages(std::vector<struct mmsghdr>& msgsToSend);
 
+    // PACKET_TX_RING support, the kernel transmits straight out of an
+    // mmap'd ring of frame slots so row data is written there directly
+    bool SetupTXRing(bool qdiscBypass);
+    void CloseTXRing();
+    unsigned char* GetTXRingSlot(int idx);
+    bool WaitForTXRingSlot(unsigned char* slot);
+    bool WaitForTXRingSlots(int count);
+    void QueueRingMessages(std::vector<struct mmsghdr>& msgs, int first, int count, bool skipPixelData);
+    int KickTXRing();
+    void PrepDataTXRing(unsigned char* channelData);
+
     int m_width;
     int m_height;
     std::string m_layout;
@@ -109,6 +121,7 @@ private:
     std::unique_ptr<char[]> m_outputFrame;
     std::unique_ptr<Matrix> m_matrix;
     std::unique_ptr<PanelMatrix> m_panelMatrix;
+    PanelGather m_gather;
     uint8_t m_gammaCurve[256];
     int m_flippedLayout;
     bool m_colorlightDisable;
@@ -133,4 +146,13 @@ private:
     std::list<std::string> m_warnings;
 
     struct sockaddr_ll m_sock_addr;
+
+    bool m_useTXRing;
+    unsigned char* m_txRing;
+    size_t m_txRingSize;
+    int m_txRingFrameSize;
+    int m_txRingFrameCount;
+    int m_txRingHead;
+    int m_packetsPerRow;
+    int m_firstPixelPacket;
 };
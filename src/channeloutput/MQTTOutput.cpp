@@ -148,16 +148,18 @@ int MQTTOutput::RawSendData(unsigned char* channelData) {
         return m_channelCount;
     }
 
-    m_r = r;
-    m_g = g;
-    m_b = b;
-    m_w = w;
-
     std::string payload = m_payload;
 
     ReplaceValues(payload, r, g, b, w);
 
-    mqtt->PublishRaw(m_topic, payload);
+    // Only the latest color matters, let the publish thread coalesce and
+    // rate limit.  If the queue was full, retry on the next frame.
+    if (mqtt->PublishRaw(m_topic, payload, false, 1, true)) {
+        m_r = r;
+        m_g = g;
+        m_b = b;
+        m_w = w;
+    }
 
     return m_channelCount;
 }
@@ -15,7 +15,6 @@
 #include "../log.h"
 
 #include "Matrix.h"
-#include <cstring> // memcpy -- needed directly for NOPCH builds
 
 /*
  *
@@ -26,8 +25,6 @@ Matrix::Matrix(int startChannel, int width, int height) :
     m_height(height) {
     LogDebug(VB_CHANNELOUT, "New Matrix: %dx%d\n", width, height);
 
-    m_buffer = new unsigned char[width * height * 3];
-
     m_enableFlagOffset = startChannel + (width * height * 3);
 }
 
@@ -35,7 +32,6 @@ Matrix::Matrix(int startChannel, int width, int height) :
  *
  */
 Matrix::~Matrix() {
-    delete[] m_buffer;
 }
 
 /*
@@ -61,46 +57,61 @@ void Matrix::AddSubMatrix(int enabled, int startChannel, int width, int height,
 /*
  *
  */
-void Matrix::OverlaySubMatrix(unsigned char* channelData, int i) {
-    if (subMatrix.size() < i)
-        return;
-
-    // Check to see if this submatrix is enabled
-    if ((!subMatrix[i].enabled) &&
-        (!channelData[m_enableFlagOffset + i]))
-        return;
-
-    int startChannel = subMatrix[i].startChannel;
-    int xOffset = subMatrix[i].xOffset;
-    int yOffset = subMatrix[i].yOffset;
-
-    unsigned char* src;
-    unsigned char* dest;
+bool Matrix::IsSubMatrixEnabled(const unsigned char* channelData, int i) const {
+    return subMatrix[i].enabled || channelData[m_enableFlagOffset + i];
+}
 
-    for (int y = 0; y < subMatrix[i].height; y++) {
-        src = channelData + subMatrix[i].startChannel + (y * subMatrix[i].width * 3);
-        dest = m_buffer + ((y + subMatrix[i].yOffset) * m_width * 3) + (subMatrix[i].xOffset * 3);
+/*
+ *
+ */
+bool Matrix::UpdateEnabledSubMatrices(const unsigned char* channelData, std::vector<uint8_t>& enabled) const {
+    bool changed = enabled.size() != subMatrix.size();
+    enabled.resize(subMatrix.size());
 
-        memcpy(dest, src, subMatrix[i].width * 3);
+    for (int i = 0; i < subMatrix.size(); i++) {
+        uint8_t e = IsSubMatrixEnabled(channelData, i) ? 1 : 0;
+        if (enabled[i] != e) {
+            enabled[i] = e;
+            changed = true;
+        }
     }
+
+    return changed;
 }
 
 /*
  *
  */
-void Matrix::OverlaySubMatrices(unsigned char* channelData) {
-    if (!subMatrix.size())
-        return;
-
-    // Clear the matrix before applying submatrices
-    // bzero(m_buffer, m_width * m_height * 3);
+void Matrix::BuildChannelMap(const std::vector<uint8_t>& enabled, std::vector<uint32_t>& map) const {
+    int w3 = m_width * 3;
 
-    // Instead, just populate our temp buffer with the contents of the matrix
-    memcpy(m_buffer, channelData + m_startChannel, m_width * m_height * 3);
-
-    for (int i = 0; i < subMatrix.size(); i++) {
-        OverlaySubMatrix(channelData, i);
+    map.resize(w3 * m_height);
+    for (int i = 0; i < map.size(); i++) {
+        map[i] = m_startChannel + i;
     }
 
-    memcpy(channelData + m_startChannel, m_buffer, m_width * m_height * 3);
+    // Later submatrices win where they overlap
+    for (int i = 0; i < subMatrix.size() && i < enabled.size(); i++) {
+        if (!enabled[i])
+            continue;
+
+        const SubMatrix& sub = subMatrix[i];
+        for (int y = 0; y < sub.height; y++) {
+            int dy = y + sub.yOffset;
+            if ((dy < 0) || (dy >= m_height))
+                continue;
+
+            for (int x = 0; x < sub.width; x++) {
+                int dx = x + sub.xOffset;
+                if ((dx < 0) || (dx >= m_width))
+                    continue;
+
+                int d = (dy * w3) + (dx * 3);
+                int src = sub.startChannel + (y * sub.width * 3) + (x * 3);
+                map[d] = src;
+                map[d + 1] = src + 1;
+                map[d + 2] = src + 2;
+            }
+        }
+    }
 }
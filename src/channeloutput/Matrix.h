@@ -11,6 +11,7 @@
  * included LICENSE.LGPL file.
  */
 
+#include <cstdint>
 #include <vector>
 
 typedef struct subMatrix {
@@ -30,16 +31,24 @@ public:
     void AddSubMatrix(int enabled, int startChannel, int width, int height,
                       int xOffset, int yOffset);
 
-    void OverlaySubMatrix(unsigned char* channelData, int i);
-    void OverlaySubMatrices(unsigned char* channelData);
+    bool HasSubMatrices() const { return !subMatrix.empty(); }
+
+    // Refresh the per-submatrix enable state from the config/enable flag
+    // channels, returns true if it changed since the last call
+    bool UpdateEnabledSubMatrices(const unsigned char* channelData, std::vector<uint8_t>& enabled) const;
+
+    // Fill map with the absolute source channel for each channel of the
+    // matrix with the enabled submatrices composited on top, for outputs
+    // that gather through a table
+    void BuildChannelMap(const std::vector<uint8_t>& enabled, std::vector<uint32_t>& map) const;
 
 private:
+    bool IsSubMatrixEnabled(const unsigned char* channelData, int i) const;
+
     int m_startChannel;
     int m_width;
     int m_height;
     int m_enableFlagOffset;
 
-    unsigned char* m_buffer;
-
     std::vector<SubMatrix> subMatrix;
 };
@@ -0,0 +1,195 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+#include "fpp-pch.h"
+
+#include "../log.h"
+
+#include "Matrix.h"
+#include "PanelBitPlanes.h"
+#include "PanelInterleaveHandler.h"
+#include "PanelMatrix.h"
+
+/*
+ * Work out where every panel pixel pair ends up in the GPIO frame.
+ */
+void PanelBitPlanes::Build(PanelMatrix* panelMatrix, PanelInterleaveHandler* handler, int startChannel,
+                           int outputs, int longestChain, int panelWidth, int panelHeight, int panelScan,
+                           bool outputByRow, int colorDepth, const std::vector<int>& bitOrder,
+                           const uint16_t* gammaCurve, const std::vector<OutputPins>& pins, size_t frameWords) {
+    // number of uint32_t per row for each bit
+    size_t rowLen = panelWidth * longestChain * panelHeight / (panelScan * 2) * 4; // 4 GPIO's
+    // number of uint32_t per full row (all bits)
+    size_t fullRowLen = rowLen * colorDepth;
+    size_t chainLen = 4 * panelWidth * panelHeight / panelScan / 2;
+
+    m_bits = bitOrder.size();
+    m_stride = outputByRow ? rowLen : rowLen * panelScan;
+    m_frameWords = frameWords;
+    m_startChannel = startChannel;
+
+    for (int x = 0; x < 256; x++) {
+        m_gamma[x] = 0;
+        for (int k = 0; k < m_bits; k++) {
+            if (gammaCurve[x] & (1 << bitOrder[k])) {
+                m_gamma[x] |= 1 << k;
+            }
+        }
+    }
+
+    // panel on each output/chain position, -1 if none
+    std::vector<int> panelAt(outputs * longestChain, -1);
+    for (int output = 0; output < outputs; output++) {
+        for (auto panel : panelMatrix->m_outputPanels[output]) {
+            int chain = panelMatrix->m_panels[panel].chain;
+            if (chain >= 0 && chain < longestChain) {
+                panelAt[output * longestChain + chain] = panel;
+            }
+        }
+    }
+
+    m_locations.clear();
+    m_sources.clear();
+    m_baseChannels.clear();
+    m_subMatrixEnabled.clear();
+    m_overlap = false;
+    std::vector<uint8_t> used(frameWords);
+    PanelInterleaveHandler::Compiled panelMap = handler->compile(panelWidth, panelHeight / 2);
+    for (int chain = 0; chain < longestChain; chain++) {
+        for (int y = 0; y < (panelHeight / 2); y++) {
+            int yw1 = y * panelWidth * 3;
+            int yw2 = (y + (panelHeight / 2)) * panelWidth * 3;
+
+            int yOut = panelMap.mappedY(0, y);
+
+            size_t offset = yOut * (outputByRow ? fullRowLen : rowLen) + (longestChain - chain - 1) * chainLen;
+
+            for (int x = 0; x < panelWidth; ++x) {
+                int xOut = panelMap.mappedX(x, y);
+
+                Location loc;
+                loc.offset = offset + xOut * 4;
+                loc.firstSource = m_sources.size();
+                loc.sourceCount = 0;
+
+                size_t last = loc.offset + (m_bits ? m_bits - 1 : 0) * m_stride + 3;
+                if (last >= frameWords) {
+                    LogErr(VB_CHANNELOUT, "PanelBitPlanes: panel %d,%d on chain %d maps outside the frame\n", x, y, chain);
+                    continue;
+                }
+                for (int k = 0; k < m_bits; k++) {
+                    for (int g = 0; g < 4; g++) {
+                        uint8_t& u = used[loc.offset + k * m_stride + g];
+                        if (u) {
+                            m_overlap = true;
+                        }
+                        u = 1;
+                    }
+                }
+
+                for (int output = 0; output < outputs; output++) {
+                    int panel = panelAt[output * longestChain + chain];
+                    if (panel < 0) {
+                        continue;
+                    }
+                    const std::vector<int>& pixelMap = panelMatrix->m_panels[panel].pixelMap;
+                    const OutputPins& p = pins[output];
+
+                    Source src;
+                    for (int c = 0; c < 6; c++) {
+                        uint32_t ch = pixelMap[(c < 3 ? yw1 : yw2) + x * 3 + (c % 3)];
+                        m_baseChannels.push_back(ch);
+                        src.channel[c] = startChannel + ch;
+                        src.bank[c] = p.bank[c] & 3;
+                        src.shift[c] = p.pin[c] ? __builtin_ctz(p.pin[c]) : 0;
+                        src.mask[c] = p.pin[c] ? 0xFFFF : 0;
+                    }
+                    m_sources.push_back(src);
+                    loc.sourceCount++;
+                }
+                m_locations.push_back(loc);
+            }
+        }
+    }
+    if (m_overlap) {
+        LogWarn(VB_CHANNELOUT, "PanelBitPlanes: interleave maps multiple pixels to the same output words, using slower frame preparation\n");
+    }
+    LogDebug(VB_CHANNELOUT, "PanelBitPlanes: %d locations, %d sources, stride %d\n",
+             (int)m_locations.size(), (int)m_sources.size(), (int)m_stride);
+}
+
+void PanelBitPlanes::UpdateSubMatrices(const Matrix* matrix, const uint8_t* channelData) {
+    if (!matrix || !matrix->HasSubMatrices()) {
+        return;
+    }
+    if (!matrix->UpdateEnabledSubMatrices(channelData, m_subMatrixEnabled)) {
+        return;
+    }
+
+    matrix->BuildChannelMap(m_subMatrixEnabled, m_channelMap);
+    const uint32_t* base = m_baseChannels.data();
+    for (auto& src : m_sources) {
+        for (int c = 0; c < 6; c++) {
+            src.channel[c] = m_channelMap[*base++];
+        }
+    }
+
+    LogDebug(VB_CHANNELOUT, "PanelBitPlanes: rebuilt sources for submatrix enable change\n");
+}
+
+/*
+ * Transpose the gamma corrected values of each location's pixels into the
+ * per bit GPIO words.  Every word touched is written exactly once so the
+ * frame doesn't need to be cleared first (words that no location maps to
+ * are never written) unless locations overlap.
+ */
+void PanelBitPlanes::Prep(const uint8_t* channelData, uint32_t* frame) const {
+    const int bits = m_bits;
+    const size_t stride = m_stride;
+    const Source* sources = m_sources.data();
+
+    if (m_overlap) {
+        memset(frame, 0, m_frameWords * 4);
+    }
+    for (auto& loc : m_locations) {
+        uint32_t planes[16][4] = {};
+
+        const Source* src = sources + loc.firstSource;
+        for (uint32_t s = 0; s < loc.sourceCount; s++, src++) {
+            for (int c = 0; c < 6; c++) {
+                uint32_t v = m_gamma[channelData[src->channel[c]]] & src->mask[c];
+                uint32_t shift = src->shift[c];
+                uint32_t* p = &planes[0][src->bank[c]];
+                for (int k = 0; k < bits; k++) {
+                    p[k * 4] |= ((v >> k) & 1) << shift;
+                }
+            }
+        }
+
+        uint32_t* dst = frame + loc.offset;
+        if (m_overlap) {
+            for (int k = 0; k < bits; k++, dst += stride) {
+                dst[0] |= planes[k][0];
+                dst[1] |= planes[k][1];
+                dst[2] |= planes[k][2];
+                dst[3] |= planes[k][3];
+            }
+        } else {
+            for (int k = 0; k < bits; k++, dst += stride) {
+                dst[0] = planes[k][0];
+                dst[1] = planes[k][1];
+                dst[2] = planes[k][2];
+                dst[3] = planes[k][3];
+            }
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Matrix;
+class PanelInterleaveHandler;
+class PanelMatrix;
+
+/*
+ * Precomputed GPIO bit plane tables for LED panel outputs that drive the
+ * panels straight from GPIO banks (BBBMatrix).
+ *
+ * The frame is made of bit planes of 4 uint32_t GPIO bank words per output
+ * column.  At init time the interleave handler, chain position, per-panel
+ * pixelMaps and pin assignments are folded into a flat list of locations
+ * (a column's 4 bank words in the first bit plane) each with one source
+ * record per output, so the per-frame work is gamma lookups and bit
+ * shuffling with no per-pixel panel lookups.
+ */
+class PanelBitPlanes {
+public:
+    // The pins of one output in r1 g1 b1 r2 g2 b2 order, pin is the bit
+    // mask in the GPIO bank word (0 if not connected), bank is 0-3
+    class OutputPins {
+    public:
+        uint32_t pin[6] = {};
+        uint8_t bank[6] = {};
+    };
+
+    // bitOrder lists the gamma corrected bit sent in each plane.  The frame
+    // is frameWords uint32_t long.
+    void Build(PanelMatrix* panelMatrix, PanelInterleaveHandler* handler, int startChannel,
+               int outputs, int longestChain, int panelWidth, int panelHeight, int panelScan,
+               bool outputByRow, int colorDepth, const std::vector<int>& bitOrder,
+               const uint16_t* gammaCurve, const std::vector<OutputPins>& pins, size_t frameWords);
+
+    // Fold the matrix's currently enabled submatrices into the source
+    // channels.  Cheap unless the set of enabled submatrices changed, call
+    // once per frame before Prep.
+    void UpdateSubMatrices(const Matrix* matrix, const uint8_t* channelData);
+
+    // Build the GPIO frame from the full channel data buffer.  Every mapped
+    // word is written once so frame only needs clearing before the first
+    // call, unless Overlap() in which case Prep clears it itself.
+    void Prep(const uint8_t* channelData, uint32_t* frame) const;
+
+    bool Overlap() const { return m_overlap; }
+    size_t Locations() const { return m_locations.size(); }
+
+private:
+    class Source {
+    public:
+        uint32_t channel[6]; // absolute channel of r1 g1 b1 r2 g2 b2
+        uint8_t bank[6];
+        uint8_t shift[6];
+        uint16_t mask[6]; // 0 if the pin isn't connected
+    };
+    class Location {
+    public:
+        uint32_t offset;
+        uint32_t firstSource;
+        uint32_t sourceCount;
+    };
+
+    std::vector<Location> m_locations;
+    std::vector<Source> m_sources;
+    size_t m_stride = 0;
+    size_t m_frameWords = 0;
+    int m_bits = 0;
+    bool m_overlap = false; // locations share words, must clear and OR
+    uint16_t m_gamma[256];  // gammaCurve with the bits in bitOrder order
+
+    // matrix relative channels of every source before any submatrices are
+    // applied, 6 per source
+    int m_startChannel = 0;
+    std::vector<uint32_t> m_baseChannels;
+    std::vector<uint8_t> m_subMatrixEnabled;
+    std::vector<uint32_t> m_channelMap;
+};
@@ -0,0 +1,258 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+#include "fpp-pch.h"
+
+#include "../common.h"
+#include "../log.h"
+
+#include "Matrix.h"
+#include "PanelGather.h"
+#include "PanelMatrix.h"
+
+PanelGather::PanelGather() :
+    m_rowBytes(0),
+    m_panelHeight(0),
+    m_workFunc(nullptr),
+    m_nextOutput(0),
+    m_outputsDone(0),
+    m_workGeneration(0),
+    m_workersRunning(false) {
+}
+
+PanelGather::~PanelGather() {
+    StopWorkers();
+}
+
+void PanelGather::Build(PanelMatrix* panelMatrix, int startChannel, int outputs,
+                        int longestChain, int panelWidth, int panelHeight,
+                        bool reverseChain, int splitSize) {
+    int pw3 = panelWidth * 3;
+
+    m_rowBytes = longestChain * pw3;
+    m_panelHeight = panelHeight;
+    m_spans.clear();
+    m_spans.resize(outputs);
+    m_baseOffsets.clear();
+    m_baseOffsets.reserve((size_t)outputs * m_rowBytes * panelHeight);
+    m_subMatrixEnabled.clear();
+
+    // Which panel sits at each chain position of each output
+    std::vector<int> chainPanel(longestChain);
+    for (int output = 0; output < outputs; output++) {
+        std::fill(chainPanel.begin(), chainPanel.end(), -1);
+        for (int panel : panelMatrix->m_outputPanels[output]) {
+            int chain = panelMatrix->m_panels[panel].chain;
+            if (reverseChain) {
+                chain = (longestChain - 1) - chain;
+            }
+            if (chain >= 0 && chain < longestChain) {
+                chainPanel[chain] = panel;
+            }
+        }
+
+        std::vector<Span>& spans = m_spans[output];
+        for (int y = 0; y < panelHeight; y++) {
+            uint32_t rowStart = y * m_rowBytes;
+            for (int c = 0; c < longestChain; c++) {
+                uint32_t dst = rowStart + c * pw3;
+                int panel = chainPanel[c];
+                int remaining = pw3;
+                int x = 0;
+                while (remaining) {
+                    int count = remaining;
+                    if (splitSize) {
+                        int inSplit = splitSize - ((dst - rowStart) % splitSize);
+                        if (count > inSplit) {
+                            count = inSplit;
+                        }
+                    }
+
+                    // extend the previous span if this one follows on directly
+                    Span* prev = spans.empty() ? nullptr : &spans.back();
+                    bool canMerge = prev && (prev->dst + prev->count == dst) &&
+                                    (!splitSize || ((dst - rowStart) % splitSize) != 0) &&
+                                    ((panel == -1) == (prev->table == BLANK_SPAN));
+                    if (panel == -1) {
+                        if (canMerge) {
+                            prev->count += count;
+                        } else {
+                            spans.push_back({ dst, (uint32_t)count, BLANK_SPAN });
+                        }
+                    } else {
+                        if (!canMerge) {
+                            spans.push_back({ dst, 0, (uint32_t)m_baseOffsets.size() });
+                            prev = &spans.back();
+                        }
+                        const std::vector<int>& pixelMap = panelMatrix->m_panels[panel].pixelMap;
+                        for (int i = 0; i < count; i++) {
+                            m_baseOffsets.push_back(pixelMap[y * pw3 + x + i]);
+                        }
+                        prev->count += count;
+                    }
+                    dst += count;
+                    x += count;
+                    remaining -= count;
+                }
+            }
+        }
+    }
+
+    m_offsets.resize(m_baseOffsets.size());
+    for (size_t i = 0; i < m_baseOffsets.size(); i++) {
+        m_offsets[i] = startChannel + m_baseOffsets[i];
+    }
+
+    int threads = std::thread::hardware_concurrency();
+    if (threads > outputs) {
+        threads = outputs;
+    }
+    StopWorkers();
+    StartWorkers(threads - 1);
+
+    LogDebug(VB_CHANNELOUT, "PanelGather: %d outputs, %d bytes per output, %d offsets, %d worker threads\n",
+             outputs, OutputBytes(), (int)m_offsets.size(), (int)m_workers.size());
+}
+
+void PanelGather::UpdateSubMatrices(const Matrix* matrix, const uint8_t* channelData) {
+    if (!matrix || !matrix->HasSubMatrices()) {
+        return;
+    }
+    if (!matrix->UpdateEnabledSubMatrices(channelData, m_subMatrixEnabled)) {
+        return;
+    }
+
+    matrix->BuildChannelMap(m_subMatrixEnabled, m_channelMap);
+    for (size_t i = 0; i < m_baseOffsets.size(); i++) {
+        m_offsets[i] = m_channelMap[m_baseOffsets[i]];
+    }
+
+    LogDebug(VB_CHANNELOUT, "PanelGather: rebuilt offsets for submatrix enable change\n");
+}
+
+/*
+ * Gather + gamma kernel.  The table lookups are inherently scalar (neither
+ * NEON nor SSE2 have a byte gather) so this is just unrolled to keep
+ * several independent loads in flight.
+ */
+void PanelGather::GatherGamma(uint8_t* dst, const uint8_t* src, const uint32_t* idx, uint32_t count, const uint8_t* gamma) {
+    uint32_t x = 0;
+    for (; x + 8 <= count; x += 8) {
+        uint8_t v0 = src[idx[x]];
+        uint8_t v1 = src[idx[x + 1]];
+        uint8_t v2 = src[idx[x + 2]];
+        uint8_t v3 = src[idx[x + 3]];
+        uint8_t v4 = src[idx[x + 4]];
+        uint8_t v5 = src[idx[x + 5]];
+        uint8_t v6 = src[idx[x + 6]];
+        uint8_t v7 = src[idx[x + 7]];
+        dst[x] = gamma[v0];
+        dst[x + 1] = gamma[v1];
+        dst[x + 2] = gamma[v2];
+        dst[x + 3] = gamma[v3];
+        dst[x + 4] = gamma[v4];
+        dst[x + 5] = gamma[v5];
+        dst[x + 6] = gamma[v6];
+        dst[x + 7] = gamma[v7];
+    }
+    for (; x < count; x++) {
+        dst[x] = gamma[src[idx[x]]];
+    }
+}
+
+void PanelGather::GatherOutput(int output, const uint8_t* channelData, uint8_t* dst, const uint8_t* gamma) const {
+    const uint32_t* offsets = Offsets();
+    for (const Span& s : m_spans[output]) {
+        if (s.table == BLANK_SPAN) {
+            memset(dst + s.dst, 0, s.count);
+        } else {
+            GatherGamma(dst + s.dst, channelData, offsets + s.table, s.count, gamma);
+        }
+    }
+}
+
+void PanelGather::ForEachOutput(const std::function<void(int)>& func) {
+    int count = m_spans.size();
+    if (m_workers.empty() || count < 2) {
+        for (int o = 0; o < count; o++) {
+            func(o);
+        }
+        return;
+    }
+
+    m_workFunc = &func;
+    m_outputsDone = 0;
+    m_nextOutput = 0;
+    {
+        std::unique_lock<std::mutex> lock(m_workMutex);
+        ++m_workGeneration;
+    }
+    m_workSignal.notify_all();
+
+    // this thread works on outputs as well instead of just waiting
+    int o;
+    while ((o = m_nextOutput++) < count) {
+        func(o);
+        ++m_outputsDone;
+    }
+    while (m_outputsDone < count) {
+        std::this_thread::yield();
+    }
+}
+
+void PanelGather::StartWorkers(int count) {
+    if (count <= 0) {
+        return;
+    }
+    m_workersRunning = true;
+    for (int x = 0; x < count; x++) {
+        m_workers.emplace_back(&PanelGather::RunWorker, this);
+    }
+}
+
+void PanelGather::StopWorkers() {
+    if (m_workers.empty()) {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_workMutex);
+        m_workersRunning = false;
+    }
+    m_workSignal.notify_all();
+    for (auto& t : m_workers) {
+        t.join();
+    }
+    m_workers.clear();
+}
+
+void PanelGather::RunWorker() {
+    SetThreadName("FPP-PanelPrep");
+    int generation = 0;
+    std::unique_lock<std::mutex> lock(m_workMutex);
+    generation = m_workGeneration;
+    while (m_workersRunning) {
+        m_workSignal.wait(lock, [&]() { return !m_workersRunning || m_workGeneration != generation; });
+        if (!m_workersRunning) {
+            break;
+        }
+        generation = m_workGeneration;
+        lock.unlock();
+
+        int count = m_spans.size();
+        int o;
+        while ((o = m_nextOutput++) < count) {
+            (*m_workFunc)(o);
+            ++m_outputsDone;
+        }
+        lock.lock();
+    }
+}
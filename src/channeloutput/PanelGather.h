@@ -0,0 +1,103 @@
+#pragma once
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Matrix;
+class PanelMatrix;
+
+/*
+ * Flattened gather tables for LED panel outputs.
+ *
+ * Each panel output (one connector with a chain of panels) is laid out as
+ * panelHeight rows of longestChain * panelWidth * 3 bytes.  At init time
+ * the per-panel pixelMaps, the chain position (and its direction) and the
+ * panel color order are folded into a single table of absolute channel
+ * offsets per output so the per-frame work is a single gather + gamma
+ * pass over each output with no per-pixel panel lookups.
+ */
+class PanelGather {
+public:
+    // A contiguous run of output bytes.  table is the index of the first
+    // source offset in m_offsets or BLANK_SPAN for positions with no panel.
+    struct Span {
+        uint32_t dst;
+        uint32_t count;
+        uint32_t table;
+    };
+    static constexpr uint32_t BLANK_SPAN = 0xFFFFFFFF;
+
+    PanelGather();
+    ~PanelGather();
+
+    // reverseChain places chain 0 at the end of the row (furthest from the
+    // connector).  If splitSize is non-zero, spans never cross a multiple of
+    // splitSize bytes within a row so callers can scatter spans into
+    // separate packets.
+    void Build(PanelMatrix* panelMatrix, int startChannel, int outputs,
+               int longestChain, int panelWidth, int panelHeight,
+               bool reverseChain, int splitSize = 0);
+
+    // Fold the matrix's currently enabled submatrices into the offset
+    // table so compositing happens as part of the gather.  Cheap unless the
+    // set of enabled submatrices changed, call once per frame before
+    // gathering.
+    void UpdateSubMatrices(const Matrix* matrix, const uint8_t* channelData);
+
+    int Outputs() const { return m_spans.size(); }
+    int RowBytes() const { return m_rowBytes; }
+    int OutputBytes() const { return m_rowBytes * m_panelHeight; }
+
+    const std::vector<Span>& Spans(int output) const { return m_spans[output]; }
+    const uint32_t* Offsets() const { return &m_offsets[0]; }
+
+    // Gather + gamma a single output into dst (OutputBytes() long)
+    void GatherOutput(int output, const uint8_t* channelData, uint8_t* dst, const uint8_t* gamma) const;
+
+    // Run func(output) for every output, spreading the outputs across
+    // worker threads.  Returns once all outputs are complete.
+    void ForEachOutput(const std::function<void(int)>& func);
+
+    static void GatherGamma(uint8_t* dst, const uint8_t* src, const uint32_t* idx, uint32_t count, const uint8_t* gamma);
+
+private:
+    void StartWorkers(int count);
+    void StopWorkers();
+    void RunWorker();
+
+    int m_rowBytes;
+    int m_panelHeight;
+
+    std::vector<std::vector<Span>> m_spans;
+    std::vector<uint32_t> m_offsets;
+
+    // matrix relative offsets before any submatrices are applied
+    std::vector<uint32_t> m_baseOffsets;
+    std::vector<uint8_t> m_subMatrixEnabled;
+    std::vector<uint32_t> m_channelMap;
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_workMutex;
+    std::condition_variable m_workSignal;
+    const std::function<void(int)>* m_workFunc;
+    std::atomic<int> m_nextOutput;
+    std::atomic<int> m_outputsDone;
+    int m_workGeneration;
+    bool m_workersRunning;
+};
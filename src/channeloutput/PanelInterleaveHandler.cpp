@@ -11,6 +11,7 @@
  */
 #include "PanelInterleaveHandler.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <vector>
 
@@ -19,6 +20,31 @@ PanelInterleaveHandler::PanelInterleaveHandler(int pw, int ph, int ps, int pi) :
     m_map.resize(m_panelWidth * m_panelHeight);
 }
 
+PanelInterleaveHandler::Compiled PanelInterleaveHandler::compile(int width, int height) {
+    Compiled c;
+    c.width = std::max(0, std::min(width, m_panelWidth));
+    c.height = std::max(0, std::min(height, m_panelHeight));
+    if (c.width == 0 || c.height == 0) {
+        // empty panel, rowLength and rows stay 0 and there are no offsets
+        return c;
+    }
+
+    std::vector<std::pair<uint16_t, uint16_t>> mapped(c.width * c.height);
+    for (int y = 0; y < c.height; ++y) {
+        for (int x = 0; x < c.width; ++x) {
+            auto& m = m_map[y * m_panelWidth + x];
+            mapped[y * c.width + x] = m;
+            c.rowLength = std::max(c.rowLength, (uint32_t)m.first + 1);
+            c.rows = std::max(c.rows, (uint32_t)m.second + 1);
+        }
+    }
+    c.offsets.resize(mapped.size());
+    for (size_t i = 0; i < mapped.size(); ++i) {
+        c.offsets[i] = mapped[i].second * c.rowLength + mapped[i].first;
+    }
+    return c;
+}
+
 class NoInterleaveHandler : public PanelInterleaveHandler {
 public:
     NoInterleaveHandler(int pw, int ph, int ps, int pi) :
@@ -65,11 +91,9 @@ public:
     virtual void mapCol(int y, int& x) {
         int whichInt = x / m_interleave;
         if (m_flipRows) {
-            if (y & m_panelScan) {
-                y &= !m_panelScan;
-            } else {
-                y |= m_panelScan;
-            }
+            // swap each pair of scan blocks, for power of two scans this
+            // is toggling the m_panelScan bit of y
+            y = ((y / m_panelScan) ^ 1) * m_panelScan + y % m_panelScan;
         }
         int offInInt = x % m_interleave;
         int mult = (m_panelHeight / m_panelScan / 2) - 1 - y / m_panelScan;
@@ -30,6 +30,26 @@ public:
         y = pair.second;
     }
 
+    // The map flattened into one table of output offsets for the top left
+    // width x height pixels of the panel.  Outputs build their channel
+    // offset tables from this instead of calling map() for every pixel.
+    class Compiled {
+    public:
+        int width = 0;
+        int height = 0;
+        uint32_t rowLength = 0; // largest mapped x + 1, 0 for an empty panel
+        uint32_t rows = 0;      // largest mapped y + 1
+
+        // offsets[y * width + x] = mappedY * rowLength + mappedX
+        std::vector<uint32_t> offsets;
+
+        uint32_t offset(int x, int y) const { return offsets[y * width + x]; }
+        // only valid for x < width and y < height, never for an empty panel
+        int mappedX(int x, int y) const { return offsets[y * width + x] % rowLength; }
+        int mappedY(int x, int y) const { return offsets[y * width + x] / rowLength; }
+    };
+    Compiled compile(int width, int height);
+
     static PanelInterleaveHandler* createHandler(const std::string& type, int panelWidth, int panelHeight, int panelScan);
 
 protected:
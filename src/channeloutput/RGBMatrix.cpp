@@ -320,6 +320,11 @@ int RGBMatrixOutput::Init(Json::Value config) {
         }
         m_gammaCurve[x] = round(f);
     }
+
+    m_gather.Build(m_panelMatrix, m_startChannel, m_outputs, m_longestChain,
+                   m_panelWidth, m_panelHeight, true);
+    m_gatherBuffer.resize(m_outputs * m_gather.OutputBytes());
+
     if (PixelOverlayManager::INSTANCE.isAutoCreatePixelOverlayModels()) {
         std::string dd = "LED Panels";
         if (config.isMember("LEDPanelMatrixName") && !config["LEDPanelMatrixName"].asString().empty()) {
@@ -380,33 +385,21 @@ void RGBMatrixOutput::OverlayTestData(unsigned char* channelData, int cycleNum,
 void RGBMatrixOutput::PrepData(unsigned char* channelData) {
     LogExcess(VB_CHANNELOUT, "RGBMatrixOutput::PrepData(%p)\n",
               channelData);
-    m_matrix->OverlaySubMatrices(channelData);
-
-    unsigned char r;
-    unsigned char g;
-    unsigned char b;
-
-    channelData += m_startChannel;
-
-    for (int output = 0; output < m_outputs; output++) {
-        int panelsOnOutput = m_panelMatrix->m_outputPanels[output].size();
-
-        for (int i = 0; i < panelsOnOutput; i++) {
-            int panel = m_panelMatrix->m_outputPanels[output][i];
-
-            int chain = (m_longestChain - 1) - m_panelMatrix->m_panels[panel].chain;
-            for (int y = 0; y < m_panelHeight; y++) {
-                int px = chain * m_panelWidth;
-                for (int x = 0; x < m_panelWidth; x++) {
-                    r = m_gammaCurve[channelData[m_panelMatrix->m_panels[panel].pixelMap[(y * m_panelWidth + x) * 3]]];
-                    g = m_gammaCurve[channelData[m_panelMatrix->m_panels[panel].pixelMap[(y * m_panelWidth + x) * 3 + 1]]];
-                    b = m_gammaCurve[channelData[m_panelMatrix->m_panels[panel].pixelMap[(y * m_panelWidth + x) * 3 + 2]]];
-
-                    m_canvas->SetPixel(px, y + (output * m_panelHeight), r, g, b);
-
-                    px++;
-                }
-            }
+    m_gather.UpdateSubMatrices(m_matrix, channelData);
+
+    // Gather + gamma each output's rows in parallel, the canvas itself
+    // isn't thread safe as parallel chains share the same GPIO words
+    int outputBytes = m_gather.OutputBytes();
+    m_gather.ForEachOutput([this, channelData, outputBytes](int output) {
+        m_gather.GatherOutput(output, channelData, &m_gatherBuffer[output * outputBytes], m_gammaCurve);
+    });
+
+    int rowPixels = m_longestChain * m_panelWidth;
+    const uint8_t* src = &m_gatherBuffer[0];
+    for (int y = 0; y < m_outputs * m_panelHeight; y++) {
+        for (int x = 0; x < rowPixels; x++) {
+            m_canvas->SetPixel(x, y, src[0], src[1], src[2]);
+            src += 3;
         }
     }
 }
@@ -15,6 +15,7 @@
 #include "fpp-json-fwd.h"
 
 #include "Matrix.h"
+#include "PanelGather.h"
 #include "PanelMatrix.h"
 
 #include "led-matrix.h"
@@ -66,6 +67,8 @@ private:
 
     Matrix* m_matrix = nullptr;
     PanelMatrix* m_panelMatrix = nullptr;
+    PanelGather m_gather;
+    std::vector<uint8_t> m_gatherBuffer;
     std::string m_autoCreatedModelName;
 
     uint8_t m_gammaCurve[256];
@@ -14,8 +14,8 @@
 
 #include "fpp-json.h"
 
+#include <atomic>
 #include <arpa/inet.h>
-#include <curl/curl.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <sys/time.h>
@@ -40,8 +40,235 @@ static const std::string TWINKLYTYPE = "Twinkly";
 constexpr int TOKEN_LEN = 8;
 constexpr int HEADER_LEN = (1 + TOKEN_LEN + 2 + 1);
 constexpr int TWINKLY_TOKEN_VALIDATE_TIME = 120; // check the token every 120s
+constexpr int TWINKLY_SESSION_CHECK_TIME = 5;    // seconds between session state checks
+constexpr int TWINKLY_RETRY_TIME = 10;           // seconds before retrying a failed login
+constexpr int TWINKLY_TOKEN_LIFETIME = 14400;    // used if the login doesn't say
 
-constexpr uint32_t MAXPACKETS = 40 * 60 * 60 * 4; // about 4 hours at 40fps,
+/*
+ * Twinkly REST session.  The handshake is login -> verify -> realtime mode,
+ * each step is queued on the CurlManager when the previous one completes so
+ * nothing here ever blocks the caller.  Once the device is in realtime
+ * mode the token is handed to the output thread via the atomics and frames
+ * are sent over UDP until the output stops.  The token is refreshed in the
+ * background before it expires, frames keep going out with the old token
+ * until the new one is ready.
+ */
+class TwinklyOutputData::Session : public std::enable_shared_from_this<TwinklyOutputData::Session> {
+public:
+    enum class State {
+        Idle,
+        LoggingIn,
+        Verifying,
+        EnablingRealtime,
+        Streaming,
+        Failed
+    };
+
+    explicit Session(const std::string& ip) :
+        ipAddress(ip),
+        baseUrl("http://" + ip + "/xled/v1/") {}
+
+    void start() {
+        std::unique_lock<std::mutex> l(lock);
+        active = true;
+        l.unlock();
+        login();
+    }
+
+    void stop() {
+        std::unique_lock<std::mutex> l(lock);
+        active = false;
+        ++generation;
+        state = State::Idle;
+        streaming = false;
+        std::string at = authToken;
+        authToken = "";
+        l.unlock();
+
+        if (at != "") {
+            // fire and forget, nothing to wait for
+            CurlManager::INSTANCE.add(baseUrl + "led/mode", "POST", "{\"mode\": \"off\"}", jsonHeaders(at),
+                                      [self = shared_from_this()](int rc, const std::string& resp) {
+                                          LogDebug(VB_CHANNELOUT, "Twinkly %s: mode off: %d\n", self->ipAddress.c_str(), rc);
+                                      });
+        }
+    }
+
+    // called periodically from the timer thread
+    void check() {
+        long long now = GetTimeMS();
+        std::unique_lock<std::mutex> l(lock);
+        if (!active) {
+            return;
+        }
+        if (state == State::Failed && now >= retryTime) {
+            l.unlock();
+            login();
+        } else if (state == State::Streaming && now >= expireTime) {
+            LogDebug(VB_CHANNELOUT, "Twinkly %s: token expiring, logging in again\n", ipAddress.c_str());
+            l.unlock();
+            login();
+        } else if (state == State::Streaming && now >= verifyTime) {
+            verifyTime = now + TWINKLY_TOKEN_VALIDATE_TIME * 1000;
+            uint32_t gen = generation;
+            std::string at = authToken;
+            l.unlock();
+            CurlManager::INSTANCE.add(baseUrl + "verify", "GET", "", { "X-Auth-Token: " + at },
+                                      [self = shared_from_this(), gen](int rc, const std::string& resp) {
+                                          self->tokenChecked(gen, rc, resp);
+                                      });
+        }
+    }
+
+    std::atomic<bool> streaming = false;
+    std::atomic<bool> tokenChanged = false;
+    std::atomic<uint64_t> token = 0;
+
+private:
+    static std::list<std::string> jsonHeaders(const std::string& at = "") {
+        std::list<std::string> headers = { "Accept: application/json", "Content-Type: application/json" };
+        if (at != "") {
+            headers.push_back("X-Auth-Token: " + at);
+        }
+        return headers;
+    }
+    static bool parseResponse(int rc, const std::string& resp, Json::Value& v) {
+        if (rc != 200) {
+            return false;
+        }
+        try {
+            v = LoadJsonFromString(resp);
+        } catch (std::exception& ex) {
+            return false;
+        }
+        return v.isObject() && (!v.isMember("code") || v["code"].asInt() == 1000);
+    }
+
+    void login() {
+        std::unique_lock<std::mutex> l(lock);
+        if (!active || state == State::LoggingIn || state == State::Verifying || state == State::EnablingRealtime) {
+            return;
+        }
+        state = State::LoggingIn;
+        uint32_t gen = generation;
+        l.unlock();
+
+        LogDebug(VB_CHANNELOUT, "Twinkly %s: logging in\n", ipAddress.c_str());
+        CurlManager::INSTANCE.add(baseUrl + "login", "POST", "{\"challenge\": \"AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8=\"}", jsonHeaders(),
+                                  [self = shared_from_this(), gen](int rc, const std::string& resp) {
+                                      self->loginDone(gen, rc, resp);
+                                  });
+    }
+    void loginDone(uint32_t gen, int rc, const std::string& resp) {
+        Json::Value v;
+        std::string at;
+        if (parseResponse(rc, resp, v) && v.isMember("authentication_token")) {
+            at = v["authentication_token"].asString();
+        }
+        std::unique_lock<std::mutex> l(lock);
+        if (gen != generation) {
+            return;
+        }
+        if (at == "") {
+            failed("login", rc);
+            return;
+        }
+        pendingToken = at;
+        pendingLifetime = v.isMember("authentication_token_expires_in") ? v["authentication_token_expires_in"].asInt() : TWINKLY_TOKEN_LIFETIME;
+        if (pendingLifetime <= 0) {
+            pendingLifetime = TWINKLY_TOKEN_LIFETIME;
+        }
+        state = State::Verifying;
+        l.unlock();
+
+        CurlManager::INSTANCE.add(baseUrl + "verify", "POST", "", jsonHeaders(at),
+                                  [self = shared_from_this(), gen](int rc, const std::string& resp) {
+                                      self->verifyDone(gen, rc, resp);
+                                  });
+    }
+    void verifyDone(uint32_t gen, int rc, const std::string& resp) {
+        Json::Value v;
+        bool ok = parseResponse(rc, resp, v);
+        std::unique_lock<std::mutex> l(lock);
+        if (gen != generation) {
+            return;
+        }
+        if (!ok) {
+            failed("verify", rc);
+            return;
+        }
+        state = State::EnablingRealtime;
+        std::string at = pendingToken;
+        l.unlock();
+
+        CurlManager::INSTANCE.add(baseUrl + "led/mode", "POST", "{\"mode\": \"rt\"}", jsonHeaders(at),
+                                  [self = shared_from_this(), gen](int rc, const std::string& resp) {
+                                      self->realtimeDone(gen, rc, resp);
+                                  });
+    }
+    void realtimeDone(uint32_t gen, int rc, const std::string& resp) {
+        Json::Value v;
+        bool ok = parseResponse(rc, resp, v);
+        std::unique_lock<std::mutex> l(lock);
+        if (gen != generation) {
+            return;
+        }
+        if (!ok) {
+            failed("realtime mode", rc);
+            return;
+        }
+        authToken = pendingToken;
+        std::vector<uint8_t> bytes = base64Decode(authToken);
+        uint64_t t = 0;
+        memcpy(&t, bytes.data(), std::min(TOKEN_LEN, (int)bytes.size()));
+        token = t;
+        tokenChanged = true;
+        streaming = true;
+
+        long long now = GetTimeMS();
+        // refresh well before the device expires the token
+        expireTime = now + pendingLifetime * 750LL;
+        verifyTime = now + TWINKLY_TOKEN_VALIDATE_TIME * 1000;
+        state = State::Streaming;
+        LogDebug(VB_CHANNELOUT, "Twinkly %s: realtime session ready\n", ipAddress.c_str());
+    }
+    void tokenChecked(uint32_t gen, int rc, const std::string& resp) {
+        if (rc == 0) {
+            // device didn't answer, the periodic check will try again
+            return;
+        }
+        Json::Value v;
+        if (!parseResponse(rc, resp, v)) {
+            std::unique_lock<std::mutex> l(lock);
+            if (gen != generation || state != State::Streaming) {
+                return;
+            }
+            l.unlock();
+            LogDebug(VB_CHANNELOUT, "Twinkly %s: token rejected (%d), logging in again\n", ipAddress.c_str(), rc);
+            login();
+        }
+    }
+    // lock must be held
+    void failed(const char* step, int rc) {
+        state = State::Failed;
+        retryTime = GetTimeMS() + TWINKLY_RETRY_TIME * 1000;
+        LogWarn(VB_CHANNELOUT, "Twinkly %s: %s failed (%d), will retry\n", ipAddress.c_str(), step, rc);
+    }
+
+    const std::string ipAddress;
+    const std::string baseUrl;
+
+    std::mutex lock;
+    bool active = false;
+    uint32_t generation = 0; // bumped on stop so late responses are ignored
+    State state = State::Idle;
+    std::string authToken;
+    std::string pendingToken;
+    int pendingLifetime = TWINKLY_TOKEN_LIFETIME;
+    long long retryTime = 0;
+    long long verifyTime = 0;
+    long long expireTime = 0;
+};
 
 const std::string& TwinklyOutputData::GetOutputTypeString() const {
     return TWINKLYTYPE;
@@ -87,8 +314,11 @@ TwinklyOutputData::TwinklyOutputData(const Json::Value& config) :
             chan += 900;
         }
     }
+    session = std::make_shared<Session>(ipAddress);
 }
 TwinklyOutputData::~TwinklyOutputData() {
+    Timers::INSTANCE.stopPeriodicTimer("Twinkly" + ipAddress);
+    session->stop();
     for (int x = 0; x < portCount; x++) {
         free(twinklyBuffers[x]);
     }
@@ -102,11 +332,14 @@ void TwinklyOutputData::GetRequiredChannelRange(int& min, int& max) {
 }
 
 void TwinklyOutputData::PrepareData(unsigned char* channelData, UDPOutputMessages& msgs) {
-    if (valid && active) {
-        reauthCount++;
-        if (reauthCount > MAXPACKETS) {
-            // need to re-authenticate or lights will stop eventually
-            StartingOutput();
+    // nothing is sent until the REST session has put the device in
+    // realtime mode, re-authentication happens in the background
+    if (valid && active && session->streaming) {
+        if (session->tokenChanged.exchange(false)) {
+            uint64_t t = session->token;
+            for (int x = 0; x < portCount; x++) {
+                memcpy(&twinklyBuffers[x][1], &t, TOKEN_LEN);
+            }
         }
 
         int start = 0;
@@ -146,118 +379,18 @@ void TwinklyOutputData::PrepareData(unsigned char* channelData, UDPOutputMessage
 }
 
 void TwinklyOutputData::StartingOutput() {
-    authenticate();
-    Timers::INSTANCE.addPeriodicTimer("Twinkly" + ipAddress, TWINKLY_TOKEN_VALIDATE_TIME * 1000, [this]() {
-        verifyToken();
+    if (!valid || !active) {
+        return;
+    }
+    session->start();
+    std::shared_ptr<Session> s = session;
+    Timers::INSTANCE.addPeriodicTimer("Twinkly" + ipAddress, TWINKLY_SESSION_CHECK_TIME * 1000, [s]() {
+        s->check();
     });
 }
 void TwinklyOutputData::StoppingOutput() {
-    callRestAPI(true, "xled/v1/led/mode", "{\"mode\": \"off\"}");
-    authToken = "";
     Timers::INSTANCE.stopPeriodicTimer("Twinkly" + ipAddress);
-}
-void TwinklyOutputData::authenticate() {
-    Json::Value r = callRestAPI(true, "xled/v1/login", "{\"challenge\": \"AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8=\"}");
-    try {
-        std::string at = r.isMember("authentication_token") ? r["authentication_token"].asString() : "";
-        if (at != "") {
-            authToken = at;
-            reauthCount = 0;
-            std::vector<uint8_t> at = base64Decode(authToken);
-            memcpy(authTokenBytes, &at[0], std::min(TOKEN_LEN, (int)at.size()));
-            for (int x = 0; x < portCount; x++) {
-                memcpy(&twinklyBuffers[x][1], &at[0], std::min(TOKEN_LEN, (int)at.size()));
-            }
-            callRestAPI(true, "xled/v1/verify", "");
-            callRestAPI(true, "xled/v1/led/mode", "{\"mode\": \"rt\"}");
-        }
-    } catch (std::exception& ex) {
-        //not much we can do other than try authenticating again later
-    }
-}
-void TwinklyOutputData::verifyToken() {
-    std::string url = "http://" + ipAddress + "/xled/v1/verify";
-    std::list<std::string> extraHeaders;
-    std::string xat = "X-Auth-Token: " + authToken;
-    extraHeaders.push_back(xat);
-    CurlManager::INSTANCE.add(url, "GET", "", extraHeaders, [this](int rc, const std::string& resp) {
-        if (rc == 200) {
-            // printf("%d:  %s\n", rc, resp.c_str());
-            try {
-                Json::Value v = LoadJsonFromString(resp);
-                if (v["code"].asInt() != 1000) {
-                    authenticate();
-                }
-            } catch (std::exception& ex) {
-                //ignore this time around, next time hopefully will work
-            }
-        }
-    });
-}
-
-// URL Helpers
-size_t urlWriteData(void* buffer, size_t size, size_t nmemb, void* userp) {
-    std::string* str = (std::string*)userp;
-
-    str->append(static_cast<const char*>(buffer), size * nmemb);
-
-    return size * nmemb;
-}
-Json::Value TwinklyOutputData::callRestAPI(bool isPost, const std::string& path, const std::string& data) {
-    std::string url = "http://" + ipAddress + "/" + path;
-
-    CURL* curl = curl_easy_init();
-    struct curl_slist* headers = NULL;
-    std::string userAgent = "FPP/";
-    userAgent += getFPPVersionTriplet();
-    std::string resp = "";
-
-    CURLcode status;
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, urlWriteData);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &resp);
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1);
-    if (startsWith(data, "{") && endsWith(data, "}")) {
-        headers = curl_slist_append(headers, "Accept: application/json");
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-    }
-    if (authToken != "") {
-        const std::string at = "X-Auth-Token: " + authToken;
-        headers = curl_slist_append(headers, at.c_str());
-    }
-    if (headers) {
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    }
-
-    if (isPost) {
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data.c_str());
-        curl_easy_setopt(curl, CURLOPT_POST, 1);
-    }
-
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, (long)5);
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 2);
-    curl_easy_setopt(curl, CURLOPT_USERAGENT, userAgent.c_str());
-
-    status = curl_easy_perform(curl);
-    if (status != CURLE_OK) {
-        LogErr(VB_GENERAL, "curl_easy_perform() failed: %s\n", curl_easy_strerror(status));
-        return Json::Value();
-    }
-
-    // printf("%s:   %s\n", url.c_str(), resp.c_str());
-    LogDebug(VB_GENERAL, "%s %s resp: %s\n", isPost ? "POST" : "GET", url.c_str(), resp.c_str());
-
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-
-    try {
-        return LoadJsonFromString(resp);
-    } catch (std::exception& ex) {
-        //not sure what to do here.  The only call that uses the return is the authentication
-        //so we'll return an empty json and hope that is good enough
-        return Json::Value();
-    }
-
+    session->stop();
 }
 
 void TwinklyOutputData::DumpConfig() {
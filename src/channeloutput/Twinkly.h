@@ -14,6 +14,7 @@
 #include "UDPOutput.h"
 #include "fpp-json-fwd.h"
 #include <list>
+#include <memory>
 
 #define TWINKLY_PORT 7777
 
@@ -32,10 +33,6 @@ public:
     virtual void StartingOutput() override;
     virtual void StoppingOutput() override;
 
-    Json::Value callRestAPI(bool isPost, const std::string& path, const std::string& body);
-    void verifyToken();
-    void authenticate();
-
     int port = 1;
     int portCount = 1;
 
@@ -44,7 +41,10 @@ public:
     struct iovec* twinklyIovecs = nullptr;
     uint8_t** twinklyBuffers = nullptr;
 
-    uint8_t authTokenBytes[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
-    std::string authToken = "";
-    uint32_t reauthCount = 0;
+private:
+    // REST login/verify/realtime mode handshakes, run asynchronously on the
+    // CurlManager.  Shared with the curl and timer callbacks so they can
+    // outlive the output.
+    class Session;
+    std::shared_ptr<Session> session;
 };
@@ -16,6 +16,7 @@
 
 #ifndef PLATFORM_OSX
 #include <linux/sockios.h>
+#include <netinet/udp.h>
 #include <sys/ioctl.h>
 #endif
 
@@ -36,6 +37,7 @@
 #include "../settings.h"
 
 #include "UDPOutput.h"
+#include "UDPSegmentedMessages.h"
 #include "ping.h"
 
 #include "NetworkMonitor.h"
@@ -253,7 +255,14 @@ UDPOutput::UDPOutput(unsigned int startChannel, unsigned int channelCount) :
     numWorkThreads(0),
     runWorkThreads(true),
     useThreadedOutput(true),
-    blockingOutput(false) {
+    blockingOutput(false),
+    useSegmentOffload(false),
+    segmentOffloadFailed(false),
+    statPackets(0),
+    statDatagrams(0),
+    statCPUNanos(0),
+    statFrames(0),
+    statStartTime(0) {
     INSTANCE = this;
 }
 UDPOutput::~UDPOutput() {
@@ -317,9 +326,15 @@ int UDPOutput::Init(Json::Value config) {
     }
     if (config.isMember("threaded")) {
         int style = config["threaded"].asInt();
-        useThreadedOutput = style == 1 || style == 3;
+        useThreadedOutput = style == 1 || style == 3 || style == 5;
         blockingOutput = style == 0 || style == 1;
+        // 4/5 are the non-blocking modes with same-destination packets
+        // batched into UDP_SEGMENT (GSO) sends
+        useSegmentOffload = style == 4 || style == 5;
     }
+#ifndef UDP_SEGMENT
+    useSegmentOffload = false;
+#endif
     if (config.isMember("interface")) {
         outInterface = config["interface"].asString();
     }
@@ -494,14 +509,116 @@ static void flushBuffers(int socket, int msgs, int total) {
 #endif
 }
 
+static uint64_t GetThreadCPUNanos() {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+int UDPOutput::SendSegmentedMessages(SendSocketInfo* socketInfo, std::vector<struct mmsghdr>& sendmsgs, int& datagrams) {
+#ifdef UDP_SEGMENT
+    // each work thread handles one destination key at a time so the
+    // coalesced message storage can just live per thread
+    thread_local SegmentedMessages segmented;
+    segmented.build(sendmsgs);
+
+    int sendSocket = socketInfo->sockets[socketInfo->curSocket];
+    int msgCount = segmented.msgs.size();
+    int sent = 0;
+    int sourceSent = 0;
+    int errCount = 0;
+    while (sent < msgCount) {
+        errno = 0;
+        int oc = sendmmsg(sendSocket, &segmented.msgs[sent], msgCount - sent, MSG_DONTWAIT);
+        if (oc > 0) {
+            for (int x = sent; x < sent + oc; x++) {
+                sourceSent += segmented.sourceCount[x];
+            }
+            sent += oc;
+            errCount = 0;
+            if (sent < msgCount) {
+                flushBuffers(sendSocket, sent, msgCount);
+            }
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+            if (++errCount >= 10) {
+                break;
+            }
+            flushBuffers(sendSocket, sent, msgCount);
+        } else if (errno == EIO || errno == EINVAL || errno == ENOPROTOOPT || errno == EOPNOTSUPP) {
+            // interface can't do checksum offload or kernel doesn't have UDP GSO,
+            // send the rest (and everything from now on) the normal way
+            if (!segmentOffloadFailed.exchange(true)) {
+                LogWarn(VB_CHANNELOUT, "UDP segmentation offload not available on %s (%s), falling back to sendmmsg\n",
+                        outInterface.c_str(), FPPstrerror(errno));
+            }
+            break;
+        } else {
+            break;
+        }
+    }
+    datagrams = sent;
+    return sourceSent;
+#else
+    return 0;
+#endif
+}
+
+void UDPOutput::UpdateSendStats(uint64_t cpuNanos, int packets, int datagrams) {
+    statCPUNanos += cpuNanos;
+    statPackets += packets;
+    statDatagrams += datagrams;
+}
+
+void UDPOutput::LogSendStats() {
+    ++statFrames;
+    uint64_t now = GetTimeMicros();
+    if (statStartTime == 0) {
+        statStartTime = now;
+        return;
+    }
+    uint64_t elapsed = now - statStartTime;
+    if (elapsed < 10000000) {
+        return;
+    }
+    uint64_t packets = statPackets.exchange(0);
+    uint64_t datagrams = statDatagrams.exchange(0);
+    uint64_t cpu = statCPUNanos.exchange(0);
+    double secs = elapsed / 1000000.0;
+    LogDebug(VB_CHANNELOUT, "UDP Output: %0.1f frames/s, %0.0f packets/s, %0.1f sends/frame, %0.1f us send CPU/frame%s\n",
+             statFrames / secs, packets / secs,
+             (double)datagrams / statFrames, cpu / 1000.0 / statFrames,
+             (useSegmentOffload && !segmentOffloadFailed) ? " (GSO)" : "");
+    statFrames = 0;
+    statStartTime = now;
+}
+
 constexpr int MSGS_PER_SENDMMSG = 8;
 int UDPOutput::SendMessages(unsigned int socketKey, SendSocketInfo* socketInfo, std::vector<struct mmsghdr>& sendmsgs) {
     errno = 0;
-    struct mmsghdr* msgs = &sendmsgs[0];
     int msgCount = sendmsgs.size();
     if (msgCount == 0) {
         return 0;
     }
+    uint64_t cpuStart = GetThreadCPUNanos();
+    int outputCount = 0;
+    int datagrams = 0;
+    if (useSegmentOffload && !segmentOffloadFailed && !blockingOutput) {
+        outputCount = SendSegmentedMessages(socketInfo, sendmsgs, datagrams);
+    }
+    if (outputCount != msgCount) {
+        int oc = SendMessages(socketKey, socketInfo, &sendmsgs[outputCount], msgCount - outputCount);
+        outputCount += oc;
+        datagrams += oc;
+    }
+    UpdateSendStats(GetThreadCPUNanos() - cpuStart, outputCount, datagrams);
+    return outputCount;
+}
+
+int UDPOutput::SendMessages(unsigned int socketKey, SendSocketInfo* socketInfo, struct mmsghdr* msgs, int msgCount) {
+    errno = 0;
 
     int newSockKey = socketKey;
     int sendSocket = socketInfo->sockets[socketInfo->curSocket];
@@ -718,6 +835,7 @@ int UDPOutput::SendData(unsigned char* channelData) {
                 }
             }
         }
+        LogSendStats();
         return 1;
     }
     for (auto& msgs : messages.messages) {
@@ -747,6 +865,7 @@ int UDPOutput::SendData(unsigned char* channelData) {
             }
         }
     }
+    LogSendStats();
     return 1;
 }
 
@@ -815,6 +934,7 @@ void UDPOutput::DumpConfig() {
     LogDebug(VB_CHANNELOUT, "    Interface        : %s\n", outInterface.c_str());
     LogDebug(VB_CHANNELOUT, "    Threaded         : %d\n", useThreadedOutput);
     LogDebug(VB_CHANNELOUT, "    Blocking         : %d\n", blockingOutput);
+    LogDebug(VB_CHANNELOUT, "    Segment Offload  : %d\n", useSegmentOffload);
     LogDebug(VB_CHANNELOUT, "    Needs Broadcast  : %d\n", needsBroadcast);
     for (auto u : outputs) {
         u->DumpConfig();
@@ -867,6 +987,10 @@ int UDPOutput::createSocket(int port, bool broadCast, bool multiCast) {
     }
     // make sure the send buffer is actually set to a reasonable size for non-blocking mode
     int bufSize = (blockingOutput ? 4096 : (MSGS_PER_SENDMMSG * 1511)) - 1;
+    if (useSegmentOffload && !blockingOutput) {
+        // a single GSO send can be up to 64K so need room for a couple of them
+        bufSize = 2 * 65536;
+    }
     setsockopt(sendSocket, SOL_SOCKET, SO_SNDBUF, &bufSize, sizeof(bufSize));
     // these sockets are for sending only, don't need a large receive buffer so
     // free some memory by setting to just a single page
@@ -138,6 +138,10 @@ public:
 
 private:
     int SendMessages(unsigned int key, SendSocketInfo* socketInfo, std::vector<struct mmsghdr>& sendmsgs);
+    int SendMessages(unsigned int key, SendSocketInfo* socketInfo, struct mmsghdr* msgs, int msgCount);
+    int SendSegmentedMessages(SendSocketInfo* socketInfo, std::vector<struct mmsghdr>& sendmsgs, int& datagrams);
+    void UpdateSendStats(uint64_t cpuNanos, int packets, int datagrams);
+    void LogSendStats();
     struct sockaddr_in localAddress;
     std::string outInterface;
     bool needsBroadcast = false;
@@ -178,4 +182,17 @@ private:
     volatile bool runWorkThreads;
     bool useThreadedOutput;
     bool blockingOutput;
+
+    // UDP_SEGMENT (GSO) batching of same-destination packets, disabled
+    // at runtime if the kernel or interface rejects it
+    bool useSegmentOffload;
+    std::atomic_bool segmentOffloadFailed;
+
+    // send statistics, logged periodically at debug level.  With GSO a
+    // datagram may carry many packets so the ratio shows the batching
+    std::atomic<uint64_t> statPackets;
+    std::atomic<uint64_t> statDatagrams;
+    std::atomic<uint64_t> statCPUNanos;
+    uint64_t statFrames;
+    uint64_t statStartTime;
 };
@@ -0,0 +1,135 @@
+#pragma once
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the GPL v2 as described in the
+ * included LICENSE.GPL file.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#ifndef PLATFORM_OSX
+#include <netinet/udp.h>
+#endif
+
+#ifdef UDP_SEGMENT
+/*
+ * Coalesces runs of same-destination, same-size messages into single
+ * UDP_SEGMENT (GSO) sends.  Used by UDPOutput and tests/native/udp_gso_bench.
+ */
+class SegmentedMessages {
+public:
+    // The kernel caps a single GSO send at 64 segments and the datagram
+    // itself at 64K
+    static constexpr int MAX_GSO_SEGMENTS = 64;
+    static constexpr int MAX_GSO_BYTES = 65000;
+
+    static size_t MessageLength(const struct mmsghdr& msg) {
+        size_t len = 0;
+        for (int x = 0; x < msg.msg_hdr.msg_iovlen; x++) {
+            len += msg.msg_hdr.msg_iov[x].iov_len;
+        }
+        return len;
+    }
+    static bool SameDestination(const struct mmsghdr& a, const struct mmsghdr& b) {
+        if (a.msg_hdr.msg_name == b.msg_hdr.msg_name) {
+            return true;
+        }
+        if (a.msg_hdr.msg_name == nullptr || b.msg_hdr.msg_name == nullptr || a.msg_hdr.msg_namelen != b.msg_hdr.msg_namelen) {
+            return false;
+        }
+        const sockaddr_in* aa = (const sockaddr_in*)a.msg_hdr.msg_name;
+        const sockaddr_in* ba = (const sockaddr_in*)b.msg_hdr.msg_name;
+        return aa->sin_addr.s_addr == ba->sin_addr.s_addr && aa->sin_port == ba->sin_port;
+    }
+
+    std::vector<struct mmsghdr> msgs;
+    std::vector<struct iovec> iovecs;
+    std::vector<char> control;
+    std::vector<int> sourceCount; // number of original messages in each msgs entry
+
+    void build(std::vector<struct mmsghdr>& src) {
+        msgs.clear();
+        iovecs.clear();
+        sourceCount.clear();
+
+        // first pass, figure out the runs so the iovec/control storage
+        // can be sized once and not move while we take pointers into it
+        struct Run {
+            int start;
+            int count;
+            size_t segSize;
+        };
+        std::vector<Run> runs;
+        size_t iovTotal = 0;
+        int idx = 0;
+        while (idx < src.size()) {
+            Run r = { idx, 1, MessageLength(src[idx]) };
+            size_t total = r.segSize;
+            // a message that already carries control data can't take the
+            // UDP_SEGMENT cmsg as well, it's sent on its own unchanged
+            bool canSegment = src[idx].msg_hdr.msg_controllen == 0;
+            iovTotal += src[idx].msg_hdr.msg_iovlen;
+            ++idx;
+            while (canSegment && idx < src.size() && r.count < MAX_GSO_SEGMENTS && SameDestination(src[r.start], src[idx])) {
+                size_t len = MessageLength(src[idx]);
+                // all segments but the last must be exactly segSize
+                if (len > r.segSize || (total + len) > MAX_GSO_BYTES || src[idx].msg_hdr.msg_controllen) {
+                    break;
+                }
+                total += len;
+                iovTotal += src[idx].msg_hdr.msg_iovlen;
+                ++r.count;
+                ++idx;
+                if (len < r.segSize) {
+                    break;
+                }
+            }
+            runs.push_back(r);
+        }
+        iovecs.resize(iovTotal);
+        control.resize(runs.size() * CMSG_SPACE(sizeof(uint16_t)));
+        memset(control.data(), 0, control.size());
+
+        size_t iovIdx = 0;
+        for (int r = 0; r < runs.size(); r++) {
+            const Run& run = runs[r];
+            if (run.count == 1) {
+                msgs.push_back(src[run.start]);
+                sourceCount.push_back(1);
+                continue;
+            }
+            struct mmsghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_hdr.msg_name = src[run.start].msg_hdr.msg_name;
+            msg.msg_hdr.msg_namelen = src[run.start].msg_hdr.msg_namelen;
+            msg.msg_hdr.msg_iov = &iovecs[iovIdx];
+            for (int m = run.start; m < run.start + run.count; m++) {
+                for (int i = 0; i < src[m].msg_hdr.msg_iovlen; i++) {
+                    iovecs[iovIdx++] = src[m].msg_hdr.msg_iov[i];
+                    ++msg.msg_hdr.msg_iovlen;
+                }
+            }
+            char* cbuf = &control[r * CMSG_SPACE(sizeof(uint16_t))];
+            msg.msg_hdr.msg_control = cbuf;
+            msg.msg_hdr.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+            struct cmsghdr* cm = CMSG_FIRSTHDR(&msg.msg_hdr);
+            cm->cmsg_level = SOL_UDP;
+            cm->cmsg_type = UDP_SEGMENT;
+            cm->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            uint16_t segSize = run.segSize;
+            memcpy(CMSG_DATA(cm), &segSize, sizeof(segSize));
+            msgs.push_back(msg);
+            sourceCount.push_back(run.count);
+        }
+    }
+};
+#endif
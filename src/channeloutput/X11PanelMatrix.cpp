@@ -191,6 +191,10 @@ int X11PanelMatrixOutput::Init(Json::Value config) {
     else
         m_title = "X11PanelMatrix";
 
+    m_gather.Build(m_panelMatrix, m_startChannel, m_outputs, m_longestChain,
+                   m_panelWidth, m_panelHeight, false);
+    m_gatherBuffer.resize(m_outputs * m_gather.OutputBytes());
+
     m_scaleWidth = m_width * m_scale;
     m_scaleHeight = m_height * m_scale;
     m_imageData = (char*)calloc(m_scaleWidth * m_scaleHeight * 4, 1);
@@ -275,16 +279,17 @@ int X11PanelMatrixOutput::Close(void) {
 int X11PanelMatrixOutput::RawSendData(unsigned char* channelData) {
     LogExcess(VB_CHANNELOUT, "X11PanelMatrixOutput::RawSendData(%p)\n",
               channelData);
-    m_matrix->OverlaySubMatrices(channelData);
+    m_gather.UpdateSubMatrices(m_matrix, channelData);
+
+    int outputBytes = m_gather.OutputBytes();
+    int rowBytes = m_gather.RowBytes();
+    m_gather.ForEachOutput([this, channelData, outputBytes](int output) {
+        m_gather.GatherOutput(output, channelData, &m_gatherBuffer[output * outputBytes], m_gammaCurve);
+    });
 
-    unsigned char r;
-    unsigned char g;
-    unsigned char b;
     unsigned char* c;
     unsigned int stride = m_scaleWidth * 4;
 
-    channelData += m_startChannel;
-
     for (int output = 0; output < m_outputs; output++) {
         int panelsOnOutput = m_panelMatrix->m_outputPanels[output].size();
 
@@ -293,20 +298,20 @@ int X11PanelMatrixOutput::RawSendData(unsigned char* channelData) {
             int chain = m_panelMatrix->m_panels[panel].chain;
             int py = m_panelMatrix->m_panels[panel].yOffset;
             int px = m_panelMatrix->m_panels[panel].xOffset;
-            for (int y = 0; y < m_panelHeight; y++) {
-                int yw = y * m_panelWidth;
-                for (int x = 0; x < m_panelWidth; x++) {
-                    r = m_gammaCurve[channelData[m_panelMatrix->m_panels[panel].pixelMap[(yw + x) * 3]]];
-                    g = m_gammaCurve[channelData[m_panelMatrix->m_panels[panel].pixelMap[(yw + x) * 3 + 1]]];
-                    b = m_gammaCurve[channelData[m_panelMatrix->m_panels[panel].pixelMap[(yw + x) * 3 + 2]]];
-
+            if (chain < 0 || chain >= m_longestChain) {
+                continue;
+            }
+            const uint8_t* src = &m_gatherBuffer[output * outputBytes + chain * m_panelWidth * 3];
+            for (int y = 0; y < m_panelHeight; y++, src += rowBytes) {
+                const uint8_t* s = src;
+                for (int x = 0; x < m_panelWidth; x++, s += 3) {
                     c = (unsigned char*)m_imageData + ((py + y) * m_scale * stride) + ((px + x) * 4 * m_scale);
 
                     for (unsigned int t = 0; t < m_scale; t++) {
-                        for (unsigned int s = 0; s < m_scale; s++) {
-                            *(c++) = b;
-                            *(c++) = g;
-                            *(c++) = r;
+                        for (unsigned int u = 0; u < m_scale; u++) {
+                            *(c++) = s[2];
+                            *(c++) = s[1];
+                            *(c++) = s[0];
                             c++;
                         }
                         c += stride - (m_scale * 4);
@@ -17,6 +17,7 @@
 #include <string>
 
 #include "Matrix.h"
+#include "PanelGather.h"
 #include "PanelMatrix.h"
 
 #include "ThreadedChannelOutput.h"
@@ -55,6 +56,8 @@ private:
 
     Matrix* m_matrix;
     PanelMatrix* m_panelMatrix;
+    PanelGather m_gather;
+    std::vector<uint8_t> m_gatherBuffer;
 
     uint8_t m_gammaCurve[256];
 
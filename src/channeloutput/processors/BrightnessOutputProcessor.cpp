@@ -61,3 +61,10 @@ void BrightnessOutputProcessor::ProcessData(unsigned char* channelData) const {
         channelData[start + x] = table[channelData[start + x]];
     }
 }
+
+bool BrightnessOutputProcessor::getLookupTable(int& rangeStart, int& rangeCount, unsigned char* lut) const {
+    rangeStart = start;
+    rangeCount = count;
+    memcpy(lut, table, 256);
+    return true;
+}
@@ -44,3 +44,12 @@ void ClampValueOutputProcessor::ProcessData(unsigned char* channelData) const {
         }
     }
 }
+
+bool ClampValueOutputProcessor::getLookupTable(int& rangeStart, int& rangeCount, unsigned char* lut) const {
+    rangeStart = start;
+    rangeCount = count;
+    for (int x = 0; x < 256; x++) {
+        lut[x] = (x > value) ? static_cast<unsigned char>(value) : x;
+    }
+    return true;
+}
@@ -42,9 +42,42 @@ OutputProcessors::~OutputProcessors() {
 
 void OutputProcessors::ProcessData(unsigned char* channelData) const {
     std::lock_guard<std::mutex> lock(processorsLock);
-    for (OutputProcessor* a : processors) {
-        if (a->isActive()) {
-            a->ProcessData(channelData);
+    for (const PlanStep& step : plan) {
+        if (step.processor) {
+            step.processor->ProcessData(channelData);
+            continue;
+        }
+
+        for (const LookupRange& l : step.lookups) {
+            unsigned char* data = channelData + l.start;
+            if (l.table == -1) {
+                memset(data, l.value, l.count);
+            } else {
+                const unsigned char* table = lookupTables[l.table].data();
+                for (int x = 0; x < l.count; x++) {
+                    data[x] = table[data[x]];
+                }
+            }
+        }
+
+        for (const CopyRun& c : step.copies) {
+            unsigned char* dst = channelData + c.dst;
+            const unsigned char* src = channelData + c.src;
+            if (c.pixelSize == 0) {
+                memcpy(dst, src, c.count);
+            } else if (c.pixelSize == 1) {
+                for (int x = 0; x < c.count; x++) {
+                    dst[x] = src[c.count - 1 - x];
+                }
+            } else {
+                int ps = c.pixelSize;
+                for (int x = 0; x + ps <= c.count; x += ps) {
+                    const unsigned char* s = src + c.count - ps - x;
+                    for (int p = 0; p < ps; p++) {
+                        dst[x + p] = s[p];
+                    }
+                }
+            }
         }
     }
 }
@@ -55,10 +88,12 @@ void OutputProcessors::addProcessor(OutputProcessor* p) {
     }
     std::lock_guard<std::mutex> lock(processorsLock);
     processors.push_back(p);
+    compile();
 }
 void OutputProcessors::removeProcessor(OutputProcessor* p) {
     std::lock_guard<std::mutex> lock(processorsLock);
     processors.remove(p);
+    compile();
 }
 void OutputProcessors::removeAll() {
     std::lock_guard<std::mutex> lock(processorsLock);
@@ -66,20 +101,11 @@ void OutputProcessors::removeAll() {
         delete a;
     }
     processors.clear();
+    compile();
 }
 
 void OutputProcessors::loadFromJSON(const Json::Value& config) {
-    // If we are reloading, remove all existing processors first
-    // But only the ones created from JSON, plugins may have added their own
-    // and we don't want to remove those.
-    std::unique_lock<std::mutex> lock(processorsLock);
-    for (auto a : fromJsonProcessors) {
-        processors.remove(a);
-        delete a;
-    }
-    fromJsonProcessors.clear();
-    lock.unlock();
-
+    std::list<OutputProcessor*> newProcessors;
     for (Json::Value::const_iterator itr = config.begin(); itr != config.end(); ++itr) {
         std::string name = itr.key().asString();
         if (name == "outputProcessors") {
@@ -87,21 +113,205 @@ void OutputProcessors::loadFromJSON(const Json::Value& config) {
             if (val.isArray()) {
                 for (int x = 0; x < val.size(); x++) {
                     OutputProcessor* p = create(val[x]);
-                    addProcessor(p);
-                    lock.lock();
-                    fromJsonProcessors.push_back(p);
-                    lock.unlock();
+                    if (p) {
+                        newProcessors.push_back(p);
+                    }
                 }
             } else {
                 OutputProcessor* p = create(val);
-                addProcessor(p);
-                lock.lock();
-                fromJsonProcessors.push_back(p);
-                lock.unlock();
+                if (p) {
+                    newProcessors.push_back(p);
+                }
+            }
+        }
+    }
+
+    // If we are reloading, remove all existing processors first
+    // But only the ones created from JSON, plugins may have added their own
+    // and we don't want to remove those.  The plan points at the old
+    // processors so it is rebuilt before the lock is released.
+    std::lock_guard<std::mutex> lock(processorsLock);
+    for (auto a : fromJsonProcessors) {
+        processors.remove(a);
+        delete a;
+    }
+    fromJsonProcessors.clear();
+    for (auto p : newProcessors) {
+        processors.push_back(p);
+        fromJsonProcessors.push_back(p);
+    }
+    compile();
+}
+
+/*
+ * Flatten the processor list into a plan.  Runs of adjacent lookup table
+ * style processors (Brightness, Scale, Clamp, Set Value, Override Zero)
+ * are composed into a single table per distinct channel range so each
+ * channel is only touched once no matter how many of them are stacked.
+ * Runs of adjacent Remaps become a single list of block copies as long as
+ * none of them read from a range an earlier one in the run has written.
+ * Anything else runs as-is, in order.
+ */
+void OutputProcessors::compile() {
+    plan.clear();
+    lookupTables.clear();
+
+    std::vector<OutputProcessor*> active;
+    for (OutputProcessor* a : processors) {
+        if (a->isActive()) {
+            active.push_back(a);
+        }
+    }
+
+    struct TableRange {
+        int start;
+        int count;
+        std::array<unsigned char, 256> table;
+    };
+    std::vector<TableRange> tableRun;
+    std::vector<std::pair<int, int>> written;
+    bool inRemapRun = false;
+
+    auto flushTables = [&]() {
+        if (tableRun.empty()) {
+            return;
+        }
+        std::vector<int> bounds;
+        for (auto& t : tableRun) {
+            bounds.push_back(t.start);
+            bounds.push_back(t.start + t.count);
+        }
+        std::sort(bounds.begin(), bounds.end());
+        bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+        PlanStep step;
+        for (int b = 0; b + 1 < bounds.size(); b++) {
+            int s = bounds[b];
+            std::array<unsigned char, 256> table;
+            for (int v = 0; v < 256; v++) {
+                table[v] = v;
+            }
+            bool covered = false;
+            for (auto& t : tableRun) {
+                if ((s >= t.start) && (s < (t.start + t.count))) {
+                    for (int v = 0; v < 256; v++) {
+                        table[v] = t.table[table[v]];
+                    }
+                    covered = true;
+                }
+            }
+            if (!covered) {
+                continue;
+            }
+
+            bool identity = true;
+            bool constant = true;
+            for (int v = 0; v < 256; v++) {
+                identity &= (table[v] == v);
+                constant &= (table[v] == table[0]);
+            }
+            if (identity) {
+                continue;
+            }
+
+            int tableIdx = -1;
+            if (!constant) {
+                if (lookupTables.empty() || lookupTables.back() != table) {
+                    lookupTables.push_back(table);
+                }
+                tableIdx = lookupTables.size() - 1;
+            }
+
+            int count = bounds[b + 1] - s;
+            if (!step.lookups.empty()) {
+                LookupRange& prev = step.lookups.back();
+                if ((prev.start + prev.count == s) && (prev.table == tableIdx) && (constant ? (prev.value == table[0]) : true)) {
+                    prev.count += count;
+                    continue;
+                }
+            }
+            step.lookups.push_back({ s, count, tableIdx, table[0] });
+        }
+        if (!step.lookups.empty()) {
+            plan.push_back(std::move(step));
+        }
+        tableRun.clear();
+    };
+    auto endRemapRun = [&]() {
+        inRemapRun = false;
+        written.clear();
+    };
+    auto overlaps = [](int s1, int c1, int s2, int c2) {
+        return (s1 < (s2 + c2)) && (s2 < (s1 + c1));
+    };
+
+    for (OutputProcessor* a : active) {
+        TableRange t;
+        if (a->getLookupTable(t.start, t.count, t.table.data())) {
+            endRemapRun();
+            if (t.count > 0) {
+                tableRun.push_back(t);
             }
+            continue;
         }
+        flushTables();
+
+        RemapOutputProcessor* r = (a->getType() == OutputProcessor::REMAP) ? dynamic_cast<RemapOutputProcessor*>(a) : nullptr;
+        if (r) {
+            int src = r->getSourceChannel();
+            int dst = r->getDestChannel();
+            int count = r->getCount();
+            int loops = r->getLoops();
+            int pixelSize = 0;
+            if ((count > 1) && r->getReverse()) {
+                pixelSize = (r->getReverse() == 1) ? 1 : (r->getReverse() + 1);
+            }
+
+            // Reading from its own destination, or a partial pixel at
+            // the end of a pixel reverse, relies on the exact copy order
+            // so leave those alone
+            bool fusable = (count > 0) && (loops > 0) && (r->getReverse() >= 0) && (r->getReverse() <= 3) &&
+                           !overlaps(src, count, dst, count * loops) &&
+                           ((pixelSize < 3) || ((count % pixelSize) == 0));
+            if (fusable) {
+                for (auto& w : written) {
+                    if (overlaps(src, count, w.first, w.second)) {
+                        endRemapRun();
+                        break;
+                    }
+                }
+                if (!inRemapRun) {
+                    plan.emplace_back();
+                    inRemapRun = true;
+                }
+                std::vector<CopyRun>& copies = plan.back().copies;
+                for (int l = 0; l < loops; l++) {
+                    int d = dst + (l * count);
+                    if (!copies.empty() && (pixelSize == 0)) {
+                        CopyRun& prev = copies.back();
+                        if ((prev.pixelSize == 0) && (prev.dst + prev.count == d) && (prev.src + prev.count == src)) {
+                            prev.count += count;
+                            continue;
+                        }
+                    }
+                    copies.push_back({ d, src, count, pixelSize });
+                }
+                written.push_back({ dst, count * loops });
+                continue;
+            }
+        }
+
+        endRemapRun();
+        PlanStep step;
+        step.processor = a;
+        plan.push_back(std::move(step));
     }
+    flushTables();
+
+    LogDebug(VB_CHANNELOUT, "OutputProcessors: %d active processors compiled into %d steps with %d lookup tables\n",
+             (int)active.size(), (int)plan.size(), (int)lookupTables.size());
 }
+
 OutputProcessor* OutputProcessors::create(const Json::Value& config) {
     int active = config["active"].asInt();
     if (active == 1) {
@@ -13,7 +13,9 @@
 
 #include "../../Sequence.h"
 #include "fpp-json-fwd.h"
+#include <array>
 #include <functional>
+#include <vector>
 
 class OutputProcessor {
 public:
@@ -22,6 +24,11 @@ public:
 
     virtual void ProcessData(unsigned char* channelData) const = 0;
 
+    // Processors that map each channel's value independently of every
+    // other channel can describe themselves as a 256 entry lookup table
+    // over a single range so runs of them can be composed into one pass.
+    virtual bool getLookupTable(int& rangeStart, int& rangeCount, unsigned char* lut) const { return false; }
+
     bool isActive() { return active; }
 
     enum OutputProcessorType {
@@ -72,9 +79,40 @@ protected:
     void removeAll();
     OutputProcessor* create(const Json::Value& config);
 
+    // Rebuild plan from processors, must be called with processorsLock
+    // held any time the list of processors changes
+    void compile();
+
+    // A range of channels run through a composed lookup table, or filled
+    // with a constant if table is -1
+    struct LookupRange {
+        int start;
+        int count;
+        int table;
+        unsigned char value;
+    };
+    // A single block copy from a run of remaps.  pixelSize 0 is a straight
+    // copy, 1 reverses the channels, 3/4 reverse RGB/RGBW pixels.
+    struct CopyRun {
+        int dst;
+        int src;
+        int count;
+        int pixelSize;
+    };
+    // Each step either runs a processor that can't be fused, or the fused
+    // lookups/copies from a run of adjacent processors
+    struct PlanStep {
+        OutputProcessor* processor = nullptr;
+        std::vector<LookupRange> lookups;
+        std::vector<CopyRun> copies;
+    };
+
     mutable std::mutex processorsLock;
     std::list<OutputProcessor*> processors;
     std::list<OutputProcessor*> fromJsonProcessors;
+
+    std::vector<PlanStep> plan;
+    std::vector<std::array<unsigned char, 256>> lookupTables;
 };
 
 void ProcessModelConfig(const Json::Value& config, std::string& model, int& start, int& count);
@@ -39,3 +39,13 @@ void OverrideZeroOutputProcessor::ProcessData(unsigned char* channelData) const
         }
     }
 }
+
+bool OverrideZeroOutputProcessor::getLookupTable(int& rangeStart, int& rangeCount, unsigned char* lut) const {
+    rangeStart = start;
+    rangeCount = count;
+    lut[0] = value;
+    for (int x = 1; x < 256; x++) {
+        lut[x] = x;
+    }
+    return true;
+}
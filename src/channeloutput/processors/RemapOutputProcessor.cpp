@@ -36,6 +36,10 @@ RemapOutputProcessor::RemapOutputProcessor(const Json::Value& config) {
 
     // channel numbers need to be 0 based
     --destChannel;
+
+    if (reverse && (count > 1)) {
+        tempBuffer = std::make_unique<unsigned char[]>(count);
+    }
 }
 
 RemapOutputProcessor::RemapOutputProcessor(int src, int dst, int c, int l, int r) {
@@ -45,6 +49,10 @@ RemapOutputProcessor::RemapOutputProcessor(int src, int dst, int c, int l, int r
     count = c;
     loops = l;
     reverse = r;
+
+    if (reverse && (count > 1)) {
+        tempBuffer = std::make_unique<unsigned char[]>(count);
+    }
 }
 
 RemapOutputProcessor::~RemapOutputProcessor() {
@@ -75,13 +83,10 @@ void RemapOutputProcessor::ProcessData(unsigned char* channelData) const {
             if (count > 1) {
                 if (!l) { // First loop, reverse while copying
                     // Copy the required section of channel data to a temporary buffer
-                    unsigned char* tempBuffer = new unsigned char[count];
-                    memcpy(tempBuffer, channelData + sourceChannel, count);
+                    memcpy(tempBuffer.get(), channelData + sourceChannel, count);
                     for (int c = 0; c < count; c++) {
                         channelData[destChannel + c] = tempBuffer[count - 1 - c];
                     }
-                    // Delete the temporary buffer
-                    delete[] tempBuffer;
                 } else { // Subsequent loops, just copy first reversed block for speed
                     memcpy(channelData + destChannel + (l * count),
                            channelData + destChannel,
@@ -98,16 +103,13 @@ void RemapOutputProcessor::ProcessData(unsigned char* channelData) const {
             if (count > 1) {
                 if (!l) { // First loop, reverse pixels while copying
                     // Copy the required section of channel data to a temporary buffer
-                    unsigned char* tempBuffer = new unsigned char[count];
-                    memcpy(tempBuffer, channelData + sourceChannel, count);
+                    memcpy(tempBuffer.get(), channelData + sourceChannel, count);
                     for (int c = 0; c < count - 2;) {
                         channelData[destChannel + c + 0] = tempBuffer[count - 1 - c - 2];
                         channelData[destChannel + c + 1] = tempBuffer[count - 1 - c - 1];
                         channelData[destChannel + c + 2] = tempBuffer[count - 1 - c - 0];
                         c += 3;
                     }
-                    // Delete the temporary buffer
-                    delete[] tempBuffer;
                 } else { // Subsequent loops, just copy first reversed block for speed
                     memcpy(channelData + destChannel + (l * count),
                            channelData + destChannel,
@@ -125,8 +127,7 @@ void RemapOutputProcessor::ProcessData(unsigned char* channelData) const {
             if (count > 1) {
                 if (!l) { // First loop, reverse pixels while copying
                     // Copy the required section of channel data to a temporary buffer
-                    unsigned char* tempBuffer = new unsigned char[count];
-                    memcpy(tempBuffer, channelData + sourceChannel, count);
+                    memcpy(tempBuffer.get(), channelData + sourceChannel, count);
                     for (int c = 0; c < count - 3;) {
                         channelData[destChannel + c + 0] = tempBuffer[count - 1 - c - 3];
                         channelData[destChannel + c + 1] = tempBuffer[count - 1 - c - 2];
@@ -134,8 +135,6 @@ void RemapOutputProcessor::ProcessData(unsigned char* channelData) const {
                         channelData[destChannel + c + 3] = tempBuffer[count - 1 - c - 0];
                         c += 4;
                     }
-                    // Delete the temporary buffer
-                    delete[] tempBuffer;
                 } else { // Subsequent loops, just copy first reversed block for speed
                     memcpy(channelData + destChannel + (l * count),
                            channelData + destChannel,
@@ -11,6 +11,8 @@
  * included LICENSE.LGPL file.
  */
 
+#include <memory>
+
 #include "OutputProcessor.h"
 #include "fpp-json-fwd.h"
 
@@ -39,4 +41,7 @@ protected:
     int loops;
     int reverse;
     std::string model;
+
+    // scratch space for reversing in place, allocated once up front
+    std::unique_ptr<unsigned char[]> tempBuffer;
 };
@@ -58,3 +58,10 @@ void ScaleValueOutputProcessor::ProcessData(unsigned char* channelData) const {
         channelData[start + x] = table[channelData[start + x]];
     }
 }
+
+bool ScaleValueOutputProcessor::getLookupTable(int& rangeStart, int& rangeCount, unsigned char* lut) const {
+    rangeStart = start;
+    rangeCount = count;
+    memcpy(lut, table, 256);
+    return true;
+}
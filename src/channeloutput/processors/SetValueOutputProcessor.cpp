@@ -36,3 +36,10 @@ SetValueOutputProcessor::~SetValueOutputProcessor() {
 void SetValueOutputProcessor::ProcessData(unsigned char* channelData) const {
     memset(channelData + start, value, count);
 }
+
+bool SetValueOutputProcessor::getLookupTable(int& rangeStart, int& rangeCount, unsigned char* lut) const {
+    rangeStart = start;
+    rangeCount = count;
+    memset(lut, value, 256);
+    return true;
+}
@@ -20,6 +20,7 @@ public:
     virtual ~SetValueOutputProcessor();
 
     virtual void ProcessData(unsigned char* channelData) const override;
+    virtual bool getLookupTable(int& rangeStart, int& rangeCount, unsigned char* lut) const override;
 
     virtual OutputProcessorType getType() const override { return SETVALUE; }
 
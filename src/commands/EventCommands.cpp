@@ -151,6 +151,7 @@ StartEffectCommand::StartEffectCommand() :
     args.push_back(CommandArg("bg", "bool", "Background"));
     args.push_back(CommandArg("ifNotRunning", "bool", "If Not Running", true).setDefaultValue("false"));
     args.push_back(CommandArg("Model", "string", "Model").setContentListUrl("api/models?simple=true", true));
+    args.push_back(CommandArg("blend", "string", "Blend Mode", true).setContentList({ "Replace", "Max", "Additive" }).setDefaultValue("Replace"));
 }
 std::unique_ptr<Command::Result> StartEffectCommand::run(const std::vector<std::string>& args) {
     if (args.empty()) {
@@ -163,6 +164,7 @@ std::unique_ptr<Command::Result> StartEffectCommand::run(const std::vector<std::
     bool iNR = false;
     bool isRunning = false;
     std::string Model = "";
+    EffectBlendMode blend = EffectBlendMode::Replace;
 
     if (args.size() > 1) {
         startChannel = std::atoi(args[1].c_str());
@@ -190,6 +192,9 @@ std::unique_ptr<Command::Result> StartEffectCommand::run(const std::vector<std::
             }
         }
     }
+    if (args.size() > 6) {
+        blend = EffectBlendModeFromString(args[6]);
+    }
 
     const Json::Value RunningEffects = GetRunningEffectsJson();
 
@@ -204,7 +209,7 @@ std::unique_ptr<Command::Result> StartEffectCommand::run(const std::vector<std::
         }
     }
 
-    StartEffect(args[0], startChannel, loop, bg);
+    StartEffect(args[0], startChannel, loop, bg, blend);
     return std::make_unique<Command::Result>("Effect Started");
 }
 
@@ -213,6 +218,7 @@ StartFSEQAsEffectCommand::StartFSEQAsEffectCommand() :
     args.push_back(CommandArg("effect", "string", "FSEQ Name").setContentListUrl("api/sequence"));
     args.push_back(CommandArg("loop", "bool", "Loop Effect").setDefaultValue("true"));
     args.push_back(CommandArg("bg", "bool", "Background"));
+    args.push_back(CommandArg("blend", "string", "Blend Mode", true).setContentList({ "Replace", "Max", "Additive" }).setDefaultValue("Replace"));
 }
 std::unique_ptr<Command::Result> StartFSEQAsEffectCommand::run(const std::vector<std::string>& args) {
     if (args.empty()) {
@@ -221,6 +227,7 @@ std::unique_ptr<Command::Result> StartFSEQAsEffectCommand::run(const std::vector
 
     bool loop = false;
     bool bg = false;
+    EffectBlendMode blend = EffectBlendMode::Replace;
 
     if (args.size() > 1) {
         loop = args[1] == "true" || args[1] == "1";
@@ -228,7 +235,10 @@ std::unique_ptr<Command::Result> StartFSEQAsEffectCommand::run(const std::vector
     if (args.size() > 2) {
         bg = args[2] == "true" || args[2] == "1";
     }
-    StartFSEQAsEffect(args[0], loop, bg);
+    if (args.size() > 3) {
+        blend = EffectBlendModeFromString(args[3]);
+    }
+    StartFSEQAsEffect(args[0], loop, bg, blend);
     return std::make_unique<Command::Result>("Effect Started");
 }
 
@@ -41,6 +41,7 @@
 #include "EPollManager.h"
 #include "FileMonitor.h"
 #include "Sequence.h"
+#include "Timers.h"
 #include "Warnings.h"
 #include "common.h"
 #include "e131defs.h"
@@ -153,6 +154,57 @@ static std::set<int> joinedSyncUniverses;
 
 static bool bridgeDataReceived = false;
 
+// Frame assembly.  Network input data is staged and only handed to the
+// sequence (followed by a single forced output) once a whole frame has
+// arrived so a frame spread across many universes isn't output partially
+// or torn across an output boundary.  A frame is complete when:
+//   - an E1.31 sync packet arrives (for data packets advertising a sync address)
+//   - an ArtSync arrives
+//   - a DDP packet with the push flag arrives
+//   - otherwise, every universe seen in the previous frame has arrived again
+//     or a universe repeats before that happens
+// Each protocol's sync is only honored while the sender is actually sending
+// it, if no sync is seen for BRIDGE_SYNC_HOLD_MS the data falls back to the
+// universe set (Art-Net uses the same 4 second rule).  If a frame doesn't
+// complete within the timeout (adapted to the incoming frame rate) whatever
+// has been received is released anyway.
+#define BRIDGE_SYNC_HOLD_MS 4000
+#define BRIDGE_FRAME_TIMEOUT_MIN_MS 5
+#define BRIDGE_FRAME_TIMEOUT_MAX_MS 100
+
+enum class BridgeFrameRelease {
+    SYNC,
+    COMPLETE,
+    REPEAT,
+    SYNC_MISSED, // sync gated frame, a universe repeated before the sync
+    TIMEOUT
+};
+
+static bool frameAssemblyEnabled = true;
+static std::vector<uint8_t> stagedData;
+static std::map<int, int> stagedRanges; // startChannel -> length, merged
+static long long stagedPacketTime = 0;
+static long long frameStartTime = 0; // 0 if nothing is staged
+static bool frameSyncGated = false;
+static uint32_t frameId = 0;
+static std::vector<uint8_t> frameUniverses;   // per InputUniverses index
+static std::vector<int> frameUniverseList;    // indexes set in frameUniverses
+static std::vector<uint8_t> learnedUniverses; // universes in the previous frame
+static int learnedUniverseCount = 0;
+static long long lastE131Sync = 0;
+static long long lastArtSync = 0;
+static long long lastDDPPush = 0;
+static long long lastFrameStartTime = 0;
+static long long frameIntervalMS = 0; // smoothed time between frames
+
+static uint64_t framesReleased = 0;
+static uint64_t framesSynced = 0;
+static uint64_t framesComplete = 0;
+static uint64_t framesPartial = 0;
+static uint64_t framesSyncMissed = 0;
+static uint64_t framesLate = 0;
+static long long maxAssemblyMS = 0;
+
 static std::map<int, std::function<bool(uint8_t* data, long long packetTime)>> ArtNetOpcodeHandlers;
 
 void AddArtNetOpcodeHandler(int opCode, std::function<bool(uint8_t* data, long long packetTime)> handler) {
@@ -324,6 +376,160 @@ inline void SetBridgeData(uint8_t* data, int startChannel, int len, long long pa
     sequence->SetBridgeData(data, startChannel, len, packetTime);
 }
 
+static void ResetFrameAssembly() {
+    Timers::INSTANCE.stopPeriodicTimer("BridgeFrameTimeout");
+    stagedRanges.clear();
+    frameStartTime = 0;
+    frameSyncGated = false;
+    frameUniverses.assign(InputUniverseCount, 0);
+    frameUniverseList.clear();
+    learnedUniverses.assign(InputUniverseCount, 0);
+    learnedUniverseCount = 0;
+    lastFrameStartTime = 0;
+    frameIntervalMS = 0;
+}
+
+static long long FrameTimeout() {
+    long long timeout = frameSyncGated ? frameIntervalMS * 2 : frameIntervalMS / 2;
+    if (!frameIntervalMS) {
+        timeout = frameSyncGated ? 50 : 20;
+    }
+    return std::clamp(timeout, (long long)BRIDGE_FRAME_TIMEOUT_MIN_MS, (long long)BRIDGE_FRAME_TIMEOUT_MAX_MS);
+}
+
+// Hand the staged frame to the sequence, returns true if there was anything
+// to release and an output should be forced
+static bool ReleaseBridgeFrame(BridgeFrameRelease reason, long long now) {
+    if (!frameStartTime) {
+        return false;
+    }
+    Timers::INSTANCE.stopPeriodicTimer("BridgeFrameTimeout");
+
+    for (auto& r : stagedRanges) {
+        SetBridgeData(&stagedData[r.first], r.first, r.second, stagedPacketTime);
+    }
+    stagedRanges.clear();
+
+    bool missing = false;
+    if (learnedUniverseCount) {
+        for (int x = 0; x < InputUniverseCount && !missing; x++) {
+            missing = learnedUniverses[x] && !frameUniverses[x];
+        }
+    }
+
+    framesReleased++;
+    switch (reason) {
+    case BridgeFrameRelease::SYNC:
+        framesSynced++;
+        break;
+    case BridgeFrameRelease::COMPLETE:
+    case BridgeFrameRelease::REPEAT:
+        framesComplete++;
+        break;
+    case BridgeFrameRelease::SYNC_MISSED:
+        framesSyncMissed++;
+        break;
+    case BridgeFrameRelease::TIMEOUT:
+        framesLate++;
+        break;
+    }
+    if (missing) {
+        framesPartial++;
+    }
+    maxAssemblyMS = std::max(maxAssemblyMS, now - frameStartTime);
+
+    if (lastFrameStartTime) {
+        long long interval = frameStartTime - lastFrameStartTime;
+        frameIntervalMS = frameIntervalMS ? (frameIntervalMS * 7 + interval) / 8 : interval;
+    }
+    lastFrameStartTime = frameStartTime;
+    frameStartTime = 0;
+
+    // the universes in this frame are what we expect in the next one
+    if (!frameUniverseList.empty()) {
+        std::fill(learnedUniverses.begin(), learnedUniverses.end(), 0);
+        for (int idx : frameUniverseList) {
+            learnedUniverses[idx] = 1;
+            frameUniverses[idx] = 0;
+        }
+        learnedUniverseCount = frameUniverseList.size();
+        frameUniverseList.clear();
+    }
+    return true;
+}
+
+// Stage a block of channel data for the frame being assembled.  universeIndex
+// is the InputUniverses index or -1 for DDP.  syncGated is true if the sender
+// of this packet is using E1.31 sync/ArtSync/DDP push.  Returns true if a
+// frame was released.
+static bool StageBridgeData(uint8_t* data, int startChannel, int len, long long packetTime,
+                            int universeIndex, bool syncGated) {
+    if (!frameAssemblyEnabled || (universeIndex < 0 && !syncGated)) {
+        SetBridgeData(data, startChannel, len, packetTime);
+        return false;
+    }
+
+    bool released = false;
+    if (universeIndex >= 0 && frameUniverses[universeIndex]) {
+        // universe repeated, the sender has started the next frame
+        released = ReleaseBridgeFrame(syncGated ? BridgeFrameRelease::SYNC_MISSED : BridgeFrameRelease::REPEAT, packetTime);
+    }
+
+    if (!frameStartTime) {
+        frameStartTime = packetTime;
+        frameSyncGated = syncGated;
+        ++frameId;
+        uint32_t id = frameId;
+        Timers::INSTANCE.addTimer("BridgeFrameTimeout", packetTime + FrameTimeout(), [id]() {
+            if (id == frameId && ReleaseBridgeFrame(BridgeFrameRelease::TIMEOUT, GetTimeMS())) {
+                ForceChannelOutputNow();
+            }
+        });
+    }
+    frameSyncGated |= syncGated;
+
+    if (stagedData.size() < (size_t)(startChannel + len)) {
+        stagedData.resize(std::max((size_t)(startChannel + len), std::min(stagedData.size() * 2, (size_t)FPPD_MAX_CHANNEL_NUM)));
+    }
+    memcpy(&stagedData[startChannel], data, len);
+    stagedPacketTime = packetTime;
+
+    // merge into the staged ranges, universes normally arrive in order so
+    // this is almost always an extension of the last range
+    auto it = stagedRanges.upper_bound(startChannel);
+    if (it != stagedRanges.begin()) {
+        auto prev = std::prev(it);
+        if (prev->first + prev->second >= startChannel) {
+            prev->second = std::max(prev->second, startChannel + len - prev->first);
+            it = prev;
+        } else {
+            it = stagedRanges.emplace(startChannel, len).first;
+        }
+    } else {
+        it = stagedRanges.emplace(startChannel, len).first;
+    }
+    auto next = std::next(it);
+    while (next != stagedRanges.end() && next->first <= it->first + it->second) {
+        it->second = std::max(it->second, next->first + next->second - it->first);
+        next = stagedRanges.erase(next);
+    }
+
+    if (universeIndex >= 0) {
+        frameUniverses[universeIndex] = 1;
+        frameUniverseList.push_back(universeIndex);
+        if (!frameSyncGated && learnedUniverseCount && (int)frameUniverseList.size() >= learnedUniverseCount) {
+            bool complete = true;
+            for (int x = 0; x < InputUniverseCount && complete; x++) {
+                complete = !learnedUniverses[x] || frameUniverses[x];
+            }
+            if (complete) {
+                released |= ReleaseBridgeFrame(BridgeFrameRelease::COMPLETE, packetTime);
+            }
+        }
+    }
+    return released;
+}
+
 // Add or drop multicast-group membership for the 239.255.x.y address
 // associated with an E1.31 universe across every non-loopback IPv4
 // interface. Op is IP_ADD_MEMBERSHIP or IP_DROP_MEMBERSHIP.
@@ -601,9 +807,8 @@ bool Bridge_StoreData(uint8_t* bridgeBuffer, long long packetTime) {
         uint32_t universe = ((int)bridgeBuffer[E131_UNIVERSE_INDEX] << 8) + bridgeBuffer[E131_UNIVERSE_INDEX + 1];
 
         // If the sender advertises a sync universe, make sure we're subscribed
-        // to its multicast group so the sync packets reach us. Data is still
-        // applied immediately; this only ensures the sync counter updates and
-        // sets the stage for any future buffered-until-sync handling.
+        // to its multicast group so the sync packets reach us and the data
+        // can be held until the sync arrives.
         int syncUniverse = ((int)bridgeBuffer[E131_SYNC_ADDRESS_INDEX] << 8) +
                            bridgeBuffer[E131_SYNC_ADDRESS_INDEX + 1];
         if (syncUniverse > 0 &&
@@ -637,13 +842,14 @@ bool Bridge_StoreData(uint8_t* bridgeBuffer, long long packetTime) {
                 }
             }
             InputUniverses[universeIndex].lastSequenceNumber = sn;
-
-            SetBridgeData(&bridgeBuffer[E131_HEADER_LENGTH],
-                          InputUniverses[universeIndex].startAddress - 1,
-                          InputUniverses[universeIndex].size,
-                          packetTime);
             InputUniverses[universeIndex].bytesReceived += InputUniverses[universeIndex].size;
             InputUniverses[universeIndex].packetsReceived++;
+
+            bool syncGated = syncUniverse > 0 && lastE131Sync && (packetTime - lastE131Sync) < BRIDGE_SYNC_HOLD_MS;
+            return StageBridgeData(&bridgeBuffer[E131_HEADER_LENGTH],
+                                   InputUniverses[universeIndex].startAddress - 1,
+                                   InputUniverses[universeIndex].size,
+                                   packetTime, universeIndex, syncGated);
         } else {
             unknownUniverse.packetsReceived++;
             uint32_t len = bridgeBuffer[16] & 0xF;
@@ -655,7 +861,8 @@ bool Bridge_StoreData(uint8_t* bridgeBuffer, long long packetTime) {
     } else if (bridgeBuffer[E131_VECTOR_INDEX] == VECTOR_ROOT_E131_EXTENDED) {
         if (bridgeBuffer[E131_EXTENDED_PACKET_TYPE_INDEX] == VECTOR_E131_EXTENDED_SYNCHRONIZATION) {
             e131SyncPackets++;
-            return true;
+            lastE131Sync = packetTime;
+            return ReleaseBridgeFrame(BridgeFrameRelease::SYNC, packetTime);
         }
         e131Errors++;
         LogDebug(VB_E131BRIDGE, "Unknown e1.31 extended packet type %d\n", (int)bridgeBuffer[E131_EXTENDED_PACKET_TYPE_INDEX]);
@@ -667,8 +874,8 @@ bool Bridge_StoreData(uint8_t* bridgeBuffer, long long packetTime) {
 }
 
 bool Bridge_HandleArtNetSync(uint8_t* bridgeBuffer, long long packetTime) {
-    // sync packet
-    return true;
+    lastArtSync = packetTime;
+    return ReleaseBridgeFrame(BridgeFrameRelease::SYNC, packetTime);
 }
 bool Bridge_StoreArtNetData(uint8_t* bridgeBuffer, long long packetTime) {
     if (bridgeBuffer[9] == 0x50 && bridgeBuffer[8] == 0x00) {
@@ -713,11 +920,11 @@ bool Bridge_StoreArtNetData(uint8_t* bridgeBuffer, long long packetTime) {
             InputUniverses[universeIndex].bytesReceived += std::min(InputUniverses[universeIndex].size, len);
             InputUniverses[universeIndex].packetsReceived++;
 
-            SetBridgeData(&bridgeBuffer[18],
-                          InputUniverses[universeIndex].startAddress - 1,
-                          std::min(InputUniverses[universeIndex].size, len),
-                          packetTime);
-
+            bool syncGated = lastArtSync && (packetTime - lastArtSync) < BRIDGE_SYNC_HOLD_MS;
+            return StageBridgeData(&bridgeBuffer[18],
+                                   InputUniverses[universeIndex].startAddress - 1,
+                                   std::min(InputUniverses[universeIndex].size, len),
+                                   packetTime, universeIndex, syncGated);
         } else {
             unknownUniverse.packetsReceived++;
             uint32_t len = bridgeBuffer[16] & 0xF;
@@ -854,11 +1061,15 @@ bool Bridge_StoreDDPData(uint8_t* bridgeBuffer, long long packetTime) {
         ddpMinChannel = std::min(ddpMinChannel, chan + 1);
         ddpMaxChannel = std::max(ddpMaxChannel, chan + len);
 
+        if (push) {
+            lastDDPPush = packetTime;
+        }
         int offset = tc ? 14 : 10;
-        SetBridgeData(&bridgeBuffer[offset],
-                      chan,
-                      len,
-                      packetTime);
+        bool syncGated = lastDDPPush && (packetTime - lastDDPPush) < BRIDGE_SYNC_HOLD_MS;
+        push = StageBridgeData(&bridgeBuffer[offset], chan, len, packetTime, -1, syncGated);
+        if (syncGated && (bridgeBuffer[0] & DDP_PUSH_FLAG)) {
+            push |= ReleaseBridgeFrame(BridgeFrameRelease::SYNC, packetTime);
+        }
         ddpBytesReceived += len;
     } else if (bridgeBuffer[0] & 0x02 && bridgeBuffer[3] == 250) {
         printf("Query config packet: %d \n", (int)bridgeBuffer[3]);
@@ -900,6 +1111,13 @@ void ResetBytesReceived() {
     unknownUniverse.bytesReceived = 0;
     unknownUniverse.packetsReceived = 0;
     e131SyncPackets = 0;
+    framesReleased = 0;
+    framesSynced = 0;
+    framesComplete = 0;
+    framesPartial = 0;
+    framesSyncMissed = 0;
+    framesLate = 0;
+    maxAssemblyMS = 0;
 }
 
 Json::Value GetE131UniverseBytesReceived() {
@@ -1011,6 +1229,20 @@ Json::Value GetE131UniverseBytesReceived() {
 
     result["universes"] = universes;
 
+    if (frameAssemblyEnabled && framesReleased) {
+        Json::Value frames;
+        frames["released"] = (Json::UInt64)framesReleased;
+        frames["synced"] = (Json::UInt64)framesSynced;
+        frames["complete"] = (Json::UInt64)framesComplete;
+        frames["partial"] = (Json::UInt64)framesPartial;
+        frames["syncMissed"] = (Json::UInt64)framesSyncMissed;
+        frames["late"] = (Json::UInt64)framesLate;
+        frames["frameIntervalMS"] = (Json::Int64)frameIntervalMS;
+        frames["maxAssemblyMS"] = (Json::Int64)maxAssemblyMS;
+        frames["universesPerFrame"] = learnedUniverseCount;
+        result["frameAssembly"] = frames;
+    }
+
     return result;
 }
 
@@ -1151,6 +1383,8 @@ static void BridgeReloadDMXInputs() {
             }
         }
     }
+    // universe indexes may have moved
+    ResetFrameAssembly();
 }
 
 void BridgeReloadUDP() {
@@ -1161,6 +1395,7 @@ void BridgeReloadUDP() {
     hasUDP = false;
     bool hasArtNet = false;
     bool enabled = Bridge_Initialize_Internal(hasArtNet);
+    ResetFrameAssembly();
     bool disableFakeBridges = getSettingInt("DisableFakeNetworkBridges");
     if (bridgeSock > 0) {
         if (enabled) {
@@ -1248,6 +1483,8 @@ void Bridge_Shutdown(void) {
     BridgeShutdownUDP(false);
     unregisterSettingsListener("DisableFakeNetworkBridges", "DisableFakeNetworkBridges");
     unregisterSettingsListener("BridgeSourcePriority", "BridgeSourcePriority");
+    unregisterSettingsListener("BridgeFrameAssembly", "BridgeFrameAssembly");
+    Timers::INSTANCE.stopPeriodicTimer("BridgeFrameTimeout");
     std::string udpInFile = FPP_DIR_CONFIG("/ci-universes.json");
     FileMonitor::INSTANCE.RemoveFile("ci-universes.json", udpInFile);
     std::string dmxInFile = FPP_DIR_CONFIG("/ci-dmx.json");
@@ -1275,6 +1512,12 @@ void Bridge_Initialize(std::map<int, std::function<bool(int)>>& callbacks) {
         }
     });
 
+    frameAssemblyEnabled = getSettingInt("BridgeFrameAssembly", 1) != 0;
+    registerSettingsListener("BridgeFrameAssembly", "BridgeFrameAssembly", [](const std::string& s) {
+        // anything already staged is flushed by the frame timeout
+        frameAssemblyEnabled = !s.empty() && s != "0";
+    });
+
     std::string udpInFile = FPP_DIR_CONFIG("/ci-universes.json");
     FileMonitor::INSTANCE.AddFile("ci-universes.json", udpInFile,
                                   []() {
@@ -16,12 +16,15 @@
 
 #include "Warnings.h" // WarningHolder -- needed directly for NOPCH builds
 
+#include <sys/stat.h>
 #include <array>
+#include <cinttypes>
 #include <cstdint>
 #include <cstring>
 #include <fnmatch.h>
 #include <functional>
 #include <list>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <stdio.h>
@@ -43,6 +46,35 @@
 
 #define MAX_EFFECTS 100
 
+// looping effects with no more than this much channel data are decoded
+// into memory once when started instead of being read every frame, as
+// long as all the preloaded effects together stay under the total
+#define MAX_PRELOAD_BYTES (16 * 1024 * 1024)
+#define MAX_PRELOAD_TOTAL_BYTES (32 * 1024 * 1024)
+
+// Every frame of an effect file, back to back, shared by all the running
+// effects playing that file
+class PreloadedEffect {
+public:
+    ~PreloadedEffect();
+
+    std::string key;
+    std::vector<uint8_t> frames;
+};
+
+static std::mutex preloadLock;
+static std::map<std::string, std::weak_ptr<PreloadedEffect>> preloadedEffects;
+static uint64_t preloadedBytes = 0;
+
+PreloadedEffect::~PreloadedEffect() {
+    std::unique_lock<std::mutex> lock(preloadLock);
+    preloadedBytes -= frames.size();
+    auto it = preloadedEffects.find(key);
+    if (it != preloadedEffects.end() && it->second.expired()) {
+        preloadedEffects.erase(it);
+    }
+}
+
 class FPPeffect {
 public:
     FPPeffect() :
@@ -57,15 +89,56 @@ public:
     FSEQFile* fp;
     int loop;
     int background;
+    EffectBlendMode blend = EffectBlendMode::Replace;
     uint32_t currentFrame;
+    uint32_t numFrames = 0;
+
+    // ranges passed to prepareRead, the frame data is packed with each
+    // one's full length back to back
+    std::vector<std::pair<uint32_t, uint32_t>> fileRanges;
+    // the same ranges clipped to FPPD_MAX_CHANNELS
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    uint32_t frameSize = 0;
+
+    // reused for every frame read from fp
+    std::vector<uint8_t> frameBuffer;
+    // set if the effect was preloaded, fp is closed
+    std::shared_ptr<const PreloadedEffect> preloaded;
 };
 
 static int effectCount = 0;
 static volatile int pauseBackgroundEffects = 0;
-static std::array<FPPeffect*, MAX_EFFECTS> effects;
+static std::array<std::shared_ptr<FPPeffect>, MAX_EFFECTS> effects;
 static std::list<std::pair<uint32_t, uint32_t>> clearRanges;
 static std::mutex effectsLock;
 
+// held by OverlayEffects while it works on the running snapshot so
+// effectsLock is only needed to take the snapshot
+static std::mutex overlayLock;
+static std::array<std::shared_ptr<FPPeffect>, MAX_EFFECTS> overlaySnapshot;
+static std::array<int, MAX_EFFECTS> overlaySnapshotIDs;
+static std::array<bool, MAX_EFFECTS> overlaySnapshotDone;
+
+EffectBlendMode EffectBlendModeFromString(const std::string& mode) {
+    if (mode == "Max" || mode == "max") {
+        return EffectBlendMode::Max;
+    } else if (mode == "Additive" || mode == "additive" || mode == "Add" || mode == "add") {
+        return EffectBlendMode::Additive;
+    }
+    return EffectBlendMode::Replace;
+}
+
+static const char* EffectBlendModeName(EffectBlendMode mode) {
+    switch (mode) {
+    case EffectBlendMode::Max:
+        return "Max";
+    case EffectBlendMode::Additive:
+        return "Additive";
+    default:
+        return "Replace";
+    }
+}
+
 /*
  * Initialize effects constructs
  */
@@ -153,29 +226,134 @@ int IsEffectRunning(void) {
     return result;
 }
 
-int StartEffect(FSEQFile* fseq, const std::string& effectName, int loop, bool bg) {
+/*
+ * Decode every frame of the effect for PrepareEffect(), reusing the frames
+ * of another running effect playing the same file.  Returns nullptr if the
+ * effect is too large or would take the preloaded total over budget.
+ */
+static std::shared_ptr<const PreloadedEffect> PreloadEffect(std::shared_ptr<FPPeffect>& e) {
+    uint64_t size = (uint64_t)e->numFrames * e->frameSize;
+    if (size > MAX_PRELOAD_BYTES) {
+        return nullptr;
+    }
+
+    // the packed data only depends on the file and the range lengths, an
+    // effect started at a different channel can share it
+    std::string key = e->fp->getFilename();
+    struct stat st;
+    if (stat(key.c_str(), &st) == 0) {
+        key += "|" + std::to_string(st.st_size) + "|" + std::to_string(st.st_mtime);
+    }
+    for (auto& rng : e->ranges) {
+        key += "|" + std::to_string(rng.second);
+    }
+    key += "|" + std::to_string(e->frameSize);
+
+    // held while decoding so a second start of the same file waits for
+    // and shares the first one's frames
+    std::unique_lock<std::mutex> lock(preloadLock);
+    auto it = preloadedEffects.find(key);
+    if (it != preloadedEffects.end()) {
+        std::shared_ptr<PreloadedEffect> p = it->second.lock();
+        if (p) {
+            LogDebug(VB_EFFECT, "Sharing preloaded frames of effect %s\n", e->name.c_str());
+            return p;
+        }
+    }
+    if (preloadedBytes + size > MAX_PRELOAD_TOTAL_BYTES) {
+        LogInfo(VB_EFFECT, "Not preloading effect %s, %" PRIu64 " bytes of effects already preloaded\n",
+                e->name.c_str(), preloadedBytes);
+        return nullptr;
+    }
+
+    std::shared_ptr<PreloadedEffect> p = std::make_shared<PreloadedEffect>();
+    p->frames.resize(size);
+    for (uint32_t f = 0; f < e->numFrames; f++) {
+        FSEQFile::FrameData* d = e->fp->getFrame(f);
+        bool ok = d && d->readPacked(&p->frames[(size_t)f * e->frameSize], e->fileRanges);
+        if (d) {
+            delete d;
+        }
+        if (!ok) {
+            LogWarn(VB_EFFECT, "Could not preload frame %d of effect %s, reading it as it plays\n", f, e->name.c_str());
+            // not counted yet, keep the destructor's accounting straight
+            p->frames.clear();
+            lock.unlock();
+            return nullptr;
+        }
+    }
+    p->key = key;
+    preloadedBytes += size;
+    preloadedEffects[key] = p;
+    LogDebug(VB_EFFECT, "Preloaded %d frames of effect %s, %" PRIu64 " bytes of effects preloaded\n",
+             e->numFrames, e->name.c_str(), preloadedBytes);
+    return p;
+}
+
+/*
+ * Work out the channel ranges the effect covers, prepare the file to read
+ * just those and preload the whole effect if it loops and is small enough
+ */
+static void PrepareEffect(std::shared_ptr<FPPeffect>& e) {
+    std::vector<std::pair<uint32_t, uint32_t>>& fileRanges = e->fileRanges;
+    V2FSEQFile* v2fseq = dynamic_cast<V2FSEQFile*>(e->fp);
+    if (v2fseq && !v2fseq->m_sparseRanges.empty()) {
+        fileRanges = v2fseq->m_sparseRanges;
+    } else {
+        // not sparse and not eseq, entire range
+        fileRanges.push_back(std::pair<uint32_t, uint32_t>(0, e->fp->getChannelCount()));
+    }
+    e->fp->prepareRead(fileRanges);
+
+    e->numFrames = e->fp->getNumFrames();
+    e->frameSize = 0;
+    for (auto& rng : fileRanges) {
+        e->frameSize += rng.second;
+        if (rng.first >= FPPD_MAX_CHANNELS) {
+            // keep the range so the packed data still lines up
+            e->ranges.push_back(std::pair<uint32_t, uint32_t>(FPPD_MAX_CHANNELS, 0));
+        } else {
+            e->ranges.push_back(std::pair<uint32_t, uint32_t>(rng.first, std::min(rng.second, (uint32_t)FPPD_MAX_CHANNELS - rng.first)));
+        }
+    }
+
+    if (e->loop && e->numFrames) {
+        e->preloaded = PreloadEffect(e);
+    }
+    if (e->preloaded) {
+        delete e->fp;
+        e->fp = nullptr;
+        return;
+    }
+
+    // a failed preload may have read part way through the file
+    e->fp->prepareRead(fileRanges);
+    e->frameBuffer.resize(e->frameSize);
+}
+
+int StartEffect(FSEQFile* fseq, const std::string& effectName, int loop, bool bg, EffectBlendMode blend) {
+    std::shared_ptr<FPPeffect> e = std::make_shared<FPPeffect>();
+    e->name = effectName;
+    e->fp = fseq;
+    e->loop = loop;
+    e->background = bg;
+    e->blend = blend;
+    int frameTime = fseq->getStepTime();
+    PrepareEffect(e);
+
     std::unique_lock<std::mutex> lock(effectsLock);
     if (effectCount >= MAX_EFFECTS) {
         LogErr(VB_EFFECT, "Unable to start effect %s, maximum number of effects already running\n", effectName.c_str());
         return -1;
     }
-    int effectID = -1;
-    int frameTime = 50;
-
-    frameTime = fseq->getStepTime();
-    effectID = GetNextEffectID();
+    int effectID = GetNextEffectID();
 
     if (effectID < 0) {
         LogErr(VB_EFFECT, "Unable to start effect %s, unable to determine next effect ID\n", effectName.c_str());
-        delete fseq;
         return effectID;
     }
 
-    effects[effectID] = new FPPeffect;
-    effects[effectID]->name = effectName;
-    effects[effectID]->fp = fseq;
-    effects[effectID]->loop = loop;
-    effects[effectID]->background = bg;
+    effects[effectID] = e;
 
     effectCount++;
     int tmpec = effectCount;
@@ -192,7 +370,7 @@ int StartEffect(FSEQFile* fseq, const std::string& effectName, int loop, bool bg
     return effectID;
 }
 
-int StartFSEQAsEffect(const std::string& fseqName, int loop, bool bg) {
+int StartFSEQAsEffect(const std::string& fseqName, int loop, bool bg, EffectBlendMode blend) {
     LogInfo(VB_EFFECT, "Starting FSEQ %s as effect\n", fseqName.c_str());
 
     std::string filename = FPP_DIR_SEQUENCE("/" + fseqName + ".fseq");
@@ -203,13 +381,13 @@ int StartFSEQAsEffect(const std::string& fseqName, int loop, bool bg) {
         WarningHolder::AddWarningTimeout(60, 49, "Effect could not be started: cannot open " + filename);
         return -1;
     }
-    return StartEffect(fseq, fseqName, loop, bg);
+    return StartEffect(fseq, fseqName, loop, bg, blend);
 }
 
 /*
  * Start a new effect offset at the specified channel number
  */
-int StartEffect(const std::string& effectName, int startChannel, int loop, bool bg) {
+int StartEffect(const std::string& effectName, int startChannel, int loop, bool bg, EffectBlendMode blend) {
     LogInfo(VB_EFFECT, "Starting effect %s at channel %d\n", effectName.c_str(), startChannel);
 
     std::string filename = FPP_DIR_EFFECT("/" + effectName + ".eseq");
@@ -239,32 +417,20 @@ int StartEffect(const std::string& effectName, int startChannel, int loop, bool
         // This will need to change if/when we support multiple models per file
         v2fseq->m_sparseRanges[0].first = startChannel - 1;
     }
-    return StartEffect(v2fseq, effectName, loop, bg);
+    return StartEffect(v2fseq, effectName, loop, bg, blend);
 }
 
 /*
  * Helper function to stop an effect, assumes effectsLock is already held
  */
 void StopEffectHelper(int effectID) {
-    FPPeffect* e = NULL;
-    e = effects[effectID];
-
-    if (e->fp) {
-        V2FSEQFile* v2fseq = dynamic_cast<V2FSEQFile*>(e->fp);
-        if (v2fseq && v2fseq->m_sparseRanges.size() != 0) {
-            for (auto& a : v2fseq->m_sparseRanges) {
-                clearRanges.push_back(std::pair<uint32_t, uint32_t>(a.first, a.second));
-            }
-            for (auto& a : v2fseq->m_rangesToRead) {
-                clearRanges.push_back(std::pair<uint32_t, uint32_t>(a.first, a.second));
-            }
-        } else {
-            // not sparse and not eseq, entire range
-            clearRanges.push_back(std::pair<uint32_t, uint32_t>(0, e->fp->getChannelCount()));
+    for (auto& a : effects[effectID]->ranges) {
+        if (a.second) {
+            clearRanges.push_back(a);
         }
     }
-    delete e;
-    effects[effectID] = NULL;
+    // OverlayEffects may still be using it, the last reference closes the file
+    effects[effectID].reset();
     effectCount--;
 }
 
@@ -302,12 +468,10 @@ int StopEffect(const std::string& effectName) {
  * Stop a single effect
  */
 int StopEffect(int effectID) {
-    FPPeffect* e = NULL;
-
     LogDebug(VB_EFFECT, "StopEffect(%d)\n", effectID);
 
     std::unique_lock<std::mutex> lock(effectsLock);
-    if (!effects[effectID]) {
+    if (effectID < 0 || effectID >= MAX_EFFECTS || !effects[effectID]) {
         return 0;
     }
 
@@ -342,45 +506,61 @@ void StopAllEffects(void) {
         sequence->SendBlankingData();
 }
 
-/*
- * Overlay a single effect onto raw channel data
- */
-int OverlayEffect(int effectID, char* channelData) {
-    FPPeffect* e = NULL;
-    if (!effects[effectID]) {
-        LogErr(VB_EFFECT, "Invalid Effect ID %d\n", effectID);
-        return 0;
+static void BlendEffectData(const FPPeffect* e, const uint8_t* src, uint8_t* dst) {
+    for (auto& rng : e->ranges) {
+        uint8_t* d = dst + rng.first;
+        switch (e->blend) {
+        case EffectBlendMode::Replace:
+            memcpy(d, src, rng.second);
+            break;
+        case EffectBlendMode::Max:
+            for (uint32_t x = 0; x < rng.second; x++) {
+                d[x] = std::max(d[x], src[x]);
+            }
+            break;
+        case EffectBlendMode::Additive:
+            for (uint32_t x = 0; x < rng.second; x++) {
+                uint32_t v = d[x] + src[x];
+                d[x] = v > 255 ? 255 : v;
+            }
+            break;
+        }
+        // packed data holds the range's full length even if it was clipped
+        src += rng.second;
     }
+}
 
-    e = effects[effectID];
-    FSEQFile::FrameData* d = e->fp->getFrame(e->currentFrame);
-    if (d == nullptr && e->loop) {
+/*
+ * Get the packed channel data for the effect's current frame and advance,
+ * returns nullptr once a non-looping effect has finished
+ */
+static const uint8_t* NextEffectFrame(FPPeffect* e) {
+    if (e->currentFrame >= e->numFrames) {
+        if (!e->loop || !e->numFrames) {
+            return nullptr;
+        }
         e->currentFrame = 0;
-        d = e->fp->getFrame(e->currentFrame);
     }
-    e->currentFrame++;
-    if (d) {
-        d->readFrame((uint8_t*)channelData, FPPD_MAX_CHANNELS);
-        delete d;
-        return 1;
-    } else {
-        StopEffectHelper(effectID);
-        for (auto& rng : clearRanges) {
-            memset(&channelData[rng.first], 0, rng.second);
-        }
-        clearRanges.clear();
+    if (e->preloaded) {
+        return &e->preloaded->frames[(size_t)e->currentFrame++ * e->frameSize];
     }
 
-    return 0;
+    FSEQFile::FrameData* d = e->fp->getFrame(e->currentFrame++);
+    if (!d) {
+        return nullptr;
+    }
+    bool ok = d->readPacked(e->frameBuffer.data(), e->fileRanges);
+    delete d;
+    return ok ? e->frameBuffer.data() : nullptr;
 }
 
 /*
  * Overlay current effects onto raw channel data
  */
 int OverlayEffects(char* channelData) {
-    int i;
     int dataRead = 0;
 
+    std::unique_lock<std::mutex> olock(overlayLock);
     std::unique_lock<std::mutex> lock(effectsLock);
 
     // for effects that have been stopped, we need to clear the data
@@ -398,17 +578,49 @@ int OverlayEffects(char* channelData) {
         skipBackground = 1;
     }
 
-    for (i = 0; i < MAX_EFFECTS; i++) {
-        if (effects[i]) {
-            if ((!skipBackground) ||
-                (skipBackground && (!effects[i]->background))) {
-                dataRead |= OverlayEffect(i, channelData);
-            }
+    // read and blend without effectsLock so starting or stopping an
+    // effect never waits on file reads
+    int running = 0;
+    for (int i = 0; i < MAX_EFFECTS; i++) {
+        if (effects[i] && (!skipBackground || !effects[i]->background)) {
+            overlaySnapshot[running] = effects[i];
+            overlaySnapshotIDs[running++] = i;
         }
     }
-
     lock.unlock();
 
+    bool finished = false;
+    for (int i = 0; i < running; i++) {
+        const uint8_t* data = NextEffectFrame(overlaySnapshot[i].get());
+        if (data) {
+            BlendEffectData(overlaySnapshot[i].get(), data, (uint8_t*)channelData);
+            dataRead = 1;
+        } else {
+            finished = true;
+        }
+        overlaySnapshotDone[i] = !data;
+    }
+
+    if (finished) {
+        lock.lock();
+        for (int i = 0; i < running; i++) {
+            int id = overlaySnapshotIDs[i];
+            if (overlaySnapshotDone[i] && effects[id] == overlaySnapshot[i]) {
+                StopEffectHelper(id);
+            }
+        }
+        for (auto& rng : clearRanges) {
+            memset(&channelData[rng.first], 0, rng.second);
+        }
+        clearRanges.clear();
+        lock.unlock();
+    }
+    // dropping the snapshot may close the files of stopped effects, don't
+    // hold effectsLock for that
+    for (int i = 0; i < running; i++) {
+        overlaySnapshot[i].reset();
+    }
+
     if ((dataRead == 0) &&
         (!IsEffectRunning()) &&
         (!sequence->IsSequenceRunning())) {
@@ -428,6 +640,7 @@ Json::Value GetRunningEffectsJson() {
             Json::Value obj;
             obj["id"] = i;
             obj["name"] = effects[i]->name;
+            obj["blend"] = EffectBlendModeName(effects[i]->blend);
             arr.append(obj);
         }
     }
@@ -15,13 +15,22 @@
 #include <string>
 #include "fpp-json-fwd.h"
 
+// How an effect's frame data is combined with the channel data below it,
+// only the channels in the effect's ranges are touched
+enum class EffectBlendMode {
+    Replace,
+    Max,     // brightest of the effect and the underlying data
+    Additive // saturating add
+};
+EffectBlendMode EffectBlendModeFromString(const std::string& mode);
+
 int GetRunningEffects(char* msg, char** result);
 Json::Value GetRunningEffectsJson();
 int IsEffectRunning(void);
 int InitEffects(void);
 void CloseEffects(void);
-int StartEffect(const std::string& effectName, int startChannel, int loop = 0, bool bg = false);
-int StartFSEQAsEffect(const std::string& effectName, int loop = 0, bool bg = false);
+int StartEffect(const std::string& effectName, int startChannel, int loop = 0, bool bg = false, EffectBlendMode blend = EffectBlendMode::Replace);
+int StartFSEQAsEffect(const std::string& effectName, int loop = 0, bool bg = false, EffectBlendMode blend = EffectBlendMode::Replace);
 int StopEffect(const std::string& effectName);
 int StopEffect(int effectID);
 void StopAllEffects(void);
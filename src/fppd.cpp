@@ -1096,6 +1096,8 @@ void MainLoop(void) {
 
     while (runMainFPPDLoop) {
         EPollManager::WaitResult epollresult = EPollManager::INSTANCE.waitForEvents(sleepms);
+        // the bridge input callbacks only return true once they have
+        // assembled a complete frame, see StageBridgeData in e131bridge.cpp
         bool pushBridgeData = epollresult == EPollManager::WaitResult::SOME_TRUE;
         if (epollresult == EPollManager::WaitResult::INTERRUPTED) {
             // We get interrupted when media players finish
@@ -1201,7 +1203,6 @@ void MainLoop(void) {
         }
         Timers::INSTANCE.fireTimers();
         CurlManager::INSTANCE.processCurls();
-        GPIOManager::INSTANCE.CheckGPIOInputs();
     }
     FileMonitor::INSTANCE.Cleanup();
 
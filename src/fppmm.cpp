@@ -28,6 +28,7 @@
 
 #include "common.h"
 #include "commands/Commands.h"
+#include "overlays/PixelOverlayBuffer.h"
 
 #include "fppversion.h"
 
@@ -195,12 +196,25 @@ void CopyFileToMappedBlock(const std::string& blockName, char* inputFilename) {
         mode_t mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
         int f = shm_open(overlayBuferName.c_str(), O_RDWR | O_CREAT, mode);
         int size = width * height * 3 + 12;
+        struct stat st;
+        if ((fstat(f, &st) == 0) && (st.st_size > size)) {
+            size = st.st_size;
+        }
         uint8_t* overlayBufferData = (uint8_t*)mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, f, 0);
         close(f);
-        memcpy(&overlayBufferData[12], &data[0], channelCount);
-        //data is copied, mark the overlay buffer as dirty so it gets copied into the data buffer
-        uint32_t* flags = (uint32_t*)&overlayBufferData[8];
-        *flags |= 1;
+        PixelOverlayBufferV2Header* v2 = PixelOverlayBufferV2Header::Find(overlayBufferData);
+        if (v2 && (v2->slotOffset + v2->slotCount * v2->slotSize <= (uint32_t)size) && ((uint32_t)channelCount <= v2->slotSize)) {
+            // write into a free slot and publish it so fppd never sees a partial frame
+            uint32_t slot;
+            uint8_t* dst = v2->BeginWrite(overlayBufferData, slot);
+            memcpy(dst, &data[0], channelCount);
+            v2->Publish(slot, true);
+        } else {
+            memcpy(&overlayBufferData[12], &data[0], channelCount);
+            //data is copied, mark the overlay buffer as dirty so it gets copied into the data buffer
+            uint32_t* flags = (uint32_t*)&overlayBufferData[8];
+            *flags |= 1;
+        }
         munmap(overlayBufferData, size);
         printf("Data imported\n");
     }
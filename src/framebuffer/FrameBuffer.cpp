@@ -35,6 +35,7 @@
 #include "commands/Commands.h"
 
 #include "FrameBuffer.h"
+#include "FrameBufferRows.h"
 #include "IOCTLFrameBuffer.h"
 #include "KMSFrameBuffer.h"
 #include "SocketFrameBuffer.h"
@@ -260,55 +261,36 @@ void FrameBuffer::DestroyFrameBuffer(void) {
  *
  */
 void FrameBuffer::FBCopyData(const uint8_t* buffer, int draw) {
-    int drow = 0;
-    const uint8_t* sR = buffer + 0; // Input always RGB
-    const uint8_t* sG = buffer + 1;
-    const uint8_t* sB = buffer + 2;
     uint8_t* ob = m_outputBuffer;
 
-    if (draw && (m_pixelSize == 1)) {
+    // With no transition on a page flipping device render straight into the
+    // page that isn't being displayed, the draw loop then only has to flip.
+    bool direct = !draw && !m_autoSync && m_pages > 1 && m_transitionType == IT_Normal && CanPageFlip();
+    if (draw || direct) {
         m_bufferLock.lock();
-        ob = FB_CURRENT_PAGE_PTR;
-    }
-    uint8_t* dR;
-    uint8_t* dG;
-    uint8_t* dB;
-    int add = m_bpp / 8;
-
-    for (int y = 0; y < m_pixelsHigh; y++) {
-        // Output is BGR(A)
-        dB = ob + (drow * m_pixelSize * m_rowStride);
-        dG = dB + 1;
-        dR = dB + 2;
-
-        for (int x = 0; x < m_pixelsWide; x++) {
-            for (int sc = 0; sc < m_pixelSize; sc++) {
-                *dR = *sR;
-                *dG = *sG;
-                *dB = *sB;
-
-                dR += add;
-                dG += add;
-                dB += add;
-            }
-
-            sR += 3;
-            sG += 3;
-            sB += 3;
+        if (direct && ((m_cPage + 1) % m_pages) == m_flipFromPage) {
+            // that page is still on screen until FBDrawNormal's flip is done,
+            // render into m_outputBuffer for a copy on the next draw instead
+            m_directPage = -1;
+            m_bufferLock.unlock();
+            direct = false;
+        } else if (direct) {
+            m_directPage = (m_cPage + 1) % m_pages;
+            ob = m_pageBuffers[m_directPage];
+        } else if (m_pixelSize == 1) {
+            ob = FB_CURRENT_PAGE_PTR;
         }
-
-        dB = ob + (drow * m_pixelSize * m_rowStride);
-        for (int sc = 1; sc < m_pixelSize; sc++) {
-            memcpy(dB + (sc * m_rowStride), dB, m_rowStride);
-        }
-
-        drow++;
     }
 
+    FBConvertRows(buffer, ob, m_pixelsWide, m_pixelsHigh, m_bpp, m_pixelSize, m_rowStride, m_convertRow);
+
     if (draw) {
         m_bufferLock.unlock();
     } else {
         m_imageReady = true;
+        if (direct) {
+            m_bufferLock.unlock();
+        }
     }
 }
 
@@ -367,62 +349,29 @@ void FrameBuffer::DrawLoop(void) {
                 continue;
                 break;
 
-            case IT_SlideUp:
-                FBDrawSlideUp();
-                break;
-
-            case IT_SlideDown:
-                FBDrawSlideDown();
-                break;
-
-            case IT_SlideLeft:
-                FBDrawSlideLeft();
-                break;
-
-            case IT_SlideRight:
-                FBDrawSlideRight();
-                break;
-
-            case IT_WipeUp:
-                FBDrawWipeUp();
-                break;
-
-            case IT_WipeDown:
-                FBDrawWipeDown();
-                break;
-
-            case IT_WipeLeft:
-                FBDrawWipeLeft();
-                break;
-
-            case IT_WipeRight:
-                FBDrawWipeRight();
-                break;
-
-            case IT_WipeToHCenter:
-                FBDrawWipeToHCenter();
-                break;
-
-            case IT_WipeFromHCenter:
-                FBDrawWipeFromHCenter();
-                break;
-
-            case IT_HorzBlindsOpen:
-                FBDrawHorzBlindsOpen();
-                break;
-
-            case IT_HorzBlindsClose:
-                FBDrawHorzBlindsClose();
+            case IT_Normal:
+            case IT_Default:
+                FBDrawNormal();
                 break;
 
-            case IT_Mosaic:
-                FBDrawMosaic();
-                break;
-
-            default:
-                FBDrawNormal();
+            default: {
+                if (m_directPage >= 0) {
+                    // rendered for a plain flip, the transition draws from m_outputBuffer
+                    std::unique_lock<std::mutex> l(m_bufferLock);
+                    memcpy(m_outputBuffer, m_pageBuffers[m_directPage], m_pageSize);
+                    m_directPage = -1;
+                }
+                std::vector<TransitionStep> steps = BuildTransition(m_nextTransitionType);
+                if (steps.empty()) {
+                    FBDrawNormal();
+                } else if (CanPageFlip() && m_pages > 1) {
+                    FBDrawPageFlipTransition(steps);
+                } else {
+                    FBDrawTransition(steps);
+                }
                 break;
             }
+            }
 
             lock.lock();
 
@@ -450,333 +399,239 @@ void FrameBuffer::NextPage(bool producer) {
 void FrameBuffer::FBDrawNormal(void) {
     m_bufferLock.lock();
 
-    NextPage();
-    memcpy(FB_CURRENT_PAGE_PTR, m_outputBuffer, m_pageSize);
-    SyncDisplay(true);
-    m_bufferLock.unlock();
-}
-
-/*
- *
- */
-void FrameBuffer::FBDrawSlideUp(void) {
-    int rEach = 2;
-    int sleepTime = 800 * 1000 * rEach / m_height;
-
-    if ((m_height % 4) == 0)
-        rEach = 4;
-
-    m_bufferLock.lock();
-    for (int i = m_height - rEach; i >= 0;) {
-        memcpy(FB_CURRENT_PAGE_PTR + (m_rowStride * i), m_outputBuffer, m_rowStride * (m_height - i));
-        SyncDisplay();
-
-        usleep(sleepTime);
-
-        i -= rEach;
+    int shown = m_cPage;
+    if (m_directPage >= 0) {
+        // FBCopyData already rendered it into the back page
+        m_cPage = m_directPage;
+        m_directPage = -1;
+    } else {
+        NextPage();
+        memcpy(FB_CURRENT_PAGE_PTR, m_outputBuffer, m_pageSize);
     }
-    m_bufferLock.unlock();
-}
-
-/*
- *
- */
-void FrameBuffer::FBDrawSlideDown(void) {
-    int rEach = 2;
-    int sleepTime = 800 * 1000 * rEach / m_height;
-
-    if ((m_height % 4) == 0)
-        rEach = 4;
 
+    // SyncDisplay may wait for the vblank, don't hold up FBCopyData on the
+    // channel output thread for that
+    m_flipFromPage = shown;
+    m_bufferLock.unlock();
+    SyncDisplay(true);
     m_bufferLock.lock();
-    for (int i = rEach; i <= m_height;) {
-        memcpy(FB_CURRENT_PAGE_PTR, m_outputBuffer + (m_rowStride * (m_height - i)), m_rowStride * i);
-        SyncDisplay();
-
-        usleep(sleepTime);
-
-        i += rEach;
-    }
+    m_flipFromPage = -1;
     m_bufferLock.unlock();
 }
 
 /*
- *
+ * Build the steps for a transition, empty if it is a plain copy
  */
-void FrameBuffer::FBDrawSlideLeft(void) {
-    int colsEach = 2;
-    int sleepTime = 800 * 1000 * colsEach / m_width;
-
-    for (int x = m_width - colsEach; x >= 0; x -= colsEach) {
-        DrawSquare(x, 0, m_width - x, m_height, 0, 0);
-        SyncDisplay();
-
-        usleep(sleepTime);
+std::vector<FrameBuffer::TransitionStep> FrameBuffer::BuildTransition(ImageTransitionType type) {
+    std::vector<TransitionStep> steps;
+    int W = m_width;
+    int H = m_height;
+    int rEach = ((H % 4) == 0) ? 4 : 2;
+
+    // rows [y, y + rows) of the new image in place
+    auto rows = [W, H](int y, int rows) {
+        if (y < 0) {
+            rows += y;
+            y = 0;
+        }
+        return TransitionRect{ 0, y, W, std::max(0, std::min(rows, H - y)), 0, y };
+    };
+
+    switch (type) {
+    // the slides always finish with the whole image in place
+    case IT_SlideUp:
+        for (int i = H - rEach; i > -rEach; i -= rEach) {
+            int y = std::max(i, 0);
+            steps.push_back({ { 0, y, W, H - y, 0, 0 } });
+        }
+        break;
+    case IT_SlideDown:
+        for (int i = rEach; i < H + rEach; i += rEach) {
+            int h = std::min(i, H);
+            steps.push_back({ { 0, 0, W, h, 0, H - h } });
+        }
+        break;
+    case IT_SlideLeft:
+        for (int i = W - 2; i > -2; i -= 2) {
+            int x = std::max(i, 0);
+            steps.push_back({ { x, 0, W - x, H, 0, 0 } });
+        }
+        break;
+    case IT_SlideRight:
+        for (int i = 2; i < W + 2; i += 2) {
+            int x = std::min(i, W);
+            steps.push_back({ { 0, 0, x, H, W - x, 0 } });
+        }
+        break;
+    case IT_WipeUp:
+        for (int i = H - rEach; i > -rEach; i -= rEach) {
+            steps.push_back({ rows(i, rEach) });
+        }
+        break;
+    case IT_WipeDown:
+        for (int i = 0; i < H; i += rEach) {
+            steps.push_back({ rows(i, rEach) });
+        }
+        break;
+    case IT_WipeLeft:
+        for (int x = W - 1; x >= 0; x--) {
+            steps.push_back({ { x, 0, 1, H, x, 0 } });
+        }
+        break;
+    case IT_WipeRight:
+        for (int x = 0; x < W; x++) {
+            steps.push_back({ { x, 0, 1, H, x, 0 } });
+        }
+        break;
+    case IT_WipeToHCenter:
+        for (int i = 0; i < (H + 1) / 2; i += rEach) {
+            steps.push_back({ rows(i, rEach), rows(H - i - rEach, rEach) });
+        }
+        break;
+    case IT_WipeFromHCenter:
+        for (int b = H / 2, t = H / 2 - 2; b < H || t > -2; b += 2, t -= 2) {
+            steps.push_back({ rows(b, 2), rows(t, 2) });
+        }
+        break;
+    case IT_HorzBlindsOpen:
+    case IT_HorzBlindsClose: {
+        const int blindSize = 32;
+        for (int s = 0; s < blindSize; s += 2) {
+            int i = (type == IT_HorzBlindsOpen) ? (blindSize - 2 - s) : s;
+            TransitionStep step;
+            for (int y = i; y < H; y += blindSize) {
+                step.push_back(rows(y, 2));
+            }
+            steps.push_back(step);
+        }
+        break;
+    }
+    case IT_Mosaic: {
+        const int squareSize = 32;
+        int xSquares = (W + squareSize - 1) / squareSize;
+        int ySquares = (H + squareSize - 1) / squareSize;
+        std::vector<int> order(xSquares * ySquares);
+        for (int i = 0; i < (int)order.size(); i++) {
+            order[i] = i;
+        }
+        for (int i = (int)order.size() - 1; i > 0; i--) {
+            std::swap(order[i], order[rand_r(&m_typeSeed) % (i + 1)]);
+        }
+        for (int sq : order) {
+            int x = (sq % xSquares) * squareSize;
+            int y = (sq / xSquares) * squareSize;
+            steps.push_back({ { x, y, std::min(squareSize, W - x), std::min(squareSize, H - y), x, y } });
+        }
+        break;
     }
-}
-
-/*
- *
- */
-void FrameBuffer::FBDrawSlideRight(void) {
-    int colsEach = 2;
-    int sleepTime = 800 * 1000 * colsEach / m_width;
-
-    for (int x = 2; x <= m_width; x += colsEach) {
-        DrawSquare(0, 0, x, m_height, m_width - x, 0);
-        SyncDisplay();
-
-        usleep(sleepTime);
+    default:
+        break;
     }
-}
-
-/*
- *
- */
-void FrameBuffer::FBDrawWipeUp(void) {
-    int rEach = 2;
-
-    if ((m_height % 4) == 0)
-        rEach = 4;
-
-    int sleepTime = 800 * 1000 * rEach / m_height;
-
-    m_bufferLock.lock();
-    for (int i = m_height - rEach; i >= 0;) {
-        memcpy(FB_CURRENT_PAGE_PTR + (m_rowStride * i), m_outputBuffer + (m_rowStride * i), m_rowStride * rEach);
-        SyncDisplay();
-
-        usleep(sleepTime);
-
-        i -= rEach;
+    for (auto& step : steps) {
+        std::erase_if(step, [](const TransitionRect& r) { return r.w <= 0 || r.h <= 0; });
     }
-    m_bufferLock.unlock();
+    return steps;
 }
 
-/*
- *
- */
-void FrameBuffer::FBDrawWipeDown(void) {
-    int rEach = 2;
-
-    if ((m_height % 4) == 0)
-        rEach = 4;
-
-    int sleepTime = 800 * 1000 * rEach / m_height;
-
-    m_bufferLock.lock();
-    for (int i = 0; i < m_height;) {
-        memcpy(FB_CURRENT_PAGE_PTR + (m_rowStride * i), m_outputBuffer + (m_rowStride * i), m_rowStride * rEach);
-        SyncDisplay();
-
-        usleep(sleepTime);
-
-        i += rEach;
-    }
-    m_bufferLock.unlock();
-}
-
-/*
- *
- */
-void FrameBuffer::FBDrawWipeLeft(void) {
+void FrameBuffer::ApplyTransitionStep(uint8_t* page, const TransitionStep& step) {
     int BPP = m_bpp / 8;
-
-    m_bufferLock.lock();
-
-    for (int x = m_width - 1; x >= 0; x--) {
-        for (int y = 0; y < m_height; y++) {
-            memcpy(FB_CURRENT_PAGE_PTR + (m_rowStride * y) + (x * BPP),
-                   m_outputBuffer + (m_rowStride * y) + (x * BPP), BPP);
+    for (auto& r : step) {
+        uint8_t* d = page + (m_rowStride * r.dy) + (r.dx * BPP);
+        const uint8_t* s = m_outputBuffer + (m_rowStride * r.sy) + (r.sx * BPP);
+        if (r.dx == 0 && r.w == m_width) {
+            // whole rows are contiguous
+            memcpy(d, s, m_rowStride * r.h);
+            continue;
         }
-        SyncDisplay();
-    }
-
-    m_bufferLock.unlock();
-}
-
-/*
- *
- */
-void FrameBuffer::FBDrawWipeRight(void) {
-    int BPP = m_bpp / 8;
-
-    m_bufferLock.lock();
-
-    for (int x = 0; x < m_width; x++) {
-        for (int y = 0; y < m_height; y++) {
-            memcpy(FB_CURRENT_PAGE_PTR + (m_rowStride * y) + (x * BPP),
-                   m_outputBuffer + (m_rowStride * y) + (x * BPP), BPP);
+        for (int y = 0; y < r.h; y++, d += m_rowStride, s += m_rowStride) {
+            memcpy(d, s, r.w * BPP);
         }
-        SyncDisplay();
-    }
-
-    m_bufferLock.unlock();
-}
-
-/*
- *
- */
-void FrameBuffer::FBDrawWipeToHCenter(void) {
-    int rEach = 2;
-    int mid = m_height / 2;
-
-    if ((m_height % 4) == 0)
-        rEach = 4;
-
-    int sleepTime = 800 * 1000 * rEach / m_height * 2;
-
-    m_bufferLock.lock();
-    for (int i = 0; i < mid; i += rEach) {
-        memcpy(FB_CURRENT_PAGE_PTR + (m_rowStride * i), m_outputBuffer + (m_rowStride * i), m_rowStride * rEach);
-        memcpy(FB_CURRENT_PAGE_PTR + (m_rowStride * (m_height - i - rEach)),
-               m_outputBuffer + (m_rowStride * (m_height - i - rEach)),
-               m_rowStride * rEach);
-        SyncDisplay();
-
-        usleep(sleepTime);
     }
-    m_bufferLock.unlock();
 }
 
 /*
- *
+ * Draw the transition onto the displayed page, spread over m_transitionTime
  */
-void FrameBuffer::FBDrawWipeFromHCenter(void) {
-    int mid = m_height / 2;
-    int rowsEachUpdate = 2;
-    int sleepTime = 800 * 1000 * rowsEachUpdate / m_height * 2;
+void FrameBuffer::FBDrawTransition(const std::vector<TransitionStep>& steps) {
+    auto start = std::chrono::steady_clock::now();
+    int count = steps.size();
 
     m_bufferLock.lock();
-
-    int t = mid - 2;
-    for (int b = mid; b < m_height; b += rowsEachUpdate, t -= rowsEachUpdate) {
-        memcpy(FB_CURRENT_PAGE_PTR + (m_rowStride * b), m_outputBuffer + (m_rowStride * b),
-               m_rowStride * rowsEachUpdate);
-
-        if (t >= 0)
-            memcpy(FB_CURRENT_PAGE_PTR + (m_rowStride * t), m_outputBuffer + (m_rowStride * t),
-                   m_rowStride * rowsEachUpdate);
-
+    for (int i = 0; i < count; i++) {
+        ApplyTransitionStep(FB_CURRENT_PAGE_PTR, steps[i]);
         SyncDisplay();
 
-        usleep(sleepTime);
-    }
-
-    m_bufferLock.unlock();
-}
-
-/*
- *
- */
-void FrameBuffer::FBDrawHorzBlindsOpen(void) {
-    int rowsEachUpdate = 2;
-    int blindSize = 32;
-    int sleepTime = 800 * 1000 * rowsEachUpdate / blindSize;
-
-    m_bufferLock.lock();
-    for (int i = (blindSize - 1); i >= 0; i -= rowsEachUpdate) {
-        for (int y = i; y < m_height; y += blindSize) {
-            memcpy(FB_CURRENT_PAGE_PTR + (m_rowStride * y), m_outputBuffer + (m_rowStride * y),
-                   m_rowStride * rowsEachUpdate);
+        // if we are behind, keep drawing until caught up
+        auto due = start + std::chrono::microseconds((long long)m_transitionTime * 1000 * (i + 1) / count);
+        if (due > std::chrono::steady_clock::now()) {
+            std::this_thread::sleep_until(due);
         }
-
-        SyncDisplay();
-
-        usleep(sleepTime);
     }
     m_bufferLock.unlock();
 }
 
 /*
- *
+ * Compose the transition in the page that isn't displayed and flip to it
+ * on each vblank.  Each flip shows the step due at that point in time so a
+ * late vblank skips ahead rather than stretching out the transition.
  */
-void FrameBuffer::FBDrawHorzBlindsClose(void) {
-    int rowsEachUpdate = 2;
-    int blindSize = 32;
-    int sleepTime = 800 * 1000 * rowsEachUpdate / blindSize;
+void FrameBuffer::FBDrawPageFlipTransition(const std::vector<TransitionStep>& steps) {
+    int count = steps.size();
+    // last step applied to each page, -1 is the old image
+    std::vector<int> applied(m_pages, -1);
 
     m_bufferLock.lock();
-    for (int i = 0; i < blindSize; i += rowsEachUpdate) {
-        for (int y = i; y < m_height; y += blindSize) {
-            memcpy(FB_CURRENT_PAGE_PTR + (m_rowStride * y), m_outputBuffer + (m_rowStride * y),
-                   m_rowStride * rowsEachUpdate);
+    // the page that's not displayed may hold an older image
+    int front = m_cPage;
+    for (int p = 0; p < m_pages; p++) {
+        if (p != front) {
+            memcpy(m_pageBuffers[p], m_pageBuffers[front], m_pageSize);
         }
-
-        SyncDisplay();
-
-        usleep(sleepTime);
     }
-    m_bufferLock.unlock();
-}
-
-/*
- *
- */
-void FrameBuffer::FBDrawMosaic(void) {
-    int squareSize = 32;
-    int xSquares = m_width / squareSize + 1;
-    int ySquares = m_height / squareSize + 1;
-    std::vector<std::vector<int>> squares;
-    squares.resize(ySquares, std::vector<int>(xSquares, 0));
-    
-    int count = xSquares * ySquares;
-    int sleepTime = 800 * 1000 / count;
-
-
-    m_bufferLock.lock();
 
-    for (int i = 0; i < (count * 10); i++) {
-        int square = rand_r(&m_typeSeed) % (count - 1);
-        int x = square % xSquares;
-        int y = square / xSquares;
+    auto start = std::chrono::steady_clock::now();
+    int shown = -1;
+    int flips = 0;
+    uint32_t dropped = 0;
+    uint32_t lastSequence = 0;
+    while (shown < count - 1) {
+        long long elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        int target = std::min(count - 1, std::max(shown + 1, (int)(elapsed * count / ((long long)m_transitionTime * 1000))));
 
-        if (!squares[y][x]) {
-            DrawSquare(x * squareSize, y * squareSize, squareSize, squareSize);
-            squares[y][x] = 1;
-
-            SyncDisplay();
-
-            usleep(sleepTime);
+        int back = (m_cPage + 1) % m_pages;
+        for (int i = applied[back] + 1; i <= target; i++) {
+            ApplyTransitionStep(m_pageBuffers[back], steps[i]);
         }
-    }
+        applied[back] = target;
 
-    for (int y = 0; y < ySquares; y++) {
-        for (int x = 0; x < xSquares; x++) {
-            if (!squares[y][x]) {
-                DrawSquare(x * squareSize, y * squareSize, squareSize,
-                           squareSize);
-                squares[y][x] = 1;
-
-                SyncDisplay();
-
-                usleep(sleepTime);
+        uint32_t sequence = 0;
+        if (!FlipToPage(back, sequence)) {
+            // can't present, just finish the image in the back page
+            for (int i = target + 1; i < count; i++) {
+                ApplyTransitionStep(m_pageBuffers[back], steps[i]);
             }
+            m_cPage = back;
+            break;
+        }
+        if (flips && sequence > lastSequence + 1) {
+            dropped += sequence - lastSequence - 1;
         }
+        lastSequence = sequence;
+        m_cPage = back;
+        shown = target;
+        flips++;
     }
-
     m_bufferLock.unlock();
-}
-
-/////////////////////////////////////////////////////////////////////////////
-
-/*
- *
- */
-void FrameBuffer::DrawSquare(int dx, int dy, int w, int h, int sx, int sy) {
-    int dRowOffset = dx * m_bpp / 8;
-    int sRowOffset = ((sx == -1) ? dx : sx) * m_bpp / 8;
-    int bytesWide = w * m_bpp / 8;
-
-    if (sy == -1)
-        sy = dy;
 
-    for (int i = 0; i < h; i++) {
-        memcpy(FB_CURRENT_PAGE_PTR + (m_rowStride * (dy + i)) + dRowOffset,
-               m_outputBuffer + (m_rowStride * (sy + i)) + sRowOffset, bytesWide);
+    if (dropped > (uint32_t)flips / 10) {
+        LogWarn(VB_CHANNELOUT, "%s: transition missed %d of %d vblanks\n", m_name.c_str(), dropped, flips + dropped);
+    } else {
+        LogDebug(VB_CHANNELOUT, "%s: transition of %d steps in %d flips, %d vblanks missed\n", m_name.c_str(), count, flips, dropped);
     }
 }
 
+/////////////////////////////////////////////////////////////////////////////
+
 void FrameBuffer::ClearAllPages() {
     for (int x = 0; x < 3; x++) {
         if (m_pageBuffers[x]) {
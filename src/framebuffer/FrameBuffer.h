@@ -17,6 +17,7 @@
 #include <list>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #include "../config.h"
 
@@ -104,22 +105,27 @@ public:
 protected:
     int FBInit(const Json::Value& config);
     void FBDrawNormal(void);
-    void FBDrawSlideUp(void);
-    void FBDrawSlideDown(void);
-    void FBDrawSlideLeft(void);
-    void FBDrawSlideRight(void);
-    void FBDrawWipeUp(void);
-    void FBDrawWipeDown(void);
-    void FBDrawWipeLeft(void);
-    void FBDrawWipeRight(void);
-    void FBDrawWipeToHCenter(void);
-    void FBDrawWipeFromHCenter(void);
-    void FBDrawHorzBlindsOpen(void);
-    void FBDrawHorzBlindsClose(void);
-    void FBDrawMosaic(void);
-
-    // Helpers
-    void DrawSquare(int dx, int dy, int w, int h, int sx = -1, int sy = -1);
+
+    // Transitions are precomputed as a list of steps, each step being the
+    // rectangles of the new image (in m_outputBuffer) to copy onto the page.
+    // Applying every step up to N gives the image for step N.
+    struct TransitionRect {
+        int dx, dy; // destination, in pixels
+        int w, h;
+        int sx, sy; // source in m_outputBuffer
+    };
+    typedef std::vector<TransitionRect> TransitionStep;
+
+    std::vector<TransitionStep> BuildTransition(ImageTransitionType type);
+    void ApplyTransitionStep(uint8_t* page, const TransitionStep& step);
+    void FBDrawTransition(const std::vector<TransitionStep>& steps);
+    void FBDrawPageFlipTransition(const std::vector<TransitionStep>& steps);
+
+    // Devices which can queue a flip to a page for the next vblank and wait
+    // for it to complete.  FlipToPage returns false if the flip could not be
+    // done, sequence is set to the vblank counter the flip completed on.
+    virtual bool CanPageFlip() { return false; }
+    virtual bool FlipToPage(int page, uint32_t& sequence) { return false; }
 
     std::string m_name;
     std::string m_device;
@@ -163,4 +169,11 @@ protected:
     int m_bufferSize = 0;
     int m_rowStride = 0;
     int m_rowPadding = 0;
+
+    // FBConvertRows() scratch row for scaling up by m_pixelSize
+    std::vector<uint8_t> m_convertRow;
+    // page FBCopyData rendered the next image directly into, -1 if none
+    int m_directPage = -1;
+    // page still on screen while FBDrawNormal waits for the flip away from it
+    int m_flipFromPage = -1;
 };
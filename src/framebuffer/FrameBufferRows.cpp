@@ -0,0 +1,153 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+#include "fpp-pch.h"
+
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FB_HAS_NEON
+#endif
+
+#include "FrameBufferRows.h"
+
+/*
+ * Row converters from the RGB input to the framebuffer formats.  The NEON
+ * versions do 16 pixels per iteration, the tail (and non-NEON builds) go
+ * through the plain loops which the compiler is free to vectorize.
+ */
+static void RGBToBGRARow(const uint8_t* s, uint8_t* d, int w) {
+    int x = 0;
+#ifdef FB_HAS_NEON
+    for (; x + 16 <= w; x += 16, s += 48, d += 64) {
+        uint8x16x3_t rgb = vld3q_u8(s);
+        uint8x16x4_t bgra;
+        bgra.val[0] = rgb.val[2];
+        bgra.val[1] = rgb.val[1];
+        bgra.val[2] = rgb.val[0];
+        bgra.val[3] = vdupq_n_u8(0);
+        vst4q_u8(d, bgra);
+    }
+#endif
+    for (; x < w; x++, s += 3, d += 4) {
+        d[0] = s[2];
+        d[1] = s[1];
+        d[2] = s[0];
+        d[3] = 0;
+    }
+}
+
+static void RGBToBGRRow(const uint8_t* s, uint8_t* d, int w) {
+    int x = 0;
+#ifdef FB_HAS_NEON
+    for (; x + 16 <= w; x += 16, s += 48, d += 48) {
+        uint8x16x3_t rgb = vld3q_u8(s);
+        uint8x16_t t = rgb.val[0];
+        rgb.val[0] = rgb.val[2];
+        rgb.val[2] = t;
+        vst3q_u8(d, rgb);
+    }
+#endif
+    for (; x < w; x++, s += 3, d += 3) {
+        d[0] = s[2];
+        d[1] = s[1];
+        d[2] = s[0];
+    }
+}
+
+static void RGBToRGB565Row(const uint8_t* s, uint8_t* dst, int w) {
+    uint16_t* d = (uint16_t*)dst;
+    int x = 0;
+#ifdef FB_HAS_NEON
+    for (; x + 16 <= w; x += 16, s += 48, d += 16) {
+        uint8x16x3_t rgb = vld3q_u8(s);
+        // red in the top 5 bits, then shift green and blue in below it
+        uint16x8_t lo = vshll_n_u8(vget_low_u8(rgb.val[0]), 8);
+        lo = vsriq_n_u16(lo, vshll_n_u8(vget_low_u8(rgb.val[1]), 8), 5);
+        lo = vsriq_n_u16(lo, vshll_n_u8(vget_low_u8(rgb.val[2]), 8), 11);
+        uint16x8_t hi = vshll_n_u8(vget_high_u8(rgb.val[0]), 8);
+        hi = vsriq_n_u16(hi, vshll_n_u8(vget_high_u8(rgb.val[1]), 8), 5);
+        hi = vsriq_n_u16(hi, vshll_n_u8(vget_high_u8(rgb.val[2]), 8), 11);
+        vst1q_u16(d, lo);
+        vst1q_u16(d + 8, hi);
+    }
+#endif
+    for (; x < w; x++, s += 3, d++) {
+        *d = ((s[0] & 0xF8) << 8) | ((s[1] & 0xFC) << 3) | (s[2] >> 3);
+    }
+}
+
+// Repeat each converted pixel scale times across the output row
+template<typename T>
+static void ScalePixels(const T* s, T* d, int w, int scale) {
+    for (int x = 0; x < w; x++) {
+        T v = s[x];
+        for (int sc = 0; sc < scale; sc++) {
+            *d++ = v;
+        }
+    }
+}
+
+static void ScaleRow(const uint8_t* s, uint8_t* d, int w, int bytesPerPixel, int scale) {
+    if (bytesPerPixel == 4) {
+        ScalePixels((const uint32_t*)s, (uint32_t*)d, w, scale);
+    } else {
+        ScalePixels((const uint16_t*)s, (uint16_t*)d, w, scale);
+    }
+}
+
+// Scaled 24bpp goes straight from the input to the output row, converting
+// into a scratch row and then replicating 3 byte pixels was slower than
+// this byte loop
+static void RGBToBGRScaledRow(const uint8_t* s, uint8_t* d, int w, int scale) {
+    for (int x = 0; x < w; x++, s += 3) {
+        for (int sc = 0; sc < scale; sc++, d += 3) {
+            d[0] = s[2];
+            d[1] = s[1];
+            d[2] = s[0];
+        }
+    }
+}
+
+void FBConvertRows(const uint8_t* src, uint8_t* dst, int width, int height, int bpp,
+                   int scale, int rowStride, std::vector<uint8_t>& scratch) {
+    // Input is always RGB, output is BGR(A) or RGB565 depending on bpp
+    void (*convert)(const uint8_t*, uint8_t*, int) = RGBToBGRRow;
+    if (bpp == 32) {
+        convert = RGBToBGRARow;
+    } else if (bpp == 16) {
+        convert = RGBToRGB565Row;
+    }
+    int bytesPerPixel = bpp / 8;
+    if (scale > 1 && bpp != 24) {
+        scratch.resize(width * bytesPerPixel);
+    }
+
+    for (int y = 0; y < height; y++) {
+        uint8_t* d = dst + (y * scale * rowStride);
+        if (scale == 1) {
+            convert(src, d, width);
+        } else {
+            if (bpp == 24) {
+                RGBToBGRScaledRow(src, d, width, scale);
+            } else {
+                convert(src, scratch.data(), width);
+                ScaleRow(scratch.data(), d, width, bytesPerPixel, scale);
+            }
+            for (int sc = 1; sc < scale; sc++) {
+                memcpy(d + (sc * rowStride), d, rowStride);
+            }
+        }
+        src += width * 3;
+    }
+}
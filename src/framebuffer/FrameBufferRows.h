@@ -0,0 +1,25 @@
+#pragma once
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+#include <cstdint>
+#include <vector>
+
+/*
+ * Convert 'height' rows of 'width' RGB input pixels into a framebuffer
+ * page in the device format for 'bpp' (32 = BGRA, 24 = BGR, 16 = RGB565),
+ * drawing each pixel as a 'scale' x 'scale' block.  Output rows are
+ * 'rowStride' bytes apart.  'scratch' holds one converted row when scaling
+ * and is reused between calls.
+ */
+void FBConvertRows(const uint8_t* src, uint8_t* dst, int width, int height, int bpp,
+                   int scale, int rowStride, std::vector<uint8_t>& scratch);
@@ -278,6 +278,7 @@ int IOCTLFrameBuffer::InitializeFrameBuffer() {
                 }
             }
         }
+        m_rgb565Standard = (m_rgb565map[31][0][0] == 0xF800) && (m_rgb565map[0][63][0] == 0x07E0) && (m_rgb565map[0][0][31] == 0x001F);
     }
     return 1;
 }
@@ -309,7 +310,7 @@ void IOCTLFrameBuffer::DestroyFrameBuffer(void) {
  *
  */
 void IOCTLFrameBuffer::FBCopyData(const uint8_t* buffer, int draw) {
-    if (m_bpp == 16) {
+    if (m_bpp == 16 && !m_rgb565Standard) {
         int sBpp = 3;
         uint8_t* d;
 
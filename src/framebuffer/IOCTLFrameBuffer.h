@@ -37,6 +37,8 @@ public:
 
     // Support for 16-bit framebuffer output
     uint16_t*** m_rgb565map = nullptr;
+    // true if the map is plain RGB565 and the base class converter can be used
+    bool m_rgb565Standard = false;
 };
 
 #endif
\ No newline at end of file
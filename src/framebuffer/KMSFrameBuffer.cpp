@@ -19,6 +19,7 @@
 #include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <unistd.h>
 
 #include "../common_mini.h"
@@ -471,32 +472,84 @@ void KMSFrameBuffer::SyncDisplay(bool pageChanged) {
     if (!pageChanged | m_pages == 1)
         return;
 
-    std::unique_lock<std::mutex> lock(mediaOutputLock);
-    if (mediaOutputStatus.mediaLoading) {
-        return;
+    uint32_t sequence = 0;
+    FlipToPage(m_cPage, sequence);
+}
+
+void KMSFrameBuffer::PageFlipHandler(int fd, unsigned int sequence, unsigned int sec, unsigned int usec, void* data) {
+    PendingFlip* flip = (PendingFlip*)data;
+    flip->sequence = sequence;
+    flip->done = true;
+}
+
+bool KMSFrameBuffer::WaitForFlip(int timeoutMS) {
+    drmEventContext ctx = {};
+    ctx.version = 2;
+    ctx.page_flip_handler = PageFlipHandler;
+
+    // another framebuffer on the same card may read our event, so only poll
+    // in short slices and recheck the flag
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMS);
+    while (!m_flip.done) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        struct pollfd pfd = { m_cardFd, POLLIN, 0 };
+        if (poll(&pfd, 1, 20) > 0 && (pfd.revents & POLLIN)) {
+            drmHandleEvent(m_cardFd, &ctx);
+        }
     }
-    if (mediaOutputStatus.output != m_connectorName) {
-        int im = ioctl(m_cardFd, DRM_IOCTL_SET_MASTER, 0);
-        if (im == 0) {
-            int ret = drmModePageFlip(m_cardFd, m_crtcId, m_fb[m_cPage].fb_id,
-                                      0, nullptr);
-            if (ret) {
-                if (!m_displayEnabled) {
-                    drmModeSetCrtc(m_cardFd, m_crtcId, m_fb[m_cPage].fb_id, 0, 0,
-                                   &m_connectorId, 1, &m_mode);
-                    m_displayEnabled = true;
-                }
-                if (m_planeId) {
-                    drmModeSetPlane(m_cardFd, m_planeId, m_crtcId, m_fb[m_cPage].fb_id, 0,
-                                    0, 0, m_mode.hdisplay, m_mode.vdisplay,
-                                    0, 0, (uint32_t)m_width << 16, (uint32_t)m_height << 16);
-                }
-                drmModePageFlip(m_cardFd, m_crtcId, m_fb[m_cPage].fb_id,
-                                0, nullptr);
+    return true;
+}
+
+bool KMSFrameBuffer::FlipToPage(int page, uint32_t& sequence) {
+    // a flip still pending from a previous call would make this one fail
+    if (!WaitForFlip(200)) {
+        LogWarn(VB_CHANNELOUT, "%s: timed out waiting for previous page flip\n", m_name.c_str());
+        m_flip.done = true;
+    }
+
+    bool queued = false;
+    {
+        std::unique_lock<std::mutex> lock(mediaOutputLock);
+        if (mediaOutputStatus.mediaLoading || mediaOutputStatus.output == m_connectorName) {
+            return false;
+        }
+        if (ioctl(m_cardFd, DRM_IOCTL_SET_MASTER, 0)) {
+            return false;
+        }
+        m_flip.done = false;
+        int ret = drmModePageFlip(m_cardFd, m_crtcId, m_fb[page].fb_id, DRM_MODE_PAGE_FLIP_EVENT, &m_flip);
+        if (ret) {
+            if (!m_displayEnabled) {
+                drmModeSetCrtc(m_cardFd, m_crtcId, m_fb[page].fb_id, 0, 0,
+                               &m_connectorId, 1, &m_mode);
+                m_displayEnabled = true;
             }
-            ioctl(m_cardFd, DRM_IOCTL_DROP_MASTER, 0);
+            if (m_planeId) {
+                drmModeSetPlane(m_cardFd, m_planeId, m_crtcId, m_fb[page].fb_id, 0,
+                                0, 0, m_mode.hdisplay, m_mode.vdisplay,
+                                0, 0, (uint32_t)m_width << 16, (uint32_t)m_height << 16);
+            }
+            ret = drmModePageFlip(m_cardFd, m_crtcId, m_fb[page].fb_id, DRM_MODE_PAGE_FLIP_EVENT, &m_flip);
         }
+        queued = (ret == 0);
+        if (!queued) {
+            // SetCrtc/SetPlane already put the page on screen
+            m_flip.done = true;
+        }
+        ioctl(m_cardFd, DRM_IOCTL_DROP_MASTER, 0);
+    }
+
+    if (!queued) {
+        sequence = 0;
+        return true;
+    }
+    if (!WaitForFlip(200)) {
+        return false;
     }
+    sequence = m_flip.sequence;
+    return true;
 }
 
 void KMSFrameBuffer::DisableDisplay() {
@@ -50,6 +50,9 @@ public:
     virtual void SyncLoop() override;
     virtual void SyncDisplay(bool pageChanged = false) override;
 
+    virtual bool CanPageFlip() override { return m_pages > 1; }
+    virtual bool FlipToPage(int page, uint32_t& sequence) override;
+
     virtual void EnableDisplay() override;
     virtual void DisableDisplay() override;
 
@@ -70,6 +73,17 @@ private:
     static bool CreateDumbBuffer(int fd, uint32_t width, uint32_t height, uint32_t format, DumbBuffer& buf);
     static void DestroyDumbBuffer(int fd, DumbBuffer& buf);
     uint32_t FindPlaneForCrtc(int fd, uint32_t crtcId, uint32_t format);
+
+    // Completion of the last page flip, filled in by whichever thread reads
+    // the event off the (possibly shared) card fd
+    struct PendingFlip {
+        std::atomic_bool done = true;
+        std::atomic_uint32_t sequence = 0;
+    };
+    PendingFlip m_flip;
+    static void PageFlipHandler(int fd, unsigned int sequence, unsigned int sec, unsigned int usec, void* data);
+    bool WaitForFlip(int timeoutMS);
+
     CardInfo* m_cardInfo = nullptr;
 };
 
@@ -2,6 +2,7 @@
 #define _FILE_OFFSET_BITS 64
 #define __STDC_FORMAT_MACROS
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include <vector>
@@ -474,7 +475,8 @@ inline bool isRecognizedBinaryVariableHeader(uint8_t a, uint8_t b) {
     // XS - xLight xsq (zstd compressed binary)
     // XN - xLight xlights_network.xml (zstd compressed binary)
     // XR - xLight xlights_rgbeffects.xml (zstd compressed binary)
-    return (a == 'F' && b == 'C') || (a == 'F' && b == 'E') || (a == 'E' && b == 'D') || (a == 'X' && b == 'S') || (a == 'X' && b == 'N') || (a == 'X' && b == 'R');
+    // CG - Channel group size for grouped compression blocks
+    return (a == 'F' && b == 'C') || (a == 'F' && b == 'E') || (a == 'E' && b == 'D') || (a == 'X' && b == 'S') || (a == 'X' && b == 'N') || (a == 'X' && b == 'R') || (a == 'C' && b == 'G');
 }
 void FSEQFile::VariableHeader::loadData() const {
     if (!data.empty() || length == 0 || !fseqFile) {
@@ -675,6 +677,22 @@ V1FSEQFile::V1FSEQFile(const std::string& fn, FILE* file, const std::vector<uint
 V1FSEQFile::~V1FSEQFile() {
 }
 
+bool FrameData::readPacked(uint8_t* data, const std::vector<std::pair<uint32_t, uint32_t>>& ranges) {
+    uint32_t maxChannel = 0;
+    for (auto& rng : ranges) {
+        maxChannel = std::max(maxChannel, rng.first + rng.second);
+    }
+    std::vector<uint8_t> frame(maxChannel);
+    if (!readFrame(frame.data(), maxChannel)) {
+        return false;
+    }
+    for (auto& rng : ranges) {
+        memcpy(data, &frame[rng.first], rng.second);
+        data += rng.second;
+    }
+    return true;
+}
+
 class UncompressedFrameData : public FSEQFile::FrameData {
 public:
     UncompressedFrameData(uint32_t frame,
@@ -707,6 +725,22 @@ public:
         }
         return true;
     }
+    virtual bool readPacked(uint8_t* data, const std::vector<std::pair<uint32_t, uint32_t>>& ranges) override {
+        // m_data is already packed for m_ranges
+        if (ranges != m_ranges) {
+            return FrameData::readPacked(data, ranges);
+        }
+        if (m_data == nullptr)
+            return false;
+        uint32_t size = 0;
+        for (auto& rng : ranges) {
+            size += rng.second;
+        }
+        if (size > m_size)
+            return false;
+        memcpy(data, m_data, size);
+        return true;
+    }
 
     uint32_t m_size;
     uint8_t* m_data;
@@ -791,6 +825,7 @@ uint32_t V1FSEQFile::getMaxChannel() const {
 static constexpr int V2FSEQ_HEADER_SIZE = 32;
 static constexpr int V2FSEQ_SPARSE_RANGE_SIZE = 6;
 static constexpr int V2FSEQ_COMPRESSION_BLOCK_SIZE = 8;
+static constexpr int V2FSEQ_MIN_CHANNEL_GROUP_SIZE = 16384;
 #if !defined(NO_ZLIB) || !defined(NO_ZSTD)
 static int V2FSEQ_OUT_BUFFER_SIZE = 0;                               // will be computed based on memory available
 static constexpr int V2FSEQ_OUT_BUFFER_FLUSH_SIZE = 4 * 1024 * 1024; // 50% full, flush it
@@ -925,6 +960,7 @@ public:
         }
     }
     virtual ~V2CompressedHandler() {
+        stopCompressionThreads();
         if (m_readThread) {
             m_readThreadRunning = false;
             m_readSignal.notify_all();
@@ -1131,9 +1167,199 @@ public:
     std::list<int> m_blocksToRead;
     std::condition_variable m_readSignal;
     int m_firstBlock = 0;
+
+    // Parallel compression.  When m_file->m_compressionThreads > 1 and the
+    // handler implements compressBlock(), complete blocks of uncompressed
+    // frames are queued to a pool of workers that each compress a whole
+    // block and a writer thread writes the blocks out in order, recording
+    // each block's offset in m_frameOffsets.
+    struct QueuedBlock {
+        uint32_t firstFrame = 0;
+        uint32_t frames = 0;
+        int level = 0;
+        std::vector<uint8_t> data;
+        std::vector<uint8_t> compressed;
+        bool done = false;
+    };
+
+    virtual bool supportsParallelCompression() const { return false; }
+    virtual int blockCompressionLevel(uint32_t frame) { return 0; }
+    // Compress block.data (block.frames frames of getChannelCount() channels)
+    // into block.compressed.  Called from the worker threads.
+    virtual void compressBlock(QueuedBlock& block) {}
+
+    bool useCompressionThreads() {
+        return supportsParallelCompression() && m_file->m_compressionThreads > 1;
+    }
+
+    // Append a frame (with the sparse ranges applied) to the block being
+    // built.  Returns true if the block is complete.
+    bool appendFrame(uint32_t frame, const uint8_t* data, std::vector<uint8_t>& block) {
+        if (m_curFrameInBlock == 0) {
+            block.reserve((size_t)std::max(m_framesPerBlock, (uint32_t)10) * m_file->getChannelCount());
+        }
+        size_t pos = block.size();
+        block.resize(pos + m_file->getChannelCount());
+        if (m_file->m_sparseRanges.empty()) {
+            memcpy(&block[pos], data, m_file->getChannelCount());
+        } else {
+            for (auto& a : m_file->m_sparseRanges) {
+                memcpy(&block[pos], &data[a.first], a.second);
+                pos += a.second;
+            }
+        }
+        m_curFrameInBlock++;
+        // if we hit the max per block OR we're in the first block and hit frame #10
+        // we'll start a new block.  We want the first block to be small so startup is
+        // quicker and we can get the first few frames as fast as possible.
+        return (m_curBlock == 0 && m_curFrameInBlock == 10) || (m_curFrameInBlock >= m_framesPerBlock && (m_curBlock + 1) < m_maxBlocks);
+    }
+
+    void addFrameParallel(uint32_t frame, const uint8_t* data) {
+        if (!m_queuedBlock) {
+            m_queuedBlock = std::make_unique<QueuedBlock>();
+            m_queuedBlock->firstFrame = frame;
+            m_queuedBlock->level = blockCompressionLevel(frame);
+        }
+        if (appendFrame(frame, data, m_queuedBlock->data)) {
+            queueBlock();
+        }
+    }
+
+    void queueBlock() {
+        if (!m_queuedBlock) {
+            return;
+        }
+        m_queuedBlock->frames = m_curFrameInBlock;
+        m_curFrameInBlock = 0;
+        m_curBlock++;
+
+        std::unique_lock<std::mutex> lock(m_compressMutex);
+        if (m_compressThreads.empty()) {
+            startCompressionThreads();
+        }
+        // don't let the reader get too far ahead of the compression
+        m_compressSignal.wait(lock, [this]() { return m_writeQueue.size() < m_compressThreads.size() * 2; });
+        m_compressQueue.push_back(m_queuedBlock.get());
+        m_writeQueue.push_back(std::move(m_queuedBlock));
+        m_compressSignal.notify_all();
+    }
+
+    void startCompressionThreads() {
+        int count = m_file->m_compressionThreads;
+        m_compressRunning = true;
+        m_compressStart = std::chrono::steady_clock::now();
+        for (int x = 0; x < count; x++) {
+            m_compressThreads.emplace_back([this]() {
+                SetThreadName("FSEQCompress");
+                std::unique_lock<std::mutex> lock(m_compressMutex);
+                while (true) {
+                    m_compressSignal.wait(lock, [this]() { return m_compressAbort || !m_compressRunning || !m_compressQueue.empty(); });
+                    if (m_compressAbort || m_compressQueue.empty()) {
+                        break;
+                    }
+                    QueuedBlock* block = m_compressQueue.front();
+                    m_compressQueue.pop_front();
+                    lock.unlock();
+                    compressBlock(*block);
+                    std::vector<uint8_t>().swap(block->data);
+                    lock.lock();
+                    block->done = true;
+                    m_compressSignal.notify_all();
+                }
+            });
+        }
+        m_compressThreads.emplace_back([this]() {
+            SetThreadName("FSEQWrite");
+            std::unique_lock<std::mutex> lock(m_compressMutex);
+            while (true) {
+                m_compressSignal.wait(lock, [this]() {
+                    return m_compressAbort || (!m_writeQueue.empty() && m_writeQueue.front()->done) || (!m_compressRunning && m_writeQueue.empty());
+                });
+                if (m_compressAbort || m_writeQueue.empty()) {
+                    break;
+                }
+                std::unique_ptr<QueuedBlock> block = std::move(m_writeQueue.front());
+                m_writeQueue.pop_front();
+                m_compressSignal.notify_all();
+                lock.unlock();
+                m_file->m_frameOffsets.push_back(std::pair<uint32_t, uint64_t>(block->firstFrame, tell()));
+                write(&block->compressed[0], block->compressed.size());
+                m_compressedBytes += block->compressed.size();
+                lock.lock();
+            }
+        });
+    }
+
+    // Waits for all queued blocks to be compressed and written
+    void finishCompressionThreads() {
+        if (m_compressThreads.empty()) {
+            return;
+        }
+        {
+            std::unique_lock<std::mutex> lock(m_compressMutex);
+            m_compressRunning = false;
+        }
+        m_compressSignal.notify_all();
+        for (auto& t : m_compressThreads) {
+            t.join();
+        }
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_compressStart).count();
+        LogDebug(VB_SEQUENCE, "  Compressed %d blocks with %d threads in %.3f seconds, %" PRIu64 " bytes written.\n",
+                 m_curBlock, (int)m_compressThreads.size() - 1, secs, m_compressedBytes);
+        m_compressThreads.clear();
+    }
+    // Drops anything not yet compressed, must be called by handlers that
+    // implement compressBlock() before they are destroyed
+    void stopCompressionThreads() {
+        {
+            std::unique_lock<std::mutex> lock(m_compressMutex);
+            m_compressAbort = true;
+        }
+        finishCompressionThreads();
+        m_compressQueue.clear();
+        m_writeQueue.clear();
+    }
+
+    std::unique_ptr<QueuedBlock> m_queuedBlock;
+    std::list<QueuedBlock*> m_compressQueue;
+    std::list<std::unique_ptr<QueuedBlock>> m_writeQueue;
+    std::vector<std::thread> m_compressThreads;
+    std::mutex m_compressMutex;
+    std::condition_variable m_compressSignal;
+    bool m_compressRunning = false;
+    bool m_compressAbort = false;
+    uint64_t m_compressedBytes = 0;
+    std::chrono::steady_clock::time_point m_compressStart;
 };
 
 #ifndef NO_ZSTD
+static int ZSTDBlockLevel(int level, uint32_t frame) {
+    int clevel = level == -99 ? 2 : level;
+    if (clevel < -25 || clevel > 25) {
+        clevel = 2;
+    }
+    if (frame == 0 && (ZSTD_versionNumber() > 10305)) {
+        // first frame needs to be grabbed as fast as possible
+        // or remotes may be off by a few frames at start.  Thus,
+        // if using recent zstd, we'll use the negative levels
+        // for the first block so the decompression can
+        // be as fast as possible
+        clevel = -10;
+    }
+    if (ZSTD_versionNumber() <= 10305 && clevel < 0) {
+        clevel = 0;
+    }
+    return clevel;
+}
+
+// Compression context for the current thread, used by the parallel
+// compression workers
+static ZSTD_CCtx* ZSTDWorkerContext() {
+    static thread_local std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)> cctx(ZSTD_createCCtx(), ZSTD_freeCCtx);
+    return cctx.get();
+}
+
 class V2ZSTDCompressionHandler : public V2CompressedHandler {
 public:
     V2ZSTDCompressionHandler(V2FSEQFile* f) :
@@ -1160,6 +1386,7 @@ public:
         LogDebug(VB_SEQUENCE, "  Prepared to read/write a ZSTD compress fseq file.\n");
     }
     virtual ~V2ZSTDCompressionHandler() {
+        stopCompressionThreads();
         free(m_outBuffer.dst);
         if (m_cctx) {
             ZSTD_freeCStream(m_cctx);
@@ -1211,6 +1438,7 @@ public:
         if (fidx >= m_curFrameInBlock) {
             m_outBuffer.size = (fidx + 1) * m_file->getChannelCount();
             ZSTD_decompressStream(m_dctx, &m_outBuffer, &m_inBuffer);
+            decodeFrames(m_curFrameInBlock, fidx);
             m_curFrameInBlock = fidx + 1;
         }
 
@@ -1241,6 +1469,10 @@ public:
         }
         return data;
     }
+    // called with the range of frames (relative to the block) that were
+    // just decompressed into m_outBuffer
+    virtual void decodeFrames(uint32_t first, uint32_t last) {}
+
     void compressData(ZSTD_CStream* m_cctx, ZSTD_inBuffer_s& input, ZSTD_outBuffer_s& output) {
         ZSTD_compressStream2(m_cctx, &output, &input, ZSTD_e_continue);
         size_t count = input.pos;
@@ -1259,7 +1491,28 @@ public:
             count += input.pos;
         }
     }
+    virtual bool supportsParallelCompression() const override { return true; }
+    virtual int blockCompressionLevel(uint32_t frame) override {
+        return ZSTDBlockLevel(m_file->m_compressionLevel, frame);
+    }
+    virtual void compressBlock(QueuedBlock& block) override {
+        ZSTD_CCtx* cctx = ZSTDWorkerContext();
+        ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters);
+        ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, block.level);
+        block.compressed.resize(ZSTD_compressBound(block.data.size()));
+        size_t r = ZSTD_compress2(cctx, &block.compressed[0], block.compressed.size(), &block.data[0], block.data.size());
+        if (ZSTD_isError(r)) {
+            LogErr(VB_SEQUENCE, "Error compressing block starting at frame %d: %s\n", block.firstFrame, ZSTD_getErrorName(r));
+            r = 0;
+        }
+        block.compressed.resize(r);
+    }
+
     virtual void addFrame(uint32_t frame, const uint8_t* data) override {
+        if (useCompressionThreads()) {
+            addFrameParallel(frame, data);
+            return;
+        }
         if (m_cctx == nullptr) {
             m_cctx = ZSTD_createCStream();
         }
@@ -1267,22 +1520,7 @@ public:
             uint64_t offset = tell();
             // LogDebug(VB_SEQUENCE, "  Preparing to create a compressed block of data starting at frame %d, offset  %" PRIu64 ".\n", frame, offset);
             m_file->m_frameOffsets.push_back(std::pair<uint32_t, uint64_t>(frame, offset));
-            int clevel = m_file->m_compressionLevel == -99 ? 2 : m_file->m_compressionLevel;
-            if (clevel < -25 || clevel > 25) {
-                clevel = 2;
-            }
-            if (frame == 0 && (ZSTD_versionNumber() > 10305)) {
-                // first frame needs to be grabbed as fast as possible
-                // or remotes may be off by a few frames at start.  Thus,
-                // if using recent zstd, we'll use the negative levels
-                // for the first block so the decompression can
-                // be as fast as possible
-                clevel = -10;
-            }
-            if (ZSTD_versionNumber() <= 10305 && clevel < 0) {
-                clevel = 0;
-            }
-            ZSTD_initCStream(m_cctx, clevel);
+            ZSTD_initCStream(m_cctx, ZSTDBlockLevel(m_file->m_compressionLevel, frame));
         }
 
         uint8_t* curData = (uint8_t*)data;
@@ -1330,7 +1568,10 @@ public:
         }
     }
     virtual void finalize() override {
-        if (m_curFrameInBlock) {
+        if (useCompressionThreads()) {
+            queueBlock();
+            finishCompressionThreads();
+        } else if (m_curFrameInBlock) {
             ZSTD_inBuffer_s input = {
                 0, 0, 0
             };
@@ -1352,6 +1593,373 @@ public:
     ZSTD_outBuffer_s m_outBuffer;
     ZSTD_inBuffer_s m_inBuffer;
 };
+
+// Each frame is XOR'd with the previous frame before being compressed.
+// Most channels don't change from one frame to the next so the XOR'd
+// frames are mostly zeros which zstd compresses far better (and
+// decompresses faster) than the raw frames.  The first frame of every
+// block is stored as-is (key frame) so blocks can still be decoded
+// independently for seeking.
+class V2ZSTDDeltaCompressionHandler : public V2ZSTDCompressionHandler {
+public:
+    V2ZSTDDeltaCompressionHandler(V2FSEQFile* f) :
+        V2ZSTDCompressionHandler(f) {}
+    virtual ~V2ZSTDDeltaCompressionHandler() {}
+
+    virtual uint8_t getCompressionType() override { return 3; }
+    virtual std::string GetType() const override { return "Compressed ZSTD Delta"; }
+
+    virtual void decodeFrames(uint32_t first, uint32_t last) override {
+        // channels are independent of each other so only the channels that
+        // will be copied out need to be reconstructed
+        uint32_t channelCount = m_file->getChannelCount();
+        uint8_t* data = (uint8_t*)m_outBuffer.dst;
+        for (uint32_t f = std::max(first, (uint32_t)1); f <= last; f++) {
+            uint8_t* cur = &data[(size_t)f * channelCount];
+            uint8_t* prev = cur - channelCount;
+            if (!m_file->m_sparseRanges.empty()) {
+                XORFrame(cur, prev, channelCount);
+            } else {
+                for (auto& rng : m_xorRanges) {
+                    XORFrame(&cur[rng.first], &prev[rng.first], rng.second);
+                }
+            }
+        }
+    }
+
+    virtual void prepareRead(uint32_t frame) override {
+        // XOR'ing a channel twice undoes it, so overlapping read ranges
+        // (fsequtils -r, MultiSync slices) are merged first
+        m_xorRanges = MergeRanges(m_file->m_rangesToRead, m_file->getChannelCount());
+        V2ZSTDCompressionHandler::prepareRead(frame);
+    }
+
+    virtual void addFrame(uint32_t frame, const uint8_t* data) override {
+        uint32_t size = m_file->getMaxChannel();
+        if (m_prevFrame.size() < size) {
+            m_prevFrame.resize(size);
+            m_delta.resize(size);
+        }
+        if (m_curFrameInBlock == 0) {
+            // key frame
+            memcpy(&m_prevFrame[0], data, size);
+            V2ZSTDCompressionHandler::addFrame(frame, data);
+            return;
+        }
+        if (m_file->m_sparseRanges.empty()) {
+            XORFrame(&m_delta[0], data, &m_prevFrame[0], size);
+            memcpy(&m_prevFrame[0], data, size);
+        } else {
+            if (m_sparseXorRanges.empty()) {
+                m_sparseXorRanges = MergeRanges(m_file->m_sparseRanges, size);
+            }
+            for (auto& a : m_sparseXorRanges) {
+                XORFrame(&m_delta[a.first], &data[a.first], &m_prevFrame[a.first], a.second);
+                memcpy(&m_prevFrame[a.first], &data[a.first], a.second);
+            }
+        }
+        V2ZSTDCompressionHandler::addFrame(frame, &m_delta[0]);
+    }
+
+private:
+    // Sorted, non-overlapping copy of ranges clipped to channelCount
+    static std::vector<std::pair<uint32_t, uint32_t>> MergeRanges(std::vector<std::pair<uint32_t, uint32_t>> ranges, uint32_t channelCount) {
+        std::sort(ranges.begin(), ranges.end());
+        std::vector<std::pair<uint32_t, uint32_t>> merged;
+        for (auto& rng : ranges) {
+            if (rng.first >= channelCount || rng.second == 0) {
+                continue;
+            }
+            uint32_t end = rng.first + std::min(rng.second, channelCount - rng.first);
+            if (!merged.empty() && rng.first <= merged.back().first + merged.back().second) {
+                merged.back().second = std::max(merged.back().first + merged.back().second, end) - merged.back().first;
+            } else {
+                merged.push_back(std::pair<uint32_t, uint32_t>(rng.first, end - rng.first));
+            }
+        }
+        return merged;
+    }
+
+    static void XORFrame(uint8_t* dst, const uint8_t* prev, uint32_t len) {
+        XORFrame(dst, dst, prev, len);
+    }
+    static void XORFrame(uint8_t* dst, const uint8_t* a, const uint8_t* b, uint32_t len) {
+        uint32_t x = 0;
+        for (; x + 8 <= len; x += 8) {
+            uint64_t va, vb;
+            memcpy(&va, &a[x], 8);
+            memcpy(&vb, &b[x], 8);
+            va ^= vb;
+            memcpy(&dst[x], &va, 8);
+        }
+        for (; x < len; x++) {
+            dst[x] = a[x] ^ b[x];
+        }
+    }
+
+    std::vector<uint8_t> m_prevFrame;
+    std::vector<uint8_t> m_delta;
+    std::vector<std::pair<uint32_t, uint32_t>> m_xorRanges;
+    std::vector<std::pair<uint32_t, uint32_t>> m_sparseXorRanges;
+};
+
+// FSEQ 2.3 channel grouped zstd blocks.  Each compression block is split
+// into groups of m_channelGroupSize channels which are compressed as
+// separate zstd frames so a reader only needs to decompress the groups
+// that contain the channels it was asked for.  Each block is laid out as:
+//     uint32_t compressedLength[numGroups]
+//     numGroups zstd frames, each holding that group's channels for every
+//     frame in the block, one frame after another
+class V2ZSTDGroupedCompressionHandler : public V2CompressedHandler {
+public:
+    V2ZSTDGroupedCompressionHandler(V2FSEQFile* f) :
+        V2CompressedHandler(f),
+        m_groupSize(0),
+        m_numGroups(0) {
+        LogDebug(VB_SEQUENCE, "  Prepared to read/write a channel grouped ZSTD compress fseq file.\n");
+    }
+    virtual ~V2ZSTDGroupedCompressionHandler() {
+        stopCompressionThreads();
+        for (auto& g : m_groups) {
+            if (g.dctx) {
+                ZSTD_freeDStream(g.dctx);
+            }
+        }
+    }
+    virtual uint8_t getCompressionType() override { return 1; }
+    virtual std::string GetType() const override { return "Compressed ZSTD (Channel Grouped)"; }
+
+    virtual void prepareRead(uint32_t frame) override {
+        setupGroups();
+        uint32_t channelCount = m_file->getChannelCount();
+
+        // sparse files are always read completely, otherwise only decompress
+        // the groups that intersect the ranges that were requested
+        if (m_file->m_sparseRanges.empty()) {
+            for (auto& grp : m_groups) {
+                grp.needed = false;
+            }
+            for (auto& rng : m_file->m_rangesToRead) {
+                if (rng.first >= channelCount || rng.second == 0) {
+                    continue;
+                }
+                uint32_t last = std::min(rng.first + rng.second, channelCount) - 1;
+                for (uint32_t g = rng.first / m_groupSize; g <= last / m_groupSize; g++) {
+                    m_groups[g].needed = true;
+                }
+            }
+        }
+        int needed = 0;
+        for (auto& grp : m_groups) {
+            needed += grp.needed ? 1 : 0;
+        }
+        LogDebug(VB_SEQUENCE, "  Channel groups: %d of %d channels, %d groups needed for reading\n", m_numGroups, m_groupSize, needed);
+        V2CompressedHandler::prepareRead(frame);
+    }
+
+    virtual FrameData* getFrame(uint32_t frame) override {
+        setupGroups();
+        uint32_t channelCount = m_file->getChannelCount();
+        if (m_curBlock >= m_file->m_frameOffsets.size() || (frame < m_file->m_frameOffsets[m_curBlock].first) || (frame >= m_file->m_frameOffsets[m_curBlock + 1].first)) {
+            // frame is not in the current block
+            m_curBlock = 0;
+            while (frame >= m_file->m_frameOffsets[m_curBlock + 1].first) {
+                m_curBlock++;
+            }
+            uint64_t len = m_file->m_frameOffsets[m_curBlock + 1].second;
+            len -= m_file->m_frameOffsets[m_curBlock].second;
+            uint64_t max = m_file->getNumFrames() * channelCount;
+            if (len > max) {
+                len = max;
+            }
+            const uint8_t* block = getBlock(m_curBlock);
+            if (m_curBlock < m_file->m_frameOffsets.size() - 2) {
+                // let the kernel know that we'll likely need the next block in the near future
+                preloadBlock(m_curBlock + 1);
+            }
+            m_framesPerBlock = (m_file->m_frameOffsets[m_curBlock + 1].first > m_file->getNumFrames() ? m_file->getNumFrames() : m_file->m_frameOffsets[m_curBlock + 1].first) - m_file->m_frameOffsets[m_curBlock].first;
+            m_curFrameInBlock = 0;
+
+            uint64_t pos = m_numGroups * 4;
+            for (uint32_t g = 0; g < m_numGroups; g++) {
+                Group& grp = m_groups[g];
+                uint32_t clen = pos <= len ? read4ByteUInt(&block[g * 4]) : 0;
+                if (pos + clen > len) {
+                    LogErr(VB_SEQUENCE, "Channel group %d of block %d extends past the end of the block\n", g, m_curBlock);
+                    clen = pos < len ? len - pos : 0;
+                }
+                grp.in.src = &block[pos];
+                grp.in.size = clen;
+                grp.in.pos = 0;
+                pos += clen;
+
+                if (grp.needed) {
+                    if (grp.dctx == nullptr) {
+                        grp.dctx = ZSTD_createDStream();
+                    }
+                    ZSTD_initDStream(grp.dctx);
+                    grp.data.resize((size_t)m_framesPerBlock * grp.channels);
+                    grp.out.dst = &grp.data[0];
+                    grp.out.size = 0;
+                    grp.out.pos = 0;
+                }
+            }
+        }
+        uint32_t fidx = frame - m_file->m_frameOffsets[m_curBlock].first;
+        if (fidx >= m_curFrameInBlock) {
+            for (auto& grp : m_groups) {
+                if (grp.needed) {
+                    grp.out.size = (size_t)(fidx + 1) * grp.channels;
+                    while (grp.out.pos < grp.out.size && grp.in.pos < grp.in.size) {
+                        size_t r = ZSTD_decompressStream(grp.dctx, &grp.out, &grp.in);
+                        if (ZSTD_isError(r)) {
+                            LogErr(VB_SEQUENCE, "Error decompressing channel group: %s\n", ZSTD_getErrorName(r));
+                            break;
+                        }
+                    }
+                }
+            }
+            m_curFrameInBlock = fidx + 1;
+        }
+
+        UncompressedFrameData* data = new UncompressedFrameData(frame, m_file->m_dataBlockSize, m_file->m_rangesToRead);
+        uint32_t sz = 0;
+        if (!m_file->m_sparseRanges.empty()) {
+            copyRange(fidx, 0, channelCount, data->m_data);
+        } else {
+            // read the ranges into the buffer
+            for (auto& rng : data->m_ranges) {
+                if (rng.first < channelCount) {
+                    copyRange(fidx, rng.first, rng.second, &data->m_data[sz]);
+                    sz += rng.second;
+                }
+            }
+        }
+        return data;
+    }
+
+    virtual bool supportsParallelCompression() const override { return true; }
+    virtual int blockCompressionLevel(uint32_t frame) override {
+        return ZSTDBlockLevel(m_file->m_compressionLevel, frame);
+    }
+    virtual void compressBlock(QueuedBlock& block) override {
+        ZSTD_CCtx* cctx = ZSTDWorkerContext();
+        uint32_t channelCount = m_file->getChannelCount();
+
+        block.compressed.resize(m_numGroups * 4 + ZSTD_compressBound(block.data.size()) + m_numGroups * 64);
+        ZSTD_outBuffer_s output = { &block.compressed[0], block.compressed.size(), m_numGroups * 4 };
+        for (uint32_t g = 0; g < m_numGroups; g++) {
+            const Group& grp = m_groups[g];
+            size_t startPos = output.pos;
+            ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters);
+            ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, block.level);
+            ZSTD_CCtx_setPledgedSrcSize(cctx, (unsigned long long)block.frames * grp.channels);
+            for (uint32_t f = 0; f < block.frames; f++) {
+                ZSTD_inBuffer_s input = {
+                    &block.data[(size_t)f * channelCount + grp.start],
+                    grp.channels,
+                    0
+                };
+                // output is sized to the compress bound so everything fits
+                ZSTD_compressStream2(cctx, &output, &input, ZSTD_e_continue);
+            }
+            ZSTD_inBuffer_s input = { 0, 0, 0 };
+            size_t r = ZSTD_compressStream2(cctx, &output, &input, ZSTD_e_end);
+            if (ZSTD_isError(r) || r != 0) {
+                LogErr(VB_SEQUENCE, "Error compressing channel group %d of block starting at frame %d\n", g, block.firstFrame);
+            }
+            write4ByteUInt(&block.compressed[g * 4], output.pos - startPos);
+        }
+        block.compressed.resize(output.pos);
+    }
+
+    virtual void addFrame(uint32_t frame, const uint8_t* data) override {
+        setupGroups();
+        if (useCompressionThreads()) {
+            addFrameParallel(frame, data);
+            return;
+        }
+        if (m_curFrameInBlock == 0) {
+            uint64_t offset = tell();
+            m_file->m_frameOffsets.push_back(std::pair<uint32_t, uint64_t>(frame, offset));
+            m_block.firstFrame = frame;
+            m_block.level = blockCompressionLevel(frame);
+        }
+        // the groups are compressed once the block is complete so the
+        // uncompressed block is held in memory until then
+        if (appendFrame(frame, data, m_block.data)) {
+            writeBlock();
+        }
+    }
+    virtual void finalize() override {
+        if (useCompressionThreads()) {
+            queueBlock();
+            finishCompressionThreads();
+        } else if (m_curFrameInBlock) {
+            writeBlock();
+            LogDebug(VB_SEQUENCE, "  Finalized last block of data.\n");
+        }
+        V2CompressedHandler::finalize();
+    }
+
+private:
+    struct Group {
+        uint32_t start = 0;
+        uint32_t channels = 0;
+        bool needed = true;
+
+        ZSTD_DStream* dctx = nullptr;
+        ZSTD_inBuffer_s in = { nullptr, 0, 0 };
+        ZSTD_outBuffer_s out = { nullptr, 0, 0 };
+        std::vector<uint8_t> data;
+    };
+
+    void setupGroups() {
+        if (m_numGroups) {
+            return;
+        }
+        uint32_t channelCount = m_file->getChannelCount();
+        m_groupSize = m_file->m_channelGroupSize;
+        if (m_groupSize == 0 || m_groupSize > channelCount) {
+            m_groupSize = channelCount ? channelCount : 1;
+        }
+        m_numGroups = (channelCount + m_groupSize - 1) / m_groupSize;
+        if (m_numGroups == 0) {
+            m_numGroups = 1;
+        }
+        m_groups.resize(m_numGroups);
+        for (uint32_t g = 0; g < m_numGroups; g++) {
+            m_groups[g].start = g * m_groupSize;
+            m_groups[g].channels = std::min(m_groupSize, channelCount - m_groups[g].start);
+        }
+    }
+
+    void copyRange(uint32_t fidx, uint32_t start, uint32_t count, uint8_t* dst) {
+        uint32_t end = std::min(start + count, m_file->getChannelCount());
+        while (start < end) {
+            Group& grp = m_groups[start / m_groupSize];
+            uint32_t off = start - grp.start;
+            uint32_t len = std::min(end - start, grp.channels - off);
+            memcpy(dst, &grp.data[(size_t)fidx * grp.channels + off], len);
+            dst += len;
+            start += len;
+        }
+    }
+
+    void writeBlock() {
+        m_block.frames = m_curFrameInBlock;
+        compressBlock(m_block);
+        write(&m_block.compressed[0], m_block.compressed.size());
+        m_block.data.clear();
+        m_curFrameInBlock = 0;
+        m_curBlock++;
+    }
+
+    uint32_t m_groupSize;
+    uint32_t m_numGroups;
+    std::vector<Group> m_groups;
+    QueuedBlock m_block;
+};
 #endif
 
 #ifndef NO_ZLIB
@@ -1364,6 +1972,7 @@ public:
         m_inBuffer(nullptr) {
     }
     virtual ~V2ZLIBCompressionHandler() {
+        stopCompressionThreads();
         if (m_outBuffer) {
             free(m_outBuffer);
         }
@@ -1426,7 +2035,28 @@ public:
         }
         return data;
     }
+    virtual bool supportsParallelCompression() const override { return true; }
+    virtual int blockCompressionLevel(uint32_t frame) override {
+        int clevel = m_file->m_compressionLevel == -99 ? 3 : m_file->m_compressionLevel;
+        if (clevel < 0 || clevel > 9) {
+            clevel = 3;
+        }
+        return clevel;
+    }
+    virtual void compressBlock(QueuedBlock& block) override {
+        uLongf len = compressBound(block.data.size());
+        block.compressed.resize(len);
+        if (compress2(&block.compressed[0], &len, &block.data[0], block.data.size(), block.level) != Z_OK) {
+            LogErr(VB_SEQUENCE, "Error compressing block starting at frame %d\n", block.firstFrame);
+        }
+        block.compressed.resize(len);
+    }
+
     virtual void addFrame(uint32_t frame, const uint8_t* data) override {
+        if (useCompressionThreads()) {
+            addFrameParallel(frame, data);
+            return;
+        }
         if (m_outBuffer == nullptr) {
             m_outBuffer = (uint8_t*)malloc(V2FSEQ_OUT_BUFFER_SIZE);
         }
@@ -1440,11 +2070,7 @@ public:
             memset(m_stream, 0, sizeof(z_stream));
         }
         if (m_curFrameInBlock == 0) {
-            int clevel = m_file->m_compressionLevel == -99 ? 3 : m_file->m_compressionLevel;
-            if (clevel < 0 || clevel > 9) {
-                clevel = 3;
-            }
-            deflateInit(m_stream, clevel);
+            deflateInit(m_stream, blockCompressionLevel(frame));
             m_stream->next_out = m_outBuffer;
             m_stream->avail_out = V2FSEQ_OUT_BUFFER_SIZE;
         }
@@ -1492,7 +2118,10 @@ public:
         }
     }
     virtual void finalize() override {
-        if (m_curFrameInBlock) {
+        if (useCompressionThreads()) {
+            queueBlock();
+            finishCompressionThreads();
+        } else if (m_curFrameInBlock) {
             while (deflate(m_stream, Z_FINISH) != Z_STREAM_END) {
                 uint64_t sz = V2FSEQ_OUT_BUFFER_SIZE;
                 sz -= m_stream->avail_out;
@@ -1527,7 +2156,18 @@ void V2FSEQFile::createHandler() {
 #ifdef NO_ZSTD
         LogErr(VB_ALL, "No support for zstd compression");
 #else
-        m_handler = new V2ZSTDCompressionHandler(this);
+        if (m_channelGroups) {
+            m_handler = new V2ZSTDGroupedCompressionHandler(this);
+        } else {
+            m_handler = new V2ZSTDCompressionHandler(this);
+        }
+#endif
+        break;
+    case CompressionType::zstdDelta:
+#ifdef NO_ZSTD
+        LogErr(VB_ALL, "No support for zstd compression");
+#else
+        m_handler = new V2ZSTDDeltaCompressionHandler(this);
 #endif
         break;
     case CompressionType::zlib:
@@ -1548,13 +2188,30 @@ V2FSEQFile::V2FSEQFile(const std::string& fn, CompressionType ct, int cl) :
     FSEQFile(fn),
     m_compressionType(ct),
     m_compressionLevel(cl),
+    m_compressionThreads(1),
     m_handler(nullptr),
-    m_allowExtendedBlocks(false) {
+    m_allowExtendedBlocks(false),
+    m_channelGroups(false),
+    m_channelGroupSize(0) {
     m_seqVersionMajor = V2FSEQ_MAJOR_VERSION;
     m_seqVersionMinor = V2FSEQ_MINOR_VERSION;
 
     createHandler();
 }
+void V2FSEQFile::enableChannelGroups(uint32_t groupSize) {
+    if (m_compressionType != CompressionType::zstd) {
+        LogErr(VB_SEQUENCE, "Channel groups are only supported with zstd compression\n");
+        return;
+    }
+    if (m_seqVersionMinor < 3) {
+        enableMinorVersionFeatures(3);
+    }
+    m_channelGroups = true;
+    m_channelGroupSize = groupSize;
+    delete m_handler;
+    m_handler = nullptr;
+    createHandler();
+}
 void V2FSEQFile::writeHeader() {
     if (!m_sparseRanges.empty()) {
         // make sure the sparse ranges fit, and then
@@ -1577,6 +2234,29 @@ void V2FSEQFile::writeHeader() {
         }
     }
 
+    // The channel group header describes this file's block layout, never
+    // carry one over from the source file
+    for (auto it = m_variableHeaders.begin(); it != m_variableHeaders.end();) {
+        if (it->code[0] == 'C' && it->code[1] == 'G') {
+            it = m_variableHeaders.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (m_channelGroups) {
+        if (m_channelGroupSize == 0) {
+            // aim for around 32 groups, but keep groups large enough
+            // to still compress well
+            m_channelGroupSize = std::max((uint32_t)V2FSEQ_MIN_CHANNEL_GROUP_SIZE, (m_seqChannelCount + 31) / 32);
+        }
+        VariableHeader header;
+        header.code[0] = 'C';
+        header.code[1] = 'G';
+        header.resizeData(4);
+        write4ByteUInt(&header.getData()[0], m_channelGroupSize);
+        m_variableHeaders.push_back(header);
+    }
+
     // Additional file format documentation available at:
     // https://github.com/FalconChristmas/fpp/blob/master/docs/FSEQ_Sequence_File_Format.txt#L17
 
@@ -1733,8 +2413,12 @@ void V2FSEQFile::writeHeader() {
 V2FSEQFile::V2FSEQFile(const std::string& fn, FILE* file, const std::vector<uint8_t>& header) :
     FSEQFile(fn, file, header),
     m_compressionType(none),
-    m_handler(nullptr) {
-    if (m_seqVersionMajor == 2 && m_seqVersionMinor > 2) {
+    m_compressionLevel(-99),
+    m_compressionThreads(1),
+    m_handler(nullptr),
+    m_channelGroups(false),
+    m_channelGroupSize(0) {
+    if (m_seqVersionMajor == 2 && m_seqVersionMinor > 3) {
         LogErr(VB_SEQUENCE, "Unknown minor version: %d.  FSEQ may not load properly.\n", m_seqVersionMinor);
     }
 
@@ -1757,6 +2441,9 @@ V2FSEQFile::V2FSEQFile(const std::string& fn, FILE* file, const std::vector<uint
         case 2:
             m_compressionType = CompressionType::zlib;
             break;
+        case 3:
+            m_compressionType = CompressionType::zstdDelta;
+            break;
         default:
             LogErr(VB_SEQUENCE, "Unknown compression type: %d\n", (int)header[20]);
         }
@@ -1846,6 +2533,13 @@ V2FSEQFile::V2FSEQFile(const std::string& fn, FILE* file, const std::vector<uint
                 m_frameOffsets.back().second = a.getExtDataOffset();
             }
         }
+
+        for (auto& a : m_variableHeaders) {
+            if (a.code[0] == 'C' && a.code[1] == 'G' && a.getDataLength() >= 4 && m_compressionType == CompressionType::zstd) {
+                m_channelGroups = true;
+                m_channelGroupSize = read4ByteUInt(&a.getData()[0]);
+            }
+        }
     }
 
     createHandler();
@@ -1865,6 +2559,9 @@ void V2FSEQFile::dumpInfo(bool indent) {
     LogDebug(VB_SEQUENCE, "%sSequence File Information\n", ind);
     LogDebug(VB_SEQUENCE, "%scompressionType       : %d\n", ind, m_compressionType);
     LogDebug(VB_SEQUENCE, "%snumBlocks             : %d\n", ind, m_handler->computeMaxBlocks());
+    if (m_channelGroups) {
+        LogDebug(VB_SEQUENCE, "%schannelGroupSize      : %d\n", ind, m_channelGroupSize);
+    }
     // Commented out to declutter the logs ... we can add it back in if we start seeing issues
     // for (auto &a : m_frameOffsets) {
     //    LogDebug(VB_SEQUENCE, "%s      %d              : %" PRIu64 "\n", ind, a.first, a.second);
@@ -77,6 +77,11 @@ public:
         virtual ~FrameData(){};
 
         virtual bool readFrame(uint8_t* data, uint32_t maxChannels) = 0;
+        // copy the channel data for ranges, the ranges passed to
+        // prepareRead, packed back to back in range order into data which
+        // holds the sum of their lengths.  The default reads the whole frame
+        // with readFrame into a scratch buffer.
+        virtual bool readPacked(uint8_t* data, const std::vector<std::pair<uint32_t, uint32_t>>& ranges);
 
         uint32_t frame;
     };
@@ -84,9 +89,10 @@ public:
     enum CompressionType {
         none,
         zstd,
-        zlib
+        zlib,
+        zstdDelta // zstd of each frame XOR'd with the previous frame
     };
-    constexpr static const char* CompressionTypeStrings[] = { "none", "zstd", "zlib" };
+    constexpr static const char* CompressionTypeStrings[] = { "none", "zstd", "zlib", "zstd-delta" };
 
 protected:
     // open file for reading
@@ -229,17 +235,28 @@ public:
         }
     }
 
+    // FSEQ 2.3+, zstd only.  Split each compression block into independently
+    // compressed groups of groupSize channels so readers that only need some
+    // of the channels only decompress the groups containing them.  A
+    // groupSize of 0 picks a size based on the channel count.
+    void enableChannelGroups(uint32_t groupSize = 0);
+
     [[nodiscard]] std::string CompressionTypeString() const {
         return CompressionTypeStrings[(int)m_compressionType];
     }
 
     CompressionType m_compressionType;
     int m_compressionLevel;
+    // number of threads used to compress blocks when writing, 1 compresses
+    // on the thread calling addFrame
+    int m_compressionThreads;
     std::vector<std::pair<uint32_t, uint32_t>> m_sparseRanges;
     std::vector<std::pair<uint32_t, uint32_t>> m_rangesToRead;
     std::vector<std::pair<uint32_t, uint64_t>> m_frameOffsets;
     uint32_t m_dataBlockSize;
     bool m_allowExtendedBlocks;
+    bool m_channelGroups;
+    uint32_t m_channelGroupSize;
 
 private:
     void createHandler();
@@ -5,9 +5,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
+#include <chrono>
 #include <list>
+#include <random>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "fppversion.h"
@@ -27,8 +31,12 @@ void usage(char* appname) {
     printf("   -m FSEQFILE       - FSEQ to merge onto the input, ignoring 0\n");
     printf("   -M[ FSEQFILE      - FSEQ to merge onto the input, copy 0\n");
     printf("   -f #              - FSEQ Version\n");
-    printf("   -c (none|zstd|zlib) - Compession type\n");
+    printf("   -c (none|zstd|zlib|zstd-delta) - Compession type\n");
     printf("   -l #              - Compression level (-99 for default)\n");
+    printf("   -t #              - Number of threads used to compress blocks, 0 for one per CPU core.\n");
+    printf("                       Prints the conversion throughput when done\n");
+    printf("   -g #              - Compress zstd blocks in independent groups of # channels so readers\n");
+    printf("                       only decompress the groups they need, 0 to pick a size.  Produces FSEQ 2.3\n");
     printf("   -r (#-# | #+#)    - Channel Range.  Use - to separate start/end channel\n");
     printf("                            Use + to separate start channel + num channels\n");
     printf("                       If used before first -m/-M argument, sets a sparse range of output\n");
@@ -37,6 +45,8 @@ void usage(char* appname) {
     printf("   -n                - No Sparse. -r will only read the range, but the resulting fseq is not sparse.\n");
     printf("   -j                - Output the fseq file metadata to json\n");
     printf("   -d                - Dump the fseq data to stdout in human-readable format\n");
+    printf("   -b                - Benchmark reading the fseq, reports size, decode speed and seek latency\n");
+    printf("                       for the file as is and re-encoded with zstd and zstd-delta (-l, -t apply)\n");
     printf("   -h                - This help output\n");
 }
 const char* outputFilename = nullptr;
@@ -57,11 +67,14 @@ static std::list<MergeFSEQ> mergeFseqs;
 static int fseqMajVersion = 2;
 static int fseqMinVersion = 0;
 static int compressionLevel = -99;
+static int channelGroupSize = -1;
+static int compressionThreads = -1;
 static bool verbose = false;
 static std::vector<std::pair<uint32_t, uint32_t>> ranges;
 static bool sparse = true;
 static bool json = false;
 static bool dump = false;
+static bool benchmark = false;
 static V2FSEQFile::CompressionType compressionType = V2FSEQFile::CompressionType::zstd;
 
 static void parseRanges(std::vector<std::pair<uint32_t, uint32_t>>& ranges, char* rng) {
@@ -91,7 +104,7 @@ int parseArguments(int argc, char** argv) {
             { 0, 0, 0, 0 }
         };
 
-        c = getopt_long(argc, argv, "c:l:o:f:r:m:M:hdjVvn", long_options, &option_index);
+        c = getopt_long(argc, argv, "c:l:g:t:o:f:r:m:M:hbdjVvn", long_options, &option_index);
         if (c == -1) {
             break;
         }
@@ -110,6 +123,9 @@ int parseArguments(int argc, char** argv) {
         case 'd':
             dump = true;
             break;
+        case 'b':
+            benchmark = true;
+            break;
         case 'v':
             verbose = true;
             break;
@@ -120,6 +136,8 @@ int parseArguments(int argc, char** argv) {
                 compressionType = V2FSEQFile::CompressionType::zlib;
             } else if (strcmp(optarg, "zstd") == 0) {
                 compressionType = V2FSEQFile::CompressionType::zstd;
+            } else if (strcmp(optarg, "zstd-delta") == 0) {
+                compressionType = V2FSEQFile::CompressionType::zstdDelta;
             } else {
                 printf("Unknown compression type: %s\n", optarg);
                 exit(EXIT_FAILURE);
@@ -128,6 +146,18 @@ int parseArguments(int argc, char** argv) {
         case 'l':
             compressionLevel = strtol(optarg, NULL, 10);
             break;
+        case 't':
+            compressionThreads = strtol(optarg, NULL, 10);
+            if (compressionThreads <= 0) {
+                compressionThreads = std::thread::hardware_concurrency();
+            }
+            break;
+        case 'g':
+            channelGroupSize = strtol(optarg, NULL, 10);
+            if (channelGroupSize < 0) {
+                channelGroupSize = 0;
+            }
+            break;
         case 'f': {
             char* next = nullptr;
             fseqMajVersion = strtol(optarg, &next, 10);
@@ -183,6 +213,176 @@ static char* escape(char* buf, const char* data) {
 std::string getFPPDDir(const std::string& path) {
     return "/tmp";
 }
+struct BenchmarkResult {
+    std::string compression;
+    uint64_t fileSize = 0;
+    double encodeSecs = 0;
+    double decodeSecs = 0;
+    double seekAverage = 0;
+    double seekWorst = 0;
+};
+
+// Decodes every frame of filename in order, then times SEEKS random seeks
+// each on a freshly opened file like fppd does when starting a sequence
+// part way through
+static bool benchmarkFile(const char* filename, uint8_t* data, BenchmarkResult& result) {
+    using Clock = std::chrono::steady_clock;
+
+    FILE* f = fopen(filename, "rb");
+    if (!f) {
+        printf("Could not open %s: %s\n", filename, strerror(errno));
+        return false;
+    }
+    fseeko(f, 0, SEEK_END);
+    result.fileSize = ftello(f);
+    fclose(f);
+
+    FSEQFile* src = FSEQFile::openFSEQFile(filename);
+    if (!src) {
+        printf("Could not read %s as an FSEQ file\n", filename);
+        return false;
+    }
+    if (src->getVersionMajor() >= 2) {
+        result.compression = ((V2FSEQFile*)src)->CompressionTypeString();
+    } else {
+        result.compression = "v1";
+    }
+    src->prepareRead(ranges);
+    auto start = Clock::now();
+    for (uint32_t x = 0; x < src->getNumFrames(); x++) {
+        FSEQFile::FrameData* fdata = src->getFrame(x);
+        if (fdata) {
+            fdata->readFrame(data, 8024 * 1024);
+            delete fdata;
+        }
+    }
+    result.decodeSecs = std::chrono::duration<double>(Clock::now() - start).count();
+    delete src;
+
+    const int SEEKS = 20;
+    std::mt19937 rng(42);
+    double total = 0;
+    result.seekWorst = 0;
+    for (int x = 0; x < SEEKS; x++) {
+        src = FSEQFile::openFSEQFile(filename);
+        if (!src) {
+            printf("Could not reopen %s\n", filename);
+            return false;
+        }
+        uint32_t frame = rng() % src->getNumFrames();
+        start = Clock::now();
+        src->prepareRead(ranges, frame);
+        FSEQFile::FrameData* fdata = src->getFrame(frame);
+        if (fdata) {
+            fdata->readFrame(data, 8024 * 1024);
+            delete fdata;
+        }
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        total += ms;
+        result.seekWorst = std::max(result.seekWorst, ms);
+        delete src;
+    }
+    result.seekAverage = total / SEEKS;
+    return true;
+}
+
+// Re-encodes every channel of filename into outputName as a v2 file using
+// the given compression and the -l/-t settings
+static bool encodeForBenchmark(const char* filename, const std::string& outputName,
+                               V2FSEQFile::CompressionType type, uint8_t* data, BenchmarkResult& result) {
+    FSEQFile* src = FSEQFile::openFSEQFile(filename);
+    if (!src) {
+        return false;
+    }
+    FSEQFile* dest = FSEQFile::createFSEQFile(outputName, 2, type, compressionLevel);
+    if (!dest) {
+        printf("Could not create %s\n", outputName.c_str());
+        delete src;
+        return false;
+    }
+    if (compressionThreads > 0) {
+        ((V2FSEQFile*)dest)->m_compressionThreads = compressionThreads;
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::pair<uint32_t, uint32_t>> all;
+    all.push_back(std::pair<uint32_t, uint32_t>(0, src->getMaxChannel()));
+    src->prepareRead(all);
+    dest->initializeFromFSEQ(*src);
+    dest->writeHeader();
+    for (uint32_t x = 0; x < src->getNumFrames(); x++) {
+        FSEQFile::FrameData* fdata = src->getFrame(x);
+        if (fdata) {
+            fdata->readFrame(data, 8024 * 1024);
+            delete fdata;
+        }
+        dest->addFrame(x, data);
+    }
+    dest->finalize();
+    result.encodeSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    delete dest;
+    delete src;
+    return true;
+}
+
+// Benchmarks filename as it is, then re-encoded with plain zstd and with
+// zstd-delta, and prints the three side by side
+static int runBenchmark(const char* filename) {
+    FSEQFile* src = FSEQFile::openFSEQFile(filename);
+    if (!src) {
+        printf("Could not read %s as an FSEQ file\n", filename);
+        return 1;
+    }
+    if (src->getNumFrames() == 0 || src->getChannelCount() == 0) {
+        printf("%s has no frames to benchmark\n", filename);
+        delete src;
+        return 1;
+    }
+    if (ranges.empty()) {
+        ranges.push_back(std::pair<uint32_t, uint32_t>(0, src->getMaxChannel()));
+    }
+    uint64_t bytesPerFrame = 0;
+    for (auto& r : ranges) {
+        bytesPerFrame += r.second;
+    }
+    uint32_t numFrames = src->getNumFrames();
+    uint64_t uncompressed = (uint64_t)numFrames * src->getChannelCount();
+
+    printf("File:            %s\n", filename);
+    printf("Version:         %d.%d\n", src->getVersionMajor(), src->getVersionMinor());
+    printf("Frames:          %d x %d channels\n", numFrames, src->getChannelCount());
+    delete src;
+
+    uint8_t* data = (uint8_t*)malloc(8024 * 1024);
+    std::vector<BenchmarkResult> results(3);
+    bool ok = benchmarkFile(filename, data, results[0]);
+    results[0].compression += " (input)";
+
+    const V2FSEQFile::CompressionType types[] = { V2FSEQFile::CompressionType::zstd, V2FSEQFile::CompressionType::zstdDelta };
+    for (int x = 0; ok && x < 2; x++) {
+        std::string tmp = std::string("/tmp/fsequtils-bench-") + std::to_string(getpid()) + "-" + std::to_string(x) + ".fseq";
+        ok = encodeForBenchmark(filename, tmp, types[x], data, results[x + 1]) &&
+             benchmarkFile(tmp.c_str(), data, results[x + 1]);
+        unlink(tmp.c_str());
+    }
+    free(data);
+    if (!ok) {
+        return 1;
+    }
+
+    printf("\n%-26s %12s %7s %9s %10s %10s %9s %9s\n", "Compression", "Size", "Ratio", "Encode s",
+           "Decode MB/s", "Frames/s", "Seek avg", "Seek max");
+    for (auto& r : results) {
+        char encode[16] = "-";
+        if (r.encodeSecs > 0) {
+            snprintf(encode, sizeof(encode), "%.3f", r.encodeSecs);
+        }
+        printf("%-26s %12" PRIu64 " %6.1f%% %9s %10.1f %10.0f %7.2fms %7.2fms\n", r.compression.c_str(),
+               r.fileSize, r.fileSize * 100.0 / uncompressed, encode,
+               (double)bytesPerFrame * numFrames / r.decodeSecs / (1024 * 1024),
+               numFrames / r.decodeSecs, r.seekAverage, r.seekWorst);
+    }
+    return 0;
+}
 int main(int argc, char* argv[]) {
     int idx = parseArguments(argc, argv);
     if (verbose) {
@@ -190,6 +390,9 @@ int main(int argc, char* argv[]) {
     } else {
         SetLogFile("stderr", false);
     }
+    if (benchmark) {
+        return runBenchmark(argv[idx]);
+    }
     FSEQFile* src = FSEQFile::openFSEQFile(argv[idx]);
     if (src) {
         if (json) {
@@ -256,6 +459,9 @@ int main(int argc, char* argv[]) {
                 }
                 printf(", \"CompressionType\": %d", (int)f->m_compressionType);
                 printf(", \"CompressionTypeString\": \"%s\"", f->CompressionTypeString().c_str());
+                if (f->m_channelGroups) {
+                    printf(", \"ChannelGroupSize\": %d", f->m_channelGroupSize);
+                }
             }
             printf("}\n");
         } else if (dump) {
@@ -309,6 +515,19 @@ int main(int argc, char* argv[]) {
                 return 1;
             }
             dest->enableMinorVersionFeatures(fseqMinVersion);
+            if (channelGroupSize >= 0) {
+                if (fseqMajVersion != 2 || compressionType != V2FSEQFile::CompressionType::zstd) {
+                    printf("Channel groups require a v2 FSEQ with zstd compression\n");
+                    delete dest;
+                    delete src;
+                    return 1;
+                }
+                ((V2FSEQFile*)dest)->enableChannelGroups(channelGroupSize);
+            }
+            if (compressionThreads > 0 && fseqMajVersion == 2) {
+                ((V2FSEQFile*)dest)->m_compressionThreads = compressionThreads;
+            }
+            auto startTime = std::chrono::steady_clock::now();
 
             if (ranges.empty()) {
                 ranges.push_back(std::pair<uint32_t, uint32_t>(0, 999999999));
@@ -350,6 +569,13 @@ int main(int argc, char* argv[]) {
             free(mergedata);
             dest->finalize();
 
+            if (compressionThreads > 0) {
+                double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+                double mb = (double)src->getNumFrames() * dest->getChannelCount() / (1024 * 1024);
+                printf("Converted %d frames (%.1f MB) in %.3f s, %.1f MB/s using %d threads\n",
+                       src->getNumFrames(), mb, secs, mb / secs, compressionThreads);
+            }
+
             if (!strcmp(outputFilename, "-memory-")) {
                 printf("size: %d\n", (int)dest->getMemoryBuffer().size());
             }
@@ -13,7 +13,6 @@
 #include "fpp-pch.h"
 
 #include "fpp-json.h"
-#include "fpphttp.h" // drogon/HTTP helpers used here; no longer pulled transitively (see fpphttp_types.h)
 #include "Events.h"
 
 #include <array>
@@ -83,7 +82,8 @@ void GPIOManager::Initialize(std::map<int, std::function<bool(int)>>& callbacks)
     }
 }
 
-// Poll-based pins: detect edges each main loop iteration.
+// Poll-based pins: detect edges every GPIO_POLL_INTERVAL_MS from the
+// "gpio_poll" timer.  Only pins that cannot deliver edge events end up here.
 // Non-debounced edges fire immediately. Debounced edges schedule a
 // timer via Timers to re-read and confirm after the settle window.
 void GPIOManager::CheckGPIOInputs(void) {
@@ -91,6 +91,8 @@ void GPIOManager::CheckGPIOInputs(void) {
         return;
     }
 
+    // expanders return every pin of a port from one bus transfer
+    PinCapabilities::StartBatchRead();
     for (auto a : pollStates) {
         // Skip pins that already have a pending debounce timer
         if (a->pendingValue != a->lastValue) {
@@ -108,6 +110,17 @@ void GPIOManager::CheckGPIOInputs(void) {
             }
         }
     }
+    PinCapabilities::EndBatchRead();
+}
+
+void GPIOManager::startPolling() {
+    Timers::INSTANCE.addPeriodicTimer("gpio_poll", GPIO_POLL_INTERVAL_MS, [this]() {
+        CheckGPIOInputs();
+    });
+}
+
+void GPIOManager::stopPolling() {
+    Timers::INSTANCE.stopPeriodicTimer("gpio_poll");
 }
 
 // Timer-driven debounce check for all pins (event-based and poll-based).
@@ -134,8 +147,10 @@ void GPIOManager::checkDebounceTimers() {
             }
         }
     };
+    PinCapabilities::StartBatchRead();
     checkList(eventStates);
     checkList(pollStates);
+    PinCapabilities::EndBatchRead();
 }
 
 // Schedule a timer to re-check debounce for an event-based pin.
@@ -152,11 +167,14 @@ void GPIOManager::scheduleDebounceCheck(GPIOState* state) {
 }
 
 void GPIOManager::Cleanup() {
+    stopPolling();
     for (auto a : eventStates) {
         if (!a->ledPin.empty())
             Timers::INSTANCE.stopPeriodicTimer("gpio_led_pulse_" + a->pin->name);
-        if (a->file != -1)
+        if (a->file != -1) {
+            EPollManager::INSTANCE.removeFileDescriptor(a->file);
             a->pin->releaseGPIOD();
+        }
         delete a;
     }
     for (auto a : pollStates) {
@@ -170,181 +188,6 @@ void GPIOManager::Cleanup() {
     pollStates.clear();
 }
 
-// --------------------------------------------------------------------------
-// OpenAPI docs for the /gpio/* endpoints handled below.
-// --------------------------------------------------------------------------
-
-/**
- * List the available GPIO pins. Add ?list=true for just the pin names.
- *
- * @route GET /api/gpio
- * @param boolean list Return just the pin names instead of full capabilities.
- * @response 200 Array of pin capability objects (or pin names when `list=true`).
- */
-
-/**
- * Read the last value set on a GPIO pin via the API/commands. Only pins with a
- * cached value can be read; output pins must be SET before they can be read.
- *
- * @route GET /api/gpio/{pin}
- * @response 200 Object with `pin` and `value` (0 or 1).
- * @response 400 The pin has no cached value.
- */
-HttpResponsePtr GPIOManager::render_GET(const HttpRequestPtr& req) {
-    auto pieces = getPathPieces(req->path());
-    int plen = pieces.size();
-    std::string p1 = pieces[0];
-    if (p1 == "gpio") {
-        if (plen <= 1) {
-            bool simpleList = false;
-            if (getRequestArg(req, "list") == "true") {
-                simpleList = true;
-            }
-            std::vector<std::string> pins = PinCapabilities::getPinNames();
-            if (pins.empty()) {
-                return makeStringResponse("[]", 200, "application/json");
-            }
-            Json::Value result;
-            for (auto& a : pins) {
-                if (simpleList) {
-                    result.append(a);
-                } else {
-                    result.append(PinCapabilities::getPinByName(a).toJSON());
-                }
-            }
-            std::string resultStr = SaveJsonToString(result);
-            return makeStringResponse(resultStr, 200, "application/json");
-        } else if (plen == 2) {
-            // Handle reading individual GPIO pin value: /gpio/{pin_name}
-            std::string pinName = pieces[1];
-            Json::Value result;
-
-            // Check if we have a tracked value for this pin FIRST (from previous SET operations)
-            // This avoids touching the pin hardware which could interfere with output pins
-            auto it = GPIOManager::INSTANCE.fppCommandLastValue.find(pinName);
-            if (it != GPIOManager::INSTANCE.fppCommandLastValue.end()) {
-                // Return the last set value without touching the pin
-                LogDebug(VB_HTTP, "GPIO GET: Returning cached value for %s: %d\n", pinName.c_str(), it->second ? 1 : 0);
-                result["pin"] = pinName;
-                result["value"] = it->second ? 1 : 0;
-                result["Status"] = "OK";
-                result["respCode"] = 200;
-
-                std::string resultStr = SaveJsonToString(result);
-                return makeStringResponse(resultStr, 200, "application/json");
-            }
-
-            // No tracked value - pin hasn't been set via API/commands yet
-            // Return error rather than trying to read it which could interfere with output pins
-            LogWarn(VB_HTTP, "GPIO GET: No cached value for pin %s - cannot read output pins safely\n", pinName.c_str());
-
-            result["pin"] = pinName;
-            result["Status"] = "ERROR";
-            result["respCode"] = 400;
-            result["Message"] = "Pin has no cached value. For output pins, you must SET a value before you can GET it. For input pins, configure them via the GPIO Input configuration page.";
-
-            std::string resultStr = SaveJsonToString(result);
-            return makeStringResponse(resultStr, 400, "application/json");
-        }
-    }
-    return makeStringResponse("Not Found", 404, "text/plain");
-}
-
-/**
- * Configure a GPIO pin for output and set its value. Body: `{"value": 0|1}`.
- *
- * @route POST /api/gpio/{pin}
- * @body {"value": 1}
- * @response 200 Object with `pin` and the applied `value`.
- * @response 400 Missing/invalid `value` field.
- * @response 404 The named pin does not exist.
- * @response 500 Error setting the pin.
- */
-HttpResponsePtr GPIOManager::render_POST(const HttpRequestPtr& req) {
-    auto pieces = getPathPieces(req->path());
-    int plen = pieces.size();
-    std::string p1 = pieces[0];
-
-    if (p1 == "gpio" && plen == 2) {
-        // Handle setting individual GPIO pin value: POST /gpio/{pin_name}
-        std::string pinName = pieces[1];
-        const PinCapabilities& pin = PinCapabilities::getPinByName(pinName);
-
-        if (pin.ptr()) {
-            Json::Value data;
-            Json::Value result;
-
-            // Parse POST data
-            if (getRequestContent(req) != "") {
-                if (!LoadJsonFromString(getRequestContent(req), data)) {
-                    Json::Value errorResult;
-                    errorResult["pin"] = pinName;
-                    errorResult["Status"] = "ERROR";
-                    errorResult["respCode"] = 400;
-                    errorResult["Message"] = "Error parsing POST content";
-
-                    std::string errorStr = SaveJsonToString(errorResult);
-                    return makeStringResponse(errorStr, 400, "application/json");
-                }
-            }
-
-            // Check for required 'value' field
-            if (!data.isMember("value")) {
-                Json::Value errorResult;
-                errorResult["pin"] = pinName;
-                errorResult["Status"] = "ERROR";
-                errorResult["respCode"] = 400;
-                errorResult["Message"] = "'value' field not specified. Use {\"value\": 0} or {\"value\": 1}";
-
-                std::string errorStr = SaveJsonToString(errorResult);
-                return makeStringResponse(errorStr, 400, "application/json");
-            }
-
-            try {
-                // Configure the pin for output
-                pin.configPin("gpio", true, "GPIO Output");
-
-                // Set the value (convert to boolean)
-                bool value = data["value"].asBool() || (data["value"].isInt() && data["value"].asInt() != 0);
-                pin.setValue(value);
-
-                // Update the last value tracking (for Opposite command functionality and GET requests)
-                GPIOManager::INSTANCE.fppCommandLastValue[pinName] = value;
-                LogDebug(VB_HTTP, "GPIO POST: Set pin %s to %d, cached value\n", pinName.c_str(), value ? 1 : 0);
-
-                result["pin"] = pinName;
-                result["value"] = value ? 1 : 0;
-                result["Status"] = "OK";
-                result["respCode"] = 200;
-                result["Message"] = "GPIO pin value set successfully";
-
-                std::string resultStr = SaveJsonToString(result);
-                return makeStringResponse(resultStr, 200, "application/json");
-            } catch (const std::exception& e) {
-                Json::Value errorResult;
-                errorResult["pin"] = pinName;
-                errorResult["Status"] = "ERROR";
-                errorResult["respCode"] = 500;
-                errorResult["Message"] = std::string("Error setting GPIO pin: ") + e.what();
-
-                std::string errorStr = SaveJsonToString(errorResult);
-                return makeStringResponse(errorStr, 500, "application/json");
-            }
-        } else {
-            Json::Value errorResult;
-            errorResult["pin"] = pinName;
-            errorResult["Status"] = "ERROR";
-            errorResult["respCode"] = 404;
-            errorResult["Message"] = "GPIO pin not found: " + pinName;
-
-            std::string errorStr = SaveJsonToString(errorResult);
-            return makeStringResponse(errorStr, 404, "application/json");
-        }
-    }
-
-    return makeStringResponse("Not Found", 404, "text/plain");
-}
-
 void GPIOManager::SetupGPIOInput(std::map<int, std::function<bool(int)>>& callbacks) {
     LogDebug(VB_GPIO, "SetupGPIOInput()\n");
 
@@ -482,8 +325,9 @@ void GPIOManager::addGPIOCallback(GPIOState* a) {
             return false;
         }
         if (v != a->lastValue) {
-            if (!a->shouldDebounce(v)) {
-                // No debounce on this edge — fire immediately.
+            if (a->kernelDebounce || !a->shouldDebounce(v)) {
+                // No debounce on this edge, or the driver already waited for
+                // the line to settle — fire immediately.
                 a->doAction(v);
             } else {
                 // Settle-then-fire: start the settle timer if this is a new direction.
@@ -504,6 +348,10 @@ void GPIOManager::AddGPIOCallback(const PinCapabilities* pin, const std::functio
     state->pin = pin;
     state->callback = cb;
     state->hasCallback = true;
+    // Callback users (eFuse/fault monitoring) need every edge as soon as it
+    // happens, they do their own filtering if they want any
+    state->debounceTime = 0;
+    state->debounceEdge = GPIOState::DebounceEdge::None;
     addState(state);
 }
 
@@ -525,6 +373,9 @@ void GPIOManager::RemoveGPIOCallback(const PinCapabilities* pin) {
         if (a->pin == pin) {
             pollStates.erase(it);
             delete a;
+            if (pollStates.empty()) {
+                stopPolling();
+            }
             return;
         }
     }
@@ -541,19 +392,24 @@ void GPIOManager::addState(GPIOState* state) {
     state->lastTriggerTime = 0;
     state->file = -1;
 
-    if (state->pin->supportsGpiod()) {
-        // Request events for any edge that has actions or is needed for hold detection.
-        bool wantRising = !state->risingActions.empty() || !state->holdActions.empty();
-        bool wantFalling = !state->fallingActions.empty() || !state->holdActions.empty();
-        state->file = state->pin->requestEventFile(wantRising, wantFalling);
-    } else {
-        state->file = -1;
-    }
+    // Request events for any edge that has actions, is needed for hold
+    // detection or feeds a callback.  When both edges are debounced the
+    // driver is asked to do it so bounces never wake us up; not every
+    // kernel/chip supports that and eventsDebounced() says if it took.
+    bool wantRising = state->hasCallback || !state->risingActions.empty() || !state->holdActions.empty();
+    bool wantFalling = state->hasCallback || !state->fallingActions.empty() || !state->holdActions.empty();
+    uint32_t debounceUS = state->debounceEdge == GPIOState::DebounceEdge::Both ? state->debounceTime : 0;
+    state->file = state->pin->requestEventFile(wantRising, wantFalling, debounceUS);
 
     if (state->file > 0) {
+        state->kernelDebounce = debounceUS && state->pin->eventsDebounced();
         eventStates.push_back(state);
         addGPIOCallback(state);
     } else {
+        // no edge events from this pin (I/O expanders), fall back to polling
+        if (pollStates.empty()) {
+            startPolling();
+        }
         pollStates.push_back(state);
     }
 }
@@ -641,7 +497,12 @@ void GPIOManager::GPIOState::checkHoldTimer(long long scheduledStart) {
 // Returns true if debounce should apply to this edge.
 // v == 1 is rising, v == 0 is falling.
 bool GPIOManager::GPIOState::shouldDebounce(int v) const {
+    if (debounceTime == 0) {
+        return false;
+    }
     switch (debounceEdge) {
+        case DebounceEdge::None:
+            return false;
         case DebounceEdge::Rising:
             return (v == 1);
         case DebounceEdge::Falling:
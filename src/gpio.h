@@ -19,6 +19,8 @@
 #include "config.h"
 
 constexpr uint32_t DEFAULT_GPIO_DEBOUNCE_TIME = 100000;
+// Pins that cannot deliver edge events (MCP23x17, PiFace) are read at this rate
+constexpr uint32_t GPIO_POLL_INTERVAL_MS = 20;
 
 class PinCapabilities;
 
@@ -114,9 +116,12 @@ private:
         enum class DebounceEdge {
             Both,    // debounce rising and falling (default)
             Rising,  // debounce only rising; falling fires immediately
-            Falling  // debounce only falling; rising fires immediately
+            Falling, // debounce only falling; rising fires immediately
+            None     // every edge fires immediately
         };
         DebounceEdge debounceEdge = DebounceEdge::Both;
+        // The pin driver filters bounces itself, events are already settled
+        bool kernelDebounce = false;
 
         // ── Re-enable after trigger ──────────────────────────────────────────
         // Controls how long the input is suppressed after commands fire.
@@ -143,6 +148,8 @@ private:
     void addGPIOCallback(GPIOState* state);
     void checkDebounceTimers();
     void scheduleDebounceCheck(GPIOState* state);
+    void startPolling();
+    void stopPolling();
     std::list<GPIOState*> pollStates;
     std::list<GPIOState*> eventStates;
     friend class GPIOCommand;
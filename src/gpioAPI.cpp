@@ -0,0 +1,195 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2022 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+#include "fpp-pch.h"
+
+#include "fpp-json.h"
+#include "fpphttp.h"
+
+#include "log.h"
+#include "util/GPIOUtils.h"
+
+#include "gpio.h"
+
+// The /gpio REST handlers live apart from gpio.cpp so the input handling
+// doesn't need the drogon headers.
+
+/**
+ * List the available GPIO pins. Add ?list=true for just the pin names.
+ *
+ * @route GET /api/gpio
+ * @param boolean list Return just the pin names instead of full capabilities.
+ * @response 200 Array of pin capability objects (or pin names when `list=true`).
+ */
+
+/**
+ * Read the last value set on a GPIO pin via the API/commands. Only pins with a
+ * cached value can be read; output pins must be SET before they can be read.
+ *
+ * @route GET /api/gpio/{pin}
+ * @response 200 Object with `pin` and `value` (0 or 1).
+ * @response 400 The pin has no cached value.
+ */
+HttpResponsePtr GPIOManager::render_GET(const HttpRequestPtr& req) {
+    auto pieces = getPathPieces(req->path());
+    int plen = pieces.size();
+    std::string p1 = pieces[0];
+    if (p1 == "gpio") {
+        if (plen <= 1) {
+            bool simpleList = false;
+            if (getRequestArg(req, "list") == "true") {
+                simpleList = true;
+            }
+            std::vector<std::string> pins = PinCapabilities::getPinNames();
+            if (pins.empty()) {
+                return makeStringResponse("[]", 200, "application/json");
+            }
+            Json::Value result;
+            for (auto& a : pins) {
+                if (simpleList) {
+                    result.append(a);
+                } else {
+                    result.append(PinCapabilities::getPinByName(a).toJSON());
+                }
+            }
+            std::string resultStr = SaveJsonToString(result);
+            return makeStringResponse(resultStr, 200, "application/json");
+        } else if (plen == 2) {
+            // Handle reading individual GPIO pin value: /gpio/{pin_name}
+            std::string pinName = pieces[1];
+            Json::Value result;
+
+            // Check if we have a tracked value for this pin FIRST (from previous SET operations)
+            // This avoids touching the pin hardware which could interfere with output pins
+            auto it = GPIOManager::INSTANCE.fppCommandLastValue.find(pinName);
+            if (it != GPIOManager::INSTANCE.fppCommandLastValue.end()) {
+                // Return the last set value without touching the pin
+                LogDebug(VB_HTTP, "GPIO GET: Returning cached value for %s: %d\n", pinName.c_str(), it->second ? 1 : 0);
+                result["pin"] = pinName;
+                result["value"] = it->second ? 1 : 0;
+                result["Status"] = "OK";
+                result["respCode"] = 200;
+
+                std::string resultStr = SaveJsonToString(result);
+                return makeStringResponse(resultStr, 200, "application/json");
+            }
+
+            // No tracked value - pin hasn't been set via API/commands yet
+            // Return error rather than trying to read it which could interfere with output pins
+            LogWarn(VB_HTTP, "GPIO GET: No cached value for pin %s - cannot read output pins safely\n", pinName.c_str());
+
+            result["pin"] = pinName;
+            result["Status"] = "ERROR";
+            result["respCode"] = 400;
+            result["Message"] = "Pin has no cached value. For output pins, you must SET a value before you can GET it. For input pins, configure them via the GPIO Input configuration page.";
+
+            std::string resultStr = SaveJsonToString(result);
+            return makeStringResponse(resultStr, 400, "application/json");
+        }
+    }
+    return makeStringResponse("Not Found", 404, "text/plain");
+}
+
+/**
+ * Configure a GPIO pin for output and set its value. Body: `{"value": 0|1}`.
+ *
+ * @route POST /api/gpio/{pin}
+ * @body {"value": 1}
+ * @response 200 Object with `pin` and the applied `value`.
+ * @response 400 Missing/invalid `value` field.
+ * @response 404 The named pin does not exist.
+ * @response 500 Error setting the pin.
+ */
+HttpResponsePtr GPIOManager::render_POST(const HttpRequestPtr& req) {
+    auto pieces = getPathPieces(req->path());
+    int plen = pieces.size();
+    std::string p1 = pieces[0];
+
+    if (p1 == "gpio" && plen == 2) {
+        // Handle setting individual GPIO pin value: POST /gpio/{pin_name}
+        std::string pinName = pieces[1];
+        const PinCapabilities& pin = PinCapabilities::getPinByName(pinName);
+
+        if (pin.ptr()) {
+            Json::Value data;
+            Json::Value result;
+
+            // Parse POST data
+            if (getRequestContent(req) != "") {
+                if (!LoadJsonFromString(getRequestContent(req), data)) {
+                    Json::Value errorResult;
+                    errorResult["pin"] = pinName;
+                    errorResult["Status"] = "ERROR";
+                    errorResult["respCode"] = 400;
+                    errorResult["Message"] = "Error parsing POST content";
+
+                    std::string errorStr = SaveJsonToString(errorResult);
+                    return makeStringResponse(errorStr, 400, "application/json");
+                }
+            }
+
+            // Check for required 'value' field
+            if (!data.isMember("value")) {
+                Json::Value errorResult;
+                errorResult["pin"] = pinName;
+                errorResult["Status"] = "ERROR";
+                errorResult["respCode"] = 400;
+                errorResult["Message"] = "'value' field not specified. Use {\"value\": 0} or {\"value\": 1}";
+
+                std::string errorStr = SaveJsonToString(errorResult);
+                return makeStringResponse(errorStr, 400, "application/json");
+            }
+
+            try {
+                // Configure the pin for output
+                pin.configPin("gpio", true, "GPIO Output");
+
+                // Set the value (convert to boolean)
+                bool value = data["value"].asBool() || (data["value"].isInt() && data["value"].asInt() != 0);
+                pin.setValue(value);
+
+                // Update the last value tracking (for Opposite command functionality and GET requests)
+                GPIOManager::INSTANCE.fppCommandLastValue[pinName] = value;
+                LogDebug(VB_HTTP, "GPIO POST: Set pin %s to %d, cached value\n", pinName.c_str(), value ? 1 : 0);
+
+                result["pin"] = pinName;
+                result["value"] = value ? 1 : 0;
+                result["Status"] = "OK";
+                result["respCode"] = 200;
+                result["Message"] = "GPIO pin value set successfully";
+
+                std::string resultStr = SaveJsonToString(result);
+                return makeStringResponse(resultStr, 200, "application/json");
+            } catch (const std::exception& e) {
+                Json::Value errorResult;
+                errorResult["pin"] = pinName;
+                errorResult["Status"] = "ERROR";
+                errorResult["respCode"] = 500;
+                errorResult["Message"] = std::string("Error setting GPIO pin: ") + e.what();
+
+                std::string errorStr = SaveJsonToString(errorResult);
+                return makeStringResponse(errorStr, 500, "application/json");
+            }
+        } else {
+            Json::Value errorResult;
+            errorResult["pin"] = pinName;
+            errorResult["Status"] = "ERROR";
+            errorResult["respCode"] = 404;
+            errorResult["Message"] = "GPIO pin not found: " + pinName;
+
+            std::string errorStr = SaveJsonToString(errorResult);
+            return makeStringResponse(errorStr, 404, "application/json");
+        }
+    }
+
+    return makeStringResponse("Not Found", 404, "text/plain");
+}
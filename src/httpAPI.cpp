@@ -13,6 +13,7 @@
 // Include drogon framework header before FPP headers to avoid
 // macro conflicts between trantor's LOG_* macros and FPP's LogLevel enum
 #include <drogon/HttpAppFramework.h>
+#include <drogon/WebSocketController.h>
 #undef LOG_WARN
 #undef LOG_INFO
 #undef LOG_DEBUG
@@ -47,12 +48,14 @@ extern volatile int runMainFPPDLoop;
 #include <string>
 #include <vector>
 
+#include "FPPDStatus.h"
 #include "MultiSync.h"
 #include "OutputMonitor.h"
 #include "Player.h"
 #include "Plugins.h"
 #include "Scheduler.h"
 #include "Sequence.h"
+#include "SequenceSlicer.h"
 #include "Warnings.h"
 #include "common.h"
 #include "e131bridge.h"
@@ -82,9 +85,9 @@ static std::time_t startupTime = std::time(nullptr);
 static bool piPowerBad = false;
 
 /*
- Build a Status JSON String
+ Build a Status JSON String, use GetCurrentFPPDStatus() to get the shared snapshot
 */
-void GetCurrentFPPDStatus(Json::Value& result) {
+void BuildFPPDStatus(Json::Value& result) {
     std::string UUID = getSetting("SystemUUID");
     static std::string host_name = getSetting("HostName");
     static std::string host_description = getSetting("HostDescription");
@@ -205,6 +208,7 @@ void GetCurrentFPPDStatus(Json::Value& result) {
     if (mqtt) {
         result["MQTT"]["configured"] = true;
         result["MQTT"]["connected"] = mqtt->IsConnected();
+        mqtt->dumpPublishStats(result["MQTT"]["publish"]);
     }
 
     if (getFPPmode() == REMOTE_MODE) {
@@ -252,6 +256,120 @@ void GetCurrentFPPDStatus(Json::Value& result) {
     }
 }
 
+void GetCurrentFPPDStatus(Json::Value& result) {
+    auto snapshot = FPPDStatus::INSTANCE.GetSnapshot();
+    for (auto& name : snapshot->getMemberNames()) {
+        result[name] = (*snapshot)[name];
+    }
+}
+
+/*
+ * Pushes the status snapshot to WebSocket clients.  A client gets the full
+ * status when it connects and then a JSON merge patch of what changed.
+ * The patch is built once per update and sent to every client holding the
+ * patch's base generation so the cost doesn't depend on how many
+ * dashboards are open.  A client holding any other generation, such as one
+ * that connected since the last update, gets the full status instead.
+ */
+class StatusWebSocket : public drogon::WebSocketController<StatusWebSocket, false> {
+public:
+    static constexpr double UPDATE_INTERVAL = 0.25;
+
+    WS_PATH_LIST_BEGIN
+    WS_PATH_ADD("/fppd/statusStream");
+    WS_PATH_LIST_END
+
+    virtual void handleNewMessage(const drogon::WebSocketConnectionPtr& conn, std::string&& message,
+                                  const drogon::WebSocketMessageType& type) override {
+        // clients don't send anything, pings are handled by drogon
+    }
+    virtual void handleNewConnection(const HttpRequestPtr& req, const drogon::WebSocketConnectionPtr& conn) override {
+        uint64_t generation = 0;
+        auto snapshot = FPPDStatus::INSTANCE.GetSnapshot(&generation);
+        conn->send(FullMessage(*snapshot, generation));
+
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_connections[conn] = generation;
+        LogDebug(VB_HTTP, "Status stream client connected, %d clients\n", (int)m_connections.size());
+    }
+    virtual void handleConnectionClosed(const drogon::WebSocketConnectionPtr& conn) override {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_connections.erase(conn);
+        LogDebug(VB_HTTP, "Status stream client disconnected, %d clients\n", (int)m_connections.size());
+    }
+
+    // Called from the drogon main loop every UPDATE_INTERVAL
+    void update() {
+        std::unique_lock<std::mutex> lock(m_lock);
+        if (m_connections.empty()) {
+            m_last.reset();
+            return;
+        }
+        lock.unlock();
+
+        uint64_t generation = 0;
+        auto snapshot = FPPDStatus::INSTANCE.GetSnapshot(&generation);
+        if (generation == m_checkedGeneration) {
+            return;
+        }
+        m_checkedGeneration = generation;
+
+        std::string diff;
+        uint64_t base = m_lastGeneration;
+        if (m_last) {
+            Json::Value patch = FPPDStatus::Diff(*m_last, *snapshot);
+            if (patch.empty()) {
+                // nothing changed, clients stay on m_lastGeneration
+                return;
+            }
+            Json::Value msg;
+            msg["type"] = "diff";
+            msg["base"] = (Json::UInt64)base;
+            msg["generation"] = (Json::UInt64)generation;
+            msg["patch"] = patch;
+            diff = SaveJsonToString(msg);
+        }
+        m_last = snapshot;
+        m_lastGeneration = generation;
+
+        std::string full;
+        lock.lock();
+        for (auto& [c, held] : m_connections) {
+            if (held == generation) {
+                // connected since the snapshot was taken
+                continue;
+            }
+            if (!diff.empty() && (held == base)) {
+                c->send(diff);
+            } else {
+                if (full.empty()) {
+                    full = FullMessage(*snapshot, generation);
+                }
+                c->send(full);
+            }
+            held = generation;
+        }
+    }
+
+private:
+    static std::string FullMessage(const Json::Value& status, uint64_t generation) {
+        Json::Value msg;
+        msg["type"] = "full";
+        msg["generation"] = (Json::UInt64)generation;
+        msg["status"] = status;
+        return SaveJsonToString(msg);
+    }
+
+    std::mutex m_lock;
+    // the status generation each client holds
+    std::map<drogon::WebSocketConnectionPtr, uint64_t> m_connections;
+
+    // only used from update()
+    std::shared_ptr<const Json::Value> m_last;
+    uint64_t m_lastGeneration = 0;
+    uint64_t m_checkedGeneration = 0;
+};
+
 /*
  *
  */
@@ -437,6 +555,13 @@ void APIServer::Init(void) {
     app.registerHandler("/player", copyHandler(handlePlayer), {drogon::Get, drogon::Post, drogon::Put, drogon::Head});
     app.registerHandlerViaRegex("/player/.*", copyHandler(handlePlayer), {drogon::Get, drogon::Post, drogon::Put, drogon::Head});
 
+    // Status stream (/fppd/statusStream WebSocket)
+    auto statusStream = std::make_shared<StatusWebSocket>();
+    app.registerController(statusStream);
+    app.getLoop()->runEvery(StatusWebSocket::UPDATE_INTERVAL, [statusStream]() {
+        statusStream->update();
+    });
+
     // Let plugins register their own routes
     PluginManager::INSTANCE.registerApis();
 
@@ -536,6 +661,18 @@ PlayerResource::~PlayerResource() {
  * @response 200 Current player status JSON.
  */
 
+/**
+ * WebSocket stream of the player status.  The first message is
+ * `{"type": "full", "generation": N, "status": {...}}` with the same status
+ * as /api/fppd/status, later messages are
+ * `{"type": "diff", "generation": N, "patch": {...}}` where patch is a JSON
+ * merge patch (RFC 7386) of the members that changed.  Updates are sent at
+ * most four times a second and only when the status changed.
+ *
+ * @route GET /api/fppd/statusStream
+ * @response 101 Switching to the WebSocket protocol.
+ */
+
 /**
  * List the messages for all currently active warnings.
  *
@@ -630,6 +767,24 @@ PlayerResource::~PlayerResource() {
  * @response 200 Running sequences.
  */
 
+/**
+ * Get a sparse copy of a sequence containing only some channel ranges.
+ *
+ * Used by MultiSync remotes so they only need to download and read the
+ * channels they output.  Slices are cached on the master and rebuilt when
+ * the sequence changes.  A slice that isn't cached yet is built in the
+ * background; the request returns 202 and should be retried after the
+ * Retry-After delay.
+ *
+ * @route GET /api/fppd/sequenceSlice/{sequence}
+ * @param string ranges Channel ranges as "first-last,first-last" (0 based, inclusive).
+ * @param string remote Address or hostname of a MultiSync remote to use the channel ranges it reported instead of `ranges`.
+ * @response 200 The sliced fseq file (application/octet-stream).
+ * @response 202 The slice is being built, try again later.
+ * @response 400 No channel ranges were specified.
+ * @response 404 The sequence or remote was not found.
+ */
+
 /**
  * Dump the cached MQTT messages.
  *
@@ -716,6 +871,39 @@ HttpResponsePtr PlayerResource::render_GET(const HttpRequestPtr& req) {
         SetOKResult(result, "");
     } else if (url == "sequence") {
         LogDebug(VB_HTTP, "API - Getting list of running sequences\n");
+    } else if (startsWith(url, "sequenceSlice/")) {
+        std::string sequence = url.substr(14);
+        SequenceSlicer::RangeList ranges;
+        std::string remote = getRequestArg(req, "remote");
+        if (!remote.empty()) {
+            if (!SequenceSlicer::INSTANCE.GetRemoteRanges(remote, ranges)) {
+                SetErrorResult(result, 404, "No channel ranges known for remote " + remote);
+            }
+        } else {
+            ranges = SequenceSlicer::ParseRanges(getRequestArg(req, "ranges"));
+            if (ranges.empty()) {
+                SetErrorResult(result, 400, "No channel ranges specified");
+            }
+        }
+        if (!ranges.empty()) {
+            std::string slice;
+            SequenceSlicer::SliceState state = SequenceSlicer::INSTANCE.GetSlice(sequence, ranges, slice);
+            if (state == SequenceSlicer::SliceState::Ready) {
+                LogDebug(VB_HTTP, "API - Sending sequence slice %s\n", slice.c_str());
+                return drogon::HttpResponse::newFileResponse(slice, sequence, drogon::CT_APPLICATION_OCTET_STREAM);
+            } else if (state == SequenceSlicer::SliceState::Building) {
+                result["Status"] = "BUILDING";
+                result["respCode"] = 202;
+                result["Message"] = "Slice of " + sequence + " is being built";
+                resultStr = SaveJsonToString(result);
+                LogResponse(req, 202, resultStr);
+                HttpResponsePtr resp = makeStringResponse(resultStr, 202, "application/json");
+                resp->addHeader("Retry-After", "2");
+                return resp;
+            } else {
+                SetErrorResult(result, 404, "Could not create slice of " + sequence);
+            }
+        }
     } else if (url == "mqtt/cache") {
         LogDebug(VB_HTTP, "API - Getting MQTT Cached data\n");
         if (mqtt) {
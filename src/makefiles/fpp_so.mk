@@ -8,6 +8,8 @@ OBJECTS_fpp_so += \
 	channeloutput/channeloutputthread.o \
 	channeloutput/ColorOrder.o \
 	channeloutput/Matrix.o \
+	channeloutput/PanelBitPlanes.o \
+	channeloutput/PanelGather.o \
 	channeloutput/PanelMatrix.o \
 	channeloutput/PanelInterleaveHandler.o \
 	channeloutput/PixelString.o \
@@ -48,14 +50,17 @@ OBJECTS_fpp_so += \
 	EPollManager.o \
 	Events.o \
 	FileMonitor.o \
+	FPPDStatus.o \
 	fppversion.o \
 	framebuffer/FrameBuffer.o \
+	framebuffer/FrameBufferRows.o \
 	framebuffer/IOCTLFrameBuffer.o \
 	framebuffer/KMSFrameBuffer.o \
 	framebuffer/SocketFrameBuffer.o \
 	framebuffer/X11FrameBuffer.o \
 	fseq/FSEQFile.o \
 	gpio.o \
+	gpioAPI.o \
 	httpAPI.o \
 	fpphttp_compat.o \
 	log.o \
@@ -79,12 +84,14 @@ OBJECTS_fpp_so += \
 	WLEDAudioSync.o \
 	Player.o \
 	OutputMonitor.o \
+	overlays/GlyphAtlas.o \
 	overlays/PixelOverlay.o \
     overlays/PixelOverlayEffects.o \
 	overlays/PixelOverlayModel.o \
 	overlays/PixelOverlayModelFB.o \
 	overlays/PixelOverlayModelSub.o \
     overlays/WLEDEffects.o \
+    overlays/wled/audio_fft.o \
     overlays/wled/colors.o \
     overlays/wled/FX.o \
     overlays/wled/FX_fcn.o \
@@ -93,8 +100,6 @@ OBJECTS_fpp_so += \
     overlays/wled/colorpalettes.o \
     overlays/wled/colorutils.o \
     overlays/wled/crgb.o \
-    overlays/wled/kiss_fftr.o \
-    overlays/wled/kiss_fft.o \
     overlays/wled/noise.o \
     overlays/wled/hsv2rgb.o \
     overlays/wled/util.o \
@@ -126,6 +131,7 @@ OBJECTS_fpp_so += \
 	sensors/Sensors.o \
 	sensors/ADS7828.o \
 	Sequence.o \
+	SequenceSlicer.o \
 	settings.o \
 	SunRise.o \
 	Timers.o \
@@ -154,6 +160,13 @@ LIBS_fpp_so += \
 	-lGraphicsMagick++ \
     $(LIBS_GPIO_ADDITIONS)
 
+# FreeType text rendering for overlay Text effects, GraphicsMagick is used if not available
+ifneq ($(wildcard /usr/include/freetype2/ft2build.h),)
+CXXFLAGS_overlays/GlyphAtlas.o+=$(shell pkg-config --cflags freetype2)
+CXXFLAGS_overlays/PixelOverlayEffects.o+=$(shell pkg-config --cflags freetype2)
+LIBS_fpp_so += $(shell pkg-config --libs freetype2)
+endif
+
 # GStreamer support
 ifneq ($(wildcard /usr/include/gstreamer-1.0/gst/gst.h),)
 CFLAGS += $(shell pkg-config --cflags gstreamer-1.0 gstreamer-app-1.0 gstreamer-net-1.0)
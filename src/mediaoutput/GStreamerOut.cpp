@@ -50,9 +50,9 @@
 // Static instance pointer for callbacks
 GStreamerOutput* GStreamerOutput::m_currentInstance = nullptr;
 
-// Static audio sample buffer for WLED audio-reactive effects
-std::array<float, GStreamerOutput::SAMPLE_BUFFER_SIZE> GStreamerOutput::s_sampleBuffer = {};
-int GStreamerOutput::s_sampleWritePos = 0;
+// Static audio sample tap for WLED audio-reactive effects
+std::atomic<GStreamerOutput::AudioSampleCallback> GStreamerOutput::s_sampleCallback{ nullptr };
+void* GStreamerOutput::s_sampleCallbackData = nullptr;
 int GStreamerOutput::s_sampleRate = 0;
 std::mutex GStreamerOutput::s_sampleMutex;
 
@@ -1159,11 +1159,9 @@ int GStreamerOutput::Start(int msTime) {
         m_videoAppsinkSignalId = 0;
     }
 
-    // Clear the sample buffer for fresh playback
+    // Pick up the sample rate from the caps of the first tapped buffer
     {
         std::lock_guard<std::mutex> lock(s_sampleMutex);
-        s_sampleBuffer.fill(0.0f);
-        s_sampleWritePos = 0;
         s_sampleRate = 0;
     }
 
@@ -2465,51 +2463,34 @@ GstFlowReturn GStreamerOutput::OnNewSample(GstAppSink* appsink, gpointer userDat
     GstBuffer* buffer = gst_sample_get_buffer(sample);
     GstCaps* caps = gst_sample_get_caps(sample);
 
-    // Extract sample rate from caps on first buffer
-    if (caps) {
-        GstStructure* s = gst_caps_get_structure(caps, 0);
-        int rate = 0;
-        if (gst_structure_get_int(s, "rate", &rate) && rate > 0) {
-            std::lock_guard<std::mutex> lock(s_sampleMutex);
-            s_sampleRate = rate;
-        }
-    }
-
-    GstMapInfo map;
-    if (gst_buffer_map(buffer, &map, GST_MAP_READ)) {
-        int numFloats = map.size / sizeof(float);
-        const float* src = reinterpret_cast<const float*>(map.data);
-
+    if (s_sampleCallback.load(std::memory_order_relaxed) && self == m_currentInstance && self->m_playing) {
         std::lock_guard<std::mutex> lock(s_sampleMutex);
-        for (int i = 0; i < numFloats; i++) {
-            s_sampleBuffer[s_sampleWritePos] = src[i];
-            s_sampleWritePos = (s_sampleWritePos + 1) % SAMPLE_BUFFER_SIZE;
+        AudioSampleCallback cb = s_sampleCallback.load(std::memory_order_relaxed);
+        // Extract sample rate from caps on first buffer
+        if (caps && s_sampleRate == 0) {
+            GstStructure* s = gst_caps_get_structure(caps, 0);
+            int rate = 0;
+            if (gst_structure_get_int(s, "rate", &rate) && rate > 0) {
+                s_sampleRate = rate;
+            }
         }
 
-        gst_buffer_unmap(buffer, &map);
+        GstMapInfo map;
+        if (cb && s_sampleRate && gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+            cb(s_sampleCallbackData, reinterpret_cast<const float*>(map.data), map.size / sizeof(float), s_sampleRate);
+            gst_buffer_unmap(buffer, &map);
+        }
     }
 
     gst_sample_unref(sample);
     return GST_FLOW_OK;
 }
 
-bool GStreamerOutput::GetAudioSamples(float* samples, int numSamples, int& sampleRate) {
-    if (!m_currentInstance || !m_currentInstance->m_playing)
-        return false;
-
+void GStreamerOutput::SetAudioSampleCallback(AudioSampleCallback cb, void* data) {
+    // once this returns no call to the previous callback is in progress
     std::lock_guard<std::mutex> lock(s_sampleMutex);
-    if (s_sampleRate == 0)
-        return false;
-
-    sampleRate = s_sampleRate;
-
-    // Read the most recent numSamples from the circular buffer
-    int readPos = (s_sampleWritePos - numSamples + SAMPLE_BUFFER_SIZE) % SAMPLE_BUFFER_SIZE;
-    for (int i = 0; i < numSamples; i++) {
-        samples[i] = s_sampleBuffer[readPos];
-        readPos = (readPos + 1) % SAMPLE_BUFFER_SIZE;
-    }
-    return true;
+    s_sampleCallback.store(cb, std::memory_order_relaxed);
+    s_sampleCallbackData = data;
 }
 
 // ──────────────────────────────────────────────────────────────────────────────
@@ -46,7 +46,12 @@ public:
     // Static methods matching SDLOutput interface
     static bool IsOverlayingVideo();
     static bool ProcessVideoOverlay(unsigned int msTimestamp);
-    static bool GetAudioSamples(float* samples, int numSamples, int& sampleRate);
+
+    // Tap for the WLED audio reactive analysis.  The callback is handed the
+    // mono float samples of the current instance on its streaming thread,
+    // calls are serialized so the receiver can treat them as one producer.
+    typedef void (*AudioSampleCallback)(void* data, const float* samples, int count, int sampleRate);
+    static void SetAudioSampleCallback(AudioSampleCallback cb, void* data);
 
     // One-time GStreamer + PipeWire env initialization (safe to call repeatedly)
     static void EnsureGStreamerInit();
@@ -122,9 +127,8 @@ private:
     static GstBusSyncReply BusSyncHandler(GstBus* bus, GstMessage* msg, gpointer userData);
 
     // Audio sample tap for WLED audio-reactive effects
-    static constexpr int SAMPLE_BUFFER_SIZE = 4096; // circular buffer size
-    static std::array<float, SAMPLE_BUFFER_SIZE> s_sampleBuffer;
-    static int s_sampleWritePos;
+    static std::atomic<AudioSampleCallback> s_sampleCallback;
+    static void* s_sampleCallbackData;
     static int s_sampleRate;
     static std::mutex s_sampleMutex;
     static GstFlowReturn OnNewSample(GstAppSink* appsink, gpointer userData);
@@ -15,7 +15,9 @@
 #include "fpp-json.h"
 #include "fppversion.h"
 
+#include <algorithm>
 #include <atomic>
+#include <climits>
 #include <cstring>
 #include <functional>
 #include <list>
@@ -31,6 +33,7 @@
 #include "Events.h"
 #include "Timers.h"
 #include "Warnings.h"
+#include "common.h"
 #include "common_mini.h" // FPPstrerror(), FPPrand() -- needed directly for NOPCH builds
 #include "log.h"
 #include "mqtt.h"
@@ -39,6 +42,10 @@
 
 #define FALCON_TOPIC "falcon/player"
 
+// Most messages that can wait in the publish queue, past this new messages
+// are dropped.  Coalesced topics only take one slot each.
+#define MQTT_MAX_QUEUED_MESSAGES 1000
+
 MosquittoClient* mqtt = NULL;
 
 class MQTTCommand : public Command {
@@ -129,6 +136,8 @@ MosquittoClient::MosquittoClient(const std::string& host, const int port,
  *
  */
 MosquittoClient::~MosquittoClient() {
+    StopPublishThread();
+
     mosquitto_loop_stop(m_mosq, true);
 
     sleep(1);
@@ -228,6 +237,10 @@ int MosquittoClient::Init(const std::string& username, const std::string& passwo
         return 0;
     }
 
+    int maxRate = getSettingInt("MQTTMaxTopicRate", 20);
+    m_topicIntervalMS = maxRate > 0 ? 1000 / maxRate : 0;
+    StartPublishThread();
+
     CommandManager::INSTANCE.addCommand(new MQTTCommand());
 
     return 1;
@@ -236,12 +249,70 @@ int MosquittoClient::Init(const std::string& username, const std::string& passwo
 /*
  *
  */
-int MosquittoClient::PublishRaw(const std::string& topic, const std::string& msg, const bool retain, const int qos) {
-    LogDebug(VB_CONTROL, "Publishing message '%s' on topic '%s'\n", msg.c_str(), topic.c_str());
+int MosquittoClient::PublishRaw(const std::string& topic, const std::string& msg, const bool retain, const int qos, const bool coalesce) {
+    LogDebug(VB_CONTROL, "Queueing message '%s' on topic '%s'\n", msg.c_str(), topic.c_str());
+
+    std::unique_lock<std::mutex> lock(m_publishLock);
+    if (!m_publishThread.joinable() || m_publishStop) {
+        // Init failed before the publish thread started, or we are shutting
+        // down.  Nothing would ever send this so don't let it sit queued.
+        if ((m_statDropped++ % 100) == 0) {
+            LogWarn(VB_CONTROL, "MQTT publish thread not running, dropping message on topic '%s'\n", topic.c_str());
+        }
+        return 0;
+    }
+    if (coalesce) {
+        PendingMessage* pending = nullptr;
+        auto it = m_publishPending.find(topic);
+        if (it != m_publishPending.end()) {
+            pending = &(*it->second);
+        } else {
+            auto dit = m_publishDeferred.find(topic);
+            if (dit != m_publishDeferred.end()) {
+                pending = &dit->second;
+            }
+        }
+        if (pending) {
+            // not sent yet, just send the new value instead
+            pending->payload = msg;
+            pending->retain = retain;
+            pending->qos = qos;
+            m_statCoalesced++;
+            return 1;
+        }
+        auto nit = m_topicNextSendMS.find(topic);
+        if (nit != m_topicNextSendMS.end() && GetTimeMS() < nit->second) {
+            PendingMessage& m = m_publishDeferred[topic];
+            m.topic = topic;
+            m.payload = msg;
+            m.retain = retain;
+            m.qos = qos;
+            m.coalesce = true;
+            m_publishCV.notify_one();
+            return 1;
+        }
+    }
+    if (m_publishQueue.size() >= MQTT_MAX_QUEUED_MESSAGES) {
+        if ((m_statDropped++ % 100) == 0) {
+            LogWarn(VB_CONTROL, "MQTT publish queue full, dropping message on topic '%s'\n", topic.c_str());
+        }
+        return 0;
+    }
+    m_publishQueue.push_back({ topic, msg, qos, retain, coalesce });
+    if (coalesce) {
+        m_publishPending[topic] = std::prev(m_publishQueue.end());
+    }
+    m_statMaxDepth = std::max(m_statMaxDepth, m_publishQueue.size());
+    m_publishCV.notify_one();
+    return 1;
+}
+
+int MosquittoClient::SendMessage(const PendingMessage& msg) {
+    LogDebug(VB_CONTROL, "Publishing message '%s' on topic '%s'\n", msg.payload.c_str(), msg.topic.c_str());
 
     pthread_mutex_lock(&m_mosqLock);
 
-    int result = mosquitto_publish(m_mosq, NULL, topic.c_str(), msg.size(), msg.c_str(), qos, retain);
+    int result = mosquitto_publish(m_mosq, NULL, msg.topic.c_str(), msg.payload.size(), msg.payload.c_str(), msg.qos, msg.retain);
 
     pthread_mutex_unlock(&m_mosqLock);
 
@@ -258,10 +329,98 @@ int MosquittoClient::PublishRaw(const std::string& topic, const std::string& msg
     return 1;
 }
 
+void MosquittoClient::StartPublishThread() {
+    std::unique_lock<std::mutex> lock(m_publishLock);
+    if (m_publishThread.joinable()) {
+        return;
+    }
+    m_publishStop = false;
+    m_publishThread = std::thread(&MosquittoClient::PublishThread, this);
+}
+
+void MosquittoClient::StopPublishThread() {
+    std::unique_lock<std::mutex> lock(m_publishLock);
+    if (!m_publishThread.joinable()) {
+        return;
+    }
+    m_publishStop = true;
+    m_publishCV.notify_one();
+    lock.unlock();
+    m_publishThread.join();
+}
+
+// Sends everything in the queue in order.  Rate limited topics that were
+// updated too soon sit in m_publishDeferred until their slot opens and then
+// go to the back of the queue.  On shutdown everything left is flushed.
+void MosquittoClient::PublishThread() {
+    SetThreadName("FPP-MQTTPublish");
+    std::unique_lock<std::mutex> lock(m_publishLock);
+    while (true) {
+        long long now = GetTimeMS();
+        long long nextDeferred = LLONG_MAX;
+        for (auto it = m_publishDeferred.begin(); it != m_publishDeferred.end();) {
+            long long due = m_topicNextSendMS[it->first];
+            if (due <= now || m_publishStop) {
+                m_publishQueue.push_back(std::move(it->second));
+                m_publishPending[it->first] = std::prev(m_publishQueue.end());
+                it = m_publishDeferred.erase(it);
+            } else {
+                nextDeferred = std::min(nextDeferred, due);
+                ++it;
+            }
+        }
+        if (m_publishQueue.empty()) {
+            if (m_publishStop) {
+                return;
+            }
+            if (nextDeferred == LLONG_MAX) {
+                m_publishCV.wait(lock);
+            } else {
+                m_publishCV.wait_for(lock, std::chrono::milliseconds(nextDeferred - now));
+            }
+            continue;
+        }
+
+        PendingMessage msg = std::move(m_publishQueue.front());
+        m_publishQueue.pop_front();
+        if (msg.coalesce) {
+            m_publishPending.erase(msg.topic);
+            if (m_topicIntervalMS) {
+                m_topicNextSendMS[msg.topic] = now + m_topicIntervalMS;
+            }
+        }
+        m_publishSending = true;
+        lock.unlock();
+        int rc = SendMessage(msg);
+        lock.lock();
+        m_publishSending = false;
+        if (rc) {
+            m_statSent++;
+        } else {
+            m_statErrors++;
+        }
+    }
+}
+
+void MosquittoClient::dumpPublishStats(Json::Value& result) {
+    std::unique_lock<std::mutex> lock(m_publishLock);
+    // includes the message being sent, queued is 0 once everything is out
+    result["queued"] = (Json::UInt64)(m_publishQueue.size() + m_publishDeferred.size() + (m_publishSending ? 1 : 0));
+    result["maxQueued"] = (Json::UInt64)m_statMaxDepth;
+    result["sent"] = (Json::UInt64)m_statSent;
+    result["errors"] = (Json::UInt64)m_statErrors;
+    result["coalesced"] = (Json::UInt64)m_statCoalesced;
+    result["dropped"] = (Json::UInt64)m_statDropped;
+}
+
 bool MosquittoClient::Publish(const std::string& topic, const std::string& data) {
     if (topic == "version" || topic == "branch" || topic == "warnings") {
         return Publish(topic, data, true, 1);
     }
+    if (topic == "fppd_status" || topic == "playlist_details" || topic == "port_status") {
+        // full status snapshots, an older one still in the queue is useless
+        return Publish(topic, data, false, 1, true);
+    }
     return Publish(topic, data, false, 1);
 }
 bool MosquittoClient::Publish(const std::string& topic, const int value) {
@@ -277,10 +436,10 @@ bool MosquittoClient::Publish(const std::string& topic, const int value) {
 /*
  *
  */
-int MosquittoClient::Publish(const std::string& subTopic, const std::string& msg, const bool retain, const int qos) {
+int MosquittoClient::Publish(const std::string& subTopic, const std::string& msg, const bool retain, const int qos, const bool coalesce) {
     std::string topic = m_baseTopic + "/" + subTopic;
 
-    return PublishRaw(topic, msg, qos, retain);
+    return PublishRaw(topic, msg, qos, retain, coalesce);
 }
 
 /*
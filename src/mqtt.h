@@ -13,10 +13,13 @@
 
 #include <functional>
 #include "fpp-json-fwd.h"
+#include <condition_variable>
+#include <list>
 #include <map>
 #include <mutex>
 #include <pthread.h>
 #include <string>
+#include <thread>
 #include <atomic>
 
 #include "Events.h"
@@ -38,8 +41,15 @@ public:
 
     virtual void PrepareForShutdown() override;
 
-    int PublishRaw(const std::string& topic, const std::string& msg, const bool retain = false, const int qos = 1);
-    int Publish(const std::string& subTopic, const std::string& msg, const bool retain, const int qos = 1);
+    // Messages are queued and sent from the publish thread, these return 0
+    // only if the message was dropped because the queue is full or the
+    // publish thread is not running (Init failed or shutdown has begun).
+    // With coalesce set, a message still waiting in the queue for the same
+    // topic is replaced instead of sending both and the topic is held to at
+    // most MQTTMaxTopicRate messages per second.  Use it for topics where only
+    // the latest value matters.
+    int PublishRaw(const std::string& topic, const std::string& msg, const bool retain = false, const int qos = 1, const bool coalesce = false);
+    int Publish(const std::string& subTopic, const std::string& msg, const bool retain, const int qos = 1, const bool coalesce = false);
     int Publish(const std::string& subTopic, const int valueconst, bool retain, const int qos = 1);
 
     void LogCallback(void* userdata, int level, const char* str);
@@ -54,10 +64,25 @@ public:
     void CacheSetMessage(std::string& topic, std::string& message);
     bool CacheCheckMessage(std::string& topic, std::string& message);
     void dumpMessageCache(Json::Value& result);
+    void dumpPublishStats(Json::Value& result);
 
     std::string GetBaseTopic() { return m_baseTopic; }
 
 private:
+    class PendingMessage {
+    public:
+        std::string topic;
+        std::string payload;
+        int qos = 1;
+        bool retain = false;
+        bool coalesce = false;
+    };
+
+    void StartPublishThread();
+    void StopPublishThread();
+    void PublishThread();
+    int SendMessage(const PendingMessage& msg);
+
     bool m_canProcessMessages;
     std::atomic<bool> m_isConnected;
     std::string m_host;
@@ -75,6 +100,26 @@ private:
 
     std::mutex messageCacheLock;
     std::map<std::string, std::string> messageCache;
+
+    std::thread m_publishThread;
+    std::mutex m_publishLock;
+    std::condition_variable m_publishCV;
+    bool m_publishStop = false;
+    std::list<PendingMessage> m_publishQueue;
+    // coalesced topics currently in m_publishQueue
+    std::map<std::string, std::list<PendingMessage>::iterator> m_publishPending;
+    // coalesced topics waiting for their rate limit slot and when it opens
+    std::map<std::string, PendingMessage> m_publishDeferred;
+    // the publish thread is sending a message it took off the queue
+    bool m_publishSending = false;
+    std::map<std::string, long long> m_topicNextSendMS;
+    int m_topicIntervalMS = 0;
+
+    uint64_t m_statSent = 0;
+    uint64_t m_statErrors = 0;
+    uint64_t m_statCoalesced = 0;
+    uint64_t m_statDropped = 0;
+    size_t m_statMaxDepth = 0;
 };
 
 extern MosquittoClient* mqtt;
@@ -489,8 +489,19 @@ void BBShiftPanelOutput::PrepData(unsigned char* channelData) {
     //     setupBrightnessValues();
     // }
     LogExcess(VB_CHANNELOUT, "BBShiftPanelOutput::PrepData(%p)\n", channelData);
-    m_matrix->OverlaySubMatrices(channelData);
-    channelData += m_startChannel;
+    if (m_matrix->HasSubMatrices() && m_matrix->UpdateEnabledSubMatrices(channelData, m_subMatrixEnabled)) {
+        m_subMatricesActive = std::find(m_subMatrixEnabled.begin(), m_subMatrixEnabled.end(), 1) != m_subMatrixEnabled.end();
+        if (m_subMatricesActive) {
+            m_matrix->BuildChannelMap(m_subMatrixEnabled, m_channelMap);
+            for (uint32_t x = m_channelMap.size(); x < m_channelCount; x++) {
+                m_channelMap.push_back(m_startChannel + x);
+            }
+        }
+    }
+    // with submatrices enabled read through the channel map instead of
+    // compositing them into channelData
+    const uint32_t* channelMap = m_subMatricesActive ? m_channelMap.data() : nullptr;
+    unsigned char* matrixData = channelData + m_startChannel;
 
     std::unique_lock<std::mutex> lock(bgTaskMutex);
     int start = 0;
@@ -501,11 +512,18 @@ void BBShiftPanelOutput::PrepData(unsigned char* channelData) {
     std::atomic<int> counter(0);
     while (start < m_channelCount) {
         ++counter;
-        bgTasks.push([this, channelData, start, end, &counter]() {
+        bgTasks.push([this, channelData, matrixData, channelMap, start, end, &counter]() {
             int x = start;
-            while (x < end) {
-                currentChannelData[channelOffsets[x]] = gammaCurve[channelData[x]];
-                x++;
+            if (channelMap) {
+                while (x < end) {
+                    currentChannelData[channelOffsets[x]] = gammaCurve[channelData[channelMap[x]]];
+                    x++;
+                }
+            } else {
+                while (x < end) {
+                    currentChannelData[channelOffsets[x]] = gammaCurve[matrixData[x]];
+                    x++;
+                }
             }
             --counter;
         });
@@ -918,26 +936,19 @@ bool BBShiftPanelOutput::setupChannelOffsets() {
         LogErr(VB_CHANNELOUT, "Failed to create panel interleave handler\n");
         return false;
     }
+    // only the top half of the panel is mapped, the bottom half shares
+    // the same row/column as the top half
+    PanelInterleaveHandler::Compiled panelMap = handler->compile(m_panelWidth, m_panelHeight / 2);
+    delete handler;
+
     numRows = 0;
     rowLen = 0;
     int maxRowLen = 0;
     for (int output = 0; output < m_numOutputs; output++) {
-        int panelsOnOutput = m_panelMatrix->m_outputPanels[output].size();
-
-        for (int i = 0; i < panelsOnOutput; i++) {
-            for (int y = 0; y < (m_panelHeight / 2); y++) {
-                for (int x = 0; x < m_panelWidth; ++x) {
-                    int yOut = y;
-                    int xOut = x;
-                    handler->map(xOut, yOut);
-                    if (yOut >= numRows) {
-                        numRows = yOut + 1;
-                    }
-                    if (xOut >= maxRowLen) {
-                        maxRowLen = xOut + 1;
-                    }
-                }
-            }
+        if (!m_panelMatrix->m_outputPanels[output].empty()) {
+            numRows = panelMap.rows;
+            maxRowLen = panelMap.rowLength;
+            break;
         }
     }
     rowLen = maxRowLen * m_longestChain;
@@ -971,10 +982,8 @@ bool BBShiftPanelOutput::setupChannelOffsets() {
                     uint32_t r2 = m_panelMatrix->m_panels[panel].pixelMap[yw2 + x * 3];
                     uint32_t g2 = m_panelMatrix->m_panels[panel].pixelMap[yw2 + x * 3 + 1];
                     uint32_t b2 = m_panelMatrix->m_panels[panel].pixelMap[yw2 + x * 3 + 2];
-                    int yOut = y;
-                    int xOut = x;
-                    handler->map(xOut, yOut);
-                    xOut += xOff;
+                    int yOut = panelMap.mappedY(x, y);
+                    int xOut = panelMap.mappedX(x, y) + xOff;
 
                     if (isPWMPanel()) {
                         // For PWM panels, the first of each group of 16 pixels is out first,
@@ -997,7 +1006,6 @@ bool BBShiftPanelOutput::setupChannelOffsets() {
             }
         }
     }
-    delete handler;
 
     /*
     for (int x = 0; x < rowLen * 3; x++) {
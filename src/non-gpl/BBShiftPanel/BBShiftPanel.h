@@ -100,6 +100,12 @@ private:
     Matrix* m_matrix = nullptr;
     PanelMatrix* m_panelMatrix = nullptr;
 
+    // absolute source channel of each matrix channel while any submatrix
+    // is enabled, rebuilt only when the enabled set changes
+    std::vector<uint8_t> m_subMatrixEnabled;
+    std::vector<uint32_t> m_channelMap;
+    bool m_subMatricesActive = false;
+
     int m_panelWidth = 0;
     int m_panelHeight = 0;
     int m_panelScan = 0;
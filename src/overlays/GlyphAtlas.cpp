@@ -0,0 +1,250 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+#include "fpp-pch.h"
+
+#include <cmath>
+#include <map>
+
+#include "../log.h"
+
+#include "GlyphAtlas.h"
+
+#ifdef HAS_FREETYPE
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#define MAX_CACHED_ATLASES 32
+
+static std::mutex atlasCacheLock;
+static FT_Library ftLibrary = nullptr;
+
+struct AtlasCacheEntry {
+    std::shared_ptr<GlyphAtlas> atlas;
+    uint64_t lastUse = 0;
+};
+static std::map<std::string, AtlasCacheEntry> atlasCache;
+static uint64_t atlasUseCount = 0;
+
+// Decode the next UTF-8 codepoint, invalid bytes are returned as-is
+static uint32_t nextCodepoint(const std::string& s, size_t& i) {
+    uint8_t c = s[i++];
+    int extra = 0;
+    uint32_t cp = c;
+    if ((c & 0xE0) == 0xC0) {
+        extra = 1;
+        cp = c & 0x1F;
+    } else if ((c & 0xF0) == 0xE0) {
+        extra = 2;
+        cp = c & 0x0F;
+    } else if ((c & 0xF8) == 0xF0) {
+        extra = 3;
+        cp = c & 0x07;
+    }
+    for (int x = 0; x < extra; x++) {
+        if (i >= s.size() || (s[i] & 0xC0) != 0x80) {
+            return c;
+        }
+        cp = (cp << 6) | (s[i++] & 0x3F);
+    }
+    return cp;
+}
+#endif
+
+std::shared_ptr<GlyphAtlas> GlyphAtlas::Get(const std::string& fontFile, int size, bool antialias) {
+#ifdef HAS_FREETYPE
+    // an evicted atlas must be destroyed after the lock is released
+    std::shared_ptr<GlyphAtlas> evicted;
+    std::unique_lock<std::mutex> lock(atlasCacheLock);
+    if (!ftLibrary && FT_Init_FreeType(&ftLibrary)) {
+        LogErr(VB_CHANNELOUT, "Could not initialize FreeType\n");
+        ftLibrary = nullptr;
+        return nullptr;
+    }
+
+    std::string key = fontFile + ":" + std::to_string(size) + (antialias ? ":aa" : "");
+    auto it = atlasCache.find(key);
+    if (it != atlasCache.end()) {
+        it->second.lastUse = ++atlasUseCount;
+        return it->second.atlas;
+    }
+
+    if (atlasCache.size() >= MAX_CACHED_ATLASES) {
+        auto oldest = atlasCache.begin();
+        for (auto i = atlasCache.begin(); i != atlasCache.end(); ++i) {
+            if (i->second.lastUse < oldest->second.lastUse) {
+                oldest = i;
+            }
+        }
+        evicted = oldest->second.atlas;
+        atlasCache.erase(oldest);
+    }
+
+    std::shared_ptr<GlyphAtlas> atlas(new GlyphAtlas(fontFile, size, antialias));
+    if (!atlas->m_face) {
+        // remember the failure so we don't retry on every message
+        atlas.reset();
+    }
+    AtlasCacheEntry& e = atlasCache[key];
+    e.atlas = atlas;
+    e.lastUse = ++atlasUseCount;
+    return atlas;
+#else
+    return nullptr;
+#endif
+}
+
+GlyphAtlas::GlyphAtlas(const std::string& fontFile, int size, bool antialias) :
+    m_antialias(antialias) {
+#ifdef HAS_FREETYPE
+    // called with atlasCacheLock held which protects ftLibrary
+    FT_Face face = nullptr;
+    if (FT_New_Face(ftLibrary, fontFile.c_str(), 0, &face)) {
+        LogWarn(VB_CHANNELOUT, "FreeType could not load font %s\n", fontFile.c_str());
+        return;
+    }
+    if (FT_Set_Char_Size(face, 0, size * 64, 72, 72)) {
+        LogWarn(VB_CHANNELOUT, "FreeType could not set font %s to size %d\n", fontFile.c_str(), size);
+        FT_Done_Face(face);
+        return;
+    }
+    m_face = face;
+    m_hasKerning = FT_HAS_KERNING(face);
+    m_ascent = (face->size->metrics.ascender + 63) >> 6;
+    m_descent = (-face->size->metrics.descender + 63) >> 6;
+    LogDebug(VB_CHANNELOUT, "Created glyph atlas for %s size %d%s\n", fontFile.c_str(), size, antialias ? " (antialiased)" : "");
+#endif
+}
+
+GlyphAtlas::~GlyphAtlas() {
+#ifdef HAS_FREETYPE
+    if (m_face) {
+        std::unique_lock<std::mutex> lock(atlasCacheLock);
+        FT_Done_Face((FT_Face)m_face);
+    }
+#endif
+}
+
+const GlyphAtlas::Glyph* GlyphAtlas::getGlyph(uint32_t codepoint) {
+    auto it = m_glyphs.find(codepoint);
+    if (it != m_glyphs.end()) {
+        return &it->second;
+    }
+    Glyph& glyph = m_glyphs[codepoint];
+#ifdef HAS_FREETYPE
+    FT_Face face = (FT_Face)m_face;
+    glyph.index = FT_Get_Char_Index(face, codepoint);
+    FT_Int32 flags = FT_LOAD_RENDER | (m_antialias ? FT_LOAD_TARGET_NORMAL : (FT_LOAD_TARGET_MONO | FT_LOAD_MONOCHROME));
+    if (FT_Load_Glyph(face, glyph.index, flags)) {
+        return &glyph;
+    }
+    FT_GlyphSlot slot = face->glyph;
+    FT_Bitmap& bm = slot->bitmap;
+    glyph.width = bm.width;
+    glyph.height = bm.rows;
+    glyph.left = slot->bitmap_left;
+    glyph.top = slot->bitmap_top;
+    glyph.advance = (slot->advance.x + 32) >> 6;
+    glyph.offset = m_bitmaps.size();
+    if (glyph.width == 0 || glyph.height == 0) {
+        // spaces and the like, nothing to store and render() must not
+        // touch m_bitmaps for them
+        glyph.width = 0;
+        glyph.height = 0;
+        return &glyph;
+    }
+    m_bitmaps.resize(m_bitmaps.size() + glyph.width * glyph.height);
+
+    uint8_t* dst = &m_bitmaps[glyph.offset];
+    for (int y = 0; y < glyph.height; y++) {
+        const uint8_t* src = bm.buffer + y * bm.pitch;
+        for (int x = 0; x < glyph.width; x++) {
+            if (bm.pixel_mode == FT_PIXEL_MODE_MONO) {
+                *dst++ = (src[x >> 3] & (0x80 >> (x & 7))) ? 255 : 0;
+            } else {
+                *dst++ = src[x];
+            }
+        }
+    }
+#endif
+    return &glyph;
+}
+
+int GlyphAtlas::kerning(const Glyph* prev, const Glyph* cur) {
+#ifdef HAS_FREETYPE
+    if (m_hasKerning && prev && prev->index && cur->index) {
+        FT_Vector delta;
+        if (!FT_Get_Kerning((FT_Face)m_face, prev->index, cur->index, FT_KERNING_DEFAULT, &delta)) {
+            return delta.x >> 6;
+        }
+    }
+#endif
+    return 0;
+}
+
+int GlyphAtlas::measure(const std::string& line) {
+    int width = 0;
+#ifdef HAS_FREETYPE
+    std::unique_lock<std::mutex> lock(m_lock);
+    const Glyph* prev = nullptr;
+    size_t i = 0;
+    while (i < line.size()) {
+        const Glyph* g = getGlyph(nextCodepoint(line, i));
+        width += kerning(prev, g) + g->advance;
+        prev = g;
+    }
+#endif
+    return width;
+}
+
+void GlyphAtlas::render(const std::vector<std::string>& lines, uint8_t* dst, int w, int h, int bpp,
+                        double centerX, double centerY, uint8_t r, uint8_t g, uint8_t b) {
+#ifdef HAS_FREETYPE
+    int lh = lineHeight();
+    int baseline = (int)std::lround(centerY - (lines.size() * lh) / 2.0) + m_ascent;
+    for (auto& line : lines) {
+        int penX = (int)std::lround(centerX - measure(line) / 2.0);
+
+        std::unique_lock<std::mutex> lock(m_lock);
+        const Glyph* prev = nullptr;
+        size_t i = 0;
+        while (i < line.size()) {
+            const Glyph* gl = getGlyph(nextCodepoint(line, i));
+            penX += kerning(prev, gl);
+            prev = gl;
+
+            int x0 = penX + gl->left;
+            int y0 = baseline - gl->top;
+            int gx0 = std::max(0, -x0);
+            int gx1 = std::min(gl->width, w - x0);
+            for (int gy = std::max(0, -y0); gy < gl->height && (y0 + gy) < h; gy++) {
+                const uint8_t* cov = &m_bitmaps[gl->offset + gy * gl->width];
+                uint8_t* p = dst + ((y0 + gy) * w + x0 + gx0) * bpp;
+                for (int gx = gx0; gx < gx1; gx++, p += bpp) {
+                    uint32_t a = cov[gx];
+                    if (a == 255) {
+                        p[0] = r;
+                        p[1] = g;
+                        p[2] = b;
+                    } else if (a) {
+                        p[0] += ((int)r - p[0]) * (int)a / 255;
+                        p[1] += ((int)g - p[1]) * (int)a / 255;
+                        p[2] += ((int)b - p[2]) * (int)a / 255;
+                    }
+                }
+            }
+            penX += gl->advance;
+        }
+        baseline += lh;
+    }
+#endif
+}
@@ -0,0 +1,79 @@
+#pragma once
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if __has_include(<ft2build.h>)
+#define HAS_FREETYPE
+#endif
+
+/*
+ * FreeType rendered glyph cache for the overlay Text effect.  Each
+ * font/size/antialias combination gets one atlas holding the coverage
+ * bitmap of every glyph rendered so far so text only needs a layout pass
+ * and a blit per message instead of a full GraphicsMagick annotate.
+ *
+ * Sizes are in points at 72 DPI (i.e. pixels) to match Magick's
+ * fontPointsize().
+ */
+class GlyphAtlas {
+public:
+    // Returns nullptr if FreeType support isn't available or the font
+    // can't be loaded, callers should fall back to Magick.
+    static std::shared_ptr<GlyphAtlas> Get(const std::string& fontFile, int size, bool antialias);
+
+    ~GlyphAtlas();
+
+    int ascent() const { return m_ascent; }
+    int descent() const { return m_descent; }
+    int lineHeight() const { return m_ascent + m_descent; }
+
+    int measure(const std::string& line);
+
+    // Render lines of UTF-8 text into an RGB(W) buffer of w x h pixels
+    // with bpp bytes per pixel.  Lines are centered horizontally on
+    // centerX and the block of lines vertically on centerY.  Glyph
+    // coverage is blended onto the existing buffer contents.
+    void render(const std::vector<std::string>& lines, uint8_t* dst, int w, int h, int bpp,
+                double centerX, double centerY, uint8_t r, uint8_t g, uint8_t b);
+
+private:
+    GlyphAtlas(const std::string& fontFile, int size, bool antialias);
+
+    struct Glyph {
+        uint32_t index = 0;  // FreeType glyph index, used for kerning
+        uint32_t offset = 0; // into m_bitmaps
+        int width = 0;
+        int height = 0;
+        int left = 0; // from the pen position
+        int top = 0;  // above the baseline
+        int advance = 0;
+    };
+    const Glyph* getGlyph(uint32_t codepoint);
+    int kerning(const Glyph* prev, const Glyph* cur);
+
+    std::mutex m_lock;
+    void* m_face = nullptr;
+    bool m_antialias;
+    bool m_hasKerning = false;
+    int m_ascent = 0;
+    int m_descent = 0;
+
+    std::unordered_map<uint32_t, Glyph> m_glyphs;
+    std::vector<uint8_t> m_bitmaps;
+};
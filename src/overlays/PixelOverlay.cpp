@@ -15,6 +15,7 @@
 #include "fpp-json.h"
 #include "fpphttp.h" // drogon/HTTP helpers used here; no longer pulled transitively (see fpphttp_types.h)
 
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <dirent.h>
 
@@ -25,6 +26,7 @@
 
 #include <magick/type.h>
 
+#include "../Sequence.h"
 #include "../channeloutput/channeloutputthread.h"
 #include "../common.h"
 #include "../effects.h"
@@ -102,6 +104,7 @@ PixelOverlayManager::PixelOverlayManager() :
     numActive(0) {
 }
 PixelOverlayManager::~PixelOverlayManager() {
+    stopOverlayDoorbell();
     if (updateThread != nullptr) {
         std::unique_lock<std::mutex> l(threadLock);
         threadKeepRunning = false;
@@ -332,6 +335,7 @@ void PixelOverlayManager::doOverlays(uint8_t* channels) {
         if (m->overlayBufferIsDirty()) {
             m->flushOverlayBuffer();
         }
+        m->flushPublishedOverlayBuffer();
     }
     // Second, do any sub-models
     for (auto m : activeModels) {
@@ -518,8 +522,16 @@ HttpResponsePtr PixelOverlayManager::render_HEAD(const HttpRequestPtr& req) {
  * Get the current pixel buffer of an overlay model. Append /rle for
  * run-length-encoded data.
  *
+ * With ?format= (or an `Accept: application/octet-stream` header) the data
+ * is returned as application/octet-stream instead of JSON, see
+ * PixelOverlayModel::getDataBinary() for the layouts.  The X-FPP-Data-Format,
+ * X-FPP-Data-Generation, X-FPP-Data-Size (unencoded size), X-FPP-Width,
+ * X-FPP-Height and X-FPP-Bytes-Per-Pixel headers describe the payload.
+ *
  * @route GET /api/overlays/model/{model}/data
- * @response 200 Object with a `data` array (and `rle` flag).
+ * @param string format raw, rle or delta.
+ * @param int since Generation to send the delta from (format=delta).  If that generation is no longer available raw data is sent.
+ * @response 200 Object with a `data` array (and `rle` flag and `dataSize`), or the binary data.
  */
 
 /**
@@ -637,11 +649,32 @@ HttpResponsePtr PixelOverlayManager::render_GET(const HttpRequestPtr& req) {
             auto m = (mit != models.end()) ? mit->second.model : nullptr;
             if (m) {
                 std::unique_lock<std::recursive_mutex> lock(m->getRunningEffectMutex());
-                if (p4 == "data") {
+                if (p4 == "data" && (getRequestArg(req, "format") != "" ||
+                                     req->getHeader("accept").find("application/octet-stream") != std::string::npos)) {
+                    std::string fmt = getRequestArg(req, "format");
+                    PixelOverlayModel::DataFormat format = PixelOverlayModel::DataFormat::RAW;
+                    if (fmt == "rle" || p5 == "rle") {
+                        format = PixelOverlayModel::DataFormat::RLE;
+                    } else if (fmt == "delta") {
+                        format = PixelOverlayModel::DataFormat::DELTA;
+                    }
+                    uint32_t since = std::strtoul(getRequestArg(req, "since").c_str(), nullptr, 10);
+                    std::string body;
+                    uint32_t generation = m->getDataBinary(body, format, since);
+                    auto resp = makeStringResponse(body, 200, "application/octet-stream");
+                    resp->addHeader("X-FPP-Data-Format", format == PixelOverlayModel::DataFormat::RLE ? "rle" : (format == PixelOverlayModel::DataFormat::DELTA ? "delta" : "raw"));
+                    resp->addHeader("X-FPP-Data-Generation", std::to_string(generation));
+                    resp->addHeader("X-FPP-Data-Size", std::to_string(m->getDataSize()));
+                    resp->addHeader("X-FPP-Width", std::to_string(m->getWidth()));
+                    resp->addHeader("X-FPP-Height", std::to_string(m->getHeight()));
+                    resp->addHeader("X-FPP-Bytes-Per-Pixel", std::to_string(m->getBytesPerPixel()));
+                    return resp;
+                } else if (p4 == "data") {
                     Json::Value data;
                     m->getDataJson(data, p5 == "rle");
                     result["data"] = data;
                     result["rle"] = p5 == "rle";
+                    result["dataSize"] = m->getDataSize();
                     result["isLocked"] = m->getRunningEffect() != nullptr; // compatibility
                     result["effectRunning"] = m->getRunningEffect() != nullptr;
                 } else if (p4 == "clear") {
@@ -777,6 +810,21 @@ HttpResponsePtr PixelOverlayManager::render_POST(const HttpRequestPtr& req) {
  * @response 200 Text effect started.
  */
 
+/**
+ * Set an overlay model's pixel data from an application/octet-stream body,
+ * either width*height*bytesPerPixel bytes of raw data, a w*h region placed at
+ * x,y, or RLE data in the GET /data?format=rle layout.
+ *
+ * @route PUT /api/overlays/model/{model}/data
+ * @param string format rle for RLE encoded data.
+ * @param int x Region x offset.
+ * @param int y Region y offset.
+ * @param int w Region width.
+ * @param int h Region height.
+ * @response 200 Data set.
+ * @response 400 The body size didn't match the model or region, or the region is outside the model.
+ */
+
 /**
  * Force the overlay buffer to be memory-mapped so external programs can access it.
  *
@@ -892,6 +940,34 @@ HttpResponsePtr PixelOverlayManager::render_PUT(const HttpRequestPtr& req) {
                             return makeStringResponse("{ \"Status\": \"OK\", \"Message\": \"\"}", 200);
                         }
                     }
+                } else if (p4 == "data") {
+                    std::string content = getRequestContent(req);
+                    const uint8_t* data = (const uint8_t*)content.data();
+                    if (getRequestArg(req, "format") == "rle") {
+                        if (!m->setDataRLE(data, content.size())) {
+                            return makeStringResponse("Invalid RLE data", 400);
+                        }
+                    } else if (getRequestArg(req, "w") != "") {
+                        int x = std::atoi(getRequestArg(req, "x").c_str());
+                        int y = std::atoi(getRequestArg(req, "y").c_str());
+                        int w = std::atoi(getRequestArg(req, "w").c_str());
+                        int h = std::atoi(getRequestArg(req, "h").c_str());
+                        if (w <= 0 || h <= 0 || content.size() != (size_t)w * h * m->getBytesPerPixel()) {
+                            return makeStringResponse("Invalid data size", 400);
+                        }
+                        if (x < 0 || y < 0 || (int64_t)x + w > m->getWidth() || (int64_t)y + h > m->getHeight()) {
+                            return makeStringResponse("Region " + std::to_string(w) + "x" + std::to_string(h) + " @ " +
+                                                          std::to_string(x) + "," + std::to_string(y) + " is outside the " +
+                                                          std::to_string(m->getWidth()) + "x" + std::to_string(m->getHeight()) + " model",
+                                                      400);
+                        }
+                        m->setData(data, x, y, w, h);
+                    } else if (content.size() == (size_t)m->getDataSize()) {
+                        m->setData(data);
+                    } else {
+                        return makeStringResponse("Invalid data size " + std::to_string(content.size()) + ", expected " + std::to_string(m->getDataSize()), 400);
+                    }
+                    return makeStringResponse("{ \"Status\": \"OK\", \"Message\": \"\"}", 200);
                 } else if (p4 == "mmap") {
                     // Force mmap the overlay buffer so external programs can have access to it
                     m->getOverlayBuffer();
@@ -1318,3 +1394,71 @@ void PixelOverlayManager::addPeriodicUpdate(int32_t initialDelayMS, PixelOverlay
     l.unlock();
     threadCV.notify_all();
 }
+
+/*
+ * External overlay buffer writers can ring a shared doorbell (a futex in
+ * shared memory) after publishing a frame.  If nothing else is driving
+ * output timing, push the frame out immediately instead of waiting for the
+ * next output frame.
+ */
+void PixelOverlayManager::startOverlayDoorbell() {
+#if defined(__linux__)
+    std::unique_lock<std::mutex> l(threadLock);
+    if (doorbellThread != nullptr) {
+        return;
+    }
+    mode_t mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+    int f = shm_open(FPP_OVERLAY_DOORBELL_NAME, O_RDWR | O_CREAT, mode);
+    if (f == -1) {
+        LogWarn(VB_CHANNELOUT, "Could not create overlay doorbell: %s\n", FPPstrerror(errno));
+        return;
+    }
+    ftruncate(f, sizeof(PixelOverlayBufferV2Header::Doorbell));
+    void* p = mmap(0, sizeof(PixelOverlayBufferV2Header::Doorbell), PROT_READ | PROT_WRITE, MAP_SHARED, f, 0);
+    close(f);
+    if (p == MAP_FAILED) {
+        LogWarn(VB_CHANNELOUT, "Could not map overlay doorbell: %s\n", FPPstrerror(errno));
+        return;
+    }
+    doorbell = (PixelOverlayBufferV2Header::Doorbell*)p;
+    doorbell->waiters = 0;
+    doorbell->magic = FPP_OVERLAY_BUFFER_V2_MAGIC;
+
+    doorbellKeepRunning = true;
+    doorbellThread = new std::thread(&PixelOverlayManager::doOverlayDoorbell, this);
+#endif
+}
+
+void PixelOverlayManager::stopOverlayDoorbell() {
+#if defined(__linux__)
+    if (doorbellThread == nullptr) {
+        return;
+    }
+    doorbellKeepRunning = false;
+    doorbell->counter.fetch_add(1);
+    syscall(SYS_futex, &doorbell->counter, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+    doorbellThread->join();
+    delete doorbellThread;
+    doorbellThread = nullptr;
+    munmap(doorbell, sizeof(PixelOverlayBufferV2Header::Doorbell));
+    doorbell = nullptr;
+#endif
+}
+
+void PixelOverlayManager::doOverlayDoorbell() {
+#if defined(__linux__)
+    SetThreadName("FPP-OverlayBell");
+    while (doorbellKeepRunning) {
+        uint32_t v = doorbell->counter.load(std::memory_order_acquire);
+        doorbell->waiters.fetch_add(1);
+        struct timespec timeout = { 1, 0 };
+        syscall(SYS_futex, &doorbell->counter, FUTEX_WAIT, v, &timeout, nullptr, 0);
+        doorbell->waiters.fetch_sub(1);
+
+        if (doorbellKeepRunning && (doorbell->counter.load(std::memory_order_acquire) != v) &&
+            (numActive > 0) && !sequence->IsSequenceRunning()) {
+            ForceChannelOutputNow();
+        }
+    }
+#endif
+}
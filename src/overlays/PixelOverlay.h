@@ -21,6 +21,8 @@
 #include <string>
 #include <thread>
 
+#include "PixelOverlayBuffer.h"
+
 class PixelOverlayState;
 class PixelOverlayModel;
 class OverlayRange;
@@ -97,6 +99,14 @@ private:
     std::recursive_mutex modelsLock;
 
     void doOverlayModelEffects();
+
+    void startOverlayDoorbell();
+    void stopOverlayDoorbell();
+    void doOverlayDoorbell();
+    std::thread* doorbellThread = nullptr;
+    std::atomic_bool doorbellKeepRunning = false;
+    PixelOverlayBufferV2Header::Doorbell* doorbell = nullptr;
+
     std::thread* updateThread = nullptr;
     bool threadKeepRunning = true;
     std::mutex threadLock;
@@ -109,4 +119,5 @@ private:
     bool autoCreate = true;
 
     friend class OverlayCommand;
+    friend class PixelOverlayModel;
 };
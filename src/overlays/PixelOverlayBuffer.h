@@ -0,0 +1,205 @@
+#pragma once
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+/*
+ * Layout of the /FPP-Model-Overlay-Buffer-<name> shared memory region.
+ *
+ * Version 1 (always present):
+ *     uint32_t width
+ *     uint32_t height
+ *     uint32_t flags     bit 0: dirty, bit 1: v2 block present,
+ *                        bits 8-15: bytesPerPixel (0 means 3)
+ *     uint8_t  data[width * height * bytesPerPixel]
+ *
+ * A v1 writer fills data and sets the dirty bit.  fppd copies the data on
+ * its next frame, which can tear if the writer is still writing.
+ *
+ * Version 2 adds a PixelOverlayBufferV2Header at V2HeaderOffset() followed
+ * by slotCount frame slots.  A writer fills the slot returned by
+ * BeginWrite() and then calls Publish().  Each slot has a seqlock style
+ * sequence number (odd while being written) so fppd can detect and retry
+ * a copy that raced with the writer.  The writer never writes into the
+ * most recently published slot or the slot fppd is currently copying, so
+ * with three slots fppd normally reads a complete frame on the first try.
+ * Only a single writer per model is supported.
+ *
+ * If the writer calls RingDoorbell() after publishing (or passes true to
+ * Publish()), fppd is woken via a futex in /FPP-Model-Overlay-Doorbell and
+ * outputs the new frame right away when no sequence is playing instead of
+ * waiting for the next output frame.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define FPP_OVERLAY_BUFFER_FLAG_DIRTY 0x01
+#define FPP_OVERLAY_BUFFER_FLAG_V2 0x02
+
+#define FPP_OVERLAY_BUFFER_V2_MAGIC 0x32424F46 // "FOB2"
+#define FPP_OVERLAY_BUFFER_V2_SLOTS 3
+#define FPP_OVERLAY_BUFFER_MAX_SLOTS 4
+
+#define FPP_OVERLAY_DOORBELL_NAME "/FPP-Model-Overlay-Doorbell"
+
+struct PixelOverlayBufferV2Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t slotSize;
+    uint32_t slotOffset; // from the start of the shared memory region
+    uint32_t reserved;
+
+    std::atomic<uint32_t> publishedSlot;
+    std::atomic<uint32_t> generation;  // incremented on every Publish()
+    std::atomic<uint32_t> readingSlot; // slot + 1 while fppd is copying, 0 otherwise
+    std::atomic<uint32_t> slotSequence[FPP_OVERLAY_BUFFER_MAX_SLOTS];
+
+    static constexpr uint32_t V1HeaderSize = 12;
+
+    static constexpr uint32_t Align(uint32_t v) {
+        return (v + 63) & ~63U;
+    }
+    static constexpr uint32_t V2HeaderOffset(uint32_t frameSize) {
+        return Align(V1HeaderSize + frameSize);
+    }
+    static constexpr uint32_t SlotOffset(uint32_t frameSize) {
+        return Align(V2HeaderOffset(frameSize) + sizeof(PixelOverlayBufferV2Header));
+    }
+    static constexpr uint32_t RegionSize(uint32_t frameSize, uint32_t slots = FPP_OVERLAY_BUFFER_V2_SLOTS) {
+        return SlotOffset(frameSize) + slots * frameSize;
+    }
+
+    // Returns the v2 header of a mapped region or nullptr if the region
+    // only has the v1 layout
+    static PixelOverlayBufferV2Header* Find(uint8_t* region) {
+        uint32_t* v1 = (uint32_t*)region;
+        if (!(v1[2] & FPP_OVERLAY_BUFFER_FLAG_V2)) {
+            return nullptr;
+        }
+        uint32_t bpp = (v1[2] >> 8) & 0xFF;
+        if (bpp == 0) {
+            bpp = 3;
+        }
+        PixelOverlayBufferV2Header* h = (PixelOverlayBufferV2Header*)(region + V2HeaderOffset(v1[0] * v1[1] * bpp));
+        if (h->magic != FPP_OVERLAY_BUFFER_V2_MAGIC) {
+            return nullptr;
+        }
+        return h;
+    }
+
+    uint8_t* Slot(uint8_t* region, uint32_t slot) const {
+        return region + slotOffset + slot * slotSize;
+    }
+
+    // Writer side
+    uint8_t* BeginWrite(uint8_t* region, uint32_t& slot) {
+        uint32_t published = publishedSlot.load(std::memory_order_acquire);
+        uint32_t reading = readingSlot.load(std::memory_order_acquire);
+        slot = (published + 1) % slotCount;
+        if (((slot + 1) == reading) && (slotCount > 2)) {
+            slot = (slot + 1) % slotCount;
+        }
+        slotSequence[slot].store(slotSequence[slot].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return Slot(region, slot);
+    }
+    void Publish(uint32_t slot, bool ringDoorbell = false) {
+        slotSequence[slot].store(slotSequence[slot].load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        publishedSlot.store(slot, std::memory_order_release);
+        generation.fetch_add(1, std::memory_order_release);
+        if (ringDoorbell) {
+            RingDoorbell();
+        }
+    }
+
+    // Reader side, copies the most recently published frame into dest
+    // (slotSize bytes).  dest only holds a complete frame when this returns
+    // true, on false it may hold a torn copy and must not be used.
+    bool Read(uint8_t* region, uint32_t& lastGeneration, uint8_t* dest) {
+        uint32_t gen = generation.load(std::memory_order_acquire);
+        if (gen == lastGeneration) {
+            return false;
+        }
+        for (int attempt = 0; attempt < 3; attempt++) {
+            if (attempt) {
+                // give the writer a chance to finish the slot
+                std::this_thread::yield();
+            }
+            uint32_t slot = publishedSlot.load(std::memory_order_acquire) % slotCount;
+            readingSlot.store(slot + 1, std::memory_order_seq_cst);
+            uint32_t seq = slotSequence[slot].load(std::memory_order_acquire);
+            if (seq & 1) {
+                continue;
+            }
+            memcpy(dest, Slot(region, slot), slotSize);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slotSequence[slot].load(std::memory_order_relaxed) == seq) {
+                readingSlot.store(0, std::memory_order_release);
+                lastGeneration = gen;
+                return true;
+            }
+        }
+        readingSlot.store(0, std::memory_order_release);
+        return false;
+    }
+
+    struct Doorbell {
+        uint32_t magic;
+        std::atomic<uint32_t> counter;
+        std::atomic<uint32_t> waiters;
+    };
+
+    static Doorbell* MapDoorbell() {
+#if defined(__linux__)
+        static Doorbell* doorbell = nullptr;
+        if (doorbell == nullptr) {
+            int f = shm_open(FPP_OVERLAY_DOORBELL_NAME, O_RDWR, 0);
+            if (f == -1) {
+                return nullptr;
+            }
+            void* p = mmap(0, sizeof(Doorbell), PROT_READ | PROT_WRITE, MAP_SHARED, f, 0);
+            close(f);
+            if (p == MAP_FAILED) {
+                return nullptr;
+            }
+            doorbell = (Doorbell*)p;
+        }
+        return doorbell;
+#else
+        return nullptr;
+#endif
+    }
+    static void RingDoorbell() {
+#if defined(__linux__)
+        Doorbell* d = MapDoorbell();
+        if (d && d->magic == FPP_OVERLAY_BUFFER_V2_MAGIC) {
+            d->counter.fetch_add(1, std::memory_order_release);
+            if (d->waiters.load(std::memory_order_acquire)) {
+                syscall(SYS_futex, &d->counter, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+            }
+        }
+#endif
+    }
+};
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "overlay buffer atomics must be lock free to be shared between processes");
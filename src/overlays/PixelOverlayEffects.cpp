@@ -36,6 +36,7 @@
 #include "../common.h"
 #include "../log.h"
 
+#include "GlyphAtlas.h"
 #include "PixelOverlay.h"
 #include "PixelOverlayModel.h"
 #include "WLEDEffects.h"
@@ -548,6 +549,101 @@ public:
         return "Center";
     }
 
+    static std::vector<std::string> splitLines(const std::string& msg) {
+        std::vector<std::string> lines;
+        size_t last = 0;
+        for (size_t x = 0; x < msg.length(); x++) {
+            if (msg[x] == '\n') {
+                lines.push_back(msg.substr(last, x - last));
+                last = x + 1;
+            } else if ((x < msg.length() - 1) && msg[x] == '\\' && msg[x + 1] == 'n') {
+                lines.push_back(msg.substr(last, x - last));
+                last = x + 2;
+                x++;
+            }
+        }
+        lines.push_back(msg.substr(last));
+        return lines;
+    }
+
+    // FreeType glyph atlas version of the Magick rendering below
+    void doTextGlyphs(PixelOverlayModel* m,
+                      GlyphAtlas* atlas,
+                      const std::string& msg,
+                      int r, int g, int b,
+                      const std::string& position,
+                      int pixelsPerSecond,
+                      bool disableWhenDone,
+                      int duration) {
+        std::vector<std::string> lines = splitLines(msg);
+        int maxWid = 0;
+        for (auto& l : lines) {
+            maxWid = std::max(maxWid, atlas->measure(l));
+        }
+        int totalHi = lines.size() * atlas->lineHeight();
+
+        if (position == "Centered" || position == "Center") {
+            int bpp = m->getBytesPerPixel();
+            std::vector<uint8_t> data(m->getWidth() * m->getHeight() * bpp, 0);
+            atlas->render(lines, &data[0], m->getWidth(), m->getHeight(), bpp,
+                          m->getWidth() / 2.0, m->getHeight() / 2.0, r, g, b);
+            m->setData(&data[0]);
+            if (disableWhenDone) {
+                int nd = 25;
+                if (duration > 0) {
+                    nd = duration * 1000;
+                }
+                m->setRunningEffect(new StopRunningEffect(m, "Text", disableWhenDone), nd);
+            }
+            return;
+        }
+
+        maxWid = std::max(maxWid, 1);
+        totalHi = std::max(totalHi, 1);
+        uint8_t* newData = (uint8_t*)calloc(maxWid * totalHi, 3);
+        atlas->render(lines, newData, maxWid, totalHi, 3, maxWid / 2.0, totalHi / 2.0, r, g, b);
+
+        double y = (m->getHeight() / 2.0) - ((totalHi) / 2.0);
+        double x = (m->getWidth() / 2.0) - (maxWid / 2.0);
+        if (position == "R2L") {
+            x = m->getWidth();
+        } else if (position == "L2R") {
+            x = -maxWid;
+        } else if (position == "B2T") {
+            y = m->getHeight();
+        } else if (position == "T2B") {
+            y = -atlas->ascent();
+        }
+        startMovement(m, newData, maxWid, totalHi, x, y, position, pixelsPerSecond, disableWhenDone);
+    }
+
+    void startMovement(PixelOverlayModel* m, uint8_t* newData, int cols, int rows,
+                       double x, double y, const std::string& position,
+                       int pixelsPerSecond, bool disableWhenDone) {
+        std::unique_lock<std::recursive_mutex> lock(m->getRunningEffectMutex());
+        TextMovementEffect* ef = dynamic_cast<TextMovementEffect*>(m->getRunningEffect());
+        if (ef == nullptr) {
+            ef = new TextMovementEffect(m);
+            ef->x = (int)x;
+            ef->y = (int)y;
+        }
+        ef->speed = pixelsPerSecond;
+        ef->disableWhenDone = disableWhenDone;
+        ef->direction = position;
+        int32_t t = 1000 / pixelsPerSecond;
+        if (t == 0) {
+            t = 1;
+        }
+        uint8_t* old = ef->imageData;
+        ef->imageData = newData;
+        ef->imageDataCols = cols;
+        ef->imageDataRows = rows;
+        ef->copyImageData(ef->x, ef->y);
+        m->setRunningEffect(ef, t);
+        lock.unlock();
+        free(old);
+    }
+
     void doText(PixelOverlayModel* m,
                 const std::string& msg,
                 int r, int g, int b,
@@ -565,6 +661,12 @@ public:
             disableWhenDone = true;
         }
 
+        std::shared_ptr<GlyphAtlas> atlas = GlyphAtlas::Get(font, fontSize, antialias);
+        if (atlas) {
+            doTextGlyphs(m, atlas.get(), msg, r, g, b, position, pixelsPerSecond, disableWhenDone, duration);
+            return;
+        }
+
         Magick::Image* image = new Magick::Image(Magick::Geometry(m->getWidth(), m->getHeight()), Magick::Color("black"));
         image->quiet(true);
         image->depth(8);
@@ -700,28 +802,7 @@ public:
                 }
             }
 
-            std::unique_lock<std::recursive_mutex> lock(m->getRunningEffectMutex());
-            TextMovementEffect* ef = dynamic_cast<TextMovementEffect*>(m->getRunningEffect());
-            if (ef == nullptr) {
-                ef = new TextMovementEffect(m);
-                ef->x = (int)x;
-                ef->y = (int)y;
-            }
-            ef->speed = pixelsPerSecond;
-            ef->disableWhenDone = disableWhenDone;
-            ef->direction = position;
-            int32_t t = 1000 / pixelsPerSecond;
-            if (t == 0) {
-                t = 1;
-            }
-            uint8_t* old = ef->imageData;
-            ef->imageData = newData;
-            ef->imageDataCols = image2.columns();
-            ef->imageDataRows = image2.rows();
-            ef->copyImageData(ef->x, ef->y);
-            m->setRunningEffect(ef, t);
-            lock.unlock();
-            free(old);
+            startMovement(m, newData, image2.columns(), image2.rows(), x, y, position, pixelsPerSecond, disableWhenDone);
         }
     }
 
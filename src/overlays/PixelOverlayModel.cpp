@@ -349,7 +349,7 @@ PixelOverlayModel::~PixelOverlayModel() {
         shm_unlink(dataName.c_str());
     }
     if (overlayBufferData) {
-        munmap(overlayBufferData, width * height * bytesPerPixel + sizeof(OverlayBufferData));
+        munmap(overlayBufferData, PixelOverlayBufferV2Header::RegionSize(width * height * bytesPerPixel));
         std::string overlayBufferName = "/FPP-Model-Overlay-Buffer-" + name;
         if (PSHMNAMLEN <= 48) {
             // system doesn't allow very long shared memory names, we'll use a shortened form
@@ -765,8 +765,117 @@ void PixelOverlayModel::getDataJson(Json::Value& v, bool rle) {
     }
 }
 
+static inline void appendLE(std::string& out, uint32_t v, int bytes) {
+    for (int x = 0; x < bytes; x++) {
+        out.push_back((char)((v >> (x * 8)) & 0xFF));
+    }
+}
+
+uint32_t PixelOverlayModel::getDataBinary(std::string& out, DataFormat& format, uint32_t sinceGeneration) {
+    int sz = width * height * bytesPerPixel;
+    std::unique_lock<std::mutex> lock(dataSnapshotLock);
+
+    out.clear();
+    if (sz == 0) {
+        format = DataFormat::RAW;
+        return dataSnapshots[dataSnapshotIdx].generation;
+    }
+
+    dataScratch.resize(sz);
+    uint8_t* cur = dataScratch.data();
+    for (int c = 0; c < sz; c++) {
+        cur[c] = (channelMap[c] != FPPD_OFF_CHANNEL) ? channelData[channelMap[c]] : 0;
+    }
+    if (dataSnapshots[dataSnapshotIdx].data != dataScratch) {
+        dataSnapshotIdx = (dataSnapshotIdx + 1) % DATA_SNAPSHOTS;
+        std::swap(dataSnapshots[dataSnapshotIdx].data, dataScratch);
+        dataSnapshots[dataSnapshotIdx].generation = ++dataGeneration;
+    }
+    const DataSnapshot& latest = dataSnapshots[dataSnapshotIdx];
+    const uint8_t* data = latest.data.data();
+
+    if (format == DataFormat::DELTA) {
+        const DataSnapshot* prev = nullptr;
+        for (auto& snap : dataSnapshots) {
+            if (snap.generation == sinceGeneration && sinceGeneration && snap.data.size() == latest.data.size()) {
+                prev = &snap;
+            }
+        }
+        if (!prev) {
+            format = DataFormat::RAW;
+        } else if (prev != &latest) {
+            const uint8_t* old = prev->data.data();
+            int c = 0;
+            while (c < sz) {
+                if (old[c] == data[c]) {
+                    c++;
+                    continue;
+                }
+                // extend the run across short unchanged gaps, a new record
+                // costs 6 bytes
+                int start = c;
+                int end = c + 1;
+                int same = 0;
+                for (c = end; c < sz && (c - start) < 0xFFFF && same < 6; c++) {
+                    if (old[c] == data[c]) {
+                        same++;
+                    } else {
+                        same = 0;
+                        end = c + 1;
+                    }
+                }
+                appendLE(out, start, 4);
+                appendLE(out, end - start, 2);
+                out.append((const char*)&data[start], end - start);
+                c = end;
+            }
+        }
+    }
+    if (format == DataFormat::RLE) {
+        int bpp = bytesPerPixel;
+        int c = 0;
+        while (c < sz) {
+            int count = 1;
+            while ((c + (count + 1) * bpp) <= sz && count < 0xFFFF &&
+                   !memcmp(&data[c], &data[c + count * bpp], bpp)) {
+                count++;
+            }
+            appendLE(out, count, 2);
+            out.append((const char*)&data[c], bpp);
+            c += count * bpp;
+        }
+    } else if (format == DataFormat::RAW) {
+        out.assign((const char*)data, sz);
+    }
+    return latest.generation;
+}
+
+bool PixelOverlayModel::setDataRLE(const uint8_t* data, size_t len) {
+    int sz = width * height * bytesPerPixel;
+    int bpp = bytesPerPixel;
+    std::vector<uint8_t> pixels(sz);
+    int c = 0;
+    size_t pos = 0;
+    while (pos + 2 + bpp <= len) {
+        int count = data[pos] | (data[pos + 1] << 8);
+        pos += 2;
+        if (c + count * bpp > sz) {
+            return false;
+        }
+        for (int x = 0; x < count; x++, c += bpp) {
+            memcpy(&pixels[c], &data[pos], bpp);
+        }
+        pos += bpp;
+    }
+    if (pos != len || c != sz) {
+        return false;
+    }
+    setData(pixels.data());
+    return true;
+}
+
 bool PixelOverlayModel::needRefresh() {
-    return (dirtyBuffer || overlayBufferIsDirty());
+    return (dirtyBuffer || overlayBufferIsDirty() || overlayBufferHasNewFrame());
 }
 
 void PixelOverlayModel::setBufferIsDirty(bool dirty) {
@@ -786,7 +895,8 @@ uint8_t* PixelOverlayModel::getOverlayBuffer() {
 
         mode_t mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
         int f = shm_open(overlayBufferName.c_str(), O_RDWR | O_CREAT, mode);
-        int size = width * height * bytesPerPixel + sizeof(OverlayBufferData);
+        uint32_t frameSize = width * height * bytesPerPixel;
+        int size = PixelOverlayBufferV2Header::RegionSize(frameSize);
         int flags = MAP_SHARED;
         if (f == -1) {
             LogWarn(VB_CHANNELOUT, "Could not create shared memory for overlay buffer %s: %s\n", name.c_str(), FPPstrerror(errno));
@@ -803,8 +913,23 @@ uint8_t* PixelOverlayModel::getOverlayBuffer() {
         overlayBufferData->width = width;
         overlayBufferData->height = height;
         overlayBufferData->flags = (bytesPerPixel << 8); // store bytesPerPixel in bits 8-15
+
+        overlayBufferV2 = (PixelOverlayBufferV2Header*)((uint8_t*)overlayBufferData + PixelOverlayBufferV2Header::V2HeaderOffset(frameSize));
+        overlayBufferV2->version = 2;
+        overlayBufferV2->slotCount = FPP_OVERLAY_BUFFER_V2_SLOTS;
+        overlayBufferV2->slotSize = frameSize;
+        overlayBufferV2->slotOffset = PixelOverlayBufferV2Header::SlotOffset(frameSize);
+        overlayBufferV2->publishedSlot = 0;
+        overlayBufferV2->generation = 0;
+        overlayBufferV2->readingSlot = 0;
+        overlayBufferGeneration = 0;
+        std::atomic_thread_fence(std::memory_order_release);
+        overlayBufferV2->magic = FPP_OVERLAY_BUFFER_V2_MAGIC;
+        overlayBufferData->flags |= FPP_OVERLAY_BUFFER_FLAG_V2;
+
         if (f != -1) {
             close(f);
+            PixelOverlayManager::INSTANCE.startOverlayDoorbell();
         }
     }
     return overlayBufferData->data;
@@ -876,6 +1001,22 @@ bool PixelOverlayModel::overlayBufferIsDirty() {
     return (overlayBufferData && (overlayBufferData->flags & 0x1));
 }
 
+bool PixelOverlayModel::overlayBufferHasNewFrame() {
+    return overlayBufferV2 && (overlayBufferV2->generation.load(std::memory_order_acquire) != overlayBufferGeneration);
+}
+
+bool PixelOverlayModel::flushPublishedOverlayBuffer() {
+    if (!overlayBufferV2) {
+        return false;
+    }
+    overlayBufferScratch.resize(overlayBufferV2->slotSize);
+    if (!overlayBufferV2->Read((uint8_t*)overlayBufferData, overlayBufferGeneration, overlayBufferScratch.data())) {
+        return false;
+    }
+    setData(overlayBufferScratch.data());
+    return true;
+}
+
 void PixelOverlayModel::setOverlayBufferDirty(bool dirty) {
     getOverlayBuffer();
 
@@ -16,6 +16,8 @@
 #include <mutex>
 #include <thread>
 
+#include "PixelOverlayBuffer.h"
+
 class RunningEffect;
 
 class PixelOverlayState {
@@ -81,6 +83,26 @@ public:
     void toJson(Json::Value& v);
     void getDataJson(Json::Value& v, bool rle = false);
 
+    // Binary pixel data (width*height*bytesPerPixel, channel map applied)
+    // for the HTTP API, avoiding a Json::Value per channel.
+    //   RAW:   the pixel data
+    //   RLE:   runs of uint16 count (little endian) followed by one pixel
+    //   DELTA: records of uint32 offset, uint16 length (little endian)
+    //          followed by length bytes of pixel data that changed since an
+    //          earlier generation
+    // Every change to the data seen by getDataBinary() gets a new generation
+    // number.  A DELTA request for a generation that is no longer
+    // available is answered with RAW data, format is updated to reflect
+    // what was returned.  Returns the generation of the data.
+    enum class DataFormat {
+        RAW,
+        RLE,
+        DELTA
+    };
+    uint32_t getDataBinary(std::string& out, DataFormat& format, uint32_t sinceGeneration = 0);
+    bool setDataRLE(const uint8_t* data, size_t len);
+    int getDataSize() const { return width * height * bytesPerPixel; }
+
     // Access to the channelData.  The channelData is a minimal array of bytes
     // If the model is a "custom" model or using singleChannel nodes or similar,
     // then the channelData will be significantly smaller than WxHxBPP
@@ -102,10 +124,13 @@ public:
     // The overlay buffer is a full continuous width*height*bytesPerPixel buffer
     // that can be used to construct the frame as a full RGB(W) image prior to
     // flushing to the channelData.  The overlay buffer is also mmapped so
-    // external programs can have easy access to it.
+    // external programs can have easy access to it.  See PixelOverlayBuffer.h
+    // for the layout, including the tear-free v2 slots.
     uint8_t* getOverlayBuffer();
     void setOverlayBufferDirty(bool dirty = true);
     bool overlayBufferIsDirty();
+    bool overlayBufferHasNewFrame();
+    bool flushPublishedOverlayBuffer();
     void clearOverlayBuffer();
     void setOverlayBufferScaledData(uint8_t* data, int w, int h);
     void fillOverlayBuffer(int r, int g, int b);
@@ -157,10 +182,25 @@ protected:
         uint8_t data[4];
     } __attribute__((__packed__));
     OverlayBufferData* overlayBufferData;
+    PixelOverlayBufferV2Header* overlayBufferV2 = nullptr;
+    uint32_t overlayBufferGeneration = 0;
+    std::vector<uint8_t> overlayBufferScratch; // validated copy of a v2 slot
 
     std::recursive_mutex effectLock;
     RunningEffect* runningEffect;
 
+    // recent copies of the pixel data for DELTA requests
+    static constexpr int DATA_SNAPSHOTS = 4;
+    struct DataSnapshot {
+        uint32_t generation = 0;
+        std::vector<uint8_t> data;
+    };
+    std::mutex dataSnapshotLock;
+    DataSnapshot dataSnapshots[DATA_SNAPSHOTS];
+    int dataSnapshotIdx = 0;
+    uint32_t dataGeneration = 0;
+    std::vector<uint8_t> dataScratch;
+
     class ChildModelState {
     public:
         std::string name;
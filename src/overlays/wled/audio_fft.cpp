@@ -0,0 +1,189 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+#include "fpp-pch.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "audio_fft.h"
+
+typedef float v4sf __attribute__((vector_size(16)));
+typedef int v4si __attribute__((vector_size(16)));
+
+// The buffers are only guaranteed malloc alignment (8 bytes on armhf) so
+// go through memcpy, which compiles down to a single unaligned load/store.
+static inline v4sf load4(const float* p) {
+    v4sf v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+static inline void store4(float* p, v4sf v) {
+    memcpy(p, &v, sizeof(v));
+}
+static inline v4sf splat(float f) {
+    return v4sf{ f, f, f, f };
+}
+
+AudioFFT::AudioFFT(int size) :
+    m_size(size),
+    m_half(size / 2),
+    m_stages(0) {
+    while ((1 << m_stages) < m_half) {
+        m_stages++;
+    }
+
+    // Stage t works on sub-transforms of length n = m_half >> t with stride
+    // s = 1 << t.  Butterfly k (of m_half / 2) belongs to sub-transform
+    // position p = k >> t and needs exp(-2 pi i p / n).
+    int bflies = m_half / 2;
+    m_twRe.resize(m_stages * bflies);
+    m_twIm.resize(m_stages * bflies);
+    for (int t = 0; t < m_stages; t++) {
+        int n = m_half >> t;
+        for (int k = 0; k < bflies; k++) {
+            double a = -2.0 * M_PI * (double)(k >> t) / (double)n;
+            m_twRe[t * bflies + k] = cos(a);
+            m_twIm[t * bflies + k] = sin(a);
+        }
+    }
+    m_upRe.resize(m_half);
+    m_upIm.resize(m_half);
+    for (int k = 0; k < m_half; k++) {
+        double a = -2.0 * M_PI * (double)k / (double)m_size;
+        m_upRe[k] = cos(a);
+        m_upIm[k] = sin(a);
+    }
+    for (int x = 0; x < 2; x++) {
+        m_re[x].resize(m_half + 4);
+        m_im[x].resize(m_half + 4);
+    }
+}
+
+void AudioFFT::powerSpectrum(const float* in, float* power) {
+    const int half = m_half;
+    const int bflies = half / 2;
+    float* xr = &m_re[0][0];
+    float* xi = &m_im[0][0];
+    float* yr = &m_re[1][0];
+    float* yi = &m_im[1][0];
+
+    // pack even samples as the real part and odd as the imaginary part
+    for (int k = 0; k < half; k += 4) {
+        v4sf a = load4(in + 2 * k);
+        v4sf b = load4(in + 2 * k + 4);
+        store4(xr + k, __builtin_shuffle(a, b, v4si{ 0, 2, 4, 6 }));
+        store4(xi + k, __builtin_shuffle(a, b, v4si{ 1, 3, 5, 7 }));
+    }
+
+    for (int t = 0; t < m_stages; t++) {
+        const int s = 1 << t;
+        const float* twr = &m_twRe[t * bflies];
+        const float* twi = &m_twIm[t * bflies];
+        for (int k = 0; k < bflies; k += 4) {
+            v4sf ar = load4(xr + k);
+            v4sf ai = load4(xi + k);
+            v4sf br = load4(xr + k + bflies);
+            v4sf bi = load4(xi + k + bflies);
+            v4sf wr = load4(twr + k);
+            v4sf wi = load4(twi + k);
+
+            v4sf sr = ar + br;
+            v4sf si = ai + bi;
+            v4sf dr = ar - br;
+            v4sf di = ai - bi;
+            v4sf orr = dr * wr - di * wi;
+            v4sf oi = dr * wi + di * wr;
+
+            // butterfly k writes y[k + s * p] and y[k + s * p + s]
+            if (s >= 4) {
+                int d = k + s * (k >> t);
+                store4(yr + d, sr);
+                store4(yi + d, si);
+                store4(yr + d + s, orr);
+                store4(yi + d + s, oi);
+            } else if (s == 2) {
+                int d = 2 * k;
+                store4(yr + d, __builtin_shuffle(sr, orr, v4si{ 0, 1, 4, 5 }));
+                store4(yr + d + 4, __builtin_shuffle(sr, orr, v4si{ 2, 3, 6, 7 }));
+                store4(yi + d, __builtin_shuffle(si, oi, v4si{ 0, 1, 4, 5 }));
+                store4(yi + d + 4, __builtin_shuffle(si, oi, v4si{ 2, 3, 6, 7 }));
+            } else {
+                int d = 2 * k;
+                store4(yr + d, __builtin_shuffle(sr, orr, v4si{ 0, 4, 1, 5 }));
+                store4(yr + d + 4, __builtin_shuffle(sr, orr, v4si{ 2, 6, 3, 7 }));
+                store4(yi + d, __builtin_shuffle(si, oi, v4si{ 0, 4, 1, 5 }));
+                store4(yi + d + 4, __builtin_shuffle(si, oi, v4si{ 2, 6, 3, 7 }));
+            }
+        }
+        std::swap(xr, yr);
+        std::swap(xi, yi);
+    }
+
+    // Unpack the real spectrum from the packed transform Z:
+    //   X[k] = (Z[k] + conj(Z[h - k])) / 2 - i W^k (Z[k] - conj(Z[h - k])) / 2
+    // Z[h] wraps to Z[0] which also makes k == 0 come out right.
+    xr[half] = xr[0];
+    xi[half] = xi[0];
+    const v4sf h = splat(0.5f);
+    for (int k = 0; k < half; k += 4) {
+        v4sf ar = load4(xr + k);
+        v4sf ai = load4(xi + k);
+        v4sf br = __builtin_shuffle(load4(xr + half - k - 3), v4si{ 3, 2, 1, 0 });
+        v4sf bi = -__builtin_shuffle(load4(xi + half - k - 3), v4si{ 3, 2, 1, 0 });
+
+        v4sf er = (ar + br) * h;
+        v4sf ei = (ai + bi) * h;
+        v4sf fr = (ai - bi) * h;
+        v4sf fi = (br - ar) * h;
+
+        v4sf wr = load4(&m_upRe[k]);
+        v4sf wi = load4(&m_upIm[k]);
+        v4sf re = er + wr * fr - wi * fi;
+        v4sf im = ei + wr * fi + wi * fr;
+        store4(power + k, re * re + im * im);
+    }
+}
+
+float AudioFFT::maxValue(const float* v, int count) {
+    float m = 0.0f;
+    int x = 0;
+    if (count >= 4) {
+        v4sf mv = load4(v);
+        for (x = 4; x + 4 <= count; x += 4) {
+            v4sf a = load4(v + x);
+            mv = mv > a ? mv : a;
+        }
+        m = std::max(std::max(mv[0], mv[1]), std::max(mv[2], mv[3]));
+    } else if (count > 0) {
+        m = v[0];
+    }
+    for (; x < count; x++) {
+        m = std::max(m, v[x]);
+    }
+    return m;
+}
+
+float AudioFFT::maxAbsValue(const float* v, int count) {
+    v4sf mv = splat(0.0f);
+    int x = 0;
+    for (; x + 4 <= count; x += 4) {
+        v4sf a = load4(v + x);
+        a = a < 0 ? -a : a;
+        mv = mv > a ? mv : a;
+    }
+    float m = std::max(std::max(mv[0], mv[1]), std::max(mv[2], mv[3]));
+    for (; x < count; x++) {
+        m = std::max(m, std::fabs(v[x]));
+    }
+    return m;
+}
@@ -0,0 +1,55 @@
+#pragma once
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+#include <vector>
+
+/*
+ * Real input FFT for the WLED audio reactive analysis.  The N real samples
+ * are packed into an N/2 point complex transform (Stockham autosort,
+ * radix-2, split real/imaginary arrays) and then unpacked, with every
+ * butterfly working on four lanes at a time using the compiler's generic
+ * vector types so the same code becomes NEON on the Pi and SSE on x86.
+ * Output is unscaled, the same as kiss_fftr.
+ *
+ * An instance holds its own work buffers and is not thread safe.
+ */
+class AudioFFT {
+public:
+    // size must be a power of two and at least 16
+    explicit AudioFFT(int size);
+
+    int size() const { return m_size; }
+
+    // Squared magnitude of bins 0 .. size/2 - 1 of the size samples in "in"
+    void powerSpectrum(const float* in, float* power);
+
+    // Vectorized reductions used for binning the spectrum
+    static float maxValue(const float* v, int count);
+    static float maxAbsValue(const float* v, int count);
+
+private:
+    int m_size;
+    int m_half;   // complex transform size
+    int m_stages; // log2(m_half)
+
+    // per stage twiddles expanded to one per butterfly, m_stages * m_half / 2
+    std::vector<float> m_twRe;
+    std::vector<float> m_twIm;
+    // unpacking twiddles, exp(-2 pi i k / size) for k < m_half
+    std::vector<float> m_upRe;
+    std::vector<float> m_upIm;
+
+    // ping-pong buffers, one spare element past m_half for the unpack
+    std::vector<float> m_re[2];
+    std::vector<float> m_im[2];
+};
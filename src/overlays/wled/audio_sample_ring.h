@@ -0,0 +1,75 @@
+#pragma once
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+// Single producer / single consumer ring carrying samples from the GStreamer
+// streaming thread to the audio analysis thread.  Each side only writes its
+// own index so neither ever blocks the other, if the analysis thread falls a
+// whole ring behind new blocks are dropped instead.
+class AudioSampleRing {
+public:
+    static constexpr uint32_t SIZE = 8192; // power of two
+
+    template<class T>
+    void push(const T* src, int count, int sampleRate) {
+        if (count > (int)SIZE) {
+            src += count - SIZE;
+            count = SIZE;
+        }
+        uint32_t head = m_head.load(std::memory_order_relaxed);
+        uint32_t tail = m_tail.load(std::memory_order_acquire);
+        if ((uint32_t)count > SIZE - (head - tail)) {
+            return;
+        }
+        for (int i = 0; i < count; i++) {
+            m_buffer[(head + i) & (SIZE - 1)] = src[i];
+        }
+        m_sampleRate.store(sampleRate, std::memory_order_relaxed);
+        m_head.store(head + count, std::memory_order_release);
+    }
+
+    uint32_t available() const {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_relaxed);
+    }
+    int sampleRate() const {
+        return m_sampleRate.load(std::memory_order_relaxed);
+    }
+
+    // Consume everything queued, shifting the newest samples into the end
+    // of the analysis window
+    template<size_t N>
+    void slide(std::array<float, N>& window) {
+        uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        uint32_t head = m_head.load(std::memory_order_acquire);
+        uint32_t count = head - tail;
+        if (count > N) {
+            tail = head - N;
+            count = N;
+        }
+        memmove(window.data(), window.data() + count, (N - count) * sizeof(float));
+        for (uint32_t i = 0; i < count; i++) {
+            window[N - count + i] = m_buffer[(tail + i) & (SIZE - 1)];
+        }
+        m_tail.store(head, std::memory_order_release);
+    }
+
+private:
+    alignas(64) std::atomic<uint32_t> m_head{ 0 };
+    alignas(64) std::atomic<uint32_t> m_tail{ 0 };
+    std::atomic<int> m_sampleRate{ 44100 };
+    std::array<float, SIZE> m_buffer;
+};
@@ -19,8 +19,11 @@
 #include "../../settings.h"
 #include "../PixelOverlayModel.h"
 
+#include <atomic>
 #include <cmath>
 #include <math.h>
+#include <memory>
+#include <thread>
 #include <time.h>
 
 #ifdef HAS_GSTREAMER
@@ -30,7 +33,8 @@
 
 #include "wled.h"
 
-#include "kiss_fftr.h"
+#include "audio_fft.h"
+#include "audio_sample_ring.h"
 #include "../../Warnings.h"
 #include "../../mediaoutput/GStreamerOut.h"
 #include "../../WLEDAudioSync.h"
@@ -155,11 +159,30 @@ void HammingWindow(std::array<float, NUM_SAMPLES> &samples)
 }
 */
 
+struct AudioSnapshot {
+    AudioFrame frame;
+    uint64_t timeMS = 0;
+};
+
 class WLEDAudioReactiveSoundSource {
 public:
+    // Frames older than this are treated as no audio so the effects fall
+    // back to their simulated input when the source stops
+    static constexpr uint64_t FRAME_TTL_MS = 250;
+    // New samples needed before the next analysis, half a window
+    static constexpr uint32_t HOP_SAMPLES = NUM_SAMPLES / 2;
+
     WLEDAudioReactiveSoundSource() {
     }
     ~WLEDAudioReactiveSoundSource() {
+        // The media tap isn't cleared here, GStreamerOutput's statics may
+        // already be gone and media has been stopped by now anyway.
+        if (analysisThread) {
+            running = false;
+            analysisThread->join();
+            delete analysisThread;
+            analysisThread = nullptr;
+        }
 #ifdef HAS_GSTREAMER
         if (gstPipeline) {
             gst_element_set_state(gstPipeline, GST_STATE_NULL);
@@ -168,21 +191,6 @@ public:
         }
 #endif
     }
-    static void InputAudioCallback(WLEDAudioReactiveSoundSource* p, uint8_t* stream, int len) {
-        int16_t* data = (int16_t*)stream;
-        int numSamples = len / sizeof(int16_t);
-        int start = 0;
-        if (numSamples > NUM_SAMPLES) {
-            numSamples = NUM_SAMPLES;
-            start = numSamples - NUM_SAMPLES;
-        }
-        p->inputSamples.fill(0);
-        for (int i = 0; i < numSamples; i++) {
-            float f = data[start + i] / 32768.0f;
-            p->inputSamples[i] = data[start + i];
-        }
-    }
-
 #ifdef HAS_GSTREAMER
     // Open a PipeWire audio source via GStreamer pipewiresrc.
     // dev is the PipeWire node.name (e.g. "alsa_input.usb-0d8c_USB_Sound_Device-00.analog-stereo")
@@ -212,7 +220,9 @@ public:
             gstPipeline = nullptr;
             return;
         }
-        gst_app_sink_set_emit_signals(GST_APP_SINK(appsink), FALSE);
+        GstAppSinkCallbacks callbacks = {};
+        callbacks.new_sample = onCaptureSample;
+        gst_app_sink_set_callbacks(GST_APP_SINK(appsink), &callbacks, this, nullptr);
         gstAppsink = appsink;
 
         GstStateChangeReturn ret = gst_element_set_state(gstPipeline, GST_STATE_PLAYING);
@@ -227,36 +237,23 @@ public:
         }
 
         inputSampleRate = 44100;
-        gstCaptureActive = true;
         LogInfo(VB_MEDIAOUT, "WLED GStreamer capture: opened PipeWire source '%s'\n", dev.c_str());
     }
 
-    bool pullGStreamerSamples() {
-        if (!gstAppsink)
-            return false;
-
-        GstSample* sample = gst_app_sink_try_pull_sample(GST_APP_SINK(gstAppsink), 0);
+    static GstFlowReturn onCaptureSample(GstAppSink* appsink, gpointer userData) {
+        WLEDAudioReactiveSoundSource* self = (WLEDAudioReactiveSoundSource*)userData;
+        GstSample* sample = gst_app_sink_pull_sample(appsink);
         if (!sample)
-            return false;
+            return GST_FLOW_OK;
 
         GstBuffer* buffer = gst_sample_get_buffer(sample);
         GstMapInfo map;
         if (gst_buffer_map(buffer, &map, GST_MAP_READ)) {
-            int16_t* data = (int16_t*)map.data;
-            int numSamples = map.size / sizeof(int16_t);
-            int start = 0;
-            if (numSamples > NUM_SAMPLES) {
-                start = numSamples - NUM_SAMPLES;
-                numSamples = NUM_SAMPLES;
-            }
-            inputSamples.fill(0);
-            for (int i = 0; i < numSamples; i++) {
-                inputSamples[i] = data[start + i];
-            }
+            self->ring.push((const int16_t*)map.data, map.size / sizeof(int16_t), self->inputSampleRate);
             gst_buffer_unmap(buffer, &map);
         }
         gst_sample_unref(sample);
-        return true;
+        return GST_FLOW_OK;
     }
 
     void openGStreamerAlsaCapture(const std::string& dev) {
@@ -285,7 +282,9 @@ public:
             gstPipeline = nullptr;
             return;
         }
-        gst_app_sink_set_emit_signals(GST_APP_SINK(appsink), FALSE);
+        GstAppSinkCallbacks callbacks = {};
+        callbacks.new_sample = onCaptureSample;
+        gst_app_sink_set_callbacks(GST_APP_SINK(appsink), &callbacks, this, nullptr);
         gstAppsink = appsink;
 
         GstStateChangeReturn ret = gst_element_set_state(gstPipeline, GST_STATE_PLAYING);
@@ -300,7 +299,6 @@ public:
         }
 
         inputSampleRate = 44100;
-        gstCaptureActive = true;
         LogInfo(VB_MEDIAOUT, "WLED GStreamer ALSA capture: opened device '%s'\n", dev.c_str());
     }
 #endif
@@ -319,131 +317,179 @@ public:
 #endif
     }
 
-    bool getAudioSamples(std::array<float, NUM_SAMPLES>& samples, int& sampleRate) {
-        if (sourceType == -1) {
-            std::string source = getSetting("WLEDAudioInput", "-- Playing Media --");
-            if (source == "-- Playing Media --") {
-                sourceType = 0;
-            } else {
-                sourceType = 1;
-                openAudioDevice(source);
-            }
+    // Latest analysed frame, shared by every reactive effect and the
+    // WLEDAudioSync sender.  Returns false if no source is producing.
+    bool getAudioFrame(AudioFrame& out) {
+        start();
+        std::shared_ptr<const AudioSnapshot> s = snapshot.load();
+        if (!s || (GetTimeMS() - s->timeMS) > FRAME_TTL_MS) {
+            return false;
+        }
+        out = s->frame;
+        return true;
+    }
+
+private:
+    void start() {
+        if (started.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(startLock);
+        if (started) {
+            return;
         }
-        bool retValue = false;
-        if (sourceType == 0) {
-            // Playing Media — use GStreamer
+        std::string source = getSetting("WLEDAudioInput", "-- Playing Media --");
+        if (source == "-- Playing Media --") {
+            sourceType = 0;
 #ifdef HAS_GSTREAMER
-            retValue = GStreamerOutput::GetAudioSamples(&samples[0], NUM_SAMPLES, sampleRate);
+            GStreamerOutput::SetAudioSampleCallback([](void* data, const float* samples, int count, int sampleRate) {
+                ((WLEDAudioReactiveSoundSource*)data)->ring.push(samples, count, sampleRate);
+            },
+                                                    this);
 #endif
-        } else if (sourceType == 1) {
-            // Audio Input — GStreamer capture (PipeWire or ALSA)
-#ifdef HAS_GSTREAMER
-            if (gstCaptureActive) {
-                retValue = pullGStreamerSamples();
-                if (retValue) {
-                    samples = inputSamples;
-                    sampleRate = inputSampleRate;
-                }
-                return retValue;
+        } else {
+            sourceType = 1;
+            openAudioDevice(source);
+        }
+        running = true;
+        analysisThread = new std::thread([this]() {
+            SetThreadName("FPP-WLEDAudio");
+            analysisLoop();
+        });
+        started = true;
+    }
+
+    // The only consumer of the sample ring.  Runs the FFT once per hop of
+    // new samples and publishes the result for the effects to pick up.
+    void analysisLoop() {
+        while (running) {
+            if (ring.available() < HOP_SAMPLES) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                continue;
             }
-#endif
+            int sampleRate = ring.sampleRate();
+            ring.slide(window);
+
+            std::shared_ptr<AudioSnapshot> s = std::make_shared<AudioSnapshot>();
+            analyze(sampleRate, s->frame);
+            s->timeMS = GetTimeMS();
+            snapshot.store(s);
         }
-        return retValue;
     }
 
-    int sourceType = -1;
-    std::array<float, NUM_SAMPLES> inputSamples;
-    int inputSampleRate = 44100;
-#ifdef HAS_GSTREAMER
-    GstElement* gstPipeline = nullptr;
-    GstElement* gstAppsink = nullptr;
-    bool gstCaptureActive = false;
-#endif
-
-} WLED_SOUND_SOURCE;
+    // Map the FFT bins to WLED's 16 (plus two unused) octave-ish buckets,
+    // each bucket is a contiguous run of bins.
+    void updateBuckets(int sampleRate) {
+        bucketRate = sampleRate;
+        bucketStart.fill(NUM_SAMPLES / 2);
+        bucketStart[0] = 0;
+
+        float rate = sampleRate;
+        int curBucket = 0;
+        double freqnext = 440.0 * exp2f(((float)((1 + 1) * 8) - 69.0) / 12.0);
+        int end = freqnext * (float)NUM_SAMPLES / rate;
+        for (int bin = 0; bin < (NUM_SAMPLES / 2); ++bin) {
+            if (bin > end) {
+                curBucket++;
+                bucketStart[curBucket] = bin;
+                if (curBucket == 18) break;
+                freqnext = 440.0 * exp2f(((double)((curBucket + 1) * 8) - 69.0) / 12.0);
+                end = freqnext * (double)NUM_SAMPLES / rate;
+            }
+        }
+    }
 
-// Free-function entry points (declared in wled.h) so external callers
-// — notably WLEDAudioSync — can pull a sample buffer and run the same
-// FFT pipeline the WLED reactive effects use, without holding a
-// WS2812FXExt instance.
-bool fetchAudioSamples(std::array<float, NUM_SAMPLES>& samples, int& sampleRate) {
-    return WLED_SOUND_SOURCE.getAudioSamples(samples, sampleRate);
-}
-
-void computeAudioFrame(const std::array<float, NUM_SAMPLES>& samples,
-                       int sampleRate,
-                       AudioFrame& out) {
-    static kiss_fftr_cfg cfg = kiss_fftr_alloc(NUM_SAMPLES, false, 0, 0);
-    kiss_fft_cpx fft_out[NUM_SAMPLES];
-    kiss_fftr(cfg, (kiss_fft_scalar*)samples.data(), fft_out);
-
-    // Log-bin into 16 octave-ish buckets, mirroring WLED's binning.
-    std::array<float, 17> res{};
-    float rate = sampleRate;
-    int curBucket = 0;
-    double freqnext = 440.0 * exp2f(((float)((1 + 1) * 8) - 69.0) / 12.0);
-    int end = freqnext * (float)NUM_SAMPLES / rate;
-    float binHzRange = rate / (float)NUM_SAMPLES;
-
-    float maxValue = 0;
-    int maxBin = 0;
-    int maxBucket = 0;
-    for (int bin = 0; bin < (NUM_SAMPLES / 2); ++bin) {
-        if (bin > end) {
-            curBucket++;
-            if (curBucket == 18) break;
-            freqnext = 440.0 * exp2f(((double)((curBucket + 1) * 8) - 69.0) / 12.0);
-            end = freqnext * (double)NUM_SAMPLES / rate;
+    // FFT + log-binning + peak/volume + beat detection over the current window
+    void analyze(int sampleRate, AudioFrame& out) {
+        if (sampleRate != bucketRate) {
+            updateBuckets(sampleRate);
         }
-        float nv = sqrtf(fft_out[bin].r * fft_out[bin].r + fft_out[bin].i * fft_out[bin].i);
-        if (nv > maxValue) {
-            maxValue = nv;
-            maxBin = bin;
-            maxBucket = curBucket;
+        fft.powerSpectrum(window.data(), power.data());
+
+        // Bucket maxima are taken on the squared magnitudes, only the
+        // winners need a sqrt
+        std::array<float, 18> res{};
+        float maxPower = 0;
+        int maxBucket = -1;
+        for (int b = 0; b < 18; b++) {
+            float p = AudioFFT::maxValue(&power[bucketStart[b]], bucketStart[b + 1] - bucketStart[b]);
+            res[b] = sqrtf(p);
+            if (p > maxPower) {
+                maxPower = p;
+                maxBucket = b;
+            }
+        }
+        int maxBin = 0;
+        if (maxBucket >= 0) {
+            maxBin = bucketStart[maxBucket];
+            while (power[maxBin] != maxPower) {
+                maxBin++;
+            }
         }
-        res[curBucket] = std::max(res[curBucket], nv);
-    }
 
-    float maxRV = 0;
-    for (int x = 0; x < 16; x++) {
-        int v2 = round(log10(res[x]) * 120.0);
-        if (v2 > 255) v2 = 255;
-        if (v2 < 0) v2 = 0;
-        out.fftResult[x] = static_cast<uint8_t>(v2);
-        if (res[x] > maxRV) maxRV = res[x];
-    }
+        float maxRV = 0;
+        for (int x = 0; x < 16; x++) {
+            int v2 = round(log10(res[x]) * 120.0);
+            if (v2 > 255) v2 = 255;
+            if (v2 < 0) v2 = 0;
+            out.fftResult[x] = static_cast<uint8_t>(v2);
+            if (res[x] > maxRV) maxRV = res[x];
+        }
 
-    out.FFT_MajorPeak = (maxBin * binHzRange) + (binHzRange / 2);
-    out.FFT_Magnitude = maxRV;
+        float binHzRange = (float)sampleRate / (float)NUM_SAMPLES;
+        out.FFT_MajorPeak = (maxBin * binHzRange) + (binHzRange / 2);
+        out.FFT_Magnitude = maxRV;
+
+        // Peak amplitude for the volume fields.
+        float peakAmp = AudioFFT::maxAbsValue(window.data(), NUM_SAMPLES);
+        float instantVolume = std::min(255.0f, peakAmp * 255.0f);
+        smoothedVolume = 0.7f * smoothedVolume + 0.3f * instantVolume;
+
+        // Beat detection — same approach as the WLED audioreactive usermod:
+        // an above-threshold step over the smoothed baseline marks a beat,
+        // held for 50ms with a 100ms refractory window so receivers don't
+        // miss it even with slower poll cadences.
+        uint64_t nowMsLocal = GetTimeMS();
+        uint8_t peakOut = 0;
+        if (instantVolume > 12.0f &&
+            instantVolume > smoothedVolume + 25.0f &&
+            (nowMsLocal - lastPeakMs) >= 100) {
+            lastPeakMs = nowMsLocal;
+        }
+        if (nowMsLocal - lastPeakMs < 50) peakOut = 1;
 
-    // RMS / peak amplitude for the volume fields.
-    float peakAmp = 0.0f;
-    for (int i = 0; i < NUM_SAMPLES; ++i) {
-        float a = std::fabs(samples[i]);
-        if (a > peakAmp) peakAmp = a;
+        out.volumeSmth = smoothedVolume;
+        out.volumeRaw = static_cast<uint16_t>(instantVolume);
+        out.samplePeak = peakOut;
     }
-    float instantVolume = std::min(255.0f, peakAmp * 255.0f);
 
-    static float smoothedVolume = 0.0f;
-    smoothedVolume = 0.7f * smoothedVolume + 0.3f * instantVolume;
+    int sourceType = -1;
+    int inputSampleRate = 44100;
+#ifdef HAS_GSTREAMER
+    GstElement* gstPipeline = nullptr;
+    GstElement* gstAppsink = nullptr;
+#endif
 
-    // Beat detection — same approach as the WLED audioreactive usermod:
-    // an above-threshold step over the smoothed baseline marks a beat,
-    // held for 50ms with a 100ms refractory window so receivers don't
-    // miss it even with slower poll cadences.
-    static uint64_t lastPeakMs = 0;
-    uint64_t nowMsLocal = GetTimeMS();
-    uint8_t peakOut = 0;
-    if (instantVolume > 12.0f &&
-        instantVolume > smoothedVolume + 25.0f &&
-        (nowMsLocal - lastPeakMs) >= 100) {
-        lastPeakMs = nowMsLocal;
-    }
-    if (nowMsLocal - lastPeakMs < 50) peakOut = 1;
+    std::mutex startLock;
+    std::atomic<bool> started{ false };
+    std::atomic<bool> running{ false };
+    std::thread* analysisThread = nullptr;
+
+    AudioSampleRing ring;
+    std::atomic<std::shared_ptr<const AudioSnapshot>> snapshot;
+
+    // analysis thread state
+    AudioFFT fft{ NUM_SAMPLES };
+    std::array<float, NUM_SAMPLES> window{};
+    std::array<float, NUM_SAMPLES / 2> power;
+    int bucketRate = 0;
+    std::array<int, 19> bucketStart; // bucket b is bins [bucketStart[b], bucketStart[b + 1])
+    float smoothedVolume = 0.0f;
+    uint64_t lastPeakMs = 0;
+} WLED_SOUND_SOURCE;
 
-    out.volumeSmth = smoothedVolume;
-    out.volumeRaw  = static_cast<uint16_t>(instantVolume);
-    out.samplePeak = peakOut;
+bool getAudioFrame(AudioFrame& out) {
+    return WLED_SOUND_SOURCE.getAudioFrame(out);
 }
 
 WS2812FXExt::WS2812FXExt() :
@@ -703,14 +749,10 @@ CRGB getCRGBForBand(int x, uint8_t* fftResult, int pal) {
     }
     return value;
 }
-void WS2812FXExt::processSamples(std::array<float, NUM_SAMPLES>& samples, int sampleRate) {
-    // Delegate the FFT + binning + RMS + beat work to the free helper
-    // so WLEDAudioSync's broadcast thread can run the same pipeline
-    // without holding a WS2812FXExt instance. We then copy the result
+void WS2812FXExt::applyAudioFrame(const AudioFrame& f) {
+    // The FFT + binning + volume + beat work is done once per audio block
+    // by the sound source's analysis thread, we just copy the shared result
     // into our own per-instance um_data fields for FX.cpp to read.
-    AudioFrame f{};
-    computeAudioFrame(samples, sampleRate, f);
-
     uint8_t* dstFft = (uint8_t*)um_data.u_data[2];
     std::memcpy(dstFft, f.fftResult, 16);
     FFT_MajorPeak = f.FFT_MajorPeak;
@@ -748,10 +790,9 @@ um_data_t* WS2812FXExt::getAudioSamples(int simulationId) {
         return &um_data;
     }
 
-    std::array<float, NUM_SAMPLES> samples;
-    int sampleRate = 0;
-    if (WLED_SOUND_SOURCE.getAudioSamples(samples, sampleRate)) {
-        processSamples(samples, sampleRate);
+    AudioFrame frame;
+    if (WLED_SOUND_SOURCE.getAudioFrame(frame)) {
+        applyAudioFrame(frame);
     } else {
         // arrays
         auto ms = GetTimeMS();
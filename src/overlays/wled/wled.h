@@ -48,7 +48,7 @@ constexpr int NUM_SAMPLES = 1024;
 long long GetTimeMS(void);
 long long GetTimeMicros(void);
 
-// Audio sample buffer + computed FFT frame, in the form used by both
+// Computed FFT frame, in the form used by both
 // the WLED reactive effects and the WLEDAudioSync UDP broadcast.
 // `volumeSmth`/`volumeRaw` are 0-255 amplitudes (NOT frequencies);
 // `samplePeak` is a beat-detection flag with a short hold window.
@@ -61,16 +61,11 @@ struct AudioFrame {
     float    FFT_MajorPeak;
 };
 
-// Pull samples from the configured audio source (playing media or a
-// configured input device). Returns false if no source is producing.
-bool fetchAudioSamples(std::array<float, NUM_SAMPLES>& samples, int& sampleRate);
+// Latest frame from the audio analysis thread, computed once per audio
+// block from the configured source (playing media or an input device)
+// and shared by every caller.  Returns false if no source is producing.
+bool getAudioFrame(AudioFrame& out);
 
-// FFT + log-binning + RMS + beat detection. Pure function over
-// (samples, sampleRate) → AudioFrame, with EMA + peak-timing kept
-// in static locals (single-threaded callers only).
-void computeAudioFrame(const std::array<float, NUM_SAMPLES>& samples,
-                       int sampleRate,
-                       AudioFrame& out);
 inline uint32_t millis() {
     return GetTimeMS();
 }
@@ -260,7 +255,7 @@ private:
     WS2812FXExt* parent = nullptr;
 
     // Sound Reactive Stuff
-    void processSamples(std::array<float, NUM_SAMPLES>& samples, int sampleRate);
+    void applyAudioFrame(const AudioFrame& f);
     static constexpr int UDATA_ELEMENTS = 8;
     um_data_t um_data;
 
@@ -21,7 +21,10 @@
 #include "../settings.h"
 
 #include "PlaylistEntryImage.h"
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <set>
 
 #include <filesystem>
 using namespace std::filesystem;
@@ -33,6 +36,102 @@ using namespace Magick;
 
 void StartPrepLoopThread(PlaylistEntryImage* fb);
 
+/*
+ * Prefetch threads shared by every image playlist entry.  An entry submits
+ * a job for each image it queues, the job decodes the next image in that
+ * entry's queue.
+ */
+class ImagePrefetchPool {
+public:
+    ImagePrefetchPool() {
+        int threads = std::min(3, std::max(1, (int)std::thread::hardware_concurrency() - 1));
+        for (int i = 0; i < threads; i++) {
+            m_threads.emplace_back([this]() { Run(); });
+        }
+    }
+    ~ImagePrefetchPool() {
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_stop = true;
+        }
+        m_signal.notify_all();
+        for (auto& t : m_threads) {
+            t.join();
+        }
+    }
+
+    static ImagePrefetchPool& Get() {
+        static ImagePrefetchPool pool;
+        return pool;
+    }
+
+    void Submit(PlaylistEntryImage* pe, int jobs) {
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_jobs.insert(m_jobs.end(), jobs, pe);
+        }
+        m_signal.notify_all();
+    }
+
+    // Drop the entry's queued jobs and wait for any that are running
+    void Remove(PlaylistEntryImage* pe) {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_jobs.erase(std::remove(m_jobs.begin(), m_jobs.end(), pe), m_jobs.end());
+        m_signal.wait(lock, [this, pe]() { return !m_running.count(pe); });
+    }
+
+private:
+    void Run() {
+        SetThreadName("FPP-ImagePrefetch");
+        std::unique_lock<std::mutex> lock(m_lock);
+        while (!m_stop) {
+            if (m_jobs.empty()) {
+                m_signal.wait(lock);
+                continue;
+            }
+
+            PlaylistEntryImage* pe = m_jobs.front();
+            m_jobs.pop_front();
+            m_running.insert(pe);
+            lock.unlock();
+
+            pe->PrefetchNext();
+
+            lock.lock();
+            m_running.erase(m_running.find(pe));
+            m_signal.notify_all();
+        }
+    }
+
+    std::mutex m_lock;
+    std::condition_variable m_signal;
+    std::deque<PlaylistEntryImage*> m_jobs;
+    std::multiset<PlaylistEntryImage*> m_running;
+    std::vector<std::thread> m_threads;
+    bool m_stop = false;
+};
+
+/*
+ * Scaled images are cached as raw RGB so they can be read straight into
+ * the buffer handed to the model without going back through Magick.  The
+ * header records what the data was built from so a cache file is ignored
+ * if the source image changes or the scaling changes.
+ */
+#define IMAGE_CACHE_VERSION 1
+#define IMAGE_CACHE_TRANSFORM_FIT 0x01 // autoOrient, resize and center/crop to the model size
+
+struct ImageCacheHeader {
+    char magic[4]; // "PEIC"
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t bytesPerPixel;
+    uint32_t transform;
+    int64_t sourceMTime;
+    uint64_t sourceSize;
+};
+static_assert(sizeof(ImageCacheHeader) == 40, "ImageCacheHeader must not contain padding");
+
 /*
  *
  */
@@ -40,7 +139,6 @@ PlaylistEntryImage::PlaylistEntryImage(Playlist* playlist, PlaylistEntryBase* pa
     PlaylistEntryBase(playlist, parent),
     m_width(800),
     m_height(600),
-    m_buffer(NULL),
     m_bufferSize(0) {
     LogDebug(VB_PLAYLIST, "PlaylistEntryImage::PlaylistEntryImage()\n");
 
@@ -51,6 +149,7 @@ PlaylistEntryImage::PlaylistEntryImage(Playlist* playlist, PlaylistEntryBase* pa
     m_cacheEntries = 200;
     m_cacheSize = 1024; // MB
     m_freeSpace = 2048; // MB
+    m_prefetchCount = 3;
 }
 
 /*
@@ -59,9 +158,15 @@ PlaylistEntryImage::PlaylistEntryImage(Playlist* playlist, PlaylistEntryBase* pa
 PlaylistEntryImage::~PlaylistEntryImage() {
     m_runLoop = false;
     m_prepSignal.notify_all();
+    {
+        std::unique_lock<std::mutex> lock(m_prefetchLock);
+        m_prefetchSignal.notify_all();
+    }
     if (m_prepThread) {
         m_prepThread->join();
         delete m_prepThread;
+
+        ImagePrefetchPool::Get().Remove(this);
     }
 
     if (m_modelOrigState == PixelOverlayState::PixelState::Disabled) {
@@ -118,7 +223,7 @@ int PlaylistEntryImage::Init(Json::Value& config) {
     CleanupCache();
 
     m_bufferSize = m_width * m_height * 3; // RGB
-    m_buffer = new unsigned char[m_bufferSize];
+    m_image = std::make_shared<std::vector<uint8_t>>(m_bufferSize);
 
     m_runLoop = true;
     m_imagePrepped = false;
@@ -249,51 +354,119 @@ const std::string PlaylistEntryImage::GetNextFile(void) {
     return result;
 }
 
+/*
+ * Keep the next m_prefetchCount images picked and queued for the
+ * prefetch threads
+ */
+void PlaylistEntryImage::QueuePrefetch(void) {
+    int queued = 0;
+    std::unique_lock<std::mutex> lock(m_prefetchLock);
+    while (m_runLoop && (m_upcoming.size() < (size_t)m_prefetchCount + 1)) {
+        std::string file = GetNextFile();
+        if (file == "")
+            break;
+
+        m_upcoming.push_back(file);
+        if ((file != m_nextFileName) && !m_prefetched.count(file)) {
+            m_prefetched[file] = nullptr;
+            m_prefetchQueue.push_back(file);
+            queued++;
+        }
+    }
+    lock.unlock();
+
+    if (queued)
+        ImagePrefetchPool::Get().Submit(this, queued);
+}
+
 /*
  *
  */
 void PlaylistEntryImage::PrepImage(void) {
-    Image image;
-    Blob blob;
-    bool needToCache = true;
-    std::string nextFile = GetNextFile();
+    QueuePrefetch();
 
-    if (nextFile == "")
+    std::unique_lock<std::mutex> lock(m_prefetchLock);
+    if (m_upcoming.empty())
         return;
 
+    std::string nextFile = m_upcoming.front();
+    m_upcoming.pop_front();
+    bool stillUpcoming = std::find(m_upcoming.begin(), m_upcoming.end(), nextFile) != m_upcoming.end();
+
+    std::shared_ptr<std::vector<uint8_t>> data;
+    auto it = m_prefetched.find(nextFile);
+    if (it != m_prefetched.end()) {
+        auto queued = std::find(m_prefetchQueue.begin(), m_prefetchQueue.end(), nextFile);
+        if (queued != m_prefetchQueue.end()) {
+            // Not started yet, load it on this thread instead of waiting
+            if (!stillUpcoming) {
+                m_prefetchQueue.erase(queued);
+                m_prefetched.erase(it);
+            }
+        } else if (nextFile != m_nextFileName) {
+            m_prefetchSignal.wait(lock, [this, &nextFile]() { return !m_runLoop || m_prefetched[nextFile]; });
+            data = m_prefetched[nextFile];
+            if (!stillUpcoming)
+                m_prefetched.erase(nextFile);
+        } else if (!stillUpcoming && it->second) {
+            m_prefetched.erase(it);
+        }
+    }
+    lock.unlock();
+
     if (nextFile == m_nextFileName) {
         m_imagePrepped = true;
         return;
     }
 
+    if (!data) {
+        data = std::make_shared<std::vector<uint8_t>>();
+        if (!LoadImage(nextFile, *data))
+            data->clear();
+    }
+    if (data->size() != (size_t)m_bufferSize) {
+        // failed to load, show black.  data may still be in m_prefetched
+        // for a repeat of this file so don't resize it in place.
+        auto black = std::make_shared<std::vector<uint8_t>>(m_bufferSize);
+        memcpy(black->data(), data->data(), std::min((size_t)m_bufferSize, data->size()));
+        data = black;
+    }
+
     m_bufferLock.lock();
 
+    // Draw() hands the data straight to the model, no copy here
     m_nextFileName = nextFile;
+    m_image = data;
 
-    memset(m_buffer, 0, m_bufferSize);
+    m_bufferLock.unlock();
+    m_imagePrepped = true;
+
+    QueuePrefetch();
+}
+
+/*
+ * Load an image scaled to the model size as RGB data, from the cache if
+ * possible.  Called from both the prep and prefetch threads.
+ */
+bool PlaylistEntryImage::LoadImage(const std::string& fileName, std::vector<uint8_t>& data) {
+    if (GetImageFromCache(fileName, data))
+        return true;
+
+    Image image;
+    Blob blob;
 
     try {
         int cols = 0;
         int rows = 0;
 
-        needToCache = false;
         image.quiet(true); // Squelch warning exceptions
 
-        if (GetImageFromCache(nextFile, image)) {
-            cols = image.columns();
-            rows = image.rows();
-        }
-
-        if ((cols != m_width) || (rows != m_height)) {
-            image.read(nextFile.c_str());
-            image.autoOrient();
-            cols = image.columns();
-            rows = image.rows();
-        }
+        image.read(fileName.c_str());
+        image.autoOrient();
+        cols = image.columns();
+        rows = image.rows();
 
         if ((cols != m_width) && (rows != m_height)) {
-            needToCache = true;
-
             image.modifyImage();
 
             // Resize to slightly larger since trying to get exact can
@@ -322,23 +495,22 @@ void PlaylistEntryImage::PrepImage(void) {
         }
 
         image.type(TrueColorType);
-
-        if (needToCache) {
-            CacheImage(nextFile, image);
-        }
-
         image.magick("RGB");
         image.write(&blob);
-
-        memcpy(m_buffer, blob.data(), m_bufferSize);
     } catch (Exception& error_) {
         LogErr(VB_PLAYLIST, "GraphicsMagick exception reading %s: %s\n",
-               nextFile.c_str(), error_.what());
-        WarningHolder::AddWarningTimeout(60, 34, "Could not read playlist image file: " + nextFile);
+               fileName.c_str(), error_.what());
+        WarningHolder::AddWarningTimeout(60, 34, "Could not read playlist image file: " + fileName);
+        return false;
     }
 
-    m_bufferLock.unlock();
-    m_imagePrepped = true;
+    const uint8_t* rgb = (const uint8_t*)blob.data();
+    data.assign(rgb, rgb + blob.length());
+    data.resize(m_bufferSize);
+
+    CacheImage(fileName, data);
+
+    return true;
 }
 
 /*
@@ -356,7 +528,7 @@ void PlaylistEntryImage::Draw(void) {
         return;
     }
 
-    m_model->setData(m_buffer);
+    m_model->setData(m_image->data());
 
     m_bufferLock.unlock();
 
@@ -388,17 +560,41 @@ void PlaylistEntryImage::PrepLoop(void) {
     }
 }
 
+/*
+ * Decode the next queued image, called from the prefetch pool
+ */
+void PlaylistEntryImage::PrefetchNext(void) {
+    std::unique_lock<std::mutex> lock(m_prefetchLock);
+    // PrepImage may have taken it already
+    if (!m_runLoop || m_prefetchQueue.empty())
+        return;
+
+    std::string fileName = m_prefetchQueue.front();
+    m_prefetchQueue.pop_front();
+    lock.unlock();
+
+    // an empty buffer marks a failed load so PrepImage doesn't wait forever
+    auto data = std::make_shared<std::vector<uint8_t>>();
+    if (!LoadImage(fileName, *data))
+        data->clear();
+
+    lock.lock();
+    m_prefetched[fileName] = data;
+    m_prefetchSignal.notify_all();
+}
+
 /*
  *
  */
-std::string PlaylistEntryImage::GetCacheFileName(std::string fileName) {
+std::string PlaylistEntryImage::GetCacheFileName(const std::string& fileName) {
     std::size_t found = fileName.find_last_of("/");
     std::string baseFile = fileName.substr(found + 1);
     std::string result = m_cacheDir;
 
     result += "/pei-";
     result += baseFile;
-    result += ".png";
+    result += "-" + std::to_string(m_width) + "x" + std::to_string(m_height);
+    result += ".rgb";
 
     return result;
 }
@@ -406,38 +602,85 @@ std::string PlaylistEntryImage::GetCacheFileName(std::string fileName) {
 /*
  *
  */
-bool PlaylistEntryImage::GetImageFromCache(std::string fileName, Image& image) {
+bool PlaylistEntryImage::GetImageFromCache(const std::string& fileName, std::vector<uint8_t>& data) {
     std::string cacheFile = GetCacheFileName(fileName);
     struct stat os;
     struct stat cs;
 
-    if (FileExists(cacheFile)) {
-        stat(fileName.c_str(), &os);
-        stat(cacheFile.c_str(), &cs);
-
-        if (os.st_mtime > cs.st_mtime)
-            return false;
-
-        try {
-            image.read(cacheFile.c_str());
-        } catch (Exception& error_) {
-            LogErr(VB_PLAYLIST, "GraphicsMagick exception reading %s: %s\n",
-                   cacheFile.c_str(), error_.what());
+    if (stat(fileName.c_str(), &os))
+        return false;
+
+    int fd = open(cacheFile.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    bool valid = false;
+    size_t dataSize = m_width * m_height * 3;
+    ImageCacheHeader header;
+    if (!fstat(fd, &cs) && ((size_t)cs.st_size == sizeof(ImageCacheHeader) + dataSize) &&
+        (read(fd, &header, sizeof(header)) == sizeof(header)) &&
+        !memcmp(header.magic, "PEIC", 4) &&
+        (header.version == IMAGE_CACHE_VERSION) &&
+        (header.width == (uint32_t)m_width) &&
+        (header.height == (uint32_t)m_height) &&
+        (header.bytesPerPixel == 3) &&
+        (header.transform == IMAGE_CACHE_TRANSFORM_FIT) &&
+        (header.sourceMTime == os.st_mtime) &&
+        (header.sourceSize == (uint64_t)os.st_size)) {
+        // read the pixels straight into the caller's buffer
+        data.resize(dataSize);
+        size_t got = 0;
+        while (got < dataSize) {
+            ssize_t r = read(fd, data.data() + got, dataSize - got);
+            if (r <= 0)
+                break;
+            got += r;
         }
-
-        return true;
+        valid = got == dataSize;
     }
+    close(fd);
 
-    return false;
+    if (!valid)
+        LogDebug(VB_PLAYLIST, "Ignoring stale image cache file %s\n", cacheFile.c_str());
+
+    return valid;
 }
 
 /*
  *
  */
-void PlaylistEntryImage::CacheImage(std::string fileName, Image& image) {
+void PlaylistEntryImage::CacheImage(const std::string& fileName, const std::vector<uint8_t>& data) {
     std::string cacheFile = GetCacheFileName(fileName);
+    struct stat os;
 
-    image.write(cacheFile.c_str());
+    if (stat(fileName.c_str(), &os))
+        return;
+
+    ImageCacheHeader header;
+    memcpy(header.magic, "PEIC", 4);
+    header.version = IMAGE_CACHE_VERSION;
+    header.width = m_width;
+    header.height = m_height;
+    header.bytesPerPixel = 3;
+    header.transform = IMAGE_CACHE_TRANSFORM_FIT;
+    header.sourceMTime = os.st_mtime;
+    header.sourceSize = os.st_size;
+
+    // Write to a per-thread temporary name so a reader never maps a partial file
+    std::string tmpFile = cacheFile + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    FILE* f = fopen(tmpFile.c_str(), "wb");
+    if (!f) {
+        LogDebug(VB_PLAYLIST, "Could not create image cache file %s\n", tmpFile.c_str());
+        return;
+    }
+    bool ok = (fwrite(&header, sizeof(header), 1, f) == 1) &&
+              (fwrite(data.data(), 1, data.size(), f) == data.size());
+    ok = !fclose(f) && ok;
+    if (!ok || rename(tmpFile.c_str(), cacheFile.c_str())) {
+        LogErr(VB_PLAYLIST, "Could not write image cache file %s\n", cacheFile.c_str());
+        unlink(tmpFile.c_str());
+        return;
+    }
 
     CleanupCache();
 }
@@ -446,6 +689,7 @@ void PlaylistEntryImage::CacheImage(std::string fileName, Image& image) {
  *
  */
 void PlaylistEntryImage::CleanupCache(void) {
+    std::unique_lock<std::mutex> lock(m_cacheLock);
     try {
         if (!exists(m_cacheDir)) {
             return;
@@ -458,8 +702,8 @@ void PlaylistEntryImage::CleanupCache(void) {
         for (const auto& entry : directory_iterator(m_cacheDir)) {
             if (entry.is_regular_file()) {
                 std::string filename = entry.path().filename().string();
-                // Only process our cache files
-                if (filename.find("pei-") == 0 && filename.find(".png") != std::string::npos) {
+                // Only process our cache files, .png files are from older versions
+                if (filename.find("pei-") == 0 && (endsWith(filename, ".rgb") || endsWith(filename, ".png"))) {
                     cacheFiles.push_back({entry.path().string(), last_write_time(entry)});
                     totalSize += file_size(entry);
                 }
@@ -14,19 +14,18 @@
 #include <atomic>
 #include "fpp-json-fwd.h"
 #include <condition_variable>
+#include <deque>
 #include <list>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "overlays/PixelOverlayModel.h"
 #include "PlaylistEntryBase.h"
 
-namespace Magick
-{
-    class Image;
-};
-
 class PlaylistEntryImage : public PlaylistEntryBase {
 public:
     PlaylistEntryImage(Playlist* playlist, PlaylistEntryBase* parent = NULL);
@@ -43,6 +42,7 @@ public:
     virtual Json::Value GetConfig(void) override;
 
     void PrepLoop(void);
+    void PrefetchNext(void);
 
 private:
     void SetFileList(void);
@@ -52,9 +52,12 @@ private:
 
     void Draw(void);
 
-    std::string GetCacheFileName(std::string fileName);
-    bool GetImageFromCache(std::string fileName, Magick::Image& image);
-    void CacheImage(std::string fileName, Magick::Image& image);
+    bool LoadImage(const std::string& fileName, std::vector<uint8_t>& data);
+    void QueuePrefetch(void);
+
+    std::string GetCacheFileName(const std::string& fileName);
+    bool GetImageFromCache(const std::string& fileName, std::vector<uint8_t>& data);
+    void CacheImage(const std::string& fileName, const std::vector<uint8_t>& data);
     void CleanupCache(void);
 
     std::string m_imagePath;
@@ -66,6 +69,7 @@ private:
     int m_cacheEntries; // # of items
     int m_cacheSize;    // MB used by cached files
     int m_freeSpace;    // MB free on filesystem
+    std::mutex m_cacheLock;
 
     std::vector<std::string> m_files;
 
@@ -76,7 +80,8 @@ private:
     PixelOverlayModel *m_model = nullptr;
     PixelOverlayState::PixelState m_modelOrigState = PixelOverlayState::PixelState::Disabled;
 
-    unsigned char* m_buffer;
+    // the prepped image, shared with m_prefetched
+    std::shared_ptr<std::vector<uint8_t>> m_image;
     int m_bufferSize;
 
     unsigned int m_fileSeed;
@@ -85,9 +90,20 @@ private:
     volatile bool m_imagePrepped;
     volatile bool m_imageDrawn;
 
-    std::thread* m_prepThread;
+    std::thread* m_prepThread = nullptr;
     std::mutex m_prepLock;
     std::mutex m_bufferLock;
 
     std::condition_variable m_prepSignal;
+
+    // Images are picked m_prefetchCount ahead of playback and decoded/scaled
+    // in parallel by the prefetch threads shared by all image entries.
+    // m_prefetched holds the finished RGB data, a null entry means the image
+    // is queued or being decoded.
+    int m_prefetchCount;
+    std::deque<std::string> m_upcoming;
+    std::deque<std::string> m_prefetchQueue;
+    std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> m_prefetched;
+    std::mutex m_prefetchLock;
+    std::condition_variable m_prefetchSignal;
 };
@@ -293,10 +293,12 @@ int GPIODCapabilities::readEventFromFile() const {
 #ifdef IS_GPIOD_CXX_V2
     if (request) {
         try {
-            gpiod::edge_event_buffer buffer(1);
+            // drain everything queued since the last wakeup, only the
+            // newest edge matters
+            gpiod::edge_event_buffer buffer(16);
             int count = request->read_edge_events(buffer);
-            if (count == 1) {
-                auto& event = buffer.get_event(0);
+            if (count > 0) {
+                auto& event = buffer.get_event(count - 1);
                 return event.type() == gpiod::edge_event::event_type::RISING_EDGE ? 1 : 0;
             }
         } catch (const std::exception& ex) {
@@ -313,8 +315,9 @@ int GPIODCapabilities::readEventFromFile() const {
     return -1;
 }
 
-int GPIODCapabilities::requestEventFile(bool risingEdge, bool fallingEdge) const {
+int GPIODCapabilities::requestEventFile(bool risingEdge, bool fallingEdge, uint32_t debounceUS) const {
     int fd = -1;
+    debounced = false;
 #ifdef HASGPIOD
 #ifdef IS_GPIOD_CXX_V2
     LogDebug(VB_GPIO, "requestEventFile V2 for pin %s (chip:%d line:%d device:%s)\n",
@@ -367,17 +370,37 @@ int GPIODCapabilities::requestEventFile(bool risingEdge, bool fallingEdge) const
         LogDebug(VB_GPIO, "Building request for pin %s: chip device=%s, line=%d\n",
                  name.c_str(), gpioName.c_str(), gpio);
 
-        gpiod::request_builder builder = chip->prepare_request();
-        builder.add_line_settings(gpio, settings);
-        builder.set_consumer(consumer);
+        if (debounceUS) {
+            // The kernel debounces in the driver or hardware so userspace
+            // only wakes up for settled edges.  Not every chip can, fall
+            // back to an undebounced request if it's refused.
+            try {
+                gpiod::line_settings dbSettings = settings;
+                dbSettings.set_debounce_period(std::chrono::microseconds(debounceUS));
+                gpiod::request_builder builder = chip->prepare_request();
+                builder.add_line_settings(gpio, dbSettings);
+                builder.set_consumer(consumer);
+                request = std::make_shared<gpiod::line_request>(builder.do_request());
+                debounced = true;
+            } catch (const std::exception& ex) {
+                LogDebug(VB_GPIO, "Pin %s does not support kernel debounce, debouncing in fppd. (%s)\n",
+                         name.c_str(), ex.what());
+            }
+        }
+        if (!request) {
+            gpiod::request_builder builder = chip->prepare_request();
+            builder.add_line_settings(gpio, settings);
+            builder.set_consumer(consumer);
 
-        LogDebug(VB_GPIO, "Executing do_request() for pin %s\n", name.c_str());
-        request = std::make_shared<gpiod::line_request>(builder.do_request());
+            LogDebug(VB_GPIO, "Executing do_request() for pin %s\n", name.c_str());
+            request = std::make_shared<gpiod::line_request>(builder.do_request());
+        }
 
         fd = request->fd();
         if (fd < 0) {
             WarningHolder::AddWarning(51, "Could not get event file descriptor for pin " + name);
             request = nullptr;
+            debounced = false;
         }
     } catch (const std::exception& ex) {
         LogDebug(VB_GPIO, "Pin %s (chip:%d line:%d device:%s) does not support edge detection - will use polling instead. (%s)\n",
@@ -489,6 +512,8 @@ void GPIODCapabilities::setValue(bool i) const {
 static std::vector<GPIODCapabilities> GPIOD_PINS;
 static PinCapabilitiesProvider* PIN_PROVIDER = nullptr;
 
+uint32_t PinCapabilities::batchReadGeneration = 0;
+
 void PinCapabilities::InitGPIO(const std::string& process, PinCapabilitiesProvider* p) {
     PROCESS_NAME = process;
     if (p == nullptr) {
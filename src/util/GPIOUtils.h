@@ -83,12 +83,26 @@ public:
     virtual int mappedGPIOIdx() const { return gpioIdx; }
     virtual int mappedGPIO() const { return gpio; }
 
-    virtual int requestEventFile(bool risingEdge, bool fallingEdge) const {
+    // Returns a file descriptor that becomes readable when the requested
+    // edges occur or -1 if the pin needs to be polled.  A non-zero
+    // debounceUS asks for the edges to only be reported once the line has
+    // been stable that long, eventsDebounced() tells if that was possible.
+    virtual int requestEventFile(bool risingEdge, bool fallingEdge, uint32_t debounceUS = 0) const {
         return -1;
     }
+    // Consumes the pending events, returns the newest value or -1 if none
     virtual int readEventFromFile() const {
         return -1;
     }
+    virtual bool eventsDebounced() const { return false; }
+
+    // Pins on an expander read a whole port per transfer.  Between
+    // StartBatchRead() and EndBatchRead() their getValue() may answer from
+    // the port values latched by the first read of the batch.
+    static void StartBatchRead() { batchReadGeneration++; }
+    static void EndBatchRead() { batchReadGeneration++; }
+    static bool InBatchRead() { return (batchReadGeneration & 1) != 0; }
+    static uint32_t BatchReadGeneration() { return batchReadGeneration; }
 
     static const PinCapabilities& getPinByName(const std::string& n);
     static const PinCapabilities& getPinByUART(const std::string& n);
@@ -105,6 +119,7 @@ public:
 protected:
     static void enableOledScreen(int i2cBus, bool enable);
     static PinCapabilitiesProvider* pinProvider;
+    static uint32_t batchReadGeneration;
 };
 
 template<class T>
@@ -158,10 +173,12 @@ public:
     virtual bool isGPIOD() const override { return true; }
     virtual void releaseGPIOD() const override;
 
-    virtual int requestEventFile(bool risingEdge, bool fallingEdge) const override;
+    virtual int requestEventFile(bool risingEdge, bool fallingEdge, uint32_t debounceUS = 0) const override;
     virtual int readEventFromFile() const override;
+    virtual bool eventsDebounced() const override { return debounced; }
 
     std::string gpioName;
+    mutable bool debounced = false;
 #ifdef HASGPIOD
 #ifdef IS_GPIOD_CXX_V2
     mutable std::shared_ptr<gpiod::chip> chip = nullptr;
@@ -63,6 +63,11 @@ static SPIUtils* MCP23x17_SPI = nullptr;
 static uint8_t status_port_a;
 static uint8_t status_port_b;
 
+// port values latched during a PinCapabilities batch read so polling all
+// 16 inputs costs one transfer per port instead of one per pin
+static int32_t batch_value[2];
+static uint32_t batch_generation[2] = { 0, 0 };
+
 static int writeByte(uint8_t reg, uint8_t data, uint8_t devId = 0) {
     if (MCP23x17_SPI) {
         uint8_t spiData[4];
@@ -132,7 +137,17 @@ bool MCP23x17PinCapabilities::getValue() const {
         pin &= 0x07;
     }
     int mask = 1 << pin;
-    int value = readByte(gpio);
+    int value;
+    if (InBatchRead()) {
+        int port = gpio - MCP23x17_GPIOA;
+        if (batch_generation[port] != BatchReadGeneration()) {
+            batch_value[port] = readByte(gpio);
+            batch_generation[port] = BatchReadGeneration();
+        }
+        value = batch_value[port];
+    } else {
+        value = readByte(gpio);
+    }
     return ((value & mask) != 0);
 }
 void MCP23x17PinCapabilities::setValue(bool i) const {
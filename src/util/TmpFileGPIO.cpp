@@ -15,6 +15,11 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#if __has_include(<sys/inotify.h>)
+#include <sys/inotify.h>
+#define HAS_INOTIFY
+#endif
+
 #include "../common.h"
 
 #include "TmpFileGPIO.h"
@@ -42,6 +47,53 @@ void TmpFilePinCapabilities::setValue(bool i) const {
         unlink(filename.c_str());
 }
 
+int TmpFilePinCapabilities::requestEventFile(bool risingEdge, bool fallingEdge, uint32_t debounceUS) const {
+#ifdef HAS_INOTIFY
+    releaseGPIOD();
+    eventFile = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (eventFile < 0) {
+        return -1;
+    }
+    if (inotify_add_watch(eventFile, "/tmp", IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM) < 0) {
+        close(eventFile);
+        eventFile = -1;
+    }
+    return eventFile;
+#else
+    return -1;
+#endif
+}
+
+int TmpFilePinCapabilities::readEventFromFile() const {
+#ifdef HAS_INOTIFY
+    // the watch is on all of /tmp, only report changes to our file
+    std::string base = filename.substr(5);
+    bool ours = false;
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t len;
+    while ((len = read(eventFile, buf, sizeof(buf))) > 0) {
+        for (char* p = buf; p < buf + len;) {
+            struct inotify_event* event = (struct inotify_event*)p;
+            if (event->len && base == event->name) {
+                ours = true;
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+    if (ours) {
+        return getValue();
+    }
+#endif
+    return -1;
+}
+
+void TmpFilePinCapabilities::releaseGPIOD() const {
+    if (eventFile != -1) {
+        close(eventFile);
+        eventFile = -1;
+    }
+}
+
 class NullTmpFilePinCapabilities : public TmpFilePinCapabilities {
 public:
     NullTmpFilePinCapabilities() :
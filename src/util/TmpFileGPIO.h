@@ -14,6 +14,10 @@
 #include "GPIOUtils.h"
 #include <vector>
 
+// Simulated pins for testing without hardware.  A pin is high while
+// /tmp/GPIO-<name> exists.  Creating or removing the file is reported as an
+// edge through an inotify watch so inputs take the same event path as real
+// gpiod pins.
 class TmpFilePinCapabilities : public PinCapabilitiesFluent<TmpFilePinCapabilities> {
 public:
     TmpFilePinCapabilities(const std::string& n, uint32_t kg);
@@ -36,7 +40,12 @@ public:
     virtual int getPWMRegisterAddress() const override { return 0; };
     virtual bool supportPWM() const override { return false; };
 
+    virtual int requestEventFile(bool risingEdge, bool fallingEdge, uint32_t debounceUS = 0) const override;
+    virtual int readEventFromFile() const override;
+    virtual void releaseGPIOD() const override;
+
     std::string filename;
+    mutable int eventFile = -1;
 };
 class TmpFilePinProvider : public PinCapabilitiesProvider {
 public:
@@ -0,0 +1,251 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the GPL v2 as described in the
+ * included LICENSE.GPL file.
+ */
+
+/*
+ * Builds BBBMatrix GPIO frames with the per-pixel loop PrepData used
+ * before the bit plane tables and with PanelBitPlanes, checks they are
+ * bit identical and reports the time per frame of each.  The second run
+ * enables a submatrix, copied into the matrix channels for the old loop
+ * the way Matrix::OverlaySubMatrices() did and folded into the tables for
+ * PanelBitPlanes.
+ *
+ *   bbb_bitplane_bench [-o outputs] [-c chain] [-w width] [-h height]
+ *                      [-s scan] [-b bits] [-i interleave] [-f frames]
+ */
+
+#include "fpp-pch.h"
+
+#include <chrono>
+#include <random>
+
+#include "channeloutput/Matrix.h"
+#include "channeloutput/PanelBitPlanes.h"
+#include "channeloutput/PanelInterleaveHandler.h"
+#include "channeloutput/PanelMatrix.h"
+
+static const std::map<int, std::vector<int>> BIT_ORDERS = {
+    { 6, { 5, 2, 1, 4, 3, 0 } },
+    { 7, { 6, 2, 1, 4, 5, 3, 0 } },
+    { 8, { 7, 3, 5, 1, 2, 6, 4, 0 } },
+    { 9, { 8, 3, 5, 1, 7, 2, 6, 4, 0 } },
+    { 10, { 9, 4, 1, 6, 3, 8, 2, 7, 5, 0 } },
+    { 11, { 10, 4, 7, 2, 3, 1, 6, 9, 8, 5, 0 } },
+    { 12, { 11, 5, 8, 2, 4, 1, 7, 10, 3, 9, 6, 0 } }
+};
+
+struct Config {
+    int outputs = 8;
+    int chain = 8;
+    int width = 64;
+    int height = 32;
+    int scan = 16;
+    int bits = 8;
+    int frames = 200;
+    std::string interleave = "0";
+};
+
+// BBBMatrix::PrepData before the bit plane tables, minus the stats
+static void OldPrepData(const Config& cfg, PanelMatrix& panels, PanelInterleaveHandler* handler,
+                        const std::vector<PanelBitPlanes::OutputPins>& pins, const std::vector<int>& bitOrder,
+                        const uint16_t* gammaCurve, const uint8_t* channelData, uint32_t* gpioFrame, size_t frameLen) {
+    size_t rowLen = cfg.width * cfg.chain * cfg.height / (cfg.scan * 2) * 4;
+
+    memset(gpioFrame, 0, frameLen);
+    for (int output = 0; output < cfg.outputs; output++) {
+        const PanelBitPlanes::OutputPins& p = pins[output];
+        for (int panel : panels.m_outputPanels[output]) {
+            int chain = panels.m_panels[panel].chain;
+            const std::vector<int>& pixelMap = panels.m_panels[panel].pixelMap;
+            for (int y = 0; y < (cfg.height / 2); y++) {
+                int yw1 = y * cfg.width * 3;
+                int yw2 = (y + (cfg.height / 2)) * cfg.width * 3;
+
+                int yOut = y;
+                int xo2 = 0;
+                handler->map(xo2, yOut);
+
+                int offset = yOut * rowLen + (cfg.chain - chain - 1) * 4 * cfg.width * cfg.height / cfg.scan / 2;
+                for (int x = 0; x < cfg.width; ++x) {
+                    uint16_t v[6];
+                    for (int c = 0; c < 6; c++) {
+                        v[c] = gammaCurve[channelData[pixelMap[(c < 3 ? yw1 : yw2) + x * 3 + c % 3]]];
+                    }
+
+                    int xOut = x;
+                    int yo2 = y;
+                    handler->map(xOut, yo2);
+
+                    int xOff = xOut * 4;
+                    for (auto bit : bitOrder) {
+                        uint16_t mask = 1 << bit;
+                        for (int c = 0; c < 6; c++) {
+                            if (v[c] & mask) {
+                                gpioFrame[offset + xOff + p.bank[c]] |= p.pin[c];
+                            }
+                        }
+                        xOff += rowLen * cfg.scan;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Matrix::OverlaySubMatrices() for a single enabled submatrix that doesn't
+// overlap the matrix channels
+static void OldOverlaySubMatrix(uint8_t* channelData, int matrixStart, int matrixWidth, int subStart, int subW,
+                                int subH, int xOffset, int yOffset) {
+    for (int y = 0; y < subH; y++) {
+        memcpy(channelData + matrixStart + ((y + yOffset) * matrixWidth * 3) + (xOffset * 3),
+               channelData + subStart + (y * subW * 3), subW * 3);
+    }
+}
+
+template<class F>
+static double MsPerFrame(int frames, F func) {
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+        func();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+int main(int argc, char** argv) {
+    Config cfg;
+    int opt;
+    while ((opt = getopt(argc, argv, "o:c:w:h:s:b:i:f:")) != -1) {
+        switch (opt) {
+        case 'o':
+            cfg.outputs = atoi(optarg);
+            break;
+        case 'c':
+            cfg.chain = atoi(optarg);
+            break;
+        case 'w':
+            cfg.width = atoi(optarg);
+            break;
+        case 'h':
+            cfg.height = atoi(optarg);
+            break;
+        case 's':
+            cfg.scan = atoi(optarg);
+            break;
+        case 'b':
+            cfg.bits = atoi(optarg);
+            break;
+        case 'i':
+            cfg.interleave = optarg;
+            break;
+        case 'f':
+            cfg.frames = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-o outputs] [-c chain] [-w width] [-h height] [-s scan] [-b bits] [-i interleave] [-f frames]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (cfg.outputs < 1 || cfg.outputs > 8 || cfg.chain < 1 || cfg.width < 1 || cfg.height < 2 ||
+        cfg.scan < 1 || cfg.height % (cfg.scan * 2) || !BIT_ORDERS.count(cfg.bits) || cfg.frames < 1) {
+        fprintf(stderr, "Invalid arguments\n");
+        return 1;
+    }
+
+    // outputs stacked vertically, chains left to right, like a typical
+    // Octoscroller layout
+    PanelMatrix panels(cfg.width, cfg.height);
+    for (int o = 0; o < cfg.outputs; o++) {
+        for (int c = 0; c < cfg.chain; c++) {
+            panels.AddPanel(o, c, 'N', c * cfg.width, o * cfg.height);
+        }
+    }
+    int matrixWidth = cfg.width * cfg.chain;
+    int matrixHeight = cfg.height * cfg.outputs;
+    int startChannel = 0;
+    int matrixChannels = matrixWidth * matrixHeight * 3;
+
+    PanelInterleaveHandler* handler = PanelInterleaveHandler::createHandler(cfg.interleave, cfg.width, cfg.height, cfg.scan);
+
+    // 6 pins per output spread over the 4 GPIO banks
+    std::vector<PanelBitPlanes::OutputPins> pins(cfg.outputs);
+    for (int o = 0; o < cfg.outputs; o++) {
+        for (int c = 0; c < 6; c++) {
+            int n = o * 6 + c;
+            pins[o].pin[c] = 1 << (n % 32);
+            pins[o].bank[c] = (n / 8) % 4;
+        }
+    }
+    const std::vector<int>& bitOrder = BIT_ORDERS.at(cfg.bits);
+    uint16_t gammaCurve[256];
+    for (int x = 0; x < 256; x++) {
+        gammaCurve[x] = round(((1 << cfg.bits) - 1) * pow(x / 255.0, 2.2));
+    }
+
+    size_t frameWords = (size_t)cfg.chain * cfg.width * cfg.bits * (cfg.height / 2) * 4;
+    size_t frameLen = frameWords * 4;
+
+    // a submatrix over the middle of the matrix sourced from channels past
+    // the end of the matrix, the way an overlay model feeds one
+    int subW = matrixWidth / 2;
+    int subH = matrixHeight / 2;
+    Matrix matrix(startChannel, matrixWidth, matrixHeight);
+    matrix.AddSubMatrix(1, matrixChannels, subW, subH, matrixWidth / 4, matrixHeight / 4);
+
+    std::vector<uint8_t> channels(matrixChannels + subW * subH * 3 + 1024);
+    std::mt19937 rng(1);
+    for (auto& c : channels) {
+        c = rng();
+    }
+
+    PanelBitPlanes bitPlanes;
+    bitPlanes.Build(&panels, handler, startChannel, cfg.outputs, cfg.chain, cfg.width, cfg.height, cfg.scan,
+                    false, cfg.bits, bitOrder, gammaCurve, pins, frameWords);
+
+    std::vector<uint32_t> oldFrame(frameWords);
+    std::vector<uint32_t> newFrame(frameWords);
+    std::vector<uint8_t> pruFrame(frameLen);
+    std::vector<uint8_t> work(channels.size());
+
+    printf("%d outputs x %d chained %dx%d 1/%d scan panels, %d bits, interleave %s, %d locations%s\n",
+           cfg.outputs, cfg.chain, cfg.width, cfg.height, cfg.scan, cfg.bits, cfg.interleave.c_str(),
+           (int)bitPlanes.Locations(), bitPlanes.Overlap() ? " (overlapping)" : "");
+    int failures = 0;
+    for (int sub = 0; sub < 2; sub++) {
+        if (sub) {
+            // build from a pristine copy every frame so the old loop's
+            // in place submatrix copy sees the same input each time
+            bitPlanes.UpdateSubMatrices(&matrix, channels.data());
+        }
+        double oldMs = MsPerFrame(cfg.frames, [&]() {
+            memcpy(work.data(), channels.data(), channels.size());
+            if (sub) {
+                OldOverlaySubMatrix(work.data(), startChannel, matrixWidth, matrixChannels, subW, subH,
+                                    matrixWidth / 4, matrixHeight / 4);
+            }
+            OldPrepData(cfg, panels, handler, pins, bitOrder, gammaCurve, work.data() + startChannel, oldFrame.data(), frameLen);
+            memcpy(pruFrame.data(), oldFrame.data(), frameLen);
+        });
+        double newMs = MsPerFrame(cfg.frames, [&]() {
+            memcpy(work.data(), channels.data(), channels.size());
+            bitPlanes.Prep(work.data(), newFrame.data());
+            memcpy(pruFrame.data(), newFrame.data(), frameLen);
+        });
+        bool same = oldFrame == newFrame;
+        if (!same) {
+            failures++;
+        }
+        printf("%-14s old %7.2f ms/frame   tables %7.2f ms/frame   %4.1fx   %s\n",
+               sub ? "submatrix" : "no submatrix", oldMs, newMs, oldMs / newMs,
+               same ? "identical" : "MISMATCH");
+    }
+    delete handler;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,186 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the GPL v2 as described in the
+ * included LICENSE.GPL file.
+ */
+
+/*
+ * Converts RGB frames into framebuffer pages with the byte at a time loop
+ * FrameBuffer::FBCopyData used before the row converters (and the
+ * IOCTLFrameBuffer RGB565 lookup table loop for 16bpp) and with
+ * FBConvertRows(), checks the pages are identical and reports the time
+ * per frame of each.
+ *
+ *   framebuffer_bench [-w width] [-h height] [-b bpp] [-s scale] [-f frames]
+ *
+ * By default a set of full HD and scaled model sizes is run for 32, 24 and
+ * 16bpp.  -w/-h give the model size before scaling, -b and -s pick a
+ * single format and scale.
+ */
+
+#include "fpp-pch.h"
+
+#include <chrono>
+#include <random>
+
+#include "framebuffer/FrameBufferRows.h"
+
+static uint16_t rgb565map[32][64][32];
+
+// FrameBuffer::FBCopyData/IOCTLFrameBuffer::FBCopyData before the row
+// converters, minus the locking
+static void OldCopyData(const uint8_t* buffer, uint8_t* ob, int w, int h, int bpp, int scale, int rowStride) {
+    const uint8_t* sR = buffer + 0;
+    const uint8_t* sG = buffer + 1;
+    const uint8_t* sB = buffer + 2;
+    for (int y = 0; y < h; y++) {
+        uint8_t* row = ob + (y * scale * rowStride);
+        if (bpp == 16) {
+            uint8_t* d = row;
+            for (int x = 0; x < w; x++) {
+                for (int sc = 0; sc < scale; sc++) {
+                    *((uint16_t*)d) = rgb565map[*sR >> 3][*sG >> 2][*sB >> 3];
+                    d += 2;
+                }
+                sR += 3;
+                sG += 3;
+                sB += 3;
+            }
+        } else {
+            int add = bpp / 8;
+            uint8_t* dB = row;
+            uint8_t* dG = dB + 1;
+            uint8_t* dR = dB + 2;
+            for (int x = 0; x < w; x++) {
+                for (int sc = 0; sc < scale; sc++) {
+                    *dR = *sR;
+                    *dG = *sG;
+                    *dB = *sB;
+                    dR += add;
+                    dG += add;
+                    dB += add;
+                }
+                sR += 3;
+                sG += 3;
+                sB += 3;
+            }
+        }
+        for (int sc = 1; sc < scale; sc++) {
+            memcpy(row + (sc * rowStride), row, rowStride);
+        }
+    }
+}
+
+template<class F>
+static double MsPerFrame(int frames, F func) {
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+        func();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+static bool Run(int w, int h, int bpp, int scale, int frames) {
+    int rowStride = w * scale * bpp / 8;
+    std::vector<uint8_t> input(w * h * 3);
+    std::mt19937 rng(1);
+    for (auto& c : input) {
+        c = rng();
+    }
+
+    // the old 32bpp loop never wrote the alpha byte, start both pages zeroed
+    std::vector<uint8_t> oldPage(rowStride * h * scale);
+    std::vector<uint8_t> newPage(rowStride * h * scale);
+    std::vector<uint8_t> scratch;
+
+    double oldMs = MsPerFrame(frames, [&]() {
+        OldCopyData(input.data(), oldPage.data(), w, h, bpp, scale, rowStride);
+    });
+    double newMs = MsPerFrame(frames, [&]() {
+        FBConvertRows(input.data(), newPage.data(), w, h, bpp, scale, rowStride, scratch);
+    });
+
+    bool same = oldPage == newPage;
+    printf("%4dx%-4d x%d %2dbpp  old %7.3f ms  new %7.3f ms  %5.2fx%s\n", w, h, scale, bpp, oldMs, newMs,
+           oldMs / newMs, same ? "" : "  MISMATCH");
+    return same;
+}
+
+int main(int argc, char** argv) {
+    int width = 0;
+    int height = 0;
+    int bpp = 0;
+    int scale = 0;
+    int frames = 200;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "w:h:b:s:f:")) != -1) {
+        switch (opt) {
+        case 'w':
+            width = atoi(optarg);
+            break;
+        case 'h':
+            height = atoi(optarg);
+            break;
+        case 'b':
+            bpp = atoi(optarg);
+            break;
+        case 's':
+            scale = atoi(optarg);
+            break;
+        case 'f':
+            frames = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-w width] [-h height] [-b bpp] [-s scale] [-f frames]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (width < 0 || height < 0 || (bpp && bpp != 16 && bpp != 24 && bpp != 32) || scale < 0 || frames < 1) {
+        fprintf(stderr, "Invalid arguments\n");
+        return 1;
+    }
+
+    // the standard RGB565 bitfields, IOCTLFrameBuffer builds this from the
+    // device's offsets
+    for (int r = 0; r < 32; r++) {
+        for (int g = 0; g < 64; g++) {
+            for (int b = 0; b < 32; b++) {
+                rgb565map[r][g][b] = (r << 11) | (g << 5) | b;
+            }
+        }
+    }
+
+    struct Size {
+        int w;
+        int h;
+        int scale;
+    };
+    std::vector<Size> sizes;
+    if (width && height) {
+        sizes.push_back({ width, height, scale ? scale : 1 });
+    } else {
+        // full HD, and models scaled up to about full HD
+        sizes = { { 1920, 1080, 1 }, { 960, 540, 2 }, { 640, 360, 3 }, { 480, 270, 4 } };
+        if (scale) {
+            std::erase_if(sizes, [scale](const Size& s) { return s.scale != scale; });
+        }
+    }
+
+    bool ok = true;
+    for (int b : { 32, 24, 16 }) {
+        if (bpp && b != bpp) {
+            continue;
+        }
+        for (auto& s : sizes) {
+            ok &= Run(s.w, s.h, b, s.scale, frames);
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the GPL v2 as described in the
+ * included LICENSE.GPL file.
+ */
+
+/*
+ * Loads a large generated schedule.json through the Scheduler and reports
+ * the initial load, reloads with nothing changed and with a few entries
+ * edited (what every schedule save does), and the GetSchedule()/GetInfo()
+ * API calls.
+ *
+ *   scheduler_bench [-n entries] [-d days] [-e edited] [-r reloads]
+ *                   [-s sunPercent]
+ *
+ * Entries are FPP command entries with unique times spread over the day,
+ * sunPercent of them start at sunset with an offset.  -d sets
+ * ScheduleDistance.  Reloads go through ScheduleProc() like fppd's, so
+ * each one waits for the next second.
+ */
+
+#include "fpp-pch.h"
+
+#include <chrono>
+#include <sys/stat.h>
+#include <thread>
+
+#include "FPPLocale.h"
+#include "Scheduler.h"
+#include "common.h"
+#include "log.h"
+#include "settings.h"
+
+static std::string mediaDir;
+
+std::string getFPPMediaDir(const std::string& path) {
+    return mediaDir + path;
+}
+Json::Value LocaleHolder::GetLocale() {
+    return Json::Value(Json::objectValue);
+}
+
+static Json::Value MakeEntry(int i, int sunPercent, int version) {
+    Json::Value e;
+    e["enabled"] = 1;
+    e["playlist"] = "";
+    e["command"] = "Volume Set";
+    Json::Value args(Json::arrayValue);
+    args.append(std::to_string(i % 100));
+    e["args"] = args;
+    // weekdays, weekends, every day and single days
+    static const int days[] = { 7, 8, 9, 10, 11, 1, 5 };
+    e["day"] = days[i % 7];
+    // edits move the entry by a minute
+    int minuteOfDay = (i * 7 + version) % (24 * 60);
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%02d:%02d:%02d", minuteOfDay / 60, minuteOfDay % 60, i % 60);
+    if ((i % 100) < sunPercent) {
+        e["startTime"] = "SunSet";
+        e["startTimeOffset"] = i % 120 - 60 + version;
+    } else {
+        e["startTime"] = buf;
+    }
+    e["endTime"] = buf;
+    e["repeat"] = (i % 50 == 0) ? 3000 : 0; // a few repeat every 30 minutes
+    e["startDate"] = "2019-01-01";
+    e["endDate"] = "2099-12-31";
+    e["stopType"] = 0;
+    return e;
+}
+
+static void WriteSchedule(int entries, int sunPercent, int edited, int version) {
+    Json::Value sch(Json::arrayValue);
+    for (int i = 0; i < entries; i++) {
+        // spread the edited entries through the schedule
+        bool edit = edited && (i % std::max(1, entries / edited)) == 0 && i / std::max(1, entries / edited) < edited;
+        sch.append(MakeEntry(i, sunPercent, edit ? version : 0));
+    }
+    SaveJsonToFile(sch, mediaDir + "/config/schedule.json");
+}
+
+static double Ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double Reload(Scheduler* s) {
+    // ScheduleProc() only runs once a second
+    time_t t = time(nullptr);
+    while (time(nullptr) == t) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    s->ReloadScheduleFile();
+    auto start = std::chrono::steady_clock::now();
+    s->ScheduleProc();
+    return Ms(start);
+}
+
+int main(int argc, char** argv) {
+    int entries = 3000;
+    int days = 14;
+    int edited = 10;
+    int reloads = 3;
+    int sunPercent = 30;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:d:e:r:s:")) != -1) {
+        switch (opt) {
+        case 'n':
+            entries = atoi(optarg);
+            break;
+        case 'd':
+            days = atoi(optarg);
+            break;
+        case 'e':
+            edited = atoi(optarg);
+            break;
+        case 'r':
+            reloads = atoi(optarg);
+            break;
+        case 's':
+            sunPercent = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n entries] [-d days] [-e edited] [-r reloads] [-s sunPercent]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (entries < 1 || days < 1 || edited < 0 || reloads < 1 || sunPercent < 0 || sunPercent > 100) {
+        fprintf(stderr, "Invalid arguments\n");
+        return 1;
+    }
+
+    // SchedulePrint() logs every entry at info level and the sun times warn
+    // when the time zone doesn't match the location, leave that out
+    FPPLogger::INSTANCE.SetAllLevel(LOG_ERR);
+
+    char dirTemplate[] = "/tmp/fpp-scheduler-bench-XXXXXX";
+    mediaDir = mkdtemp(dirTemplate);
+    mkdir((mediaDir + "/config").c_str(), 0755);
+    mkdir((mediaDir + "/playlists").c_str(), 0755);
+
+    SetSetting("ScheduleDistance", days);
+    SetSetting("Latitude", "38.938524");
+    SetSetting("Longitude", "-104.600945");
+
+    WriteSchedule(entries, sunPercent, 0, 0);
+
+    auto start = std::chrono::steady_clock::now();
+    Scheduler* s = new Scheduler();
+    double initial = Ms(start);
+
+    double unchanged = 0;
+    for (int r = 0; r < reloads; r++) {
+        unchanged += Reload(s);
+    }
+    unchanged /= reloads;
+
+    double edits = 0;
+    for (int r = 0; r < reloads; r++) {
+        WriteSchedule(entries, sunPercent, edited, r + 1);
+        edits += Reload(s);
+    }
+    edits /= reloads;
+
+    start = std::chrono::steady_clock::now();
+    Json::Value sched = s->GetSchedule();
+    double getSchedule = Ms(start);
+
+    start = std::chrono::steady_clock::now();
+    Json::Value info = s->GetInfo();
+    double getInfo = Ms(start);
+
+    printf("%d entries, %d days, %d%% sun times, %d occurrences\n", entries, days, sunPercent,
+           (int)sched["items"].size());
+    printf("initial load      %9.2f ms\n", initial);
+    printf("unchanged reload  %9.2f ms\n", unchanged);
+    printf("reload, %3d edited %8.2f ms\n", edited, edits);
+    printf("GetSchedule()     %9.2f ms\n", getSchedule);
+    printf("GetInfo()         %9.2f ms\n", getInfo);
+
+    delete s;
+    unlink((mediaDir + "/config/schedule.json").c_str());
+    rmdir((mediaDir + "/config").c_str());
+    rmdir((mediaDir + "/playlists").c_str());
+    rmdir(mediaDir.c_str());
+    return 0;
+}
@@ -0,0 +1,47 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+// Stand in for the command manager.  Commands are accepted and thrown away,
+// running one or a preset does nothing.
+#include "fpp-pch.h"
+
+#include "commands/Commands.h"
+
+Command::Command(const std::string& n) :
+    name(n) {
+}
+Command::~Command() {}
+Json::Value Command::getDescription() {
+    return Json::Value();
+}
+
+CommandManager CommandManager::INSTANCE;
+CommandManager::CommandManager() {}
+CommandManager::~CommandManager() {}
+void CommandManager::addCommand(Command* cmd) {
+    delete cmd;
+}
+std::unique_ptr<Command::Result> CommandManager::run(const std::string& command, const std::vector<std::string>& args) {
+    return nullptr;
+}
+std::unique_ptr<Command::Result> CommandManager::run(const std::string& command, const Json::Value& argsArray) {
+    return nullptr;
+}
+std::unique_ptr<Command::Result> CommandManager::run(const Json::Value& command) {
+    return nullptr;
+}
+int CommandManager::TriggerPreset(std::string name) {
+    return 0;
+}
+int CommandManager::TriggerPreset(std::string name, std::map<std::string, std::string>& keywords) {
+    return 0;
+}
@@ -0,0 +1,23 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+// Stand in for the fppversion.c the src Makefile generates from git
+#include "fppversion.h"
+
+extern "C" {
+const char* getFPPVersion(void) { return "test"; }
+const char* getFPPMajorVersion(void) { return "0"; }
+const char* getFPPMinorVersion(void) { return "0"; }
+const char* getFPPBranch(void) { return "test"; }
+const char* getFPPVersionTriplet(void) { return "0.0.0"; }
+void printVersionInfo(void) {}
+}
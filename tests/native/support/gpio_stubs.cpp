@@ -0,0 +1,31 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+// Stand in for the fppd pieces gpio.cpp calls out to besides the commands
+// and player in command_stubs.cpp and player_stubs.cpp.
+#include "fpp-pch.h"
+
+#include "Events.h"
+#include "common.h"
+#include "settings.h"
+
+bool Events::Publish(const std::string& topic, int value) {
+    return true;
+}
+
+bool LoadJsonFromFile(const std::string& filename, Json::Value& root) {
+    return false;
+}
+
+std::string getFPPMediaDir(const std::string& path) {
+    return "/nonexistent" + path;
+}
@@ -0,0 +1,88 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+#pragma once
+
+// The part of the libmosquitto API mqtt.cpp uses, backed by the in-process
+// stub broker in mosquitto_stubs.cpp instead of a network connection.  The
+// StubBroker namespace lets a test make calls fail and see what was
+// published.
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define MOSQ_LOG_INFO 0x01
+#define MOSQ_LOG_NOTICE 0x02
+#define MOSQ_LOG_WARNING 0x04
+#define MOSQ_LOG_ERR 0x08
+#define MOSQ_LOG_DEBUG 0x10
+
+enum mosq_err_t {
+    MOSQ_ERR_SUCCESS = 0,
+    MOSQ_ERR_NOMEM = 1,
+    MOSQ_ERR_PROTOCOL = 2,
+    MOSQ_ERR_INVAL = 3,
+    MOSQ_ERR_NO_CONN = 4,
+    MOSQ_ERR_NOT_SUPPORTED = 10,
+};
+
+struct mosquitto;
+struct mosquitto_message {
+    int mid;
+    char* topic;
+    void* payload;
+    int payloadlen;
+    int qos;
+    bool retain;
+};
+
+int mosquitto_lib_init(void);
+int mosquitto_lib_cleanup(void);
+struct mosquitto* mosquitto_new(const char* id, bool clean_session, void* obj);
+void mosquitto_destroy(struct mosquitto* mosq);
+void mosquitto_user_data_set(struct mosquitto* mosq, void* obj);
+void mosquitto_log_callback_set(struct mosquitto* mosq, void (*on_log)(struct mosquitto*, void*, int, const char*));
+void mosquitto_connect_callback_set(struct mosquitto* mosq, void (*on_connect)(struct mosquitto*, void*, int));
+void mosquitto_disconnect_callback_set(struct mosquitto* mosq, void (*on_disconnect)(struct mosquitto*, void*, int));
+void mosquitto_message_callback_set(struct mosquitto* mosq, void (*on_message)(struct mosquitto*, void*, const struct mosquitto_message*));
+int mosquitto_username_pw_set(struct mosquitto* mosq, const char* username, const char* password);
+int mosquitto_tls_set(struct mosquitto* mosq, const char* cafile, const char* capath, const char* certfile,
+                      const char* keyfile, int (*pw_callback)(char* buf, int size, int rwflag, void* userdata));
+int mosquitto_will_set(struct mosquitto* mosq, const char* topic, int payloadlen, const void* payload, int qos, bool retain);
+int mosquitto_connect_async(struct mosquitto* mosq, const char* host, int port, int keepalive);
+int mosquitto_loop_start(struct mosquitto* mosq);
+int mosquitto_loop_stop(struct mosquitto* mosq, bool force);
+int mosquitto_publish(struct mosquitto* mosq, int* mid, const char* topic, int payloadlen, const void* payload, int qos, bool retain);
+int mosquitto_subscribe(struct mosquitto* mosq, int* mid, const char* sub, int qos);
+int mosquitto_unsubscribe(struct mosquitto* mosq, int* mid, const char* sub);
+int mosquitto_topic_matches_sub(const char* sub, const char* topic, bool* result);
+
+namespace StubBroker {
+struct Message {
+    std::string topic;
+    std::string payload;
+    int qos;
+    bool retain;
+};
+
+// what the next client gets back from these calls
+extern int connectResult;
+extern int loopStartResult;
+// how long each publish takes to "reach" the broker
+extern int publishDelayUS;
+
+// everything published so far, lock the mutex to read while a client runs
+extern std::mutex lock;
+extern std::vector<Message> published;
+
+void Reset();
+}
@@ -0,0 +1,132 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+// In-process stand in for libmosquitto and the broker behind it.  A
+// connected client's publishes are recorded in StubBroker::published, in
+// the order the client sent them.
+#include "fpp-pch.h"
+
+#include <chrono>
+#include <thread>
+
+#include "mosquitto.h"
+
+struct mosquitto {
+    void* userdata = nullptr;
+    void (*onConnect)(struct mosquitto*, void*, int) = nullptr;
+    void (*onDisconnect)(struct mosquitto*, void*, int) = nullptr;
+    bool connecting = false;
+    bool connected = false;
+};
+
+namespace StubBroker {
+int connectResult = MOSQ_ERR_SUCCESS;
+int loopStartResult = MOSQ_ERR_SUCCESS;
+int publishDelayUS = 0;
+std::mutex lock;
+std::vector<Message> published;
+
+void Reset() {
+    std::unique_lock<std::mutex> l(lock);
+    connectResult = MOSQ_ERR_SUCCESS;
+    loopStartResult = MOSQ_ERR_SUCCESS;
+    publishDelayUS = 0;
+    published.clear();
+}
+}
+
+int mosquitto_lib_init(void) {
+    return MOSQ_ERR_SUCCESS;
+}
+int mosquitto_lib_cleanup(void) {
+    return MOSQ_ERR_SUCCESS;
+}
+struct mosquitto* mosquitto_new(const char* id, bool clean_session, void* obj) {
+    mosquitto* m = new mosquitto();
+    m->userdata = obj;
+    return m;
+}
+void mosquitto_destroy(struct mosquitto* mosq) {
+    delete mosq;
+}
+void mosquitto_user_data_set(struct mosquitto* mosq, void* obj) {
+    mosq->userdata = obj;
+}
+void mosquitto_log_callback_set(struct mosquitto* mosq, void (*on_log)(struct mosquitto*, void*, int, const char*)) {
+}
+void mosquitto_connect_callback_set(struct mosquitto* mosq, void (*on_connect)(struct mosquitto*, void*, int)) {
+    mosq->onConnect = on_connect;
+}
+void mosquitto_disconnect_callback_set(struct mosquitto* mosq, void (*on_disconnect)(struct mosquitto*, void*, int)) {
+    mosq->onDisconnect = on_disconnect;
+}
+void mosquitto_message_callback_set(struct mosquitto* mosq, void (*on_message)(struct mosquitto*, void*, const struct mosquitto_message*)) {
+}
+int mosquitto_username_pw_set(struct mosquitto* mosq, const char* username, const char* password) {
+    return MOSQ_ERR_SUCCESS;
+}
+int mosquitto_tls_set(struct mosquitto* mosq, const char* cafile, const char* capath, const char* certfile,
+                      const char* keyfile, int (*pw_callback)(char* buf, int size, int rwflag, void* userdata)) {
+    return MOSQ_ERR_SUCCESS;
+}
+int mosquitto_will_set(struct mosquitto* mosq, const char* topic, int payloadlen, const void* payload, int qos, bool retain) {
+    return MOSQ_ERR_SUCCESS;
+}
+int mosquitto_connect_async(struct mosquitto* mosq, const char* host, int port, int keepalive) {
+    mosq->connecting = StubBroker::connectResult == MOSQ_ERR_SUCCESS;
+    return StubBroker::connectResult;
+}
+
+// The real loop thread connects in the background, the stub connects right
+// away so the client is usable as soon as Init returns.
+int mosquitto_loop_start(struct mosquitto* mosq) {
+    if (StubBroker::loopStartResult != MOSQ_ERR_SUCCESS) {
+        return StubBroker::loopStartResult;
+    }
+    if (mosq->connecting) {
+        mosq->connected = true;
+        if (mosq->onConnect) {
+            mosq->onConnect(mosq, mosq->userdata, 0);
+        }
+    }
+    return MOSQ_ERR_SUCCESS;
+}
+int mosquitto_loop_stop(struct mosquitto* mosq, bool force) {
+    if (mosq && mosq->connected) {
+        mosq->connected = false;
+        if (mosq->onDisconnect) {
+            mosq->onDisconnect(mosq, mosq->userdata, 0);
+        }
+    }
+    return MOSQ_ERR_SUCCESS;
+}
+int mosquitto_publish(struct mosquitto* mosq, int* mid, const char* topic, int payloadlen, const void* payload, int qos, bool retain) {
+    if (!mosq->connected) {
+        return MOSQ_ERR_NO_CONN;
+    }
+    if (StubBroker::publishDelayUS) {
+        std::this_thread::sleep_for(std::chrono::microseconds(StubBroker::publishDelayUS));
+    }
+    std::unique_lock<std::mutex> l(StubBroker::lock);
+    StubBroker::published.push_back({ topic, std::string((const char*)payload, payloadlen), qos, retain });
+    return MOSQ_ERR_SUCCESS;
+}
+int mosquitto_subscribe(struct mosquitto* mosq, int* mid, const char* sub, int qos) {
+    return mosq->connected ? MOSQ_ERR_SUCCESS : MOSQ_ERR_NO_CONN;
+}
+int mosquitto_unsubscribe(struct mosquitto* mosq, int* mid, const char* sub) {
+    return mosq->connected ? MOSQ_ERR_SUCCESS : MOSQ_ERR_NO_CONN;
+}
+int mosquitto_topic_matches_sub(const char* sub, const char* topic, bool* result) {
+    *result = strcmp(sub, topic) == 0;
+    return MOSQ_ERR_SUCCESS;
+}
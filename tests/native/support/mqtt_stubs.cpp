@@ -0,0 +1,28 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+// Stand in for the events and thread naming mqtt.cpp uses.  libmosquitto is
+// replaced by mosquitto_stubs.cpp.
+#include "fpp-pch.h"
+
+#include "Events.h"
+#include "common.h"
+
+EventHandler::EventHandler() {}
+EventHandler::~EventHandler() {}
+
+void Events::InvokeCallback(const std::string& topic, const std::string& topic_in, const std::string& payload) {
+}
+
+void SetThreadName(const std::string& name) {
+    pthread_setname_np(pthread_self(), name.c_str());
+}
@@ -0,0 +1,42 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+// Stand in for the overlay model lookups the output processors make.  The
+// tests use plain channel ranges so no model is ever found.
+#include "fpp-pch.h"
+
+#include "overlays/PixelOverlay.h"
+#include "overlays/PixelOverlayModel.h"
+
+// private to PixelOverlay.cpp, needed to destroy the manager's range list
+class OverlayRange {
+public:
+    int start = 0;
+    int end = 0;
+    int value = 0;
+};
+
+PixelOverlayManager PixelOverlayManager::INSTANCE;
+
+PixelOverlayManager::PixelOverlayManager() {}
+PixelOverlayManager::~PixelOverlayManager() {}
+
+PixelOverlayModel* PixelOverlayManager::getModel(const std::string& name) {
+    return nullptr;
+}
+
+int PixelOverlayModel::getChannelCount() const {
+    return 0;
+}
+int PixelOverlayModel::getStartChannel() const {
+    return 0;
+}
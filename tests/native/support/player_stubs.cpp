@@ -0,0 +1,62 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+// Stand in for the playlist player, which stays idle.  Starting a playlist
+// does nothing.
+#include "fpp-pch.h"
+
+#include "Player.h"
+
+Player Player::INSTANCE;
+Player::Player() {}
+Player::~Player() {}
+PlaylistStatus Player::GetStatus() {
+    return FPP_STATUS_IDLE;
+}
+HttpResponsePtr Player::render_GET(const HttpRequestPtr& req) {
+    return nullptr;
+}
+HttpResponsePtr Player::render_POST(const HttpRequestPtr& req) {
+    return nullptr;
+}
+HttpResponsePtr Player::render_PUT(const HttpRequestPtr& req) {
+    return nullptr;
+}
+int Player::StartScheduledPlaylist(const std::string& name, const int position,
+                                   const int repeat, const int scheduleEntry, const int scheduledPriority,
+                                   const time_t sTime, const time_t eTime, const int method) {
+    return 0;
+}
+int Player::AdjustPlaylistStopTime(const int seconds) {
+    return 0;
+}
+int Player::StopNow(int forceStop) {
+    return 0;
+}
+int Player::StopGracefully(int forceStop, int afterCurrentLoop) {
+    return 0;
+}
+std::string Player::GetPlaylistName() {
+    return "";
+}
+int Player::GetRepeat() {
+    return 0;
+}
+int Player::GetStopMethod() {
+    return 0;
+}
+int Player::GetScheduleEntry() {
+    return -1;
+}
+int Player::WasScheduled() {
+    return 0;
+}
@@ -0,0 +1,41 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+// Stand in for the settings store.  Nothing is read from disk, a test sets
+// what it needs with SetSetting() and everything else reads as unset.  The
+// system is always in player mode.
+#include "fpp-pch.h"
+
+#include "settings.h"
+
+static std::map<std::string, std::string> settings;
+
+std::string getSetting(const char* setting, const char* defaultVal) {
+    auto it = settings.find(setting);
+    return it == settings.end() ? defaultVal : it->second;
+}
+int getSettingInt(const char* setting, int defaultVal) {
+    auto it = settings.find(setting);
+    return it == settings.end() ? defaultVal : atoi(it->second.c_str());
+}
+int SetSetting(const std::string& key, const std::string& value) {
+    settings[key] = value;
+    return 1;
+}
+int SetSetting(const std::string& key, const int value) {
+    settings[key] = std::to_string(value);
+    return 1;
+}
+
+FPPMode getFPPmode(void) {
+    return PLAYER_MODE;
+}
@@ -0,0 +1,40 @@
+#pragma once
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+#include <cstdio>
+
+// Minimal check helpers for the native tests.  A test binary returns
+// TEST_RESULT() from main so make stops on the first failing test.
+static int TEST_FAILURES = 0;
+
+#define CHECK(cond)                                                       \
+    do {                                                                  \
+        if (!(cond)) {                                                    \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            TEST_FAILURES++;                                              \
+        }                                                                 \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                    \
+    do {                                                                  \
+        auto _va = (a);                                                   \
+        auto _vb = (b);                                                   \
+        if (!(_va == _vb)) {                                              \
+            fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", \
+                    __FILE__, __LINE__, #a, #b, (long long)_va, (long long)_vb); \
+            TEST_FAILURES++;                                              \
+        }                                                                 \
+    } while (0)
+
+#define TEST_RESULT()                                                     \
+    (TEST_FAILURES ? (fprintf(stderr, "%d check(s) failed\n", TEST_FAILURES), 1) : (printf("OK\n"), 0))
@@ -0,0 +1,62 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+// Stand in for the UDPOutputData/UDPOutputMessages parts of UDPOutput.cpp
+// so a single UDP output type can be tested without the UDPOutput channel
+// output, its network monitor and the other protocols.  Messages are only
+// collected, the test sends them itself.  Addresses must be numeric and
+// there is no de-duplication.
+#include "fpp-pch.h"
+
+#include <arpa/inet.h>
+
+#include "channeloutput/UDPOutput.h"
+
+UDPOutputMessages::UDPOutputMessages() {
+}
+UDPOutputMessages::~UDPOutputMessages() {
+}
+std::vector<struct mmsghdr>& UDPOutputMessages::GetMessages(unsigned int key) {
+    return messages[key];
+}
+
+UDPOutputData::UDPOutputData(const Json::Value& config) :
+    valid(true),
+    type(0),
+    monitor(true),
+    failCount(0),
+    lastData(nullptr),
+    skippedFrames(0) {
+    description = config["description"].asString();
+    startChannel = config["startChannel"].asInt();
+    channelCount = config["channelCount"].asInt();
+    active = config.isMember("active") ? config["active"].asInt() : 1;
+    type = config["type"].asInt();
+    ipAddress = config["address"].asString();
+}
+UDPOutputData::~UDPOutputData() {
+}
+
+static const std::string UNKNOWN_TYPE = "UDP";
+const std::string& UDPOutputData::GetOutputTypeString() const {
+    return UNKNOWN_TYPE;
+}
+in_addr_t UDPOutputData::toInetAddr(const std::string& ip, bool& valid) {
+    in_addr_t addr = inet_addr(ip.c_str());
+    valid = addr != INADDR_NONE;
+    return addr;
+}
+void UDPOutputData::SaveFrame(unsigned char* channelData, int len) {
+}
+bool UDPOutputData::NeedToOutputFrame(unsigned char* channelData, int startChannel, int savedIdx, int count) {
+    return true;
+}
@@ -0,0 +1,21 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+// Stand in for the warning list, warnings are dropped.
+#include "fpp-pch.h"
+
+#include "Warnings.h"
+
+void WarningHolder::AddWarning(int id, const std::string& w, const std::map<std::string, std::string>& data) {
+}
+void WarningHolder::RemoveWarning(int id, const std::string& w, const std::string& plugin) {
+}
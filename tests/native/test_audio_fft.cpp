@@ -0,0 +1,284 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+// Checks the WLED audio reactive AudioFFT against a naive DFT on synthetic
+// tones and noise, and the sample ring that feeds it from the GStreamer
+// thread.
+#include "fpp-pch.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+
+#include "overlays/wled/audio_fft.h"
+#include "overlays/wled/audio_sample_ring.h"
+
+#include "testing.h"
+
+static std::vector<double> NaivePower(const std::vector<float>& in) {
+    int n = in.size();
+    std::vector<double> power(n / 2);
+    for (int k = 0; k < n / 2; k++) {
+        double re = 0;
+        double im = 0;
+        for (int t = 0; t < n; t++) {
+            double a = -2.0 * M_PI * (double)k * t / n;
+            re += in[t] * cos(a);
+            im += in[t] * sin(a);
+        }
+        power[k] = re * re + im * im;
+    }
+    return power;
+}
+
+// Every bin within a small fraction of the strongest one, float against
+// double accumulation over log2(n) stages
+static void CheckSpectrum(AudioFFT& fft, const std::vector<float>& in) {
+    int n = fft.size();
+    std::vector<float> power(n / 2);
+    fft.powerSpectrum(in.data(), power.data());
+    std::vector<double> ref = NaivePower(in);
+
+    double maxRef = *std::max_element(ref.begin(), ref.end());
+    int bad = 0;
+    for (int k = 0; k < n / 2; k++) {
+        if (fabs(power[k] - ref[k]) > 1e-4 * maxRef + 1e-6) {
+            if (!bad) {
+                fprintf(stderr, "size %d bin %d: %g != %g\n", n, k, power[k], ref[k]);
+            }
+            bad++;
+        }
+    }
+    CHECK_EQ(bad, 0);
+}
+
+static std::vector<float> Tone(int n, double sampleRate, double freq, double amp, double phase = 0) {
+    std::vector<float> v(n);
+    for (int i = 0; i < n; i++) {
+        v[i] = amp * sin(2.0 * M_PI * freq * i / sampleRate + phase);
+    }
+    return v;
+}
+
+static void TestAgainstDFT() {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    for (int n : { 16, 32, 64, 256, 1024 }) {
+        AudioFFT fft(n);
+        CHECK_EQ(fft.size(), n);
+
+        // DC, Nyquist and single bins hit the packing/unpacking edge cases
+        CheckSpectrum(fft, std::vector<float>(n, 0.5f));
+        std::vector<float> alt(n);
+        for (int i = 0; i < n; i++) {
+            alt[i] = (i & 1) ? -1.0f : 1.0f;
+        }
+        CheckSpectrum(fft, alt);
+        CheckSpectrum(fft, Tone(n, n, 1, 1.0));
+        CheckSpectrum(fft, Tone(n, n, n / 4 + 1, 0.7, 0.3));
+
+        // off-bin tone plus a harmonic and noise, like real audio
+        std::vector<float> mix = Tone(n, 44100, 1000, 0.8);
+        std::vector<float> h = Tone(n, 44100, 3000, 0.2, 1.0);
+        for (int i = 0; i < n; i++) {
+            mix[i] += h[i] + 0.05f * noise(rng);
+        }
+        CheckSpectrum(fft, mix);
+
+        std::vector<float> rnd(n);
+        for (auto& f : rnd) {
+            f = noise(rng);
+        }
+        CheckSpectrum(fft, rnd);
+    }
+}
+
+static void TestTonePeaks() {
+    const int n = 1024;
+    AudioFFT fft(n);
+    std::vector<float> power(n / 2);
+    for (double rate : { 22050.0, 44100.0, 48000.0 }) {
+        for (double freq : { 100.0, 440.0, 1000.0, 3000.0, 8000.0 }) {
+            if (freq >= rate / 2) {
+                continue;
+            }
+            fft.powerSpectrum(Tone(n, rate, freq, 1.0).data(), power.data());
+            int peak = std::max_element(power.begin(), power.end()) - power.begin();
+            int expected = (int)lround(freq * n / rate);
+            CHECK(abs(peak - expected) <= 1);
+        }
+    }
+}
+
+static void TestReductions() {
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    for (int count = 0; count < 70; count++) {
+        std::vector<float> v(count);
+        float mxAbs = 0;
+        for (int i = 0; i < count; i++) {
+            v[i] = dist(rng);
+            mxAbs = std::max(mxAbs, fabsf(v[i]));
+        }
+        if (count) {
+            // power spectra are never negative, maxValue only needs to
+            // be right for those
+            std::vector<float> pos(v);
+            float mxPos = 0;
+            for (auto& f : pos) {
+                f = fabsf(f);
+                mxPos = std::max(mxPos, f);
+            }
+            CHECK(AudioFFT::maxValue(pos.data(), count) == mxPos);
+        }
+        CHECK(AudioFFT::maxAbsValue(v.data(), count) == mxAbs);
+    }
+}
+
+static void TestRing() {
+    const size_t N = 1024;
+    std::array<float, N> window{};
+    auto ring = std::make_unique<AudioSampleRing>();
+
+    // partial pushes slide in behind the existing window contents
+    std::vector<int16_t> block(441);
+    int next = 1;
+    for (int b = 0; b < 3; b++) {
+        for (auto& s : block) {
+            s = next++;
+        }
+        ring->push(block.data(), block.size(), 22050);
+    }
+    CHECK_EQ(ring->available(), 3 * 441);
+    CHECK_EQ(ring->sampleRate(), 22050);
+    ring->slide(window);
+    CHECK_EQ(ring->available(), 0);
+    for (size_t i = 0; i < N; i++) {
+        CHECK_EQ((int)window[i], next - (int)N + (int)i);
+    }
+
+    // a short hop keeps the older samples and appends the new ones
+    std::vector<float> hop(100);
+    for (auto& f : hop) {
+        f = next++;
+    }
+    ring->push(hop.data(), hop.size(), 44100);
+    ring->slide(window);
+    CHECK_EQ(ring->sampleRate(), 44100);
+    for (size_t i = 0; i < N; i++) {
+        CHECK_EQ((int)window[i], next - (int)N + (int)i);
+    }
+
+    // wrap the indices around the end of the ring a few times
+    for (int b = 0; b < 50; b++) {
+        std::vector<float> chunk(700);
+        for (auto& f : chunk) {
+            f = next++;
+        }
+        ring->push(chunk.data(), chunk.size(), 44100);
+        ring->slide(window);
+        CHECK_EQ((int)window[N - 1], next - 1);
+        CHECK_EQ((int)window[0], next - (int)N);
+    }
+
+    // a full ring drops new blocks rather than overwriting unread ones
+    std::vector<float> big(AudioSampleRing::SIZE - 10);
+    for (auto& f : big) {
+        f = next++;
+    }
+    ring->push(big.data(), big.size(), 44100);
+    int last = next - 1;
+    std::vector<float> extra(20, -1.0f);
+    ring->push(extra.data(), extra.size(), 44100);
+    CHECK_EQ(ring->available(), AudioSampleRing::SIZE - 10);
+    ring->slide(window);
+    CHECK_EQ((int)window[N - 1], last);
+
+    // a block bigger than the ring keeps its newest samples
+    std::vector<float> huge(AudioSampleRing::SIZE + 500);
+    for (auto& f : huge) {
+        f = next++;
+    }
+    ring->push(huge.data(), huge.size(), 44100);
+    CHECK_EQ(ring->available(), AudioSampleRing::SIZE);
+    ring->slide(window);
+    CHECK_EQ((int)window[N - 1], next - 1);
+    CHECK_EQ((int)window[0], next - (int)N);
+}
+
+// GStreamer thread pushing 441 sample blocks of a counting signal while the
+// analysis thread slides.  Blocks may be dropped whole when the ring is
+// full but the consumed samples must stay in order, never repeat and only
+// jump at the start of a block.
+static void TestRingThreaded() {
+    const size_t N = 1024;
+    const int BLOCK = 441;
+    auto ring = std::make_unique<AudioSampleRing>();
+    std::atomic<bool> done{ false };
+
+    std::thread producer([&]() {
+        std::vector<float> block(BLOCK);
+        int next = 1;
+        auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+        // stay well inside the integers a float holds exactly
+        while (std::chrono::steady_clock::now() < end && next < 8000000) {
+            for (auto& f : block) {
+                f = next++;
+            }
+            ring->push(block.data(), block.size(), 44100);
+            std::this_thread::yield();
+        }
+        done = true;
+    });
+
+    std::array<float, N> window{};
+    int slides = 0;
+    int bad = 0;
+    float lastConsumed = 0;
+    while (!done || ring->available()) {
+        uint32_t avail = ring->available();
+        if (avail < 256 && !done) {
+            std::this_thread::yield();
+            continue;
+        }
+        ring->slide(window);
+        slides++;
+        size_t count = std::min<size_t>(avail, N);
+        for (size_t i = N - count; i < N; i++) {
+            float prev = i ? window[i - 1] : 0;
+            if (i == N - count) {
+                prev = lastConsumed;
+            }
+            bool blockStart = ((int)window[i] - 1) % BLOCK == 0;
+            if (!(window[i] == prev + 1 || (blockStart && window[i] > prev))) {
+                bad++;
+                break;
+            }
+        }
+        lastConsumed = window[N - 1];
+    }
+    producer.join();
+    CHECK(slides > 0);
+    CHECK_EQ(bad, 0);
+}
+
+int main(int argc, char** argv) {
+    TestAgainstDFT();
+    TestTonePeaks();
+    TestReductions();
+    TestRing();
+    TestRingThreaded();
+    return TEST_RESULT();
+}
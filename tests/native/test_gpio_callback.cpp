@@ -0,0 +1,103 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+// Drives a simulated /tmp/GPIO-<pin> input through
+// GPIOManager::AddGPIOCallback and the EPollManager/Timers loop fppd runs.
+// Callback pins (OutputMonitor's eFuse and fault inputs) must see every
+// edge straight away, not after the 100ms debounce settle that gpio.json
+// inputs get.
+#include "fpp-pch.h"
+
+#include "EPollManager.h"
+#include "Timers.h"
+#include "common.h"
+#include "gpio.h"
+#include "util/GPIOUtils.h"
+#include "util/TmpFileGPIO.h"
+
+#include "testing.h"
+
+struct Edge {
+    int value;
+    long long timeUS;
+};
+static std::vector<Edge> edges;
+
+// Run the fppd event loop until an edge arrives or maxMS passes
+static void Pump(int maxMS, size_t wantEdges) {
+    long long end = GetTimeMS() + maxMS;
+    while (edges.size() < wantEdges && GetTimeMS() < end) {
+        EPollManager::INSTANCE.waitForEvents(5);
+        Timers::INSTANCE.fireTimers();
+    }
+}
+
+// Toggle the pin and return how long the callback took, -1 if it never came
+static long long Toggle(const PinCapabilities& pin, bool v) {
+    size_t want = edges.size() + 1;
+    long long start = GetTime();
+    pin.setValue(v);
+    Pump(1000, want);
+    if (edges.size() < want) {
+        return -1;
+    }
+    return edges.back().timeUS - start;
+}
+
+int main(int argc, char** argv) {
+    PinCapabilities::InitGPIO("test_gpio_callback", new TmpFilePinProvider());
+    EPollManager::INSTANCE.setTimerCallback([]() {
+        Timers::INSTANCE.fireTimers();
+    });
+
+    const PinCapabilities& pin = PinCapabilities::getPinByName("TF-20");
+    CHECK(pin.ptr() != nullptr);
+    if (!pin.ptr()) {
+        return TEST_RESULT();
+    }
+    pin.setValue(false);
+
+    GPIOManager::INSTANCE.AddGPIOCallback(pin.ptr(), [](int v) {
+        edges.push_back({ v, GetTime() });
+        return true;
+    });
+
+    // both edges arrive well inside the default debounce window
+    for (int i = 0; i < 5; i++) {
+        long long rise = Toggle(pin, true);
+        CHECK(rise >= 0 && rise < DEFAULT_GPIO_DEBOUNCE_TIME / 2);
+        CHECK(!edges.empty() && edges.back().value == 1);
+
+        long long fall = Toggle(pin, false);
+        CHECK(fall >= 0 && fall < DEFAULT_GPIO_DEBOUNCE_TIME / 2);
+        CHECK(!edges.empty() && edges.back().value == 0);
+    }
+    CHECK_EQ(edges.size(), 10);
+
+    // a short pulse, like an eFuse trip that recovers, is still reported
+    size_t before = edges.size();
+    pin.setValue(true);
+    Pump(1000, before + 1);
+    pin.setValue(false);
+    Pump(1000, before + 2);
+    CHECK_EQ(edges.size(), before + 2);
+
+    // nothing fires once the callback is removed
+    GPIOManager::INSTANCE.RemoveGPIOCallback(pin.ptr());
+    before = edges.size();
+    pin.setValue(true);
+    Pump(50, before + 1);
+    CHECK_EQ(edges.size(), before);
+    pin.setValue(false);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,154 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+// Runs MosquittoClient against the stub broker in support/mosquitto_stubs.cpp.
+// Checks the publish thread keeps FIFO topics in order, coalesces topics
+// that only need their latest value, flushes the queue on shutdown and
+// refuses messages when Init failed and there is no thread to send them.
+#include "fpp-pch.h"
+
+#include <chrono>
+#include <thread>
+
+#include "common.h"
+#include "mosquitto.h"
+#include "mqtt.h"
+
+#include "testing.h"
+
+static MosquittoClient* NewClient() {
+    mqtt = new MosquittoClient("localhost", 1883, "test");
+    return mqtt;
+}
+
+static Json::Value Stats(MosquittoClient* client) {
+    Json::Value stats;
+    client->dumpPublishStats(stats);
+    return stats;
+}
+
+static std::vector<StubBroker::Message> Published() {
+    std::unique_lock<std::mutex> l(StubBroker::lock);
+    return StubBroker::published;
+}
+
+// Wait for the publish thread to empty the queue
+static bool Drain(MosquittoClient* client, int maxMS) {
+    long long end = GetTimeMS() + maxMS;
+    while (GetTimeMS() < end) {
+        if (Stats(client)["queued"].asUInt64() == 0) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+}
+
+static void TestInitFailure() {
+    MosquittoClient* client = NewClient();
+    CHECK_EQ(client->Init("", "", ""), 0);
+    CHECK_EQ(client->PublishRaw("test/raw", "1"), 0);
+    CHECK_EQ(client->PublishRaw("test/coalesced", "1", false, 1, true), 0);
+    CHECK_EQ(client->Publish("status", "idle", false), 0);
+    CHECK(!client->Publish("playlist_details", "{}"));
+
+    Json::Value stats = Stats(client);
+    CHECK_EQ(stats["queued"].asUInt64(), 0);
+    CHECK_EQ(stats["dropped"].asUInt64(), 4);
+    delete client;
+    CHECK(Published().empty());
+}
+
+static void TestPublish() {
+    StubBroker::Reset();
+    // slow enough that the coalesced topic backs up behind the FIFO ones
+    StubBroker::publishDelayUS = 500;
+
+    MosquittoClient* client = NewClient();
+    CHECK_EQ(client->Init("", "", ""), 1);
+    CHECK(client->IsConnected());
+    std::string base = client->GetBaseTopic();
+
+    const int count = 200;
+    for (int i = 0; i < count; i++) {
+        CHECK_EQ(client->PublishRaw("test/fifo", std::to_string(i)), 1);
+        CHECK_EQ(client->PublishRaw("test/light", std::to_string(i), false, 1, true), 1);
+    }
+    CHECK(Drain(client, 5000));
+
+    std::vector<StubBroker::Message> msgs = Published();
+    int fifo = 0;
+    int lights = 0;
+    std::string lastLight;
+    for (auto& m : msgs) {
+        if (m.topic == "test/fifo") {
+            CHECK(m.payload == std::to_string(fifo));
+            fifo++;
+        } else if (m.topic == "test/light") {
+            lights++;
+            lastLight = m.payload;
+        }
+    }
+    CHECK_EQ(fifo, count);
+    CHECK(lastLight == std::to_string(count - 1));
+    CHECK(lights < count);
+
+    Json::Value stats = Stats(client);
+    CHECK_EQ(stats["sent"].asUInt64(), msgs.size());
+    CHECK_EQ(stats["coalesced"].asUInt64(), count - lights);
+    CHECK_EQ(stats["dropped"].asUInt64(), 0);
+    CHECK_EQ(stats["errors"].asUInt64(), 0);
+
+    // the status snapshots coalesce, other topics go under the base topic
+    CHECK(client->Publish("fppd_status", "{}"));
+    CHECK(client->Publish("playlist/name/status", "Main"));
+    CHECK(Drain(client, 1000));
+    msgs = Published();
+    CHECK(msgs.size() >= 2 && msgs[msgs.size() - 1].topic == base + "/playlist/name/status");
+
+    // whatever is still queued goes out before the client goes away, even
+    // the deferred coalesced update
+    StubBroker::Reset();
+    StubBroker::publishDelayUS = 200;
+    for (int i = 0; i < 50; i++) {
+        client->PublishRaw("test/fifo", std::to_string(i));
+    }
+    client->PublishRaw("test/light", "final", false, 1, true);
+    delete client;
+
+    msgs = Published();
+    fifo = 0;
+    lastLight = "";
+    for (auto& m : msgs) {
+        if (m.topic == "test/fifo") {
+            CHECK(m.payload == std::to_string(fifo));
+            fifo++;
+        } else if (m.topic == "test/light") {
+            lastLight = m.payload;
+        }
+    }
+    CHECK_EQ(fifo, 50);
+    CHECK(lastLight == "final");
+}
+
+int main(int argc, char** argv) {
+    StubBroker::Reset();
+    StubBroker::connectResult = MOSQ_ERR_INVAL;
+    TestInitFailure();
+
+    StubBroker::Reset();
+    StubBroker::loopStartResult = MOSQ_ERR_NOT_SUPPORTED;
+    TestInitFailure();
+
+    TestPublish();
+    return TEST_RESULT();
+}
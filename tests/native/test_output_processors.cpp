@@ -0,0 +1,189 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+/*
+ * Random stacks of output processors run through the compiled plan must
+ * give the same channel data as running each processor in order.  Every
+ * round reloads the same two OutputProcessors objects so the plan is also
+ * checked after loadFromJSON() replaces the processors it was built from,
+ * while another thread keeps running frames through it the way the
+ * channel output thread does.
+ *
+ *   test_output_processors [seed]
+ */
+
+#include "fpp-pch.h"
+
+#include <random>
+
+#include "channeloutput/processors/OutputProcessor.h"
+#include "testing.h"
+
+constexpr int CHANNELS = 600;
+constexpr int ROUNDS = 300;
+constexpr int FRAMES = 4;
+
+class SequentialOutputProcessors : public OutputProcessors {
+public:
+    // What ProcessData() did before processors were compiled into a plan
+    void ProcessSequential(unsigned char* channelData) {
+        std::lock_guard<std::mutex> lock(processorsLock);
+        for (OutputProcessor* p : processors) {
+            if (p->isActive()) {
+                p->ProcessData(channelData);
+            }
+        }
+    }
+};
+
+static std::mt19937 rng;
+
+static int Rand(int lo, int hi) {
+    return std::uniform_int_distribution<int>(lo, hi)(rng);
+}
+
+// 1 based start and a count that fits in the buffer
+static void RandomRange(Json::Value& p, int maxCount) {
+    int count = Rand(1, maxCount);
+    p["start"] = Rand(1, CHANNELS - count + 1);
+    p["count"] = count;
+}
+
+static Json::Value RandomProcessor() {
+    Json::Value p;
+    p["active"] = 1;
+    switch (Rand(0, 6)) {
+    case 0:
+        p["type"] = "Brightness";
+        RandomRange(p, 200);
+        p["brightness"] = Rand(0, 100);
+        p["gamma"] = Rand(5, 30) / 10.0;
+        break;
+    case 1:
+        p["type"] = "Scale Value";
+        RandomRange(p, 200);
+        p["scale"] = Rand(0, 30) / 10.0;
+        break;
+    case 2:
+        p["type"] = "Clamp Value";
+        RandomRange(p, 200);
+        p["value"] = Rand(0, 255);
+        break;
+    case 3:
+        p["type"] = "Set Value";
+        RandomRange(p, 200);
+        p["value"] = Rand(0, 255);
+        break;
+    case 4:
+        p["type"] = "Override Zero";
+        RandomRange(p, 200);
+        p["value"] = Rand(0, 255);
+        break;
+    case 5: {
+        p["type"] = "Reorder Colors";
+        int pixels = Rand(1, 60);
+        p["start"] = Rand(1, CHANNELS - (pixels * 3) + 1);
+        p["count"] = pixels;
+        static const int orders[] = { 123, 132, 213, 231, 312, 321 };
+        p["colorOrder"] = orders[Rand(0, 5)];
+        break;
+    }
+    default: {
+        // Remaps are the most likely to be fused wrongly so weight them up
+        p["type"] = "Remap";
+        int count = Rand(1, 48);
+        int loops = Rand(1, 4);
+        p["source"] = Rand(1, CHANNELS - count + 1);
+        p["destination"] = Rand(1, CHANNELS - (count * loops) + 1);
+        p["count"] = count;
+        p["loops"] = loops;
+        p["reverse"] = Rand(0, 3);
+        break;
+    }
+    }
+    return p;
+}
+
+int main(int argc, char** argv) {
+    unsigned seed = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 12345;
+    rng.seed(seed);
+    // every processor logs its range at Info when created
+    FPPLogger::INSTANCE.ChannelOut.level = LOG_WARN;
+
+    SequentialOutputProcessors planned;
+    SequentialOutputProcessors sequential;
+    std::vector<unsigned char> a(CHANNELS);
+    std::vector<unsigned char> b(CHANNELS);
+
+    // Only checks that frames never run a plan left pointing at deleted
+    // processors (crashes, or fails under -fsanitize=address)
+    std::atomic<bool> running(true);
+    std::thread output([&]() {
+        std::vector<unsigned char> frame(CHANNELS);
+        while (running) {
+            planned.ProcessData(frame.data());
+        }
+    });
+
+    for (int round = 0; round < ROUNDS; round++) {
+        Json::Value config;
+        Json::Value& list = config["outputProcessors"];
+        list = Json::Value(Json::arrayValue);
+        int count = Rand(1, 12);
+        for (int x = 0; x < count; x++) {
+            Json::Value p = RandomProcessor();
+            // runs of the same kind are what the compiler fuses
+            int repeats = Rand(0, 2);
+            list.append(p);
+            for (int r = 0; r < repeats && x + 1 < count; r++, x++) {
+                Json::Value q = RandomProcessor();
+                while (q["type"] != p["type"]) {
+                    q = RandomProcessor();
+                }
+                list.append(q);
+            }
+        }
+        planned.loadFromJSON(config);
+        sequential.loadFromJSON(config);
+
+        for (int f = 0; f < FRAMES; f++) {
+            for (int c = 0; c < CHANNELS; c++) {
+                // plenty of zeros for Override Zero
+                a[c] = Rand(0, 3) ? Rand(0, 255) : 0;
+            }
+            b = a;
+            planned.ProcessData(a.data());
+            sequential.ProcessSequential(b.data());
+
+            int diff = -1;
+            for (int c = 0; c < CHANNELS && diff == -1; c++) {
+                if (a[c] != b[c]) {
+                    diff = c;
+                }
+            }
+            if (diff != -1) {
+                fprintf(stderr, "seed %u round %d frame %d: channel %d is %d, expected %d\n%s\n",
+                        seed, round, f, diff, a[diff], b[diff], list.toStyledString().c_str());
+            }
+            CHECK_EQ(diff, -1);
+            if (diff != -1) {
+                break;
+            }
+        }
+        if (TEST_FAILURES) {
+            break;
+        }
+    }
+    running = false;
+    output.join();
+    return TEST_RESULT();
+}
@@ -0,0 +1,114 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+/*
+ * A writer publishes frames into the v2 overlay buffer slots as fast as it
+ * can while the reader copies them out.  Every frame is filled with one
+ * byte value, so a copy Read() accepts must hold a single value.  A slot
+ * held mid-write must never be accepted.
+ */
+
+#include "fpp-pch.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "overlays/PixelOverlayBuffer.h"
+#include "testing.h"
+
+constexpr uint32_t FRAME_SIZE = 64 * 32 * 3;
+
+static bool Uniform(const std::vector<uint8_t>& frame) {
+    for (uint8_t v : frame) {
+        if (v != frame[0]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::vector<uint8_t> region(PixelOverlayBufferV2Header::RegionSize(FRAME_SIZE) + 64);
+    uint8_t* base = region.data();
+    uint32_t* v1 = (uint32_t*)base;
+    v1[0] = 64;
+    v1[1] = 32;
+    v1[2] = FPP_OVERLAY_BUFFER_FLAG_V2;
+
+    PixelOverlayBufferV2Header* h = new (base + PixelOverlayBufferV2Header::V2HeaderOffset(FRAME_SIZE)) PixelOverlayBufferV2Header();
+    h->magic = FPP_OVERLAY_BUFFER_V2_MAGIC;
+    h->version = 2;
+    h->slotCount = FPP_OVERLAY_BUFFER_V2_SLOTS;
+    h->slotSize = FRAME_SIZE;
+    h->slotOffset = PixelOverlayBufferV2Header::SlotOffset(FRAME_SIZE);
+    CHECK(PixelOverlayBufferV2Header::Find(base) == h);
+
+    std::vector<uint8_t> dest(FRAME_SIZE);
+    uint32_t lastGeneration = 0;
+
+    // Nothing published yet
+    CHECK(!h->Read(base, lastGeneration, dest.data()));
+
+    // A slot left mid-write is never accepted, however often it is retried
+    uint32_t slot;
+    uint8_t* data = h->BeginWrite(base, slot);
+    memset(data, 7, FRAME_SIZE);
+    h->publishedSlot.store(slot);
+    h->generation.fetch_add(1);
+    CHECK(!h->Read(base, lastGeneration, dest.data()));
+    CHECK_EQ(lastGeneration, 0);
+    h->Publish(slot);
+    CHECK(h->Read(base, lastGeneration, dest.data()));
+    CHECK(Uniform(dest));
+    CHECK_EQ(dest[0], 7);
+    CHECK(!h->Read(base, lastGeneration, dest.data()));
+
+    // Racing writer, run until both sides have done enough work to race
+    // often, even when the two threads share one CPU
+    std::atomic<bool> done(false);
+    std::atomic<int> published(0);
+    std::thread writer([&]() {
+        uint8_t value = 0;
+        while (!done) {
+            uint32_t s;
+            uint8_t* d = h->BeginWrite(base, s);
+            ++value;
+            for (uint32_t i = 0; i < FRAME_SIZE; i++) {
+                d[i] = value;
+            }
+            h->Publish(s);
+            published++;
+        }
+    });
+    int accepted = 0;
+    int torn = 0;
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((accepted < 200 || published < 100000) && std::chrono::steady_clock::now() < end) {
+        if (h->Read(base, lastGeneration, dest.data())) {
+            accepted++;
+            if (!Uniform(dest)) {
+                torn++;
+            }
+        }
+    }
+    done = true;
+    writer.join();
+    if (accepted == 0 || torn) {
+        fprintf(stderr, "%d of %d frames accepted, %d torn\n", accepted, published.load(), torn);
+    }
+    CHECK(accepted > 0);
+    CHECK_EQ(torn, 0);
+    CHECK_EQ(h->readingSlot.load(), 0);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,214 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+/*
+ * The compiled panel interleave tables must match map() for every handler
+ * type, and for the plain, flipped and zigzag types they must also match
+ * the panel layouts drawn in PanelInterleaveHandler.cpp.  Those layouts
+ * are restated here in terms of scan blocks rather than by copying the
+ * handler arithmetic, so a mistake in the handler shows up too.
+ */
+
+#include "fpp-pch.h"
+
+#include <set>
+
+#include "channeloutput/PanelInterleaveHandler.h"
+#include "testing.h"
+
+struct Geometry {
+    int width;
+    int height;
+    int scan;
+};
+
+// The top half of the panel is made of height / scan / 2 blocks of scan
+// rows.  The shift register chain for one row runs through interleave
+// pixels of each block in turn, last block first.
+static int Blocks(const Geometry& g) {
+    return g.height / g.scan / 2;
+}
+
+// "N" and "Nf" interleave, "Nf" panels swap each pair of blocks
+static void SimpleMap(const Geometry& g, int interleave, bool flip, int x, int y, int& xOut, int& yOut) {
+    int block = y / g.scan;
+    if (flip) {
+        block ^= 1;
+    }
+    yOut = y % g.scan;
+    int group = x / interleave;
+    xOut = interleave * (group * Blocks(g) + (Blocks(g) - 1 - block)) + x % interleave;
+}
+
+// "Nz" interleave on two block panels, odd groups of interleave pixels
+// have the two blocks swapped
+static void ZigZagMap(const Geometry& g, int interleave, int x, int y, int& xOut, int& yOut) {
+    int block = y / g.scan;
+    int group = x / interleave;
+    if (group & 1) {
+        block ^= 1;
+    }
+    yOut = y % g.scan;
+    xOut = interleave * (group * Blocks(g) + block) + x % interleave;
+}
+
+// Check a compiled region against the reference arithmetic, including the
+// row count and row length outputs size their buffers from
+static void CheckCompiled(const std::string& type, const Geometry& g, int height,
+                          const std::function<void(int, int, int&, int&)>& ref) {
+    PanelInterleaveHandler* handler = PanelInterleaveHandler::createHandler(type, g.width, g.height, g.scan);
+    PanelInterleaveHandler::Compiled c = handler->compile(g.width, height);
+    delete handler;
+
+    CHECK_EQ(c.width, g.width);
+    CHECK_EQ(c.height, height);
+    CHECK_EQ(c.offsets.size(), (size_t)g.width * height);
+
+    uint32_t rowLength = 0;
+    uint32_t rows = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < g.width; x++) {
+            int xOut, yOut;
+            ref(x, y, xOut, yOut);
+            rowLength = std::max(rowLength, (uint32_t)xOut + 1);
+            rows = std::max(rows, (uint32_t)yOut + 1);
+        }
+    }
+    CHECK_EQ(c.rowLength, rowLength);
+    CHECK_EQ(c.rows, rows);
+
+    int errors = 0;
+    int duplicates = 0;
+    std::set<uint32_t> used;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < g.width; x++) {
+            // every pixel drives its own LED
+            if (!used.insert(c.offset(x, y)).second) {
+                duplicates++;
+            }
+
+            int xOut, yOut;
+            ref(x, y, xOut, yOut);
+            if (c.mappedX(x, y) != xOut || c.mappedY(x, y) != yOut ||
+                c.offset(x, y) != (uint32_t)yOut * rowLength + xOut) {
+                if (errors++ == 0) {
+                    fprintf(stderr, "%s %dx%d/%d height %d: %d,%d should be %d,%d, compiled %d,%d\n",
+                            type.c_str(), g.width, g.height, g.scan, height, x, y, xOut, yOut,
+                            c.mappedX(x, y), c.mappedY(x, y));
+                }
+            }
+        }
+    }
+    CHECK_EQ(errors, 0);
+    CHECK_EQ(duplicates, 0);
+}
+
+// compile() against map() for every type createHandler knows, over the
+// whole panel and over the top half the outputs compile
+static void CheckAgainstMap(const std::string& type, const Geometry& g) {
+    PanelInterleaveHandler* handler = PanelInterleaveHandler::createHandler(type, g.width, g.height, g.scan);
+    for (int height : { g.height, g.height / 2 }) {
+        PanelInterleaveHandler::Compiled c = handler->compile(g.width, height);
+        CHECK_EQ(c.offsets.size(), (size_t)g.width * height);
+        int errors = 0;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < g.width; x++) {
+                int xOut = x;
+                int yOut = y;
+                handler->map(xOut, yOut);
+                if (c.mappedX(x, y) != xOut || c.mappedY(x, y) != yOut ||
+                    c.offset(x, y) != (uint32_t)yOut * c.rowLength + xOut) {
+                    if (errors++ == 0) {
+                        fprintf(stderr, "%s %dx%d/%d height %d: %d,%d maps to %d,%d, compiled %d,%d\n",
+                                type.c_str(), g.width, g.height, g.scan, height, x, y, xOut, yOut,
+                                c.mappedX(x, y), c.mappedY(x, y));
+                    }
+                }
+            }
+        }
+        CHECK_EQ(errors, 0);
+    }
+    delete handler;
+}
+
+int main() {
+    const Geometry geometries[] = {
+        { 32, 16, 4 }, { 32, 16, 8 }, { 32, 32, 4 }, { 32, 32, 8 }, { 32, 32, 16 },
+        { 64, 32, 8 }, { 64, 32, 16 }, { 64, 64, 8 }, { 64, 64, 16 }, { 64, 64, 32 },
+        { 80, 40, 10 }, { 128, 64, 16 }, { 128, 64, 32 }
+    };
+
+    std::vector<std::string> types = { "0", "4z", "8z", "16z", "32z", "40z",
+                                       "1f", "2f", "4f", "8f", "16f", "32f", "40f", "64f", "80f",
+                                       "1", "2", "4", "8", "16", "32", "40", "64", "80",
+                                       "8c", "16c", "8s", "16s" };
+    for (int i = 1; i <= 21; i++) {
+        types.push_back("RPi" + std::to_string(i));
+    }
+    for (const Geometry& g : geometries) {
+        for (const std::string& type : types) {
+            CheckAgainstMap(type, g);
+        }
+    }
+
+    for (const Geometry& g : geometries) {
+        if (g.scan * 2 == g.height) {
+            // scan of half the height has no interleave, whatever the type
+            CheckCompiled("8z", g, g.height, [&](int x, int y, int& xo, int& yo) {
+                xo = x;
+                yo = y;
+            });
+            continue;
+        }
+
+        // outputs compile the top half only, the bottom half shares its rows
+        int height = g.height / 2;
+        for (int interleave : { 4, 8, 16, 32 }) {
+            std::string n = std::to_string(interleave);
+            CheckCompiled(n, g, height, [&](int x, int y, int& xo, int& yo) {
+                SimpleMap(g, interleave, false, x, y, xo, yo);
+            });
+            CheckCompiled(n + "f", g, height, [&](int x, int y, int& xo, int& yo) {
+                SimpleMap(g, interleave, true, x, y, xo, yo);
+            });
+            if (Blocks(g) == 2) {
+                CheckCompiled(n + "z", g, height, [&](int x, int y, int& xo, int& yo) {
+                    ZigZagMap(g, interleave, x, y, xo, yo);
+                });
+            }
+        }
+    }
+
+    // Compiling a region larger than the panel stops at the panel edge
+    PanelInterleaveHandler* handler = PanelInterleaveHandler::createHandler("8", 32, 16, 4);
+    PanelInterleaveHandler::Compiled c = handler->compile(64, 32);
+    CHECK_EQ(c.width, 32);
+    CHECK_EQ(c.height, 16);
+
+    // An empty panel gives empty tables rather than dividing by a zero
+    // row length
+    c = handler->compile(0, 8);
+    CHECK_EQ(c.offsets.size(), 0);
+    CHECK_EQ(c.rowLength, 0);
+    CHECK_EQ(c.rows, 0);
+    c = handler->compile(-4, 8);
+    CHECK_EQ(c.offsets.size(), 0);
+    delete handler;
+
+    handler = PanelInterleaveHandler::createHandler("8", 0, 0, 0);
+    c = handler->compile(32, 16);
+    CHECK_EQ(c.offsets.size(), 0);
+    CHECK_EQ(c.rowLength, 0);
+    delete handler;
+
+    return TEST_RESULT();
+}
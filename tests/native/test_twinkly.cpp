@@ -0,0 +1,355 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the LGPL v2.1 as described in the
+ * included LICENSE.LGPL file.
+ */
+
+// Runs a TwinklyOutputData against a mock Twinkly on 127.0.0.2.  The mock
+// answers the xled REST login/verify/mode calls, reached through an
+// http_proxy so it doesn't need port 80, and receives the realtime frames
+// on the UDP port.  The handshake must never block the caller, frames only
+// go out once the device is in realtime mode and carry its token, and
+// responses that arrive after the output stopped are ignored.
+#include "fpp-pch.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <thread>
+
+#include "CurlManager.h"
+#include "Timers.h"
+#include "common.h"
+#include "channeloutput/Twinkly.h"
+
+#include "testing.h"
+
+static const char* DEVICE_IP = "127.0.0.2";
+static const std::string TOKEN = "ESIzRFVmd4g=";
+static const uint8_t TOKEN_BYTES[8] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88 };
+
+class MockTwinkly {
+public:
+    struct Request {
+        std::string method;
+        std::string path;
+        std::string token;
+        std::string body;
+    };
+
+    MockTwinkly() {
+        httpSock = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(httpSock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        bind(httpSock, (sockaddr*)&addr, sizeof(addr));
+        listen(httpSock, 8);
+        socklen_t len = sizeof(addr);
+        getsockname(httpSock, (sockaddr*)&addr, &len);
+        httpPort = ntohs(addr.sin_port);
+
+        udpSock = socket(AF_INET, SOCK_DGRAM, 0);
+        setsockopt(udpSock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        addr.sin_addr.s_addr = inet_addr(DEVICE_IP);
+        addr.sin_port = htons(TWINKLY_PORT);
+        udpBound = bind(udpSock, (sockaddr*)&addr, sizeof(addr)) == 0;
+
+        thread = std::thread([this]() { Serve(); });
+    }
+    ~MockTwinkly() {
+        stop = true;
+        thread.join();
+        close(httpSock);
+        close(udpSock);
+    }
+
+    std::vector<Request> Requests() {
+        std::unique_lock<std::mutex> l(lock);
+        return requests;
+    }
+    std::string Mode() {
+        std::unique_lock<std::mutex> l(lock);
+        return mode;
+    }
+
+    // next realtime frame packet, empty if none arrived
+    std::vector<uint8_t> ReceiveFrame(int timeoutMS) {
+        pollfd pfd = { udpSock, POLLIN, 0 };
+        std::vector<uint8_t> buf(2048);
+        if (poll(&pfd, 1, timeoutMS) <= 0) {
+            return {};
+        }
+        int len = recv(udpSock, buf.data(), buf.size(), 0);
+        buf.resize(len > 0 ? len : 0);
+        return buf;
+    }
+
+    int httpPort = 0;
+    bool udpBound = false;
+    std::atomic<int> failLogins = 0;
+    std::atomic<int> delayMS = 0;
+
+private:
+    void Serve() {
+        while (!stop) {
+            pollfd pfd = { httpSock, POLLIN, 0 };
+            if (poll(&pfd, 1, 20) <= 0) {
+                continue;
+            }
+            int c = accept(httpSock, nullptr, nullptr);
+            if (c >= 0) {
+                Handle(c);
+                close(c);
+            }
+        }
+    }
+    void Handle(int c) {
+        std::string in;
+        char buf[4096];
+        size_t hdrEnd;
+        while ((hdrEnd = in.find("\r\n\r\n")) == std::string::npos) {
+            int r = recv(c, buf, sizeof(buf), 0);
+            if (r <= 0) {
+                return;
+            }
+            in.append(buf, r);
+        }
+        std::string headers = in.substr(0, hdrEnd);
+        std::string lower = headers;
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        size_t contentLength = 0;
+        size_t p = lower.find("content-length:");
+        if (p != std::string::npos) {
+            contentLength = atoi(lower.c_str() + p + 15);
+        }
+        while (in.size() < hdrEnd + 4 + contentLength) {
+            int r = recv(c, buf, sizeof(buf), 0);
+            if (r <= 0) {
+                return;
+            }
+            in.append(buf, r);
+        }
+
+        // proxied requests carry the full URL, "POST http://host/xled/v1/login HTTP/1.1"
+        Request req;
+        req.method = headers.substr(0, headers.find(' '));
+        size_t u = headers.find("/xled/v1/");
+        req.path = u == std::string::npos ? "" : headers.substr(u + 9, headers.find(' ', u) - u - 9);
+        p = lower.find("x-auth-token:");
+        if (p != std::string::npos) {
+            size_t e = headers.find("\r\n", p);
+            req.token = headers.substr(p + 13, e - p - 13);
+            req.token.erase(0, req.token.find_first_not_of(' '));
+        }
+        req.body = in.substr(hdrEnd + 4, contentLength);
+
+        if (delayMS) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delayMS));
+        }
+
+        int status = 200;
+        std::string resp = "{\"code\": 1000}";
+        std::unique_lock<std::mutex> l(lock);
+        requests.push_back(req);
+        if (req.path == "login") {
+            if (failLogins > 0) {
+                failLogins--;
+                status = 401;
+                resp = "{\"code\": 1104}";
+            } else {
+                resp = "{\"authentication_token\": \"" + TOKEN + "\", \"authentication_token_expires_in\": 14400, \"code\": 1000}";
+            }
+        } else if (req.token != TOKEN) {
+            status = 401;
+            resp = "Invalid Token";
+        } else if (req.path == "led/mode") {
+            mode = req.body.find("\"rt\"") != std::string::npos ? "rt" : "off";
+        }
+        l.unlock();
+
+        std::string out = "HTTP/1.1 " + std::to_string(status) + (status == 200 ? " OK" : " Unauthorized") +
+                          "\r\nContent-Type: application/json\r\nContent-Length: " + std::to_string(resp.size()) +
+                          "\r\nConnection: close\r\n\r\n" + resp;
+        send(c, out.data(), out.size(), MSG_NOSIGNAL);
+    }
+
+    int httpSock = -1;
+    int udpSock = -1;
+    std::atomic<bool> stop = false;
+    std::thread thread;
+    std::mutex lock;
+    std::vector<Request> requests;
+    std::string mode = "movie";
+};
+
+// Run the curl and timer work fppd does from its main loop until done()
+static bool Pump(int maxMS, const std::function<bool()>& done) {
+    long long end = GetTimeMS() + maxMS;
+    while (GetTimeMS() < end) {
+        CurlManager::INSTANCE.processCurls();
+        Timers::INSTANCE.fireTimers();
+        if (done()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return false;
+}
+
+static TwinklyOutputData* NewOutput(int channels) {
+    Json::Value config;
+    config["address"] = DEVICE_IP;
+    config["startChannel"] = 1;
+    config["channelCount"] = channels;
+    config["active"] = 1;
+    return new TwinklyOutputData(config);
+}
+
+static int Prepare(TwinklyOutputData* out, unsigned char* data, UDPOutputMessages& msgs) {
+    msgs[out->twinklyAddress.sin_addr.s_addr].clear();
+    out->PrepareData(data, msgs);
+    return msgs[out->twinklyAddress.sin_addr.s_addr].size();
+}
+
+static void TestStreaming(MockTwinkly& mock) {
+    const int channels = 1200;
+    std::vector<unsigned char> data(channels);
+    for (int i = 0; i < channels; i++) {
+        data[i] = i * 7;
+    }
+    UDPOutputMessages msgs;
+
+    TwinklyOutputData* out = NewOutput(channels);
+    CHECK_EQ(out->portCount, 2);
+    CHECK_EQ(Prepare(out, data.data(), msgs), 0);
+
+    // a slow device doesn't hold up the caller, the handshake runs from
+    // the curl processing
+    mock.delayMS = 100;
+    long long start = GetTimeMS();
+    out->StartingOutput();
+    CHECK(GetTimeMS() - start < 50);
+    CHECK_EQ(Prepare(out, data.data(), msgs), 0);
+
+    CHECK(Pump(5000, [&]() { return Prepare(out, data.data(), msgs) > 0; }));
+    mock.delayMS = 0;
+
+    std::vector<MockTwinkly::Request> reqs = mock.Requests();
+    CHECK_EQ(reqs.size(), 3);
+    if (reqs.size() == 3) {
+        CHECK(reqs[0].method == "POST" && reqs[0].path == "login");
+        CHECK(reqs[1].method == "POST" && reqs[1].path == "verify" && reqs[1].token == TOKEN);
+        CHECK(reqs[2].method == "POST" && reqs[2].path == "led/mode" && reqs[2].token == TOKEN);
+    }
+    CHECK(mock.Mode() == "rt");
+
+    // send the frame the way UDPOutput does and check what the device gets
+    std::vector<struct mmsghdr>& m = msgs[out->twinklyAddress.sin_addr.s_addr];
+    CHECK_EQ(m.size(), 2);
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    CHECK_EQ(sendmmsg(sock, m.data(), m.size(), 0), (int)m.size());
+    close(sock);
+
+    int offset = 0;
+    for (int p = 0; p < 2; p++) {
+        std::vector<uint8_t> pkt = mock.ReceiveFrame(1000);
+        int len = std::min(900, channels - offset);
+        CHECK_EQ(pkt.size(), 12 + len);
+        if (pkt.size() != 12 + len) {
+            break;
+        }
+        CHECK_EQ(pkt[0], 3);
+        CHECK(memcmp(&pkt[1], TOKEN_BYTES, 8) == 0);
+        CHECK_EQ(pkt[9], 0);
+        CHECK_EQ(pkt[10], 0);
+        CHECK_EQ(pkt[11], p);
+        CHECK(memcmp(&pkt[12], &data[offset], len) == 0);
+        offset += len;
+    }
+
+    // stopping turns realtime mode off with the same token and stops frames
+    size_t before = mock.Requests().size();
+    out->StoppingOutput();
+    CHECK_EQ(Prepare(out, data.data(), msgs), 0);
+    CHECK(Pump(2000, [&]() { return mock.Mode() == "off"; }));
+    reqs = mock.Requests();
+    CHECK_EQ(reqs.size(), before + 1);
+    CHECK(reqs.back().path == "led/mode" && reqs.back().token == TOKEN);
+
+    delete out;
+    Pump(200, []() { return false; });
+}
+
+static void TestLoginFailure(MockTwinkly& mock) {
+    std::vector<unsigned char> data(300);
+    UDPOutputMessages msgs;
+    size_t before = mock.Requests().size();
+    mock.failLogins = 1;
+
+    TwinklyOutputData* out = NewOutput(data.size());
+    out->StartingOutput();
+    Pump(500, []() { return false; });
+
+    // one attempt, then wait for the retry time rather than hammering it
+    std::vector<MockTwinkly::Request> reqs = mock.Requests();
+    CHECK_EQ(reqs.size(), before + 1);
+    CHECK(reqs.back().path == "login");
+    CHECK_EQ(Prepare(out, data.data(), msgs), 0);
+    CHECK(mock.Mode() != "rt");
+
+    out->StoppingOutput();
+    delete out;
+    Pump(200, []() { return false; });
+    mock.failLogins = 0;
+}
+
+static void TestStopDuringHandshake(MockTwinkly& mock) {
+    std::vector<unsigned char> data(300);
+    UDPOutputMessages msgs;
+    size_t before = mock.Requests().size();
+    mock.delayMS = 200;
+
+    TwinklyOutputData* out = NewOutput(data.size());
+    out->StartingOutput();
+    out->StoppingOutput();
+
+    // the login answer arrives after the stop and must not carry on to
+    // verify and realtime mode
+    Pump(1000, []() { return false; });
+    std::vector<MockTwinkly::Request> reqs = mock.Requests();
+    CHECK_EQ(reqs.size(), before + 1);
+    CHECK(mock.Mode() != "rt");
+    CHECK_EQ(Prepare(out, data.data(), msgs), 0);
+
+    delete out;
+    mock.delayMS = 0;
+}
+
+int main(int argc, char** argv) {
+    MockTwinkly mock;
+    CHECK(mock.udpBound);
+    if (!mock.udpBound) {
+        fprintf(stderr, "Could not bind %s:%d for the mock Twinkly\n", DEVICE_IP, TWINKLY_PORT);
+        return TEST_RESULT();
+    }
+
+    // libcurl sends the REST calls for 127.0.0.2 to the mock's port
+    std::string proxy = "http://127.0.0.1:" + std::to_string(mock.httpPort);
+    setenv("http_proxy", proxy.c_str(), 1);
+    unsetenv("no_proxy");
+    unsetenv("NO_PROXY");
+
+    TestStreaming(mock);
+    TestLoginFailure(mock);
+    TestStopDuringHandshake(mock);
+    return TEST_RESULT();
+}
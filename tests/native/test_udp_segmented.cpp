@@ -0,0 +1,80 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the GPL v2 as described in the
+ * included LICENSE.GPL file.
+ */
+
+#include "fpp-pch.h"
+
+#include <netinet/in.h>
+
+#include "channeloutput/UDPSegmentedMessages.h"
+#include "testing.h"
+
+int main() {
+    sockaddr_in a = {};
+    a.sin_family = AF_INET;
+    a.sin_port = htons(5568);
+    sockaddr_in b = a;
+    b.sin_port = htons(5569);
+
+    uint8_t data[10][100];
+    struct iovec iovs[10];
+    std::vector<struct mmsghdr> msgs(10);
+    char ownControl[CMSG_SPACE(sizeof(int))] = {};
+    for (int x = 0; x < 10; x++) {
+        iovs[x].iov_base = data[x];
+        iovs[x].iov_len = 100;
+        memset(&msgs[x], 0, sizeof(msgs[x]));
+        msgs[x].msg_hdr.msg_name = x < 6 ? &a : &b;
+        msgs[x].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        msgs[x].msg_hdr.msg_iov = &iovs[x];
+        msgs[x].msg_hdr.msg_iovlen = 1;
+    }
+    // the last packet to each destination is short and ends its run
+    iovs[5].iov_len = 40;
+    iovs[9].iov_len = 40;
+
+    SegmentedMessages seg;
+    seg.build(msgs);
+    CHECK_EQ(seg.msgs.size(), 2);
+    CHECK_EQ(seg.sourceCount[0], 6);
+    CHECK_EQ(seg.sourceCount[1], 4);
+    CHECK_EQ(seg.msgs[0].msg_hdr.msg_iovlen, 6);
+    struct cmsghdr* cm = CMSG_FIRSTHDR(&seg.msgs[0].msg_hdr);
+    CHECK(cm != nullptr && cm->cmsg_type == UDP_SEGMENT);
+    uint16_t segSize = 0;
+    memcpy(&segSize, CMSG_DATA(cm), sizeof(segSize));
+    CHECK_EQ(segSize, 100);
+
+    // A message that already has control data, first in its run or not,
+    // goes out by itself with its own control buffer untouched
+    msgs[0].msg_hdr.msg_control = ownControl;
+    msgs[0].msg_hdr.msg_controllen = sizeof(ownControl);
+    msgs[7].msg_hdr.msg_control = ownControl;
+    msgs[7].msg_hdr.msg_controllen = sizeof(ownControl);
+    seg.build(msgs);
+    // [0] alone, [1..5] run, [6] alone (run broken by 7), [7] alone, [8..9] run
+    CHECK_EQ(seg.msgs.size(), 5);
+    CHECK_EQ(seg.sourceCount[0], 1);
+    CHECK(seg.msgs[0].msg_hdr.msg_control == ownControl);
+    CHECK_EQ(seg.msgs[0].msg_hdr.msg_controllen, sizeof(ownControl));
+    CHECK_EQ(seg.sourceCount[1], 5);
+    CHECK_EQ(seg.sourceCount[2], 1);
+    CHECK_EQ(seg.sourceCount[3], 1);
+    CHECK(seg.msgs[3].msg_hdr.msg_control == ownControl);
+    CHECK_EQ(seg.sourceCount[4], 2);
+
+    int total = 0;
+    for (int c : seg.sourceCount) {
+        total += c;
+    }
+    CHECK_EQ(total, 10);
+    return TEST_RESULT();
+}
@@ -0,0 +1,113 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the GPL v2 as described in the
+ * included LICENSE.GPL file.
+ */
+
+/*
+ * Renders overlay Text effect messages through GlyphAtlas into a model
+ * sized RGB buffer and reports frames/s, once for the first message with
+ * an empty atlas and then for a message that changes every frame (a
+ * clock or countdown), the way the Text effect redraws it.
+ *
+ *   text_glyph_bench [-F font] [-s size] [-w width] [-h height]
+ *                    [-m message] [-a] [-f frames]
+ *
+ * -a renders without antialiasing.  Use \n in the message for new lines.
+ */
+
+#include "fpp-pch.h"
+
+#include <chrono>
+
+#include "overlays/GlyphAtlas.h"
+
+static std::vector<std::string> SplitLines(const std::string& msg) {
+    std::vector<std::string> lines;
+    size_t last = 0;
+    size_t x;
+    while ((x = msg.find("\\n", last)) != std::string::npos) {
+        lines.push_back(msg.substr(last, x - last));
+        last = x + 2;
+    }
+    lines.push_back(msg.substr(last));
+    return lines;
+}
+
+int main(int argc, char** argv) {
+    std::string font = "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf";
+    std::string msg = "Merry Christmas  \\n  from the Falcon Player";
+    int size = 24;
+    int width = 256;
+    int height = 64;
+    int frames = 2000;
+    bool antialias = true;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "F:s:w:h:m:af:")) != -1) {
+        switch (opt) {
+        case 'F':
+            font = optarg;
+            break;
+        case 's':
+            size = atoi(optarg);
+            break;
+        case 'w':
+            width = atoi(optarg);
+            break;
+        case 'h':
+            height = atoi(optarg);
+            break;
+        case 'm':
+            msg = optarg;
+            break;
+        case 'a':
+            antialias = false;
+            break;
+        case 'f':
+            frames = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-F font] [-s size] [-w width] [-h height] [-m message] [-a] [-f frames]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (size < 1 || width < 1 || height < 1 || frames < 1) {
+        fprintf(stderr, "Invalid arguments\n");
+        return 1;
+    }
+
+    std::shared_ptr<GlyphAtlas> atlas = GlyphAtlas::Get(font, size, antialias);
+    if (!atlas) {
+        fprintf(stderr, "Could not load %s, FreeType missing or bad font (use -F)\n", font.c_str());
+        return 1;
+    }
+
+    std::vector<uint8_t> data(width * height * 3);
+    std::vector<std::string> lines = SplitLines(msg);
+
+    auto start = std::chrono::steady_clock::now();
+    atlas->render(lines, data.data(), width, height, 3, width / 2.0, height / 2.0, 255, 0, 0);
+    double firstMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+        std::vector<std::string> l = lines;
+        l.back() += " " + std::to_string(f);
+        memset(data.data(), 0, data.size());
+        atlas->render(l, data.data(), width, height, 3, width / 2.0, height / 2.0, 255, 255, 255);
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%s size %d%s, %dx%d, %d lines\n", font.c_str(), size, antialias ? " antialiased" : "",
+           width, height, (int)lines.size());
+    printf("first message  %8.3f ms (renders the glyphs into the atlas)\n", firstMs);
+    printf("changing text  %8.3f ms/frame  %10.0f frames/s\n", secs * 1000.0 / frames, frames / secs);
+    return 0;
+}
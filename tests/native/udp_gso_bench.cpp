@@ -0,0 +1,199 @@
+/*
+ * This file is part of the Falcon Player (FPP) and is Copyright (C)
+ * 2013-2026 by the Falcon Player Developers.
+ *
+ * The Falcon Player (FPP) is free software, and is covered under
+ * multiple Open Source licenses.  Please see the included 'LICENSES'
+ * file for descriptions of what files are covered by each license.
+ *
+ * This source file is covered under the GPL v2 as described in the
+ * included LICENSE.GPL file.
+ */
+
+/*
+ * Blasts universe sized packets at loopback receivers with plain sendmmsg
+ * and with the UDP_SEGMENT batching UDPOutput uses, then reports packets/s
+ * and send CPU per frame for each.
+ *
+ *   udp_gso_bench [-u universes] [-s packetSize] [-d destinations] [-f frames]
+ */
+
+#include "fpp-pch.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "channeloutput/UDPSegmentedMessages.h"
+
+// same batch size UDPOutput uses for the non-GSO path
+constexpr int MSGS_PER_SENDMMSG = 8;
+
+static std::atomic<bool> running(true);
+static std::atomic<uint64_t> received(0);
+
+static uint64_t ThreadCPUNanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+static uint64_t WallNanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void receiveLoop(std::vector<int> socks) {
+    std::vector<char> buf(65536);
+    while (running) {
+        bool any = false;
+        for (int s : socks) {
+            while (recv(s, &buf[0], buf.size(), MSG_DONTWAIT) > 0) {
+                received++;
+                any = true;
+            }
+        }
+        if (!any) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+struct Result {
+    bool ok = true;
+    uint64_t packets = 0;
+    uint64_t syscalls = 0;
+    uint64_t cpuNanos = 0;
+    uint64_t wallNanos = 0;
+};
+
+static Result runFrames(int sock, std::vector<struct mmsghdr>& msgs, int frames, bool gso) {
+    Result r;
+    SegmentedMessages segmented;
+    uint64_t wallStart = WallNanos();
+    uint64_t cpuStart = ThreadCPUNanos();
+    for (int f = 0; f < frames; f++) {
+        struct mmsghdr* out = &msgs[0];
+        int count = msgs.size();
+        if (gso) {
+            segmented.build(msgs);
+            out = &segmented.msgs[0];
+            count = segmented.msgs.size();
+        }
+        int sent = 0;
+        while (sent < count) {
+            int batch = gso ? (count - sent) : std::min(MSGS_PER_SENDMMSG, count - sent);
+            int rc = sendmmsg(sock, out + sent, batch, 0);
+            r.syscalls++;
+            if (rc < 0) {
+                if (errno == EINTR || errno == ENOBUFS) {
+                    continue;
+                }
+                fprintf(stderr, "sendmmsg failed: %s\n", strerror(errno));
+                r.ok = false;
+                return r;
+            }
+            sent += rc;
+        }
+        r.packets += msgs.size();
+    }
+    r.cpuNanos = ThreadCPUNanos() - cpuStart;
+    r.wallNanos = WallNanos() - wallStart;
+    return r;
+}
+
+int main(int argc, char** argv) {
+    int universes = 5000;
+    int packetSize = 638; // E1.31 header + 512 channels
+    int destinations = 10;
+    int frames = 200;
+    int opt;
+    while ((opt = getopt(argc, argv, "u:s:d:f:")) != -1) {
+        switch (opt) {
+        case 'u':
+            universes = atoi(optarg);
+            break;
+        case 's':
+            packetSize = atoi(optarg);
+            break;
+        case 'd':
+            destinations = atoi(optarg);
+            break;
+        case 'f':
+            frames = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-u universes] [-s packetSize] [-d destinations] [-f frames]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (universes < 1 || packetSize < 1 || packetSize > 1472 || destinations < 1 || frames < 1) {
+        fprintf(stderr, "Invalid arguments\n");
+        return 1;
+    }
+
+    // one receiver per destination, like one controller per IP
+    std::vector<int> rxSocks;
+    std::vector<sockaddr_in> addrs(destinations);
+    for (int d = 0; d < destinations; d++) {
+        int s = socket(AF_INET, SOCK_DGRAM, 0);
+        int rcvBuf = 8 * 1024 * 1024;
+        setsockopt(s, SOL_SOCKET, SO_RCVBUF, &rcvBuf, sizeof(rcvBuf));
+        sockaddr_in& a = addrs[d];
+        memset(&a, 0, sizeof(a));
+        a.sin_family = AF_INET;
+        a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        a.sin_port = 0;
+        if (bind(s, (sockaddr*)&a, sizeof(a)) != 0) {
+            fprintf(stderr, "bind failed: %s\n", strerror(errno));
+            return 1;
+        }
+        socklen_t len = sizeof(a);
+        getsockname(s, (sockaddr*)&a, &len);
+        rxSocks.push_back(s);
+    }
+    std::thread rxThread(receiveLoop, rxSocks);
+
+    int tx = socket(AF_INET, SOCK_DGRAM, 0);
+    int sndBuf = 2 * 65536;
+    setsockopt(tx, SOL_SOCKET, SO_SNDBUF, &sndBuf, sizeof(sndBuf));
+
+    // universes are spread over the destinations in consecutive blocks the
+    // same way a universe output lists them per controller
+    std::vector<uint8_t> data((size_t)universes * packetSize);
+    for (size_t x = 0; x < data.size(); x++) {
+        data[x] = x & 0xFF;
+    }
+    std::vector<struct iovec> iovs(universes);
+    std::vector<struct mmsghdr> msgs(universes);
+    int perDest = (universes + destinations - 1) / destinations;
+    for (int u = 0; u < universes; u++) {
+        iovs[u].iov_base = &data[(size_t)u * packetSize];
+        iovs[u].iov_len = packetSize;
+        memset(&msgs[u], 0, sizeof(msgs[u]));
+        msgs[u].msg_hdr.msg_name = &addrs[u / perDest];
+        msgs[u].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        msgs[u].msg_hdr.msg_iov = &iovs[u];
+        msgs[u].msg_hdr.msg_iovlen = 1;
+    }
+
+    printf("%d universes x %d bytes to %d loopback receivers, %d frames\n", universes, packetSize, destinations, frames);
+    const char* names[2] = { "sendmmsg", "UDP_SEGMENT" };
+    for (int mode = 0; mode < 2; mode++) {
+        received = 0;
+        Result r = runFrames(tx, msgs, frames, mode == 1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        if (!r.ok) {
+            printf("%-12s  not supported here\n", names[mode]);
+            continue;
+        }
+        double secs = r.wallNanos / 1e9;
+        printf("%-12s  %10.0f packets/s  %8.1f us CPU/frame  %7.1f syscalls/frame  %5.1f%% received\n",
+               names[mode], r.packets / secs, r.cpuNanos / 1000.0 / frames,
+               (double)r.syscalls / frames, 100.0 * received / r.packets);
+    }
+    running = false;
+    rxThread.join();
+    return 0;
+}
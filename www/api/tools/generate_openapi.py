@@ -38,7 +38,7 @@ CPP_SOURCES = [
     REPO_ROOT / 'src' / 'channeltester' / 'ChannelTester.cpp',  # ChannelTester       /fppd/testing/*
     REPO_ROOT / 'src' / 'overlays' / 'PixelOverlay.cpp',        # PixelOverlayManager /models, /overlays/*
     REPO_ROOT / 'src' / 'commands' / 'Commands.cpp',            # CommandManager      /command(s), /commandPresets
-    REPO_ROOT / 'src' / 'gpio.cpp',                             # GPIOManager         /gpio/*
+    REPO_ROOT / 'src' / 'gpioAPI.cpp',                          # GPIOManager         /gpio/*
     REPO_ROOT / 'src' / 'Player.cpp',                           # Player              /player/*
 ]
 
@@ -170,6 +170,8 @@ if (file_exists(__DIR__ . "/fppdefines.php")) {
 									<option value="1" selected>Multi-Threaded Blocking</option>
 									<option value="2">Single-Threaded Non-Blocking</option>
 									<option value="3">Multi-Threaded Non-Blocking</option>
+									<option value="4">Single-Threaded Segmented (UDP GSO)</option>
+									<option value="5">Multi-Threaded Segmented (UDP GSO)</option>
 								</select>
 							</div>
 						</div>